@@ -11,6 +11,7 @@ See the Mulan PSL v2 for more details. */
 #include <benchmark/benchmark.h>
 
 #include "sql/expr/arithmetic_operator.hpp"
+#include "sql/expr/simd_kernel.h"
 
 class ArithmeticBenchmark : public benchmark::Fixture
 {
@@ -97,4 +98,141 @@ static void benchmark_sum_scalar(benchmark::State &state)
 
 BENCHMARK(benchmark_sum_scalar)->RangeMultiplier(2)->Range(1 << 10, 1 << 12);
 
+////////////////////////////////////////////////////////////////////////////////
+// SimdKernel 在不同指令集上的性能。第一个参数是 SimdLevel，CPU 不支持时跳过
+
+static bool set_benchmark_simd_level(benchmark::State &state)
+{
+  const SimdLevel level = static_cast<SimdLevel>(state.range(0));
+  if (static_cast<int>(level) > static_cast<int>(cpu_simd_level())) {
+    state.SkipWithError("simd level is not supported by cpu");
+    return false;
+  }
+  set_simd_level(level);
+  state.SetLabel(simd_level_name(level));
+  return true;
+}
+
+static void simd_level_args(benchmark::internal::Benchmark *benchmark)
+{
+  for (int level : {0, 1, 2}) {
+    for (int size : {1024, 4096}) {
+      benchmark->Args({level, size});
+    }
+  }
+}
+
+static void benchmark_kernel_compare_int32(benchmark::State &state)
+{
+  if (!set_benchmark_simd_level(state)) {
+    return;
+  }
+  const int            size = state.range(1);
+  std::vector<int32_t> data(size);
+  for (int i = 0; i < size; i++) {
+    data[i] = i % 100;
+  }
+  const int32_t        value = 50;
+  std::vector<uint8_t> result(size);
+  for (auto _ : state) {
+    std::fill(result.begin(), result.end(), 1);
+    SimdKernel::compare_int32(CompOp::LESS_THAN, data.data(), false, &value, true, size, result.data());
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+  set_simd_level(cpu_simd_level());
+}
+
+BENCHMARK(benchmark_kernel_compare_int32)->Apply(simd_level_args);
+
+static void benchmark_kernel_compare_float(benchmark::State &state)
+{
+  if (!set_benchmark_simd_level(state)) {
+    return;
+  }
+  const int            size = state.range(1);
+  std::vector<float>   left(size);
+  std::vector<float>   right(size);
+  for (int i = 0; i < size; i++) {
+    left[i]  = static_cast<float>(i % 100);
+    right[i] = static_cast<float>(i % 37);
+  }
+  std::vector<uint8_t> result(size);
+  for (auto _ : state) {
+    std::fill(result.begin(), result.end(), 1);
+    SimdKernel::compare_float(CompOp::GREAT_EQUAL, left.data(), false, right.data(), false, size, result.data());
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+  set_simd_level(cpu_simd_level());
+}
+
+BENCHMARK(benchmark_kernel_compare_float)->Apply(simd_level_args);
+
+static void benchmark_kernel_compare_chars(benchmark::State &state)
+{
+  if (!set_benchmark_simd_level(state)) {
+    return;
+  }
+  const int         size = state.range(1);
+  const int         len  = 16;
+  std::vector<char> data(static_cast<size_t>(size) * len, 0);
+  for (int i = 0; i < size; i++) {
+    snprintf(data.data() + static_cast<size_t>(i) * len, len, "name-%08d", i % 100);
+  }
+  const char           value[] = "name-00000050";
+  std::vector<uint8_t> result(size);
+  for (auto _ : state) {
+    std::fill(result.begin(), result.end(), 1);
+    SimdKernel::compare_chars(
+        CompOp::EQUAL_TO, data.data(), len, false, value, sizeof(value) - 1, true, size, result.data());
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+  set_simd_level(cpu_simd_level());
+}
+
+BENCHMARK(benchmark_kernel_compare_chars)->Apply(simd_level_args);
+
+static void benchmark_kernel_mask_or(benchmark::State &state)
+{
+  if (!set_benchmark_simd_level(state)) {
+    return;
+  }
+  const int            size = state.range(1);
+  std::vector<uint8_t> dst(size);
+  std::vector<uint8_t> src(size);
+  for (int i = 0; i < size; i++) {
+    src[i] = i % 3 == 0;
+  }
+  for (auto _ : state) {
+    SimdKernel::mask_or(dst.data(), src.data(), size);
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+  set_simd_level(cpu_simd_level());
+}
+
+BENCHMARK(benchmark_kernel_mask_or)->Apply(simd_level_args);
+
+static void benchmark_kernel_arith_float(benchmark::State &state)
+{
+  if (!set_benchmark_simd_level(state)) {
+    return;
+  }
+  const int          size = state.range(1);
+  std::vector<float> left(size, 1.0f);
+  std::vector<float> right(size, 0.5f);
+  std::vector<float> result(size);
+  for (auto _ : state) {
+    SimdKernel::arith_float(
+        SimdKernel::ArithType::MUL, left.data(), false, right.data(), false, size, result.data());
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+  set_simd_level(cpu_simd_level());
+}
+
+BENCHMARK(benchmark_kernel_arith_float)->Apply(simd_level_args);
+
 BENCHMARK_MAIN();
\ No newline at end of file
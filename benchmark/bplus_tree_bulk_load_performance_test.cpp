@@ -0,0 +1,137 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/filesystem.h"
+#include "common/lang/random.h"
+#include "common/lang/stdexcept.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/index/bplus_tree_bulk_loader.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 对比创建索引时逐条插入和批量构建B+树的耗时
+ * @details 数据是随机生成的整数键值，每一行的 RID 都不同。参数0是行数。
+ */
+class BulkLoadBenchmark : public Fixture
+{
+public:
+  void SetUp(const State &state) override
+  {
+    LoggerFactory::init_default("bplus_tree_bulk_load_performance_test.log", LOG_LEVEL_WARN);
+
+    const int64_t row_num = state.range(0);
+    if (static_cast<int64_t>(keys_.size()) != row_num) {
+      keys_.resize(row_num);
+      mt19937 generator(0);
+      for (int64_t i = 0; i < row_num; i++) {
+        keys_[i] = static_cast<int32_t>(generator());
+      }
+    }
+
+    filesystem::remove_all(directory_);
+    filesystem::create_directories(directory_);
+
+    bpm_ = make_unique<BufferPoolManager>();
+    if (OB_FAIL(bpm_->init(make_unique<VacuousDoubleWriteBuffer>())) ||
+        OB_FAIL(bpm_->create_file(file_name().c_str())) ||
+        OB_FAIL(bpm_->open_file(log_handler_, file_name().c_str(), buffer_pool_)) ||
+        OB_FAIL(handler_.create(log_handler_, *buffer_pool_, AttrType::INTS, sizeof(int32_t)))) {
+      throw runtime_error("failed to create bplus tree");
+    }
+  }
+
+  void TearDown(const State &state) override
+  {
+    handler_.close();
+    bpm_->close_file(file_name().c_str());
+    bpm_.reset();
+    filesystem::remove_all(directory_);
+  }
+
+  static RID make_rid(int64_t row) { return RID(static_cast<PageNum>(row / 1000), static_cast<SlotNum>(row % 1000)); }
+
+protected:
+  string file_name() const { return (filesystem::path(directory_) / "bulk_load.btree").string(); }
+
+protected:
+  const char *directory_ = "bplus_tree_bulk_load_performance_test";
+
+  vector<int32_t>              keys_;
+  VacuousLogHandler            log_handler_;
+  unique_ptr<BufferPoolManager> bpm_;
+  DiskBufferPool              *buffer_pool_ = nullptr;
+  BplusTreeHandler             handler_;
+};
+
+/// 原来的方式，每一行都调用一次 insert_entry
+BENCHMARK_DEFINE_F(BulkLoadBenchmark, InsertEntry)(State &state)
+{
+  for (auto _ : state) {
+    for (size_t i = 0; i < keys_.size(); i++) {
+      RID rid = make_rid(i);
+      if (OB_FAIL(handler_.insert_entry(reinterpret_cast<const char *>(&keys_[i]), &rid))) {
+        state.SkipWithError("failed to insert entry");
+        return;
+      }
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * keys_.size());
+}
+
+/// 外部排序之后自底向上地构建
+BENCHMARK_DEFINE_F(BulkLoadBenchmark, BulkLoad)(State &state)
+{
+  for (auto _ : state) {
+    BplusTreeBulkLoader loader(handler_);
+    for (size_t i = 0; i < keys_.size(); i++) {
+      if (OB_FAIL(loader.add(reinterpret_cast<const char *>(&keys_[i]), make_rid(i)))) {
+        state.SkipWithError("failed to add entry");
+        return;
+      }
+    }
+    if (OB_FAIL(loader.finish())) {
+      state.SkipWithError("failed to bulk load");
+      return;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * keys_.size());
+}
+
+// 每次迭代都需要一棵空的B+树，所以只迭代一次
+BENCHMARK_REGISTER_F(BulkLoadBenchmark, InsertEntry)
+    ->Arg(1000 * 1000)
+    ->Arg(10 * 1000 * 1000)
+    ->Unit(kMillisecond)
+    ->Iterations(1)
+    ->UseRealTime();
+
+BENCHMARK_REGISTER_F(BulkLoadBenchmark, BulkLoad)
+    ->Arg(1000 * 1000)
+    ->Arg(10 * 1000 * 1000)
+    ->Unit(kMillisecond)
+    ->Iterations(1)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 #include <benchmark/benchmark.h>
 #include <inttypes.h>
 
+#include "common/lang/atomic.h"
 #include "common/lang/stdexcept.h"
 #include "common/log/log.h"
 #include "common/math/integer_generator.h"
@@ -208,7 +209,44 @@ BENCHMARK_DEFINE_F(InsertionBenchmark, Insertion)(State &state)
   state.counters["other"]     = Counter(stat.insert_other_count, Counter::kIsRate);
 }
 
-BENCHMARK_REGISTER_F(InsertionBenchmark, Insertion)->Threads(10);
+BENCHMARK_REGISTER_F(InsertionBenchmark, Insertion)->ThreadRange(1, 64)->UseRealTime();
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief 所有线程插入递增的键值，类似自增主键，写操作都集中在最右边的叶子节点上
+ */
+struct SequentialInsertionBenchmark : public BenchmarkBase
+{
+  string Name() const override { return "sequential_insertion"; }
+
+  void SetUp(const State &state) override
+  {
+    BenchmarkBase::SetUp(state);
+    if (0 == state.thread_index()) {
+      next_value_ = 1;
+    }
+  }
+
+protected:
+  atomic<uint32_t> next_value_{1};
+};
+
+BENCHMARK_DEFINE_F(SequentialInsertionBenchmark, Insertion)(State &state)
+{
+  Stat stat;
+
+  for (auto _ : state) {
+    uint32_t value = next_value_.fetch_add(1);
+    Insert(value, stat);
+  }
+
+  state.counters["success"]   = Counter(stat.insert_success_count, Counter::kIsRate);
+  state.counters["duplicate"] = Counter(stat.duplicate_count, Counter::kIsRate);
+  state.counters["other"]     = Counter(stat.insert_other_count, Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(SequentialInsertionBenchmark, Insertion)->ThreadRange(1, 64)->UseRealTime();
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,120 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2024/07/20.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/stdexcept.h"
+#include "common/log/log.h"
+#include "common/math/integer_generator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 测试 DiskBufferPool::get_this_page/unpin_page 在不同线程数下的吞吐量
+ * @details 参数0是数据页面的个数，参数1是buffer pool的内存大小(MB)。
+ * 如果数据页面比内存中能容纳的页面多，就会测试到淘汰的流程。
+ */
+class BufferPoolBenchmark : public Fixture
+{
+public:
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      while (!setup_done_) {
+        this_thread::sleep_for(chrono::milliseconds(100));
+      }
+      return;
+    }
+
+    LoggerFactory::init_default("buffer_pool_concurrency_test.log", LOG_LEVEL_WARN);
+
+    bpm_ = make_unique<BufferPoolManager>(static_cast<int>(state.range(1)) * 1024 * 1024);
+    bpm_->init(make_unique<VacuousDoubleWriteBuffer>());
+
+    ::remove(filename_);
+    RC rc = bpm_->create_file(filename_);
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to create buffer pool file");
+    }
+
+    rc = bpm_->open_file(log_handler_, filename_, buffer_pool_);
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to open buffer pool file");
+    }
+
+    page_count_ = static_cast<int>(state.range(0));
+    for (int i = 0; i < page_count_; i++) {
+      Frame *frame = nullptr;
+      rc           = buffer_pool_->allocate_page(&frame);
+      if (OB_FAIL(rc)) {
+        throw runtime_error("failed to allocate page");
+      }
+      frame->mark_dirty();
+      buffer_pool_->unpin_page(frame);
+    }
+    setup_done_ = true;
+  }
+
+  void TearDown(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    setup_done_ = false;
+    buffer_pool_->close_file();
+    buffer_pool_ = nullptr;
+    bpm_.reset();
+    ::remove(filename_);
+  }
+
+protected:
+  const char                   *filename_ = "buffer_pool_concurrency_test.bp";
+  unique_ptr<BufferPoolManager> bpm_;
+  DiskBufferPool               *buffer_pool_ = nullptr;
+  VacuousLogHandler             log_handler_;
+  int                           page_count_ = 0;
+  volatile bool                 setup_done_ = false;
+};
+
+BENCHMARK_DEFINE_F(BufferPoolBenchmark, GetUnpin)(State &state)
+{
+  IntegerGenerator generator(1, page_count_);  // page 0 是文件头
+  int64_t          failed_count = 0;
+
+  for (auto _ : state) {
+    Frame *frame = nullptr;
+    RC     rc    = buffer_pool_->get_this_page(generator.next(), &frame);
+    if (OB_FAIL(rc)) {
+      failed_count++;
+      continue;
+    }
+    buffer_pool_->unpin_page(frame);
+  }
+
+  state.counters["failed"] = Counter(failed_count, Counter::kIsRate);
+  state.SetItemsProcessed(state.iterations());
+}
+
+// 所有页面都在内存中
+BENCHMARK_REGISTER_F(BufferPoolBenchmark, GetUnpin)->Args({1024, 16})->ThreadRange(1, 64)->UseRealTime();
+// 页面数是内存的4倍，会频繁地淘汰页面
+BENCHMARK_REGISTER_F(BufferPoolBenchmark, GetUnpin)->Args({4096, 8})->ThreadRange(1, 64)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,118 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2024/07/22.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/chrono.h"
+#include "common/lang/filesystem.h"
+#include "common/lang/stdexcept.h"
+#include "common/log/log.h"
+#include "storage/clog/disk_log_handler.h"
+#include "storage/clog/log_replayer.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 测试事务提交的延迟和吞吐量
+ * @details 每次提交写一条日志，然后等待这条日志落盘(wait_lsn)，与事务提交的流程一样。
+ * 参数0是组提交的等待时间(微秒)。
+ */
+class CommitBenchmark : public Fixture
+{
+public:
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      while (!setup_done_) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+      }
+      return;
+    }
+
+    LoggerFactory::init_default("clog_commit_performance_test.log", LOG_LEVEL_WARN);
+
+    filesystem::remove_all(directory_);
+
+    log_handler_ = make_unique<DiskLogHandler>();
+    RC rc        = log_handler_->init(directory_);
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to init log handler");
+    }
+
+    log_handler_->set_group_commit_options(chrono::microseconds(state.range(0)), 1024 * 1024);
+
+    rc = log_handler_->replay(replayer_, 0);
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to replay log handler");
+    }
+
+    rc = log_handler_->start();
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to start log handler");
+    }
+    setup_done_ = true;
+  }
+
+  void TearDown(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    setup_done_ = false;
+    log_handler_->stop();
+    log_handler_->await_termination();
+    log_handler_.reset();
+    filesystem::remove_all(directory_);
+  }
+
+protected:
+  class NopReplayer : public LogReplayer
+  {
+  public:
+    RC replay(const LogEntry &) override { return RC::SUCCESS; }
+  };
+
+  const char                *directory_ = "clog_commit_performance_test";
+  unique_ptr<DiskLogHandler> log_handler_;
+  NopReplayer                replayer_;
+  volatile bool              setup_done_ = false;
+};
+
+BENCHMARK_DEFINE_F(CommitBenchmark, Commit)(State &state)
+{
+  vector<char> payload(64, 'a');
+  int64_t      failed_count = 0;
+
+  for (auto _ : state) {
+    LSN lsn = 0;
+    RC  rc  = log_handler_->append(lsn, LogModule::Id::TRANSACTION, span<const char>(payload));
+    if (OB_SUCC(rc)) {
+      rc = log_handler_->wait_lsn(lsn);
+    }
+    if (OB_FAIL(rc)) {
+      failed_count++;
+    }
+  }
+
+  state.counters["failed"] = Counter(failed_count, Counter::kIsRate);
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(CommitBenchmark, Commit)->Arg(0)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_REGISTER_F(CommitBenchmark, Commit)->Arg(100)->ThreadRange(1, 64)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,134 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/filesystem.h"
+#include "common/lang/fstream.h"
+#include "common/lang/random.h"
+#include "common/lang/stdexcept.h"
+#include "common/lang/string.h"
+#include "common/log/log.h"
+#include "sql/executor/data_file_loader.h"
+#include "storage/db/db.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 测试 LOAD DATA 导入数据的速度
+ * @details 每种大小的数据文件只生成一次，每次迭代都在一个新的数据库中建表并导入。
+ * 参数0是数据文件的大小(MB)，参数1表示是否在 id 列上创建索引，参数2是解析线程数。
+ * 结果中的 bytes_per_second 就是导入的速度。
+ */
+class LoadDataBenchmark : public Fixture
+{
+public:
+  void SetUp(const State &state) override
+  {
+    LoggerFactory::init_default("load_data_performance_test.log", LOG_LEVEL_WARN);
+
+    data_file_ = "load_data_performance_test_" + to_string(state.range(0)) + "mb.data";
+    if (!filesystem::exists(data_file_)) {
+      generate(state.range(0) * 1024 * 1024);
+    }
+  }
+
+  void TearDown(const State &state) override { filesystem::remove_all(db_directory_); }
+
+  /// 在新的数据库中导入一次数据，只统计导入的时间
+  void load(State &state, bool with_index, int thread_num)
+  {
+    state.PauseTiming();
+    filesystem::remove_all(db_directory_);
+    filesystem::create_directories(db_directory_);
+
+    auto  db    = make_unique<Db>();
+    Table *table = nullptr;
+    if (OB_FAIL(db->init("load_data", db_directory_, "vacuous", "vacuous")) ||
+        OB_FAIL(db->create_table("t", attributes_)) || (table = db->find_table("t")) == nullptr) {
+      throw runtime_error("failed to create table");
+    }
+    if (with_index && OB_FAIL(table->create_index(nullptr, {table->table_meta().field("id")}, "t_id"))) {
+      throw runtime_error("failed to create index");
+    }
+    state.ResumeTiming();
+
+    DataFileLoader loader(table, thread_num);
+    RC             rc = loader.load(data_file_.c_str());
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to load data: " + loader.error_message());
+    }
+
+    state.PauseTiming();
+    state.SetBytesProcessed(state.bytes_processed() + loader.file_size());
+    state.counters["records"] = static_cast<double>(loader.record_num());
+    db.reset();
+    state.ResumeTiming();
+  }
+
+protected:
+  /// 生成至少 file_size 字节的数据文件，id 是随机的，以免索引的键值天然有序
+  void generate(int64_t file_size)
+  {
+    ofstream ofs(data_file_, ios::out | ios::trunc);
+    if (!ofs.is_open()) {
+      throw runtime_error("failed to create data file");
+    }
+
+    const char *cities[] = {"beijing", "shanghai", "hangzhou", "shenzhen", "chengdu"};
+    mt19937     generator(0);
+    string      line;
+    for (int64_t size = 0, i = 0; size < file_size; i++) {
+      line = to_string(static_cast<int32_t>(generator())) + "|" + to_string(generator() % 10000 / 100.0) + "|name_" +
+             to_string(i) + "|" + cities[i % 5] + "\n";
+      ofs << line;
+      size += line.size();
+    }
+  }
+
+protected:
+  string      data_file_;
+  const char *db_directory_ = "load_data_performance_test_db";
+
+  const vector<AttrInfoSqlNode> attributes_ = {
+      {AttrType::INTS, "id", sizeof(int32_t)},
+      {AttrType::FLOATS, "score", sizeof(float)},
+      {AttrType::CHARS, "name", 32},
+      {AttrType::CHARS, "city", 16},
+  };
+};
+
+BENCHMARK_DEFINE_F(LoadDataBenchmark, Load)(State &state)
+{
+  for (auto _ : state) {
+    load(state, state.range(1) != 0, static_cast<int>(state.range(2)));
+  }
+}
+
+// 每次迭代都需要一个新的数据库，所以只迭代一次
+BENCHMARK_REGISTER_F(LoadDataBenchmark, Load)
+    ->ArgNames({"mb", "index", "threads"})
+    ->Args({256, 0, 1})
+    ->Args({256, 0, 4})
+    ->Args({256, 1, 4})
+    ->Args({4096, 1, 4})
+    ->Unit(kMillisecond)
+    ->Iterations(1)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
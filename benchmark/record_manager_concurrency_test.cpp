@@ -91,6 +91,7 @@ public:
     LoggerFactory::init_default(log_name.c_str(), LOG_LEVEL_INFO);
 
     ::remove(record_filename.c_str());
+    ::remove(FreeSpaceMap::file_name(record_filename.c_str()).c_str());
 
     RC rc = bpm_.create_file(record_filename.c_str());
     if (rc != RC::SUCCESS) {
@@ -256,7 +257,8 @@ BENCHMARK_DEFINE_F(InsertionBenchmark, Insertion)(State &state)
   state.counters["other"]   = Counter(stat.insert_other_count, Counter::kIsRate);
 }
 
-BENCHMARK_REGISTER_F(InsertionBenchmark, Insertion)->Threads(10);
+// 不同线程数下的插入吞吐，用来观察插入的扩展性
+BENCHMARK_REGISTER_F(InsertionBenchmark, Insertion)->ThreadRange(1, 8)->UseRealTime();
 
 ////////////////////////////////////////////////////////////////////////////////
 
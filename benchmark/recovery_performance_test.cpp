@@ -0,0 +1,191 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/filesystem.h"
+#include "common/lang/stdexcept.h"
+#include "common/lang/string.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/disk_log_handler.h"
+#include "storage/clog/integrated_log_replayer.h"
+#include "storage/record/record_manager.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 测试崩溃恢复时日志回放的耗时
+ * @details 先在多个数据文件中插入记录生成大量日志，并保存一份没有刷盘的数据文件。
+ * 每次迭代都从这份数据文件和日志开始，使用不同的回放线程数做一次完整的恢复。
+ * 参数0是回放线程数。
+ */
+class RecoveryBenchmark : public Fixture
+{
+public:
+  void SetUp(const State &state) override
+  {
+    LoggerFactory::init_default("recovery_performance_test.log", LOG_LEVEL_WARN);
+
+    if (!filesystem::exists(base_directory_)) {
+      generate();
+    }
+  }
+
+  void TearDown(const State &state) override { filesystem::remove_all(work_directory_); }
+
+  /// 从保存的数据文件和日志做一次恢复，只统计日志回放的时间
+  void recover(State &state, int worker_num)
+  {
+    state.PauseTiming();
+    filesystem::remove_all(work_directory_);
+    filesystem::copy(base_directory_, work_directory_, filesystem::copy_options::recursive);
+
+    BufferPoolManager bpm;
+    DiskLogHandler    log_handler;
+    if (OB_FAIL(bpm.init(make_unique<VacuousDoubleWriteBuffer>())) ||
+        OB_FAIL(log_handler.init(work_directory_))) {
+      throw runtime_error("failed to init buffer pool manager or log handler");
+    }
+
+    vector<string> files;
+    for (int i = 0; i < FILE_NUM; i++) {
+      DiskBufferPool *buffer_pool = nullptr;
+      files.push_back(data_file(work_directory_, i));
+      if (OB_FAIL(bpm.open_file(log_handler, files.back().c_str(), buffer_pool))) {
+        throw runtime_error("failed to open buffer pool file");
+      }
+    }
+    state.ResumeTiming();
+
+    IntegratedLogReplayer log_replayer(bpm, worker_num);
+    RC                    rc = log_handler.replay(log_replayer, 0);
+    if (OB_SUCC(rc)) {
+      rc = log_replayer.on_done();
+    }
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to replay log");
+    }
+
+    state.PauseTiming();
+    for (const string &file : files) {
+      bpm.close_file(file.c_str());
+    }
+    state.ResumeTiming();
+  }
+
+protected:
+  static string data_file(const char *directory, int index)
+  {
+    return (filesystem::path(directory) / ("recovery_" + to_string(index) + ".bp")).string();
+  }
+
+  /// 生成日志和数据文件。数据页面只在分配时以空页面的形式写入磁盘，所有修改都需要从日志中恢复
+  void generate()
+  {
+    const char *directory = "recovery_performance_test_gen";
+    filesystem::remove_all(directory);
+    filesystem::create_directories(directory);
+
+    BufferPoolManager bpm(512 * 1024 * 1024);
+    DiskLogHandler    log_handler;
+    NopReplayer       replayer;
+    if (OB_FAIL(bpm.init(make_unique<VacuousDoubleWriteBuffer>())) || OB_FAIL(log_handler.init(directory)) ||
+        OB_FAIL(log_handler.replay(replayer, 0)) || OB_FAIL(log_handler.start())) {
+      throw runtime_error("failed to init buffer pool manager or log handler");
+    }
+
+    vector<unique_ptr<RecordFileHandler>> handlers;
+    for (int i = 0; i < FILE_NUM; i++) {
+      string          file        = data_file(directory, i);
+      DiskBufferPool *buffer_pool = nullptr;
+      if (OB_FAIL(bpm.create_file(file.c_str())) || OB_FAIL(bpm.open_file(log_handler, file.c_str(), buffer_pool))) {
+        throw runtime_error("failed to create buffer pool file");
+      }
+
+      handlers.push_back(make_unique<RecordFileHandler>(StorageFormat::ROW_FORMAT));
+      if (OB_FAIL(handlers.back()->init(*buffer_pool, log_handler, nullptr))) {
+        throw runtime_error("failed to init record file handler");
+      }
+    }
+
+    char record[RECORD_SIZE] = "hello, world!";
+    for (int i = 0; i < RECORD_NUM_PER_FILE; i++) {
+      for (auto &handler : handlers) {
+        RID rid;
+        if (OB_FAIL(handler->insert_record(record, RECORD_SIZE, &rid))) {
+          throw runtime_error("failed to insert record");
+        }
+      }
+    }
+    log_handler.wait_lsn(log_handler.current_lsn());
+
+    // 数据页都还在内存中，这时复制出来的数据文件相当于崩溃时的磁盘状态
+    filesystem::create_directories(base_directory_);
+    for (int i = 0; i < FILE_NUM; i++) {
+      filesystem::copy_file(data_file(directory, i), data_file(base_directory_, i));
+    }
+    for (const auto &entry : filesystem::directory_iterator(directory)) {
+      if (entry.path().filename().string().rfind("clog_", 0) == 0) {
+        filesystem::copy(entry.path(), base_directory_, filesystem::copy_options::overwrite_existing);
+      }
+    }
+
+    for (auto &handler : handlers) {
+      handler->close();
+    }
+    handlers.clear();
+    log_handler.stop();
+    log_handler.await_termination();
+    for (int i = 0; i < FILE_NUM; i++) {
+      bpm.close_file(data_file(directory, i).c_str());
+    }
+    filesystem::remove_all(directory);
+  }
+
+protected:
+  class NopReplayer : public LogReplayer
+  {
+  public:
+    RC replay(const LogEntry &) override { return RC::SUCCESS; }
+  };
+
+  static constexpr int FILE_NUM            = 8;
+  static constexpr int RECORD_NUM_PER_FILE = 20000;
+  static constexpr int RECORD_SIZE         = 100;
+
+  const char *base_directory_ = "recovery_performance_test_base";
+  const char *work_directory_ = "recovery_performance_test";
+};
+
+BENCHMARK_DEFINE_F(RecoveryBenchmark, Replay)(State &state)
+{
+  for (auto _ : state) {
+    recover(state, static_cast<int>(state.range(0)));
+  }
+
+  state.SetItemsProcessed(state.iterations() * FILE_NUM * RECORD_NUM_PER_FILE);
+}
+
+BENCHMARK_REGISTER_F(RecoveryBenchmark, Replay)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->Unit(kMillisecond)
+    ->Iterations(3)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -17,9 +17,12 @@ See the Mulan PSL v2 for more details. */
 #include <stdio.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
+#include <limits.h>
 #include <unistd.h>
 
 #include "common/io/io.h"
+#include "common/lang/algorithm.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "common/math/regex.h"
@@ -367,6 +370,33 @@ int writen(int fd, const void *buf, int size)
   return 0;
 }
 
+int writevn(int fd, struct iovec *iov, int iovcnt)
+{
+  while (iovcnt > 0) {
+    const int     batch = min(iovcnt, IOV_MAX);
+    const ssize_t ret   = ::writev(fd, iov, batch);
+    if (ret < 0) {
+      const int err = errno;
+      if (EAGAIN != err && EINTR != err)
+        return err;
+      continue;
+    }
+
+    // 跳过已经写完的部分，可能有一段只写了一半
+    size_t written = static_cast<size_t>(ret);
+    while (iovcnt > 0 && written >= iov->iov_len) {
+      written -= iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+    if (iovcnt > 0) {
+      iov->iov_base = static_cast<char *>(iov->iov_base) + written;
+      iov->iov_len -= written;
+    }
+  }
+  return 0;
+}
+
 int readn(int fd, void *buf, int size)
 {
   char *tmp = (char *)buf;
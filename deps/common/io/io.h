@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <sys/uio.h>
 #include <vector>
 
 #include "common/defs.h"
@@ -67,6 +68,17 @@ int getFileSize(const char *filePath, uint64_t &fileLen);
  */
 int writen(int fd, const void *buf, int size);
 
+/**
+ * @brief 使用writev一次性写入多段数据
+ * @details 会修改iov中的内容，写入失败时iov的状态是不确定的
+ *
+ * @param fd 写入的描述符
+ * @param iov 写入的数据
+ * @param iovcnt iov数组的长度
+ * @return int 0 表示成功，否则返回errno
+ */
+int writevn(int fd, struct iovec *iov, int iovcnt);
+
 /**
  * @brief 一次性读取指定长度的数据
  *
@@ -0,0 +1,272 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2024/07/20.
+//
+
+#pragma once
+
+#include "common/lang/algorithm.h"
+#include "common/lang/functional.h"
+#include "common/lang/unordered_set.h"
+
+namespace common {
+
+/**
+ * @brief 分段LRU缓存(Segmented LRU)
+ * @details 与 LruCache 接口一致，但是把链表分成了两段：试用段(probation)和保护段(protected)。
+ * 新放入的元素先进入试用段，只有在试用段中再次被访问到(get命中)时才会晋升到保护段。
+ * 保护段的大小有上限，超出时将保护段尾部的元素降级到试用段头部。
+ * 淘汰时(foreach_reverse)先遍历试用段，再遍历保护段。
+ *
+ * 这是 LRU-2 的一种近似实现，一次性的顺序扫描只会污染试用段，不会把频繁访问的元素
+ * (比如B+树的内部节点)挤出去。
+ */
+template <typename Key, typename Value, typename Hash = hash<Key>, typename Pred = equal_to<Key>>
+class SegmentedLruCache
+{
+  class ListNode
+  {
+  public:
+    Key   key_;
+    Value value_;
+    bool  protected_ = false;
+
+    ListNode *prev_ = nullptr;
+    ListNode *next_ = nullptr;
+
+  public:
+    ListNode(const Key &key, const Value &value) : key_(key), value_(value) {}
+  };
+
+  /**
+   * @brief 一个简单的双向链表，front是最近访问的，tail是最久没有访问的
+   */
+  class NodeList
+  {
+  public:
+    void push_front(ListNode *node)
+    {
+      node->prev_ = nullptr;
+      node->next_ = front_;
+      if (front_ != nullptr) {
+        front_->prev_ = node;
+      } else {
+        tail_ = node;
+      }
+      front_ = node;
+      size_++;
+    }
+
+    void unlink(ListNode *node)
+    {
+      if (node->prev_ != nullptr) {
+        node->prev_->next_ = node->next_;
+      } else {
+        front_ = node->next_;
+      }
+
+      if (node->next_ != nullptr) {
+        node->next_->prev_ = node->prev_;
+      } else {
+        tail_ = node->prev_;
+      }
+
+      node->prev_ = nullptr;
+      node->next_ = nullptr;
+      size_--;
+    }
+
+    void clear()
+    {
+      front_ = nullptr;
+      tail_  = nullptr;
+      size_  = 0;
+    }
+
+    ListNode *front() const { return front_; }
+    ListNode *tail() const { return tail_; }
+    size_t    size() const { return size_; }
+
+  private:
+    ListNode *front_ = nullptr;
+    ListNode *tail_  = nullptr;
+    size_t    size_  = 0;
+  };
+
+  class PListNodeHasher
+  {
+  public:
+    size_t operator()(ListNode *node) const
+    {
+      if (node == nullptr) {
+        return 0;
+      }
+      return hasher_(node->key_);
+    }
+
+  private:
+    Hash hasher_;
+  };
+
+  class PListNodePredicator
+  {
+  public:
+    bool operator()(ListNode *const node1, ListNode *const node2) const
+    {
+      if (node1 == node2) {
+        return true;
+      }
+
+      if (node1 == nullptr || node2 == nullptr) {
+        return false;
+      }
+
+      return pred_(node1->key_, node2->key_);
+    }
+
+  private:
+    Pred pred_;
+  };
+
+public:
+  /**
+   * @param reserve 预留的哈希表大小
+   * @param protected_percent 保护段最多占用的元素百分比
+   */
+  SegmentedLruCache(size_t reserve = 0, int protected_percent = DEFAULT_PROTECTED_PERCENT)
+      : protected_percent_(protected_percent)
+  {
+    if (reserve > 0) {
+      searcher_.reserve(reserve);
+    }
+  }
+
+  ~SegmentedLruCache() { destroy(); }
+
+  void destroy()
+  {
+    for (ListNode *node : searcher_) {
+      delete node;
+    }
+    searcher_.clear();
+
+    probation_.clear();
+    protected_.clear();
+  }
+
+  size_t count() const { return searcher_.size(); }
+  size_t protected_count() const { return protected_.size(); }
+
+  bool get(const Key &key, Value &value)
+  {
+    auto iter = searcher_.find((ListNode *)&key);
+    if (iter == searcher_.end()) {
+      return false;
+    }
+
+    touch(*iter);
+    value = (*iter)->value_;
+    return true;
+  }
+
+  void put(const Key &key, const Value &value)
+  {
+    auto iter = searcher_.find((ListNode *)&key);
+    if (iter != searcher_.end()) {
+      ListNode *ln = *iter;
+      ln->value_   = value;
+      touch(ln);
+      return;
+    }
+
+    ListNode *ln = new ListNode(key, value);
+    probation_.push_front(ln);
+    searcher_.insert(ln);
+  }
+
+  void remove(const Key &key)
+  {
+    auto iter = searcher_.find((ListNode *)&key);
+    if (iter == searcher_.end()) {
+      return;
+    }
+
+    ListNode *node = *iter;
+    list_of(node).unlink(node);
+    searcher_.erase(iter);
+    delete node;
+  }
+
+  /**
+   * @brief 按照从热到冷的顺序遍历：先保护段，再试用段
+   */
+  void foreach (function<bool(const Key &, const Value &)> func)
+  {
+    for (NodeList *list : {&protected_, &probation_}) {
+      for (ListNode *node = list->front(); node != nullptr; node = node->next_) {
+        if (!func(node->key_, node->value_)) {
+          return;
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief 按照淘汰优先级遍历：先试用段，再保护段，每段都从最久未访问的开始
+   */
+  void foreach_reverse(function<bool(const Key &, const Value &)> func)
+  {
+    for (NodeList *list : {&probation_, &protected_}) {
+      for (ListNode *node = list->tail(); node != nullptr; node = node->prev_) {
+        if (!func(node->key_, node->value_)) {
+          return;
+        }
+      }
+    }
+  }
+
+private:
+  NodeList &list_of(ListNode *node) { return node->protected_ ? protected_ : probation_; }
+
+  void touch(ListNode *node)
+  {
+    if (node->protected_) {
+      protected_.unlink(node);
+      protected_.push_front(node);
+      return;
+    }
+
+    // 在试用段中再次被访问，晋升到保护段
+    probation_.unlink(node);
+    node->protected_ = true;
+    protected_.push_front(node);
+
+    const size_t max_protected = max<size_t>(1, searcher_.size() * protected_percent_ / 100);
+    while (protected_.size() > max_protected) {
+      ListNode *victim = protected_.tail();
+      protected_.unlink(victim);
+      victim->protected_ = false;
+      probation_.push_front(victim);
+    }
+  }
+
+private:
+  static constexpr int DEFAULT_PROTECTED_PERCENT = 80;
+
+  using SearchType = unordered_set<ListNode *, PListNodeHasher, PListNodePredicator>;
+  SearchType searcher_;
+  NodeList   probation_;
+  NodeList   protected_;
+  int        protected_percent_;
+};
+
+}  // namespace common
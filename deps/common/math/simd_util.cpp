@@ -9,8 +9,55 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include <stdint.h>
+#include <atomic>
 #include "common/math/simd_util.h"
 
+SimdLevel cpu_simd_level()
+{
+#if defined(SIMD_RUNTIME_DISPATCH)
+  static const SimdLevel level = []() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512vl")) {
+      return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+      return SimdLevel::AVX2;
+    }
+    return SimdLevel::SCALAR;
+  }();
+  return level;
+#else
+  return SimdLevel::SCALAR;
+#endif
+}
+
+static std::atomic<SimdLevel> &current_simd_level()
+{
+  static std::atomic<SimdLevel> level(cpu_simd_level());
+  return level;
+}
+
+SimdLevel simd_level() { return current_simd_level().load(std::memory_order_relaxed); }
+
+void set_simd_level(SimdLevel level)
+{
+  if (static_cast<int>(level) > static_cast<int>(cpu_simd_level())) {
+    level = cpu_simd_level();
+  }
+  current_simd_level().store(level, std::memory_order_relaxed);
+}
+
+const char *simd_level_name(SimdLevel level)
+{
+  switch (level) {
+    case SimdLevel::SCALAR: return "scalar";
+    case SimdLevel::AVX2: return "avx2";
+    case SimdLevel::AVX512: return "avx512";
+  }
+  return "unknown";
+}
+
 #if defined(USE_SIMD)
 
 int mm256_extract_epi32_var_indx(const __m256i vec, const unsigned int i)
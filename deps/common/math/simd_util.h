@@ -10,6 +10,36 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+/**
+ * @brief 运行时可以使用的 SIMD 指令集
+ * @details 与编译选项 USE_SIMD 无关。需要运行时选择实现的代码(比如 SimdKernel)按照 simd_level()
+ * 选择标量、AVX2 或者 AVX-512 的实现，这样同一个二进制文件可以运行在不同的 CPU 上。
+ */
+enum class SimdLevel
+{
+  SCALAR,  ///< 不使用 SIMD 指令
+  AVX2,
+  AVX512,  ///< 需要 AVX-512 F/BW/VL
+};
+
+/// @brief 当前 CPU 支持的最高的指令集
+SimdLevel cpu_simd_level();
+
+/// @brief 实际使用的指令集，默认与 cpu_simd_level() 相同
+SimdLevel simd_level();
+
+/// @brief 设置实际使用的指令集，超过 CPU 支持的指令集时使用 CPU 支持的最高指令集。主要用于测试
+void set_simd_level(SimdLevel level);
+
+const char *simd_level_name(SimdLevel level);
+
+/// 支持按函数指定目标指令集(target attribute)的编译器才能在运行时选择 SIMD 实现
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_RUNTIME_DISPATCH 1
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx2,avx512f,avx512bw,avx512vl")))
+#endif
+
 #if defined(USE_SIMD)
 #include <immintrin.h>
 
@@ -27,7 +27,7 @@ public:
   virtual Snapshot *get_snapshot() { return snapshot_value_; }
 
 protected:
-  Snapshot *snapshot_value_;
+  Snapshot *snapshot_value_ = nullptr;
 };
 
 }  // namespace common
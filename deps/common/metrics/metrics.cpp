@@ -46,7 +46,7 @@ void Meter::snapshot()
 
   long now_tick = now.tv_sec * 1000000 + now.tv_usec;
 
-  double temp_value = ((double)value_.exchange(0l)) / ((now_tick - snapshot_tick_) / 1000000);
+  double temp_value = ((double)value_.exchange(0l)) / ((now_tick - snapshot_tick_) / 1000000.0);
   snapshot_tick_    = now_tick;
 
   if (snapshot_value_ == NULL) {
@@ -87,7 +87,7 @@ void SimpleTimer::snapshot()
   double mean = 0;
 
   if (times_snapshot > 0) {
-    tps  = ((double)times_snapshot) / ((now_tick - snapshot_tick_) / 1000000);
+    tps  = ((double)times_snapshot) / ((now_tick - snapshot_tick_) / 1000000.0);
     mean = ((double)value_snapshot) / times_snapshot;
   }
 
@@ -151,7 +151,7 @@ void Timer::snapshot()
 
   long now_tick = now.tv_sec * 1000000 + now.tv_usec;
 
-  double tps     = ((double)value_.exchange(0l)) / ((now_tick - snapshot_tick_) / 1000000);
+  double tps     = ((double)value_.exchange(0l)) / ((now_tick - snapshot_tick_) / 1000000.0);
   snapshot_tick_ = now_tick;
 
   MUTEX_LOCK(&mutex);
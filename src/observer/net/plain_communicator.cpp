@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "net/plain_communicator.h"
 #include "common/io/io.h"
+#include "common/lang/algorithm.h"
 #include "common/log/log.h"
 #include "event/session_event.h"
 #include "net/buffered_writer.h"
@@ -37,12 +38,21 @@ RC PlainCommunicator::read_event(SessionEvent *&event)
   int data_len = 0;
   int read_len = 0;
 
-  const int    max_packet_size = 8192;
-  vector<char> buf(max_packet_size);
+  // 一条 insert 语句可能带有几千行数据，所以缓存按需扩大，直到 max_packet_size
+  const int    max_packet_size = 64 * 1024 * 1024;
+  vector<char> buf(8192);
 
   // 持续接收消息，直到遇到'\0'。将'\0'遇到的后续数据直接丢弃没有处理，因为目前仅支持一收一发的模式
   while (true) {
-    read_len = ::read(fd_, buf.data() + data_len, max_packet_size - data_len);
+    if (data_len == static_cast<int>(buf.size())) {
+      if (data_len >= max_packet_size) {
+        data_len = max_packet_size + 1;
+        break;
+      }
+      buf.resize(min(static_cast<int>(buf.size()) * 2, max_packet_size));
+    }
+
+    read_len = ::read(fd_, buf.data() + data_len, buf.size() - data_len);
     if (read_len < 0) {
       if (errno == EAGAIN) {
         continue;
@@ -53,11 +63,6 @@ RC PlainCommunicator::read_event(SessionEvent *&event)
       break;
     }
 
-    if (read_len + data_len > max_packet_size) {
-      data_len += read_len;
-      break;
-    }
-
     bool msg_end = false;
     for (int i = 0; i < read_len; i++) {
       if (buf[data_len + i] == 0) {
@@ -330,7 +335,8 @@ RC PlainCommunicator::write_chunk_result(SqlResult *sql_result)
   Chunk chunk;
   while (RC::SUCCESS == (rc = sql_result->next_chunk(chunk))) {
     int col_num = chunk.column_num();
-    for (int row_idx = 0; row_idx < chunk.rows(); row_idx++) {
+    for (int i = 0; i < chunk.selected_rows(); i++) {
+      const int row_idx = chunk.row_index(i);
       for (int col_idx = 0; col_idx < col_num; col_idx++) {
         if (col_idx != 0) {
           const char *delim = " | ";
@@ -0,0 +1,304 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "sql/executor/data_file_loader.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/charconv.h"
+#include "common/lang/defer.h"
+#include "common/lang/mutex.h"
+#include "common/lang/span.h"
+#include "common/lang/thread.h"
+#include "common/log/log.h"
+#include "storage/record/record.h"
+#include "storage/table/table.h"
+
+struct DataFileLoader::Block
+{
+  const char *begin = nullptr;
+  const char *end   = nullptr;
+
+  bool         parsed     = false;
+  int          line_count = 0;  ///< 解析了多少行，出错时最后一行就是出错的行
+  vector<char> data;            ///< 解析出来的记录，一条接着一条存放
+  vector<int>  record_lines;    ///< 每条记录在数据块中的行号，从1开始
+  RC           rc = RC::SUCCESS;
+  string       errmsg;
+};
+
+static bool is_blank(const char *begin, const char *end)
+{
+  for (; begin < end; begin++) {
+    if (!isspace(static_cast<unsigned char>(*begin))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// 解析整数或浮点数，忽略两端的空白字符，整个字符串都需要是合法的数字
+template <typename T>
+static bool parse_number(const char *begin, const char *end, T &value)
+{
+  while (begin < end && isspace(static_cast<unsigned char>(*begin))) {
+    begin++;
+  }
+  while (end > begin && isspace(static_cast<unsigned char>(end[-1]))) {
+    end--;
+  }
+  if (end - begin > 1 && begin[0] == '+' && begin[1] != '-') {
+    begin++;  // from_chars 不接受正号
+  }
+
+  from_chars_result result = from_chars(begin, end, value);
+  return begin < end && result.ec == errc() && result.ptr == end;
+}
+
+DataFileLoader::DataFileLoader(Table *table, int thread_num, char delimiter, int block_size)
+    : table_(table),
+      thread_num_(thread_num > 0 ? thread_num : max(1, static_cast<int>(thread::hardware_concurrency()))),
+      delimiter_(delimiter),
+      block_size_(max(1, block_size))
+{
+  const TableMeta &table_meta = table->table_meta();
+  record_size_                = table_meta.record_size();
+  for (int i = table_meta.sys_field_num(); i < table_meta.field_num(); i++) {
+    fields_.push_back(table_meta.field(i));
+  }
+}
+
+RC DataFileLoader::load(const char *file_name)
+{
+  int fd = ::open(file_name, O_RDONLY);
+  if (fd < 0) {
+    error_message_ = string("Failed to open file: ") + file_name + ". system error=" + strerror(errno);
+    return RC::FILE_NOT_EXIST;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    error_message_ = string("Failed to stat file: ") + file_name + ". system error=" + strerror(errno);
+    ::close(fd);
+    return RC::IOERR_READ;
+  }
+  file_size_ = st.st_size;
+
+  const char *data = nullptr;
+  if (file_size_ > 0) {
+    void *addr = mmap(nullptr, file_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      error_message_ = string("Failed to map file: ") + file_name + ". system error=" + strerror(errno);
+      ::close(fd);
+      return RC::IOERR_READ;
+    }
+    madvise(addr, file_size_, MADV_SEQUENTIAL);
+    data = static_cast<const char *>(addr);
+  }
+  ::close(fd);  // 关闭文件不影响已经建立的映射
+  DEFER(if (data != nullptr) { munmap(const_cast<char *>(data), file_size_); });
+
+  // 按照换行符切分数据块，每个数据块都包含完整的行
+  vector<Block> blocks;
+  for (const char *pos = data, *end = data + file_size_; pos < end;) {
+    const char *block_end = pos + min<int64_t>(block_size_, end - pos);
+    if (block_end < end) {
+      const void *newline = memchr(block_end - 1, '\n', end - block_end + 1);
+      block_end           = newline != nullptr ? static_cast<const char *>(newline) + 1 : end;
+    }
+    blocks.emplace_back();
+    blocks.back().begin = pos;
+    blocks.back().end   = block_end;
+    pos                 = block_end;
+  }
+
+  LOG_INFO("start to load data. table=%s, file=%s, size=%ld, blocks=%d, threads=%d",
+           table_->name(), file_name, file_size_, static_cast<int>(blocks.size()), thread_num_);
+
+  mutex              lock;
+  condition_variable cond;
+  size_t             next_block     = 0;  // 下一个要解析的数据块
+  size_t             inserted_block = 0;  // 已经插入了多少个数据块
+  bool               stopped        = false;
+  const size_t       max_pending    = 2 * static_cast<size_t>(thread_num_);
+
+  auto parser = [&]() {
+    unique_lock<mutex> guard(lock);
+    while (true) {
+      cond.wait(guard, [&]() {
+        return stopped || next_block >= blocks.size() || next_block < inserted_block + max_pending;
+      });
+      if (stopped || next_block >= blocks.size()) {
+        return;
+      }
+
+      Block &block = blocks[next_block++];
+      guard.unlock();
+      parse_block(block);
+      guard.lock();
+      block.parsed = true;
+      cond.notify_all();
+    }
+  };
+
+  vector<thread> parsers;
+  for (int i = 0; i < thread_num_ && i < static_cast<int>(blocks.size()); i++) {
+    parsers.emplace_back(parser);
+  }
+
+  RC rc = RC::SUCCESS;
+  for (size_t i = 0; i < blocks.size() && OB_SUCC(rc); i++) {
+    Block &block = blocks[i];
+    {
+      unique_lock<mutex> guard(lock);
+      cond.wait(guard, [&block]() { return block.parsed; });
+    }
+
+    rc = insert_block(block);
+    vector<char>().swap(block.data);
+    vector<int>().swap(block.record_lines);
+
+    lock_guard<mutex> guard(lock);
+    inserted_block = i + 1;
+    cond.notify_all();
+  }
+
+  {
+    lock_guard<mutex> guard(lock);
+    stopped = true;
+    cond.notify_all();
+  }
+  for (thread &t : parsers) {
+    t.join();
+  }
+
+  LOG_INFO("load data done. table=%s, lines=%ld, records=%ld, rc=%s",
+           table_->name(), line_num_, record_num_, strrc(rc));
+  return rc;
+}
+
+void DataFileLoader::parse_block(Block &block) const
+{
+  const char *pos = block.begin;
+  while (pos < block.end) {
+    const char *line_end = static_cast<const char *>(memchr(pos, '\n', block.end - pos));
+    if (line_end == nullptr) {
+      line_end = block.end;
+    }
+    block.line_count++;
+
+    if (!is_blank(pos, line_end)) {
+      const size_t offset = block.data.size();
+      block.data.resize(offset + record_size_);
+      block.rc = parse_line(pos, line_end, block.data.data() + offset, block.errmsg);
+      if (OB_FAIL(block.rc)) {
+        block.data.resize(offset);
+        return;
+      }
+      block.record_lines.push_back(block.line_count);
+    }
+    pos = line_end + 1;
+  }
+}
+
+RC DataFileLoader::parse_line(const char *begin, const char *end, char *record, string &errmsg) const
+{
+  const char *pos = begin;
+  for (size_t i = 0; i < fields_.size(); i++) {
+    if (pos == nullptr) {
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+
+    const char *delimiter = static_cast<const char *>(memchr(pos, delimiter_, end - pos));
+    const char *value_end = delimiter != nullptr ? delimiter : end;
+
+    const FieldMeta *field = fields_[i];
+    char            *dest  = record + field->offset();
+    switch (field->type()) {
+      case AttrType::INTS: {
+        int value = 0;
+        if (!parse_number(pos, value_end, value)) {
+          errmsg = "need an integer but got '" + string(pos, value_end) + "' (field index:" + std::to_string(i) +
+                   ")";
+          return RC::SCHEMA_FIELD_TYPE_MISMATCH;
+        }
+        memcpy(dest, &value, sizeof(value));
+      } break;
+      case AttrType::FLOATS: {
+        float value = 0;
+        if (!parse_number(pos, value_end, value)) {
+          errmsg = "need a float number but got '" + string(pos, value_end) + "'(field index:" +
+                   std::to_string(i) + ")";
+          return RC::SCHEMA_FIELD_TYPE_MISMATCH;
+        }
+        memcpy(dest, &value, sizeof(value));
+      } break;
+      case AttrType::CHARS: {
+        // 超过字段长度的部分会被截断，剩下的部分已经是0
+        memcpy(dest, pos, min<size_t>(field->len(), value_end - pos));
+      } break;
+      default: {
+        errmsg = string("Unsupported field type to loading: ") + attr_type_to_string(field->type());
+        return RC::SCHEMA_FIELD_TYPE_MISMATCH;
+      }
+    }
+
+    pos = delimiter != nullptr ? delimiter + 1 : nullptr;
+  }
+  return RC::SUCCESS;
+}
+
+RC DataFileLoader::insert_block(Block &block)
+{
+  const int      record_num = static_cast<int>(block.record_lines.size());
+  vector<Record> records(record_num);
+  for (int i = 0; i < record_num; i++) {
+    records[i].set_data(block.data.data() + static_cast<size_t>(i) * record_size_, record_size_);
+  }
+
+  RC rc = table_->insert_records(records);
+  if (OB_SUCC(rc)) {
+    record_num_ += record_num;
+  } else {
+    // 批量插入失败时不会留下任何数据，逐条插入找到出错的行
+    LOG_WARN("failed to insert records in batch, retry one by one. table=%s, rc=%s", table_->name(), strrc(rc));
+    for (int i = 0; i < record_num; i++) {
+      rc = table_->insert_records(span<Record>(&records[i], 1));
+      if (OB_FAIL(rc)) {
+        line_num_ += block.record_lines[i];
+        set_line_error(line_num_, "insert failed.", rc);
+        return rc;
+      }
+      record_num_++;
+    }
+  }
+
+  line_num_ += block.line_count;
+  if (OB_FAIL(block.rc)) {
+    set_line_error(line_num_, block.errmsg, block.rc);
+    return block.rc;
+  }
+  return RC::SUCCESS;
+}
+
+void DataFileLoader::set_line_error(int64_t line, const string &errmsg, RC rc)
+{
+  error_line_    = line;
+  error_message_ = "Line:" + std::to_string(line) + " insert record failed:" + errmsg + ". error:" + strrc(rc);
+}
@@ -0,0 +1,85 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "common/rc.h"
+
+class Table;
+class FieldMeta;
+
+/**
+ * @brief 从文本文件中导入数据到表中
+ * @ingroup Executor
+ * @details 文件中每行是一条记录，字段之间使用分隔符分开，多出来的字段会被忽略。导入的过程是流水线式的：
+ * 1. 使用 mmap 映射整个文件，按照 block_size 切分成多个数据块，每个数据块都在换行符之后结束；
+ * 2. 多个解析线程并行地解析数据块。使用 memchr 查找换行符和分隔符(glibc 中是 SIMD 实现的)，
+ *    字段值直接转换后写到记录的内存中，不生成中间的 string 和 Value；
+ * 3. 当前线程按照数据块的顺序，使用 Table::insert_records 批量插入记录，索引也同时写入并记录日志，
+ *    导入过程中崩溃或者有其它会话并发写入时，索引与数据仍然是一致的。
+ *
+ * 已经解析但是还没有插入的数据块最多有 2 * thread_num 个，以限制内存的使用。
+ * 遇到错误时停止导入，出错的行之前的记录都会保留下来。
+ */
+class DataFileLoader
+{
+public:
+  static constexpr int DEFAULT_BLOCK_SIZE = 4 * 1024 * 1024;
+
+  /**
+   * @param thread_num 解析线程的个数，小于等于0时使用CPU的个数
+   * @param block_size 每个数据块的大小，实际的大小会延长到下一个换行符
+   */
+  DataFileLoader(Table *table, int thread_num = 0, char delimiter = '|', int block_size = DEFAULT_BLOCK_SIZE);
+
+  RC load(const char *file_name);
+
+  int64_t line_num() const { return line_num_; }      ///< 处理了多少行，出错时包含出错的行
+  int64_t record_num() const { return record_num_; }  ///< 导入了多少条记录
+  int64_t file_size() const { return file_size_; }
+
+  /// 出错的行号，不是某一行的错误时是0
+  int64_t error_line() const { return error_line_; }
+  const string &error_message() const { return error_message_; }
+
+private:
+  struct Block;
+
+  /// 解析一个数据块中的所有行，遇到错误时停止
+  void parse_block(Block &block) const;
+
+  /// 解析一行数据，写到 record 中。record 需要已经清零
+  RC parse_line(const char *begin, const char *end, char *record, string &errmsg) const;
+
+  /// 按照数据块的顺序插入记录。批量插入失败时逐条插入，找到出错的行
+  RC insert_block(Block &block);
+
+  void set_line_error(int64_t line, const string &errmsg, RC rc);
+
+private:
+  Table                    *table_       = nullptr;
+  int                       thread_num_  = 1;
+  char                      delimiter_   = '|';
+  int                       block_size_  = DEFAULT_BLOCK_SIZE;
+  int                       record_size_ = 0;
+  vector<const FieldMeta *> fields_;  ///< 需要导入的字段，不包含系统字段
+
+  int64_t line_num_   = 0;
+  int64_t record_num_ = 0;
+  int64_t file_size_  = 0;
+  int64_t error_line_ = 0;
+  string  error_message_;
+};
@@ -31,5 +31,13 @@ void SumState<T>::update(const T *values, int size)
 #endif
 }
 
+template <typename T>
+void SumState<T>::update(const T *values, const int *selection, int size)
+{
+  for (int i = 0; i < size; ++i) {
+    value += values[selection[i]];
+  }
+}
+
 template class SumState<int>;
 template class SumState<float>;
\ No newline at end of file
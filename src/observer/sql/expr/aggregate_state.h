@@ -15,4 +15,6 @@ public:
   SumState() : value(0) {}
   T    value;
   void update(const T *values, int size);
+  /// 只累加 selection 中指定位置的值
+  void update(const T *values, const int *selection, int size);
 };
\ No newline at end of file
@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/expr/expression.h"
 #include "sql/expr/tuple.h"
 #include "sql/expr/arithmetic_operator.hpp"
+#include "sql/expr/simd_kernel.h"
 
 using namespace std;
 
@@ -41,10 +42,19 @@ RC FieldExpr::get_column(Chunk &chunk, Column &column)
 {
   if (pos_ != -1) {
     column.reference(chunk.column(pos_));
-  } else {
-    column.reference(chunk.column(field().meta()->field_id()));
+    return RC::SUCCESS;
   }
-  return RC::SUCCESS;
+
+  // 表扫描输出的 chunk 中可能还有事务字段，不能直接把字段ID当作列的下标
+  const int field_id = field().meta()->field_id();
+  for (int i = 0; i < chunk.column_num(); i++) {
+    if (chunk.column_ids(i) == field_id) {
+      column.reference(chunk.column(i));
+      return RC::SUCCESS;
+    }
+  }
+  LOG_WARN("no such column in chunk. field=%s.%s", table_name(), field_name());
+  return RC::SCHEMA_FIELD_NOT_EXIST;
 }
 
 bool ValueExpr::equal(const Expression &other) const
@@ -247,35 +257,46 @@ RC ComparisonExpr::eval(Chunk &chunk, std::vector<uint8_t> &select)
     LOG_WARN("cannot compare columns with different types");
     return RC::INTERNAL;
   }
-  if (left_column.attr_type() == AttrType::INTS) {
-    rc = compare_column<int>(left_column, right_column, select);
-  } else if (left_column.attr_type() == AttrType::FLOATS) {
-    rc = compare_column<float>(left_column, right_column, select);
-  } else {
-    // TODO: support string compare
-    LOG_WARN("unsupported data type %d", left_column.attr_type());
-    return RC::INTERNAL;
-  }
+  rc = compare_column(left_column, right_column, select);
   return rc;
 }
 
-template <typename T>
 RC ComparisonExpr::compare_column(const Column &left, const Column &right, std::vector<uint8_t> &result) const
 {
-  RC rc = RC::SUCCESS;
-
-  bool left_const  = left.column_type() == Column::Type::CONSTANT_COLUMN;
-  bool right_const = right.column_type() == Column::Type::CONSTANT_COLUMN;
-  if (left_const && right_const) {
-    compare_result<T, true, true>((T *)left.data(), (T *)right.data(), left.count(), result, comp_);
-  } else if (left_const && !right_const) {
-    compare_result<T, true, false>((T *)left.data(), (T *)right.data(), right.count(), result, comp_);
-  } else if (!left_const && right_const) {
-    compare_result<T, false, true>((T *)left.data(), (T *)right.data(), left.count(), result, comp_);
-  } else {
-    compare_result<T, false, false>((T *)left.data(), (T *)right.data(), left.count(), result, comp_);
+  if (comp_ == LIKE || comp_ == NOT_LIKE || comp_ >= NO_OP) {
+    LOG_WARN("unsupported compare operator %d", comp_);
+    return RC::UNIMPLENMENT;
+  }
+
+  const bool left_const  = left.column_type() == Column::Type::CONSTANT_COLUMN;
+  const bool right_const = right.column_type() == Column::Type::CONSTANT_COLUMN;
+  const int  n           = left_const && right_const ? static_cast<int>(result.size())
+                           : left_const              ? right.count()
+                                                     : left.count();
+  switch (left.attr_type()) {
+    case AttrType::INTS:
+    case AttrType::DATES: {
+      SimdKernel::compare_int32(
+          comp_, (const int32_t *)left.data(), left_const, (const int32_t *)right.data(), right_const, n, result.data());
+    } break;
+    case AttrType::FLOATS: {
+      SimdKernel::compare_float(
+          comp_, (const float *)left.data(), left_const, (const float *)right.data(), right_const, n, result.data());
+    } break;
+    case AttrType::BOOLEANS: {
+      SimdKernel::compare_bool(
+          comp_, (const uint8_t *)left.data(), left_const, (const uint8_t *)right.data(), right_const, n, result.data());
+    } break;
+    case AttrType::CHARS: {
+      SimdKernel::compare_chars(comp_, left.data(), left.attr_len(), left_const, right.data(), right.attr_len(),
+          right_const, n, result.data());
+    } break;
+    default: {
+      LOG_WARN("unsupported data type %d", left.attr_type());
+      return RC::INTERNAL;
+    }
   }
-  return rc;
+  return RC::SUCCESS;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -310,6 +331,42 @@ RC ConjunctionExpr::get_value(const Tuple &tuple, Value &value) const
   return rc;
 }
 
+RC ConjunctionExpr::eval(Chunk &chunk, std::vector<uint8_t> &select)
+{
+  RC rc = RC::SUCCESS;
+  if (conjunction_type_ == Type::AND) {
+    for (unique_ptr<Expression> &expr : children_) {
+      rc = expr->eval(chunk, select);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to eval child expression. rc=%s", strrc(rc));
+        return rc;
+      }
+    }
+    return rc;
+  }
+
+  if (children_.empty()) {
+    std::fill(select.begin(), select.end(), 0);
+    return rc;
+  }
+
+  // OR: 每个子表达式单独计算，结果按位或起来
+  std::vector<uint8_t> any_selected(select.size(), 0);
+  std::vector<uint8_t> child_select;
+  for (unique_ptr<Expression> &expr : children_) {
+    child_select.assign(select.size(), 1);
+    rc = expr->eval(chunk, child_select);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to eval child expression. rc=%s", strrc(rc));
+      return rc;
+    }
+    SimdKernel::mask_or(any_selected.data(), child_select.data(), static_cast<int>(select.size()));
+  }
+
+  SimdKernel::mask_and(select.data(), any_selected.data(), static_cast<int>(select.size()));
+  return rc;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 ArithmeticExpr::ArithmeticExpr(ArithmeticExpr::Type type, Expression *left, Expression *right)
@@ -417,47 +474,37 @@ RC ArithmeticExpr::execute_calc(
     const Column &left, const Column &right, Column &result, Type type, AttrType attr_type) const
 {
   RC rc = RC::SUCCESS;
+
+  SimdKernel::ArithType kernel_type = SimdKernel::ArithType::ADD;
   switch (type) {
-    case Type::ADD: {
-      if (attr_type == AttrType::INTS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, int, AddOperator>(
-            (int *)left.data(), (int *)right.data(), (int *)result.data(), result.capacity());
-      } else if (attr_type == AttrType::FLOATS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, float, AddOperator>(
-            (float *)left.data(), (float *)right.data(), (float *)result.data(), result.capacity());
-      } else {
-        rc = RC::UNIMPLENMENT;
-      }
-    } break;
+    case Type::ADD: kernel_type = SimdKernel::ArithType::ADD; break;
+    case Type::SUB: kernel_type = SimdKernel::ArithType::SUB; break;
+    case Type::MUL: kernel_type = SimdKernel::ArithType::MUL; break;
+    case Type::DIV: kernel_type = SimdKernel::ArithType::DIV; break;
+    default: break;
+  }
+
+  switch (type) {
+    case Type::ADD:
     case Type::SUB:
+    case Type::MUL: {
       if (attr_type == AttrType::INTS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, int, SubtractOperator>(
-            (int *)left.data(), (int *)right.data(), (int *)result.data(), result.capacity());
-      } else if (attr_type == AttrType::FLOATS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, float, SubtractOperator>(
-            (float *)left.data(), (float *)right.data(), (float *)result.data(), result.capacity());
-      } else {
-        rc = RC::UNIMPLENMENT;
-      }
-      break;
-    case Type::MUL:
-      if (attr_type == AttrType::INTS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, int, MultiplyOperator>(
-            (int *)left.data(), (int *)right.data(), (int *)result.data(), result.capacity());
+        SimdKernel::arith_int32(kernel_type, (const int32_t *)left.data(), LEFT_CONSTANT,
+            (const int32_t *)right.data(), RIGHT_CONSTANT, result.capacity(), (int32_t *)result.data());
       } else if (attr_type == AttrType::FLOATS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, float, MultiplyOperator>(
-            (float *)left.data(), (float *)right.data(), (float *)result.data(), result.capacity());
+        SimdKernel::arith_float(kernel_type, (const float *)left.data(), LEFT_CONSTANT, (const float *)right.data(),
+            RIGHT_CONSTANT, result.capacity(), (float *)result.data());
       } else {
         rc = RC::UNIMPLENMENT;
       }
-      break;
+    } break;
     case Type::DIV:
       if (attr_type == AttrType::INTS) {
         binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, int, DivideOperator>(
             (int *)left.data(), (int *)right.data(), (int *)result.data(), result.capacity());
       } else if (attr_type == AttrType::FLOATS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, float, DivideOperator>(
-            (float *)left.data(), (float *)right.data(), (float *)result.data(), result.capacity());
+        SimdKernel::arith_float(kernel_type, (const float *)left.data(), LEFT_CONSTANT, (const float *)right.data(),
+            RIGHT_CONSTANT, result.capacity(), (float *)result.data());
       } else {
         rc = RC::UNIMPLENMENT;
       }
@@ -306,7 +306,7 @@ public:
    */
   RC compare_value(const Value &left, const Value &right, bool &value) const;
 
-  template <typename T>
+  /// 使用 SimdKernel 按列比较，支持 INTS/DATES/FLOATS/BOOLEANS/CHARS，不支持 LIKE
   RC compare_column(const Column &left, const Column &right, std::vector<uint8_t> &result) const;
 
 private:
@@ -338,6 +338,12 @@ public:
   AttrType value_type() const override { return AttrType::BOOLEANS; }
   RC       get_value(const Tuple &tuple, Value &value) const override;
 
+  /**
+   * @brief 根据所有子表达式的 `select` 结果计算联结后的 `select`
+   * @details 与 ComparisonExpr::eval 一样，结果会与 select 中原有的值做与运算
+   */
+  RC eval(Chunk &chunk, std::vector<uint8_t> &select) override;
+
   Type conjunction_type() const { return conjunction_type_; }
 
   std::vector<std::unique_ptr<Expression>> &children() { return children_; }
@@ -0,0 +1,132 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include <string.h>
+
+#include "sql/expr/join_hash_table.h"
+#include "common/lang/string_view.h"
+#include "common/lang/functional.h"
+
+namespace {
+
+/// murmurhash3 的 finalizer，让低位也能充分混合，因为槽位是用低位定位的
+uint64_t mix(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+}  // namespace
+
+void JoinHashTable::build()
+{
+  size_t capacity = 16;
+  while (capacity < hashes_.size() * 2) {
+    capacity <<= 1;
+  }
+
+  mask_ = capacity - 1;
+  slots_.assign(capacity, Slot());
+  for (size_t row = 0; row < hashes_.size(); row++) {
+    const uint64_t hash = hashes_[row];
+    size_t         pos  = hash & mask_;
+    while (slots_[pos].row != -1) {
+      pos = (pos + 1) & mask_;
+    }
+    slots_[pos].hash = hash;
+    slots_[pos].row  = static_cast<int32_t>(row);
+  }
+}
+
+void JoinHashTable::clear()
+{
+  hashes_.clear();
+  slots_.clear();
+  mask_ = 0;
+}
+
+int JoinHashTable::next(uint64_t hash, size_t &pos) const
+{
+  if (slots_.empty()) {
+    return -1;
+  }
+
+  // 槽位数至少是行数的两倍，一定能遇到空槽位
+  while (slots_[pos].row != -1) {
+    const Slot &slot = slots_[pos];
+    pos              = (pos + 1) & mask_;
+    if (slot.hash == hash) {
+      return slot.row;
+    }
+  }
+  return -1;
+}
+
+bool JoinHashTable::support(AttrType type)
+{
+  switch (type) {
+    case AttrType::CHARS:
+    case AttrType::INTS:
+    case AttrType::FLOATS:
+    case AttrType::DATES: return true;
+    default: return false;
+  }
+}
+
+uint64_t JoinHashTable::hash(AttrType type, const char *data, int len)
+{
+  switch (type) {
+    case AttrType::CHARS: {
+      return mix(std::hash<string_view>()(string_view(data, strnlen(data, len))));
+    }
+    case AttrType::FLOATS: {
+      float value = *reinterpret_cast<const float *>(data);
+      if (value == 0) {
+        value = 0;  // 0.0 和 -0.0 相等，哈希值也要相同
+      }
+      uint32_t bits = 0;
+      memcpy(&bits, &value, sizeof(bits));
+      return mix(bits);
+    }
+    default: {
+      return mix(static_cast<uint32_t>(*reinterpret_cast<const int32_t *>(data)));
+    }
+  }
+}
+
+uint64_t JoinHashTable::combine(uint64_t seed, uint64_t hash)
+{
+  return seed ^ (hash + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+bool JoinHashTable::equal(AttrType type, const char *left, int left_len, const char *right, int right_len)
+{
+  switch (type) {
+    case AttrType::CHARS: {
+      const size_t left_size  = strnlen(left, left_len);
+      const size_t right_size = strnlen(right, right_len);
+      return left_size == right_size && 0 == memcmp(left, right, left_size);
+    }
+    case AttrType::FLOATS: {
+      return *reinterpret_cast<const float *>(left) == *reinterpret_cast<const float *>(right);
+    }
+    default: {
+      return *reinterpret_cast<const int32_t *>(left) == *reinterpret_cast<const int32_t *>(right);
+    }
+  }
+}
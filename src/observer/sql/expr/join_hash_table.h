@@ -0,0 +1,93 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+
+#include "common/lang/vector.h"
+#include "sql/parser/value.h"
+
+/**
+ * @brief 用于 hash join 的哈希表，不支持并发访问
+ * @details 使用开放寻址(线性探测)的方式组织，每个槽位只保存连接键的哈希值和行号，
+ * 探测时先比较哈希值，连续的槽位可以很好地利用CPU缓存。
+ * 行数据和连接键由使用者自己保存，哈希值相同时由使用者比较连接键是否真的相等。
+ * 使用方法：先调用 add 加入所有行的哈希值，再调用 build 建立哈希表，之后就可以探测了。
+ */
+class JoinHashTable
+{
+public:
+  JoinHashTable()  = default;
+  ~JoinHashTable() = default;
+
+  /**
+   * @brief 加入一行的哈希值，行号就是加入的顺序(从0开始)
+   */
+  void add(uint64_t hash) { hashes_.push_back(hash); }
+
+  /**
+   * @brief 使用所有已经加入的行建立哈希表。槽位数是不小于两倍行数的2的幂
+   */
+  void build();
+
+  /**
+   * @brief 清空所有的数据
+   */
+  void clear();
+
+  /// 加入的行数
+  int size() const { return static_cast<int>(hashes_.size()); }
+
+  /// 开始探测哈希值为 hash 的行，返回的位置作为 next 的参数
+  size_t begin(uint64_t hash) const { return hash & mask_; }
+
+  /**
+   * @brief 找到下一个哈希值等于 hash 的行
+   * @param pos 探测的位置，会被修改为下一次探测的位置
+   * @return 行号，没有更多的行时返回 -1
+   */
+  int next(uint64_t hash, size_t &pos) const;
+
+public:
+  /// 判断某个类型是否可以作为连接键
+  static bool support(AttrType type);
+
+  /**
+   * @brief 计算一个值的哈希值
+   * @details data 是值在 Value 或者 Column 中的内存表示。字符串会忽略结尾的'\0'，
+   * 所以不同长度的字符串字段也可以作为连接键。
+   */
+  static uint64_t hash(AttrType type, const char *data, int len);
+  static uint64_t hash(const Value &value) { return hash(value.attr_type(), value.data(), value.length()); }
+
+  /// 把多个连接键的哈希值组合在一起
+  static uint64_t combine(uint64_t seed, uint64_t hash);
+
+  /// 判断两个同类型的值是否相等，内存表示与 hash 的参数一致
+  static bool equal(AttrType type, const char *left, int left_len, const char *right, int right_len);
+  static bool equal(const Value &left, const Value &right)
+  {
+    return equal(left.attr_type(), left.data(), left.length(), right.data(), right.length());
+  }
+
+private:
+  struct Slot
+  {
+    uint64_t hash = 0;
+    int32_t  row  = -1;  ///< -1 表示空槽位
+  };
+
+  vector<uint64_t> hashes_;  ///< 每一行的哈希值
+  vector<Slot>     slots_;
+  uint64_t         mask_ = 0;
+};
@@ -0,0 +1,754 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include <string.h>
+#include <type_traits>
+
+#include "sql/expr/simd_kernel.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/comparator.h"
+
+#if defined(SIMD_RUNTIME_DISPATCH)
+#include <immintrin.h>
+#endif
+
+using ArithType = SimdKernel::ArithType;
+
+namespace {
+
+/// 把比较运算符转换成模板参数，循环中就不需要再判断运算符
+template <typename F>
+void dispatch_comp_op(CompOp op, F &&func)
+{
+  switch (op) {
+    case EQUAL_TO: func(std::integral_constant<CompOp, EQUAL_TO>()); break;
+    case NOT_EQUAL: func(std::integral_constant<CompOp, NOT_EQUAL>()); break;
+    case LESS_THAN: func(std::integral_constant<CompOp, LESS_THAN>()); break;
+    case LESS_EQUAL: func(std::integral_constant<CompOp, LESS_EQUAL>()); break;
+    case GREAT_THAN: func(std::integral_constant<CompOp, GREAT_THAN>()); break;
+    case GREAT_EQUAL: func(std::integral_constant<CompOp, GREAT_EQUAL>()); break;
+    default: break;
+  }
+}
+
+template <typename F>
+void dispatch_arith_type(ArithType type, F &&func)
+{
+  switch (type) {
+    case ArithType::ADD: func(std::integral_constant<ArithType, ArithType::ADD>()); break;
+    case ArithType::SUB: func(std::integral_constant<ArithType, ArithType::SUB>()); break;
+    case ArithType::MUL: func(std::integral_constant<ArithType, ArithType::MUL>()); break;
+    case ArithType::DIV: func(std::integral_constant<ArithType, ArithType::DIV>()); break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 标量实现。SIMD 实现也用它们处理最后不足一个向量的数据，所以都带有起始下标 from
+
+template <CompOp OP, typename T>
+inline bool compare_value(const T &left, const T &right)
+{
+  if constexpr (OP == EQUAL_TO) {
+    return left == right;
+  } else if constexpr (OP == NOT_EQUAL) {
+    return left != right;
+  } else if constexpr (OP == LESS_THAN) {
+    return left < right;
+  } else if constexpr (OP == LESS_EQUAL) {
+    return left <= right;
+  } else if constexpr (OP == GREAT_THAN) {
+    return left > right;
+  } else {
+    return left >= right;
+  }
+}
+
+template <CompOp OP, typename T>
+void compare_scalar(
+    const T *left, bool left_const, const T *right, bool right_const, int from, int n, uint8_t *result)
+{
+  for (int i = from; i < n; i++) {
+    const T &l = left[left_const ? 0 : i];
+    const T &r = right[right_const ? 0 : i];
+    result[i] &= compare_value<OP>(l, r) ? 1 : 0;
+  }
+}
+
+template <CompOp OP>
+void compare_bool_scalar(
+    const uint8_t *left, bool left_const, const uint8_t *right, bool right_const, int from, int n, uint8_t *result)
+{
+  for (int i = from; i < n; i++) {
+    const uint8_t l = left[left_const ? 0 : i] != 0;
+    const uint8_t r = right[right_const ? 0 : i] != 0;
+    result[i] &= compare_value<OP>(l, r) ? 1 : 0;
+  }
+}
+
+/// 两个字符串前 min(left_len, right_len) 个字节中第一个不同的位置是 diff_pos(-1表示相同)，返回与
+/// common::compare_string 相同的比较结果
+inline int chars_compare_result(const char *left, int left_len, const char *right, int right_len, int diff_pos)
+{
+  if (diff_pos >= 0) {
+    return static_cast<int>(static_cast<unsigned char>(left[diff_pos])) -
+           static_cast<int>(static_cast<unsigned char>(right[diff_pos]));
+  }
+  if (left_len > right_len) {
+    return left[right_len];
+  }
+  if (right_len > left_len) {
+    return 0 - right[left_len];
+  }
+  return 0;
+}
+
+inline int compare_chars_value(const char *left, int left_len, const char *right, int right_len)
+{
+  const int left_str_len  = strnlen(left, left_len);
+  const int right_str_len = strnlen(right, right_len);
+  return common::compare_string((void *)left, left_str_len, (void *)right, right_str_len);
+}
+
+template <CompOp OP>
+void compare_chars_scalar(const char *left, int left_len, bool left_const, const char *right, int right_len,
+    bool right_const, int from, int n, uint8_t *result)
+{
+  for (int i = from; i < n; i++) {
+    const char *l = left_const ? left : left + static_cast<size_t>(i) * left_len;
+    const char *r = right_const ? right : right + static_cast<size_t>(i) * right_len;
+    result[i] &= compare_value<OP>(compare_chars_value(l, left_len, r, right_len), 0) ? 1 : 0;
+  }
+}
+
+void mask_and_scalar(uint8_t *dst, const uint8_t *src, int from, int n)
+{
+  for (int i = from; i < n; i++) {
+    dst[i] &= src[i];
+  }
+}
+
+void mask_or_scalar(uint8_t *dst, const uint8_t *src, int from, int n)
+{
+  for (int i = from; i < n; i++) {
+    dst[i] |= src[i];
+  }
+}
+
+template <ArithType TYPE, typename T>
+inline T arith_value(const T &left, const T &right)
+{
+  if constexpr (TYPE == ArithType::ADD) {
+    return left + right;
+  } else if constexpr (TYPE == ArithType::SUB) {
+    return left - right;
+  } else if constexpr (TYPE == ArithType::MUL) {
+    return left * right;
+  } else {
+    return left / right;
+  }
+}
+
+template <ArithType TYPE, typename T>
+void arith_scalar(const T *left, bool left_const, const T *right, bool right_const, int from, int n, T *result)
+{
+  for (int i = from; i < n; i++) {
+    result[i] = arith_value<TYPE>(left[left_const ? 0 : i], right[right_const ? 0 : i]);
+  }
+}
+
+#if defined(SIMD_RUNTIME_DISPATCH)
+
+////////////////////////////////////////////////////////////////////////////////
+// AVX2
+
+template <CompOp OP>
+SIMD_TARGET_AVX2 inline __m256i avx2_cmp_epi32(__m256i left, __m256i right)
+{
+  const __m256i ones = _mm256_set1_epi32(-1);
+  if constexpr (OP == EQUAL_TO) {
+    return _mm256_cmpeq_epi32(left, right);
+  } else if constexpr (OP == NOT_EQUAL) {
+    return _mm256_xor_si256(_mm256_cmpeq_epi32(left, right), ones);
+  } else if constexpr (OP == LESS_THAN) {
+    return _mm256_cmpgt_epi32(right, left);
+  } else if constexpr (OP == LESS_EQUAL) {
+    return _mm256_xor_si256(_mm256_cmpgt_epi32(left, right), ones);
+  } else if constexpr (OP == GREAT_THAN) {
+    return _mm256_cmpgt_epi32(left, right);
+  } else {
+    return _mm256_xor_si256(_mm256_cmpgt_epi32(right, left), ones);
+  }
+}
+
+/// 值只有0和1，按有符号数比较也没有问题
+template <CompOp OP>
+SIMD_TARGET_AVX2 inline __m256i avx2_cmp_epi8(__m256i left, __m256i right)
+{
+  const __m256i ones = _mm256_set1_epi8(-1);
+  if constexpr (OP == EQUAL_TO) {
+    return _mm256_cmpeq_epi8(left, right);
+  } else if constexpr (OP == NOT_EQUAL) {
+    return _mm256_xor_si256(_mm256_cmpeq_epi8(left, right), ones);
+  } else if constexpr (OP == LESS_THAN) {
+    return _mm256_cmpgt_epi8(right, left);
+  } else if constexpr (OP == LESS_EQUAL) {
+    return _mm256_xor_si256(_mm256_cmpgt_epi8(left, right), ones);
+  } else if constexpr (OP == GREAT_THAN) {
+    return _mm256_cmpgt_epi8(left, right);
+  } else {
+    return _mm256_xor_si256(_mm256_cmpgt_epi8(right, left), ones);
+  }
+}
+
+/// NaN 与任何值比较的结果与标量的比较运算相同，只有不等于是 true
+template <CompOp OP>
+constexpr int float_cmp_predicate()
+{
+  if constexpr (OP == EQUAL_TO) {
+    return _CMP_EQ_OQ;
+  } else if constexpr (OP == NOT_EQUAL) {
+    return _CMP_NEQ_UQ;
+  } else if constexpr (OP == LESS_THAN) {
+    return _CMP_LT_OQ;
+  } else if constexpr (OP == LESS_EQUAL) {
+    return _CMP_LE_OQ;
+  } else if constexpr (OP == GREAT_THAN) {
+    return _CMP_GT_OQ;
+  } else {
+    return _CMP_GE_OQ;
+  }
+}
+
+/// 把8个32位的比较结果(0或-1)转换成8个字节的0或1，与 result 做与运算
+SIMD_TARGET_AVX2 inline void avx2_and_mask8(__m256i cmp, uint8_t *result)
+{
+  const __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(cmp), _mm256_extracti128_si256(cmp, 1));
+  const __m128i bytes = _mm_packs_epi16(words, words);
+  const uint64_t bits  = static_cast<uint64_t>(_mm_cvtsi128_si64(bytes)) & 0x0101010101010101ULL;
+
+  uint64_t old = 0;
+  memcpy(&old, result, sizeof(old));
+  old &= bits;
+  memcpy(result, &old, sizeof(old));
+}
+
+template <CompOp OP>
+SIMD_TARGET_AVX2 void compare_int32_avx2(
+    const int32_t *left, bool left_const, const int32_t *right, bool right_const, int n, uint8_t *result)
+{
+  const __m256i left_value  = _mm256_set1_epi32(left[0]);
+  const __m256i right_value = _mm256_set1_epi32(right[0]);
+
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i l = left_const ? left_value : _mm256_loadu_si256((const __m256i *)(left + i));
+    const __m256i r = right_const ? right_value : _mm256_loadu_si256((const __m256i *)(right + i));
+    avx2_and_mask8(avx2_cmp_epi32<OP>(l, r), result + i);
+  }
+  compare_scalar<OP>(left, left_const, right, right_const, i, n, result);
+}
+
+template <CompOp OP>
+SIMD_TARGET_AVX2 void compare_float_avx2(
+    const float *left, bool left_const, const float *right, bool right_const, int n, uint8_t *result)
+{
+  const __m256 left_value  = _mm256_set1_ps(left[0]);
+  const __m256 right_value = _mm256_set1_ps(right[0]);
+
+  constexpr int predicate = float_cmp_predicate<OP>();
+
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256 l = left_const ? left_value : _mm256_loadu_ps(left + i);
+    const __m256 r = right_const ? right_value : _mm256_loadu_ps(right + i);
+    avx2_and_mask8(_mm256_castps_si256(_mm256_cmp_ps(l, r, predicate)), result + i);
+  }
+  compare_scalar<OP>(left, left_const, right, right_const, i, n, result);
+}
+
+template <CompOp OP>
+SIMD_TARGET_AVX2 void compare_bool_avx2(
+    const uint8_t *left, bool left_const, const uint8_t *right, bool right_const, int n, uint8_t *result)
+{
+  const __m256i one         = _mm256_set1_epi8(1);
+  const __m256i left_value  = _mm256_set1_epi8(left[0] != 0);
+  const __m256i right_value = _mm256_set1_epi8(right[0] != 0);
+
+  int i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i l   = left_const ? left_value : _mm256_min_epu8(_mm256_loadu_si256((const __m256i *)(left + i)), one);
+    const __m256i r   = right_const ? right_value : _mm256_min_epu8(_mm256_loadu_si256((const __m256i *)(right + i)), one);
+    const __m256i cmp = _mm256_and_si256(avx2_cmp_epi8<OP>(l, r), one);
+    const __m256i old = _mm256_loadu_si256((const __m256i *)(result + i));
+    _mm256_storeu_si256((__m256i *)(result + i), _mm256_and_si256(old, cmp));
+  }
+  compare_bool_scalar<OP>(left, left_const, right, right_const, i, n, result);
+}
+
+/// 字符串中 '\0' 以及超出长度的位置
+SIMD_TARGET_AVX2 inline uint32_t avx2_chars_end_mask(__m256i value, int len)
+{
+  uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(value, _mm256_setzero_si256())));
+  if (len < 32) {
+    mask |= ~((1U << len) - 1);
+  }
+  return mask;
+}
+
+/// 比较最长32个字节的字符串，left/right 之后必须可以读取32个字节
+SIMD_TARGET_AVX2 inline int avx2_compare_chars(const char *left, int left_len, const char *right, int right_len)
+{
+  const __m256i l = _mm256_loadu_si256((const __m256i *)left);
+  const __m256i r = _mm256_loadu_si256((const __m256i *)right);
+
+  const uint32_t left_end  = avx2_chars_end_mask(l, left_len);
+  const uint32_t right_end = avx2_chars_end_mask(r, right_len);
+  const int      left_str_len  = left_end != 0 ? __builtin_ctz(left_end) : 32;
+  const int      right_str_len = right_end != 0 ? __builtin_ctz(right_end) : 32;
+  const int      len           = min(left_str_len, right_str_len);
+
+  uint32_t diff = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(l, r)));
+  if (len < 32) {
+    diff &= (1U << len) - 1;
+  }
+  const int diff_pos = diff != 0 ? __builtin_ctz(diff) : -1;
+  return chars_compare_result(left, left_str_len, right, right_str_len, diff_pos);
+}
+
+/**
+ * @brief 每次比较一行
+ * @details 字符串长度不超过32个字节时使用。常量复制到补0的缓存中；
+ * 每一行后面不足32个字节可以读取时，也复制到缓存中再比较
+ */
+template <CompOp OP>
+SIMD_TARGET_AVX2 void compare_chars_avx2(const char *left, int left_len, bool left_const, const char *right,
+    int right_len, bool right_const, int n, uint8_t *result)
+{
+  alignas(32) char left_buffer[32]  = {0};
+  alignas(32) char right_buffer[32] = {0};
+  const char      *left_end         = left + static_cast<size_t>(left_const ? 1 : n) * left_len;
+  const char      *right_end        = right + static_cast<size_t>(right_const ? 1 : n) * right_len;
+  if (left_const) {
+    memcpy(left_buffer, left, left_len);
+  }
+  if (right_const) {
+    memcpy(right_buffer, right, right_len);
+  }
+
+  for (int i = 0; i < n; i++) {
+    const char *l = left_const ? left_buffer : left + static_cast<size_t>(i) * left_len;
+    const char *r = right_const ? right_buffer : right + static_cast<size_t>(i) * right_len;
+    if (!left_const && l + 32 > left_end) {
+      memcpy(left_buffer, l, left_len);
+      l = left_buffer;
+    }
+    if (!right_const && r + 32 > right_end) {
+      memcpy(right_buffer, r, right_len);
+      r = right_buffer;
+    }
+    result[i] &= compare_value<OP>(avx2_compare_chars(l, left_len, r, right_len), 0) ? 1 : 0;
+  }
+}
+
+SIMD_TARGET_AVX2 void mask_and_avx2(uint8_t *dst, const uint8_t *src, int n)
+{
+  int i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+    const __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+    _mm256_storeu_si256((__m256i *)(dst + i), _mm256_and_si256(d, s));
+  }
+  mask_and_scalar(dst, src, i, n);
+}
+
+SIMD_TARGET_AVX2 void mask_or_avx2(uint8_t *dst, const uint8_t *src, int n)
+{
+  int i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+    const __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+    _mm256_storeu_si256((__m256i *)(dst + i), _mm256_or_si256(d, s));
+  }
+  mask_or_scalar(dst, src, i, n);
+}
+
+template <ArithType TYPE>
+SIMD_TARGET_AVX2 void arith_int32_avx2(
+    const int32_t *left, bool left_const, const int32_t *right, bool right_const, int n, int32_t *result)
+{
+  const __m256i left_value  = _mm256_set1_epi32(left[0]);
+  const __m256i right_value = _mm256_set1_epi32(right[0]);
+
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i l = left_const ? left_value : _mm256_loadu_si256((const __m256i *)(left + i));
+    const __m256i r = right_const ? right_value : _mm256_loadu_si256((const __m256i *)(right + i));
+    __m256i       v;
+    if constexpr (TYPE == ArithType::ADD) {
+      v = _mm256_add_epi32(l, r);
+    } else if constexpr (TYPE == ArithType::SUB) {
+      v = _mm256_sub_epi32(l, r);
+    } else {
+      v = _mm256_mullo_epi32(l, r);
+    }
+    _mm256_storeu_si256((__m256i *)(result + i), v);
+  }
+  arith_scalar<TYPE>(left, left_const, right, right_const, i, n, result);
+}
+
+template <ArithType TYPE>
+SIMD_TARGET_AVX2 void arith_float_avx2(
+    const float *left, bool left_const, const float *right, bool right_const, int n, float *result)
+{
+  const __m256 left_value  = _mm256_set1_ps(left[0]);
+  const __m256 right_value = _mm256_set1_ps(right[0]);
+
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256 l = left_const ? left_value : _mm256_loadu_ps(left + i);
+    const __m256 r = right_const ? right_value : _mm256_loadu_ps(right + i);
+    __m256       v;
+    if constexpr (TYPE == ArithType::ADD) {
+      v = _mm256_add_ps(l, r);
+    } else if constexpr (TYPE == ArithType::SUB) {
+      v = _mm256_sub_ps(l, r);
+    } else if constexpr (TYPE == ArithType::MUL) {
+      v = _mm256_mul_ps(l, r);
+    } else {
+      v = _mm256_div_ps(l, r);
+    }
+    _mm256_storeu_ps(result + i, v);
+  }
+  arith_scalar<TYPE>(left, left_const, right, right_const, i, n, result);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// AVX-512。比较结果是掩码寄存器，直接用 BW/VL 的掩码指令转换成字节
+
+template <CompOp OP>
+constexpr int int_cmp_predicate()
+{
+  if constexpr (OP == EQUAL_TO) {
+    return _MM_CMPINT_EQ;
+  } else if constexpr (OP == NOT_EQUAL) {
+    return _MM_CMPINT_NE;
+  } else if constexpr (OP == LESS_THAN) {
+    return _MM_CMPINT_LT;
+  } else if constexpr (OP == LESS_EQUAL) {
+    return _MM_CMPINT_LE;
+  } else if constexpr (OP == GREAT_THAN) {
+    return _MM_CMPINT_NLE;
+  } else {
+    return _MM_CMPINT_NLT;
+  }
+}
+
+SIMD_TARGET_AVX512 inline void avx512_and_mask16(__mmask16 mask, uint8_t *result)
+{
+  const __m128i bits = _mm_maskz_mov_epi8(mask, _mm_set1_epi8(1));
+  const __m128i old  = _mm_loadu_si128((const __m128i *)result);
+  _mm_storeu_si128((__m128i *)result, _mm_and_si128(old, bits));
+}
+
+template <CompOp OP>
+SIMD_TARGET_AVX512 void compare_int32_avx512(
+    const int32_t *left, bool left_const, const int32_t *right, bool right_const, int n, uint8_t *result)
+{
+  const __m512i left_value  = _mm512_set1_epi32(left[0]);
+  const __m512i right_value = _mm512_set1_epi32(right[0]);
+
+  constexpr int predicate = int_cmp_predicate<OP>();
+
+  int i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m512i l = left_const ? left_value : _mm512_loadu_si512(left + i);
+    const __m512i r = right_const ? right_value : _mm512_loadu_si512(right + i);
+    avx512_and_mask16(_mm512_cmp_epi32_mask(l, r, predicate), result + i);
+  }
+  compare_scalar<OP>(left, left_const, right, right_const, i, n, result);
+}
+
+template <CompOp OP>
+SIMD_TARGET_AVX512 void compare_float_avx512(
+    const float *left, bool left_const, const float *right, bool right_const, int n, uint8_t *result)
+{
+  const __m512 left_value  = _mm512_set1_ps(left[0]);
+  const __m512 right_value = _mm512_set1_ps(right[0]);
+
+  constexpr int predicate = float_cmp_predicate<OP>();
+
+  int i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m512 l = left_const ? left_value : _mm512_loadu_ps(left + i);
+    const __m512 r = right_const ? right_value : _mm512_loadu_ps(right + i);
+    avx512_and_mask16(_mm512_cmp_ps_mask(l, r, predicate), result + i);
+  }
+  compare_scalar<OP>(left, left_const, right, right_const, i, n, result);
+}
+
+template <CompOp OP>
+SIMD_TARGET_AVX512 void compare_bool_avx512(
+    const uint8_t *left, bool left_const, const uint8_t *right, bool right_const, int n, uint8_t *result)
+{
+  const __m512i one         = _mm512_set1_epi8(1);
+  const __m512i left_value  = _mm512_set1_epi8(left[0] != 0);
+  const __m512i right_value = _mm512_set1_epi8(right[0] != 0);
+
+  constexpr int predicate = int_cmp_predicate<OP>();
+
+  int i = 0;
+  for (; i + 64 <= n; i += 64) {
+    const __m512i l    = left_const ? left_value : _mm512_min_epu8(_mm512_loadu_si512(left + i), one);
+    const __m512i r    = right_const ? right_value : _mm512_min_epu8(_mm512_loadu_si512(right + i), one);
+    const __m512i bits = _mm512_maskz_mov_epi8(_mm512_cmp_epu8_mask(l, r, predicate), one);
+    const __m512i old  = _mm512_loadu_si512(result + i);
+    _mm512_storeu_si512(result + i, _mm512_and_si512(old, bits));
+  }
+  compare_bool_scalar<OP>(left, left_const, right, right_const, i, n, result);
+}
+
+/// 比较最长64个字节的字符串。用带掩码的读取，不会访问超出长度的内存，超出长度的字节都是0
+SIMD_TARGET_AVX512 inline int avx512_compare_chars(const char *left, int left_len, const char *right, int right_len)
+{
+  const __mmask64 left_load  = left_len < 64 ? ((1ULL << left_len) - 1) : ~0ULL;
+  const __mmask64 right_load = right_len < 64 ? ((1ULL << right_len) - 1) : ~0ULL;
+  const __m512i   l          = _mm512_maskz_loadu_epi8(left_load, left);
+  const __m512i   r          = _mm512_maskz_loadu_epi8(right_load, right);
+
+  const __m512i  zero          = _mm512_setzero_si512();
+  const uint64_t left_end      = _mm512_cmpeq_epi8_mask(l, zero);
+  const uint64_t right_end     = _mm512_cmpeq_epi8_mask(r, zero);
+  const int      left_str_len  = left_end != 0 ? __builtin_ctzll(left_end) : 64;
+  const int      right_str_len = right_end != 0 ? __builtin_ctzll(right_end) : 64;
+  const int      len           = min(left_str_len, right_str_len);
+
+  uint64_t diff = _mm512_cmpneq_epi8_mask(l, r);
+  if (len < 64) {
+    diff &= (1ULL << len) - 1;
+  }
+  const int diff_pos = diff != 0 ? __builtin_ctzll(diff) : -1;
+  return chars_compare_result(left, left_str_len, right, right_str_len, diff_pos);
+}
+
+template <CompOp OP>
+SIMD_TARGET_AVX512 void compare_chars_avx512(const char *left, int left_len, bool left_const, const char *right,
+    int right_len, bool right_const, int n, uint8_t *result)
+{
+  for (int i = 0; i < n; i++) {
+    const char *l = left_const ? left : left + static_cast<size_t>(i) * left_len;
+    const char *r = right_const ? right : right + static_cast<size_t>(i) * right_len;
+    result[i] &= compare_value<OP>(avx512_compare_chars(l, left_len, r, right_len), 0) ? 1 : 0;
+  }
+}
+
+SIMD_TARGET_AVX512 void mask_and_avx512(uint8_t *dst, const uint8_t *src, int n)
+{
+  int i = 0;
+  for (; i + 64 <= n; i += 64) {
+    _mm512_storeu_si512(dst + i, _mm512_and_si512(_mm512_loadu_si512(dst + i), _mm512_loadu_si512(src + i)));
+  }
+  mask_and_scalar(dst, src, i, n);
+}
+
+SIMD_TARGET_AVX512 void mask_or_avx512(uint8_t *dst, const uint8_t *src, int n)
+{
+  int i = 0;
+  for (; i + 64 <= n; i += 64) {
+    _mm512_storeu_si512(dst + i, _mm512_or_si512(_mm512_loadu_si512(dst + i), _mm512_loadu_si512(src + i)));
+  }
+  mask_or_scalar(dst, src, i, n);
+}
+
+template <ArithType TYPE>
+SIMD_TARGET_AVX512 void arith_int32_avx512(
+    const int32_t *left, bool left_const, const int32_t *right, bool right_const, int n, int32_t *result)
+{
+  const __m512i left_value  = _mm512_set1_epi32(left[0]);
+  const __m512i right_value = _mm512_set1_epi32(right[0]);
+
+  int i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m512i l = left_const ? left_value : _mm512_loadu_si512(left + i);
+    const __m512i r = right_const ? right_value : _mm512_loadu_si512(right + i);
+    __m512i       v;
+    if constexpr (TYPE == ArithType::ADD) {
+      v = _mm512_add_epi32(l, r);
+    } else if constexpr (TYPE == ArithType::SUB) {
+      v = _mm512_sub_epi32(l, r);
+    } else {
+      v = _mm512_mullo_epi32(l, r);
+    }
+    _mm512_storeu_si512(result + i, v);
+  }
+  arith_scalar<TYPE>(left, left_const, right, right_const, i, n, result);
+}
+
+template <ArithType TYPE>
+SIMD_TARGET_AVX512 void arith_float_avx512(
+    const float *left, bool left_const, const float *right, bool right_const, int n, float *result)
+{
+  const __m512 left_value  = _mm512_set1_ps(left[0]);
+  const __m512 right_value = _mm512_set1_ps(right[0]);
+
+  int i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m512 l = left_const ? left_value : _mm512_loadu_ps(left + i);
+    const __m512 r = right_const ? right_value : _mm512_loadu_ps(right + i);
+    __m512       v;
+    if constexpr (TYPE == ArithType::ADD) {
+      v = _mm512_add_ps(l, r);
+    } else if constexpr (TYPE == ArithType::SUB) {
+      v = _mm512_sub_ps(l, r);
+    } else if constexpr (TYPE == ArithType::MUL) {
+      v = _mm512_mul_ps(l, r);
+    } else {
+      v = _mm512_div_ps(l, r);
+    }
+    _mm512_storeu_ps(result + i, v);
+  }
+  arith_scalar<TYPE>(left, left_const, right, right_const, i, n, result);
+}
+
+#endif  // SIMD_RUNTIME_DISPATCH
+
+}  // namespace
+
+void SimdKernel::compare_int32(
+    CompOp op, const int32_t *left, bool left_const, const int32_t *right, bool right_const, int n, uint8_t *result)
+{
+  dispatch_comp_op(op, [&](auto op_constant) {
+    constexpr CompOp OP = decltype(op_constant)::value;
+    switch (simd_level()) {
+#if defined(SIMD_RUNTIME_DISPATCH)
+      case SimdLevel::AVX512: compare_int32_avx512<OP>(left, left_const, right, right_const, n, result); break;
+      case SimdLevel::AVX2: compare_int32_avx2<OP>(left, left_const, right, right_const, n, result); break;
+#endif
+      default: compare_scalar<OP>(left, left_const, right, right_const, 0, n, result); break;
+    }
+  });
+}
+
+void SimdKernel::compare_float(
+    CompOp op, const float *left, bool left_const, const float *right, bool right_const, int n, uint8_t *result)
+{
+  dispatch_comp_op(op, [&](auto op_constant) {
+    constexpr CompOp OP = decltype(op_constant)::value;
+    switch (simd_level()) {
+#if defined(SIMD_RUNTIME_DISPATCH)
+      case SimdLevel::AVX512: compare_float_avx512<OP>(left, left_const, right, right_const, n, result); break;
+      case SimdLevel::AVX2: compare_float_avx2<OP>(left, left_const, right, right_const, n, result); break;
+#endif
+      default: compare_scalar<OP>(left, left_const, right, right_const, 0, n, result); break;
+    }
+  });
+}
+
+void SimdKernel::compare_bool(
+    CompOp op, const uint8_t *left, bool left_const, const uint8_t *right, bool right_const, int n, uint8_t *result)
+{
+  dispatch_comp_op(op, [&](auto op_constant) {
+    constexpr CompOp OP = decltype(op_constant)::value;
+    switch (simd_level()) {
+#if defined(SIMD_RUNTIME_DISPATCH)
+      case SimdLevel::AVX512: compare_bool_avx512<OP>(left, left_const, right, right_const, n, result); break;
+      case SimdLevel::AVX2: compare_bool_avx2<OP>(left, left_const, right, right_const, n, result); break;
+#endif
+      default: compare_bool_scalar<OP>(left, left_const, right, right_const, 0, n, result); break;
+    }
+  });
+}
+
+void SimdKernel::compare_chars(CompOp op, const char *left, int left_len, bool left_const, const char *right,
+    int right_len, bool right_const, int n, uint8_t *result)
+{
+  const int max_len = max(left_len, right_len);
+  dispatch_comp_op(op, [&](auto op_constant) {
+    constexpr CompOp OP    = decltype(op_constant)::value;
+    SimdLevel        level = simd_level();
+    // 每行的字符串放不进一个向量时使用标量实现
+    if (level == SimdLevel::AVX512 && max_len > 64) {
+      level = SimdLevel::AVX2;
+    }
+    if (level == SimdLevel::AVX2 && max_len > 32) {
+      level = SimdLevel::SCALAR;
+    }
+    switch (level) {
+#if defined(SIMD_RUNTIME_DISPATCH)
+      case SimdLevel::AVX512: {
+        compare_chars_avx512<OP>(left, left_len, left_const, right, right_len, right_const, n, result);
+      } break;
+      case SimdLevel::AVX2: {
+        compare_chars_avx2<OP>(left, left_len, left_const, right, right_len, right_const, n, result);
+      } break;
+#endif
+      default: {
+        compare_chars_scalar<OP>(left, left_len, left_const, right, right_len, right_const, 0, n, result);
+      } break;
+    }
+  });
+}
+
+void SimdKernel::mask_and(uint8_t *dst, const uint8_t *src, int n)
+{
+  switch (simd_level()) {
+#if defined(SIMD_RUNTIME_DISPATCH)
+    case SimdLevel::AVX512: mask_and_avx512(dst, src, n); break;
+    case SimdLevel::AVX2: mask_and_avx2(dst, src, n); break;
+#endif
+    default: mask_and_scalar(dst, src, 0, n); break;
+  }
+}
+
+void SimdKernel::mask_or(uint8_t *dst, const uint8_t *src, int n)
+{
+  switch (simd_level()) {
+#if defined(SIMD_RUNTIME_DISPATCH)
+    case SimdLevel::AVX512: mask_or_avx512(dst, src, n); break;
+    case SimdLevel::AVX2: mask_or_avx2(dst, src, n); break;
+#endif
+    default: mask_or_scalar(dst, src, 0, n); break;
+  }
+}
+
+void SimdKernel::arith_int32(ArithType type, const int32_t *left, bool left_const, const int32_t *right,
+    bool right_const, int n, int32_t *result)
+{
+  dispatch_arith_type(type, [&](auto type_constant) {
+    constexpr ArithType TYPE = decltype(type_constant)::value;
+    if constexpr (TYPE != ArithType::DIV) {
+      switch (simd_level()) {
+#if defined(SIMD_RUNTIME_DISPATCH)
+        case SimdLevel::AVX512: arith_int32_avx512<TYPE>(left, left_const, right, right_const, n, result); break;
+        case SimdLevel::AVX2: arith_int32_avx2<TYPE>(left, left_const, right, right_const, n, result); break;
+#endif
+        default: arith_scalar<TYPE>(left, left_const, right, right_const, 0, n, result); break;
+      }
+    }
+  });
+}
+
+void SimdKernel::arith_float(
+    ArithType type, const float *left, bool left_const, const float *right, bool right_const, int n, float *result)
+{
+  dispatch_arith_type(type, [&](auto type_constant) {
+    constexpr ArithType TYPE = decltype(type_constant)::value;
+    switch (simd_level()) {
+#if defined(SIMD_RUNTIME_DISPATCH)
+      case SimdLevel::AVX512: arith_float_avx512<TYPE>(left, left_const, right, right_const, n, result); break;
+      case SimdLevel::AVX2: arith_float_avx2<TYPE>(left, left_const, right, right_const, n, result); break;
+#endif
+      default: arith_scalar<TYPE>(left, left_const, right, right_const, 0, n, result); break;
+    }
+  });
+}
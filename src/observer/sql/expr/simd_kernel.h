@@ -0,0 +1,68 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common/math/simd_util.h"
+#include "sql/parser/parse_defs.h"
+
+/**
+ * @brief 向量化表达式计算使用的函数(kernel)
+ * @details 每个函数都有标量、AVX2 和 AVX-512 三种实现，调用时按照 simd_level() 选择，
+ * 与编译选项 USE_SIMD 无关。
+ * 参数中的 left_const/right_const 为 true 时，对应的数据是常量列，只有一个值。
+ * 比较函数的结果与 result 中原有的值做与运算，与 ComparisonExpr::eval 的约定相同。
+ */
+class SimdKernel
+{
+public:
+  enum class ArithType
+  {
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+  };
+
+  /// INTS 与 DATES 都按照 int32 比较
+  static void compare_int32(CompOp op, const int32_t *left, bool left_const, const int32_t *right, bool right_const,
+      int n, uint8_t *result);
+  static void compare_float(
+      CompOp op, const float *left, bool left_const, const float *right, bool right_const, int n, uint8_t *result);
+
+  /// BOOLEANS 每个值占一个字节，非0都是 true
+  static void compare_bool(CompOp op, const uint8_t *left, bool left_const, const uint8_t *right, bool right_const,
+      int n, uint8_t *result);
+
+  /**
+   * @brief 比较定长的字符串
+   * @details 每个值最长 left_len/right_len 个字节，遇到 '\0' 提前结束，结果与 Value::compare 相同。
+   * 两边的长度可以不同，比如字段与字符串常量比较
+   */
+  static void compare_chars(CompOp op, const char *left, int left_len, bool left_const, const char *right,
+      int right_len, bool right_const, int n, uint8_t *result);
+
+  /// dst[i] &= src[i]，值只能是 0 或 1
+  static void mask_and(uint8_t *dst, const uint8_t *src, int n);
+  /// dst[i] |= src[i]，值只能是 0 或 1
+  static void mask_or(uint8_t *dst, const uint8_t *src, int n);
+
+  /// @note 整数除法没有向量化实现，不支持 ArithType::DIV
+  static void arith_int32(ArithType type, const int32_t *left, bool left_const, const int32_t *right,
+      bool right_const, int n, int32_t *result);
+  static void arith_float(
+      ArithType type, const float *left, bool left_const, const float *right, bool right_const, int n, float *result);
+};
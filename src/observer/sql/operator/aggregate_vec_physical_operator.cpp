@@ -73,9 +73,9 @@ RC AggregateVecPhysicalOperator::open(Trx *trx)
       auto *aggregate_expr = static_cast<AggregateExpr *>(aggregate_expressions_[aggr_idx]);
       if (aggregate_expr->aggregate_type() == AggregateExpr::Type::SUM) {
         if (aggregate_expr->value_type() == AttrType::INTS) {
-          update_aggregate_state<SumState<int>, int>(aggr_values_.at(aggr_idx), column);
+          update_aggregate_state<SumState<int>, int>(aggr_values_.at(aggr_idx), chunk_, column);
         } else if (aggregate_expr->value_type() == AttrType::FLOATS) {
-          update_aggregate_state<SumState<float>, float>(aggr_values_.at(aggr_idx), column);
+          update_aggregate_state<SumState<float>, float>(aggr_values_.at(aggr_idx), chunk_, column);
         } else {
           ASSERT(false, "not supported value type");
         }
@@ -93,11 +93,20 @@ RC AggregateVecPhysicalOperator::open(Trx *trx)
   return rc;
 }
 template <class STATE, typename T>
-void AggregateVecPhysicalOperator::update_aggregate_state(void *state, const Column &column)
+void AggregateVecPhysicalOperator::update_aggregate_state(void *state, const Chunk &chunk, const Column &column)
 {
   STATE *state_ptr = reinterpret_cast<STATE *>(state);
   T *    data      = (T *)column.data();
-  state_ptr->update(data, column.count());
+  if (column.column_type() == Column::Type::CONSTANT_COLUMN) {
+    // 常量列只有一个值，每个选中的行都要累加一次
+    for (int i = 0; i < chunk.selected_rows(); i++) {
+      state_ptr->update(data, 1);
+    }
+  } else if (chunk.has_selection()) {
+    state_ptr->update(data, chunk.selection().data(), static_cast<int>(chunk.selection().size()));
+  } else {
+    state_ptr->update(data, column.count());
+  }
 }
 
 RC AggregateVecPhysicalOperator::next(Chunk &chunk)
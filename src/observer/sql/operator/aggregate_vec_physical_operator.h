@@ -30,8 +30,12 @@ public:
   RC close() override;
 
 private:
+  /**
+   * @brief 用 column 中的值更新聚合状态
+   * @param chunk column 是在 chunk 上计算出来的，只累加 chunk 中选中的行
+   */
   template <class STATE, typename T>
-  void update_aggregate_state(void *state, const Column &column);
+  void update_aggregate_state(void *state, const Chunk &chunk, const Column &column);
 
   template <class STATE, typename T>
   void append_to_column(void *state, Column &column)
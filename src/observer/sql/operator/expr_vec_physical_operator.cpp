@@ -48,6 +48,8 @@ RC ExprVecPhysicalOperator::next(Chunk &chunk)
       expressions_[i]->get_column(chunk_, *column);
       evaled_chunk_.add_column(std::move(column), i);
     }
+    // 表达式按行计算，结果的行与子算子的行一一对应，选择向量可以直接使用
+    evaled_chunk_.copy_selection(chunk_);
     chunk.reference(evaled_chunk_);
   }
   return rc;
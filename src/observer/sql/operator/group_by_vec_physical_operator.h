@@ -50,11 +50,15 @@ public:
       // traverse each row of chunk_
       int col_id = 0;
       Chunk group_chunks, aggrs_chunks;
+      // 只把选中的行放到哈希表中
       for(auto& group_expr : group_by_exprs_) {
         Column col;
         group_expr->get_column(chunk_, col);
-        group_chunks.add_column(make_unique<Column>(col.attr_type(), col.attr_len()), col_id);
-        group_chunks.column_ptr(col_id)->append(col.data(), col.count());
+        group_chunks.add_column(make_unique<Column>(col.attr_type(), col.attr_len(), chunk_.selected_rows()), col_id);
+        rc = chunk_.gather(col, *group_chunks.column_ptr(col_id));
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
         col_id ++;
       }
 
@@ -62,8 +66,11 @@ public:
       for(auto aggrs_expr : value_expressions_) {
         Column col;
         aggrs_expr->get_column(chunk_, col);
-        aggrs_chunks.add_column(make_unique<Column>(col.attr_type(), col.attr_len()), col_id);
-        aggrs_chunks.column_ptr(col_id)->append(col.data(), col.count());
+        aggrs_chunks.add_column(make_unique<Column>(col.attr_type(), col.attr_len(), chunk_.selected_rows()), col_id);
+        rc = chunk_.gather(col, *aggrs_chunks.column_ptr(col_id));
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
         col_id ++;
       }
 
@@ -85,17 +92,14 @@ public:
       return RC::RECORD_EOF;
     }
     
+    // chunk_ 中可能是子算子已经释放的数据(比如 PAX 页面)，只根据表达式的类型创建输出的列
     int col_id = 0;
     for(auto& group_expr : group_by_exprs_) {
-      Column col;
-      group_expr->get_column(chunk_, col);
-      chunk.add_column(make_unique<Column>(col.attr_type(), col.attr_len()), col_id);
+      chunk.add_column(make_unique<Column>(group_expr->value_type(), group_expr->value_length()), col_id);
       col_id ++;
     }
     for(auto& aggrs_expr : value_expressions_) {
-      Column col;
-      aggrs_expr->get_column(chunk_, col);
-      chunk.add_column(make_unique<Column>(col.attr_type(), col.attr_len()), col_id);
+      chunk.add_column(make_unique<Column>(aggrs_expr->value_type(), aggrs_expr->value_length()), col_id);
       col_id ++;
     }
     
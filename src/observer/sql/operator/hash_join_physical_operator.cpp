@@ -0,0 +1,180 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include "sql/operator/hash_join_physical_operator.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+HashJoinPhysicalOperator::HashJoinPhysicalOperator(
+    vector<unique_ptr<Expression>> &&build_keys, vector<unique_ptr<Expression>> &&probe_keys, bool build_left)
+    : build_keys_(std::move(build_keys)), probe_keys_(std::move(probe_keys)), build_left_(build_left)
+{
+  ASSERT(build_keys_.size() == probe_keys_.size(), "build keys and probe keys should have the same size");
+}
+
+string HashJoinPhysicalOperator::param() const { return build_left_ ? "build=left" : "build=right"; }
+
+RC HashJoinPhysicalOperator::open(Trx *trx)
+{
+  if (children_.size() != 2) {
+    LOG_WARN("hash join operator should have 2 children");
+    return RC::INTERNAL;
+  }
+
+  build_       = children_[build_left_ ? 0 : 1].get();
+  probe_       = children_[build_left_ ? 1 : 0].get();
+  probe_tuple_ = nullptr;
+
+  RC rc = build_->open(trx);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open build side operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = build();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  rc = probe_->open(trx);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open probe side operator. rc=%s", strrc(rc));
+  }
+  return rc;
+}
+
+RC HashJoinPhysicalOperator::build()
+{
+  hash_table_.clear();
+  build_tuples_.clear();
+  build_key_values_.clear();
+
+  RC            rc = RC::SUCCESS;
+  vector<Value> key_values;
+  while (OB_SUCC(rc = build_->next())) {
+    Tuple   *tuple = build_->current_tuple();
+    uint64_t hash  = 0;
+    rc             = eval_keys(*tuple, build_keys_, key_values, hash);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    build_tuples_.emplace_back();
+    rc = ValueListTuple::make(*tuple, build_tuples_.back());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to materialize tuple of build side. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    build_key_values_.insert(build_key_values_.end(), key_values.begin(), key_values.end());
+    hash_table_.add(hash);
+  }
+
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to get next tuple of build side. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  hash_table_.build();
+  LOG_TRACE("hash join build done. rows=%d", hash_table_.size());
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::next()
+{
+  // 构建侧没有数据时不需要读取探测侧
+  if (hash_table_.size() == 0) {
+    return RC::RECORD_EOF;
+  }
+
+  RC rc = RC::SUCCESS;
+  while (true) {
+    if (probe_tuple_ != nullptr) {
+      int build_row = -1;
+      while ((build_row = hash_table_.next(probe_hash_, probe_pos_)) != -1) {
+        if (!keys_equal(build_row)) {
+          continue;
+        }
+
+        Tuple *build_tuple = &build_tuples_[build_row];
+        joined_tuple_.set_left(build_left_ ? build_tuple : probe_tuple_);
+        joined_tuple_.set_right(build_left_ ? probe_tuple_ : build_tuple);
+        return RC::SUCCESS;
+      }
+    }
+
+    rc = probe_->next();
+    if (OB_FAIL(rc)) {
+      probe_tuple_ = nullptr;
+      return rc;
+    }
+
+    probe_tuple_ = probe_->current_tuple();
+    rc           = eval_keys(*probe_tuple_, probe_keys_, probe_key_values_, probe_hash_);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    probe_pos_ = hash_table_.begin(probe_hash_);
+  }
+  return rc;
+}
+
+RC HashJoinPhysicalOperator::close()
+{
+  RC rc = build_->close();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to close build side operator. rc=%s", strrc(rc));
+  }
+
+  RC rc2 = probe_->close();
+  if (OB_FAIL(rc2)) {
+    LOG_WARN("failed to close probe side operator. rc=%s", strrc(rc2));
+    rc = rc2;
+  }
+
+  hash_table_.clear();
+  build_tuples_.clear();
+  build_key_values_.clear();
+  return rc;
+}
+
+Tuple *HashJoinPhysicalOperator::current_tuple() { return &joined_tuple_; }
+
+RC HashJoinPhysicalOperator::eval_keys(
+    const Tuple &tuple, vector<unique_ptr<Expression>> &keys, vector<Value> &values, uint64_t &hash)
+{
+  values.resize(keys.size());
+  hash = 0;
+  for (size_t i = 0; i < keys.size(); i++) {
+    RC rc = keys[i]->get_value(tuple, values[i]);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get value of join key. rc=%s", strrc(rc));
+      return rc;
+    }
+    hash = JoinHashTable::combine(hash, JoinHashTable::hash(values[i]));
+  }
+  return RC::SUCCESS;
+}
+
+bool HashJoinPhysicalOperator::keys_equal(int build_row) const
+{
+  const Value *build_values = &build_key_values_[build_row * build_keys_.size()];
+  for (size_t i = 0; i < probe_key_values_.size(); i++) {
+    if (!JoinHashTable::equal(build_values[i], probe_key_values_[i])) {
+      return false;
+    }
+  }
+  return true;
+}
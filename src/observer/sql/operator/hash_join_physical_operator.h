@@ -0,0 +1,74 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+
+#include "sql/expr/join_hash_table.h"
+#include "sql/operator/physical_operator.h"
+
+/**
+ * @brief 等值连接的 hash join 算子
+ * @ingroup PhysicalOperator
+ * @details open 时读取构建(build)侧子算子的所有数据，保存下来并建立哈希表，
+ * 然后依次读取探测(probe)侧的每一行，在哈希表中查找连接键相等的行。
+ * 两个子算子都只遍历一次，不像 nested loop join 需要反复扫描右表。
+ * 不管哪一边是构建侧，输出的 tuple 总是左表在前右表在后。
+ */
+class HashJoinPhysicalOperator : public PhysicalOperator
+{
+public:
+  /**
+   * @param build_keys 构建侧的连接键
+   * @param probe_keys 探测侧的连接键，与 build_keys 一一对应
+   * @param build_left 左子算子(children_[0])是否是构建侧
+   */
+  HashJoinPhysicalOperator(
+      vector<unique_ptr<Expression>> &&build_keys, vector<unique_ptr<Expression>> &&probe_keys, bool build_left);
+  virtual ~HashJoinPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::HASH_JOIN; }
+
+  string param() const override;
+
+  RC     open(Trx *trx) override;
+  RC     next() override;
+  RC     close() override;
+  Tuple *current_tuple() override;
+
+private:
+  RC build();
+
+  /// 计算 tuple 的连接键，结果保存在 values 中
+  RC eval_keys(const Tuple &tuple, vector<unique_ptr<Expression>> &keys, vector<Value> &values, uint64_t &hash);
+
+  bool keys_equal(int build_row) const;
+
+private:
+  vector<unique_ptr<Expression>> build_keys_;
+  vector<unique_ptr<Expression>> probe_keys_;
+  bool                           build_left_ = false;
+
+  PhysicalOperator *build_ = nullptr;
+  PhysicalOperator *probe_ = nullptr;
+
+  JoinHashTable          hash_table_;
+  vector<ValueListTuple> build_tuples_;      ///< 构建侧所有的行
+  vector<Value>          build_key_values_;  ///< 构建侧所有行的连接键，每行 build_keys_.size() 个
+
+  Tuple        *probe_tuple_ = nullptr;  ///< 当前正在探测的行
+  vector<Value> probe_key_values_;
+  uint64_t      probe_hash_ = 0;
+  size_t        probe_pos_  = 0;
+  JoinedTuple   joined_tuple_;
+};
@@ -0,0 +1,315 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include "sql/operator/hash_join_vec_physical_operator.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+namespace {
+
+/// 常量列只有一个值，所有行都使用这个值
+char *column_data(const Column &column, int row)
+{
+  if (column.column_type() == Column::Type::CONSTANT_COLUMN) {
+    return column.data();
+  }
+  return column.data() + static_cast<size_t>(row) * column.attr_len();
+}
+
+}  // namespace
+
+HashJoinVecPhysicalOperator::HashJoinVecPhysicalOperator(
+    vector<unique_ptr<Expression>> &&build_keys, vector<unique_ptr<Expression>> &&probe_keys, bool build_left)
+    : build_keys_(std::move(build_keys)), probe_keys_(std::move(probe_keys)), build_left_(build_left)
+{
+  ASSERT(build_keys_.size() == probe_keys_.size(), "build keys and probe keys should have the same size");
+}
+
+string HashJoinVecPhysicalOperator::param() const { return build_left_ ? "build=left" : "build=right"; }
+
+RC HashJoinVecPhysicalOperator::open(Trx *trx)
+{
+  if (children_.size() != 2) {
+    LOG_WARN("hash join operator should have 2 children");
+    return RC::INTERNAL;
+  }
+
+  build_ = children_[build_left_ ? 0 : 1].get();
+  probe_ = children_[build_left_ ? 1 : 0].get();
+
+  probe_chunk_.reset();
+  output_.reset();
+  probe_row_  = 0;
+  probing_    = false;
+  probe_done_ = false;
+
+  RC rc = build_->open(trx);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open build side operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = build();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  rc = probe_->open(trx);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open probe side operator. rc=%s", strrc(rc));
+  }
+  return rc;
+}
+
+RC HashJoinVecPhysicalOperator::build()
+{
+  hash_table_.clear();
+  build_columns_.clear();
+  build_key_columns_.clear();
+
+  // 只保存 chunk 中选中的行
+  auto append_column = [](BuildColumn &build_column, const Chunk &chunk, const Column &column) {
+    const int rows = chunk.selected_rows();
+    if (column.column_type() != Column::Type::CONSTANT_COLUMN && !chunk.has_selection()) {
+      build_column.data.insert(
+          build_column.data.end(), column.data(), column.data() + static_cast<size_t>(rows) * column.attr_len());
+      return;
+    }
+    for (int i = 0; i < rows; i++) {
+      const char *data = column_data(column, chunk.row_index(i));
+      build_column.data.insert(build_column.data.end(), data, data + column.attr_len());
+    }
+  };
+
+  RC                         rc = RC::SUCCESS;
+  Chunk                      chunk;
+  vector<unique_ptr<Column>> key_columns;
+  vector<uint64_t>           hashes;
+  while (OB_SUCC(rc = build_->next(chunk))) {
+    if (chunk.selected_rows() == 0) {
+      continue;
+    }
+
+    rc = eval_keys(chunk, build_keys_, key_columns);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    if (build_columns_.empty()) {
+      build_columns_.resize(chunk.column_num());
+      for (int i = 0; i < chunk.column_num(); i++) {
+        build_columns_[i].attr_type = chunk.column(i).attr_type();
+        build_columns_[i].attr_len  = chunk.column(i).attr_len();
+      }
+      build_key_columns_.resize(key_columns.size());
+      for (size_t i = 0; i < key_columns.size(); i++) {
+        build_key_columns_[i].attr_type = key_columns[i]->attr_type();
+        build_key_columns_[i].attr_len  = key_columns[i]->attr_len();
+      }
+    }
+
+    for (int i = 0; i < chunk.column_num(); i++) {
+      append_column(build_columns_[i], chunk, chunk.column(i));
+    }
+    for (size_t i = 0; i < key_columns.size(); i++) {
+      append_column(build_key_columns_[i], chunk, *key_columns[i]);
+    }
+
+    hash_keys(chunk, key_columns, hashes);
+    for (uint64_t hash : hashes) {
+      hash_table_.add(hash);
+    }
+  }
+
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to get next chunk of build side. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  hash_table_.build();
+  LOG_TRACE("hash join build done. rows=%d", hash_table_.size());
+  return RC::SUCCESS;
+}
+
+RC HashJoinVecPhysicalOperator::next(Chunk &chunk)
+{
+  // 构建侧没有数据时不需要读取探测侧
+  if (hash_table_.size() == 0) {
+    return RC::RECORD_EOF;
+  }
+
+  RC rc = RC::SUCCESS;
+  output_.reset_data();
+  while (!probe_done_) {
+    if (probe_row_ >= probe_chunk_.selected_rows()) {
+      rc = next_probe_chunk();
+      if (rc == RC::RECORD_EOF) {
+        probe_done_ = true;
+        break;
+      } else if (OB_FAIL(rc)) {
+        return rc;
+      }
+      continue;
+    }
+
+    const int rows = probe_chunk_.selected_rows();
+    for (; probe_row_ < rows; probe_row_++) {
+      const uint64_t hash      = probe_hashes_[probe_row_];
+      const int      probe_row = probe_chunk_.row_index(probe_row_);
+      if (!probing_) {
+        probe_pos_ = hash_table_.begin(hash);
+        probing_   = true;
+      }
+
+      int build_row = -1;
+      while ((build_row = hash_table_.next(hash, probe_pos_)) != -1) {
+        if (!keys_equal(build_row, probe_row)) {
+          continue;
+        }
+
+        rc = append_row(build_row, probe_row);
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
+
+        // 输出已满，下次从当前的探测位置继续
+        if (output_.rows() >= output_.capacity()) {
+          return chunk.reference(output_);
+        }
+      }
+      probing_ = false;
+    }
+  }
+
+  if (output_.rows() == 0) {
+    return RC::RECORD_EOF;
+  }
+  return chunk.reference(output_);
+}
+
+RC HashJoinVecPhysicalOperator::close()
+{
+  RC rc = build_->close();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to close build side operator. rc=%s", strrc(rc));
+  }
+
+  RC rc2 = probe_->close();
+  if (OB_FAIL(rc2)) {
+    LOG_WARN("failed to close probe side operator. rc=%s", strrc(rc2));
+    rc = rc2;
+  }
+
+  hash_table_.clear();
+  build_columns_.clear();
+  build_key_columns_.clear();
+  return rc;
+}
+
+RC HashJoinVecPhysicalOperator::next_probe_chunk()
+{
+  RC rc = probe_->next(probe_chunk_);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  if (output_.column_num() == 0) {
+    vector<pair<AttrType, int>> types;
+    for (int i = 0; i < probe_chunk_.column_num(); i++) {
+      types.emplace_back(probe_chunk_.column(i).attr_type(), probe_chunk_.column(i).attr_len());
+    }
+    auto build_iter = build_left_ ? types.begin() : types.end();
+    for (const BuildColumn &build_column : build_columns_) {
+      build_iter = types.emplace(build_iter, build_column.attr_type, build_column.attr_len) + 1;
+    }
+
+    for (size_t i = 0; i < types.size(); i++) {
+      output_.add_column(make_unique<Column>(types[i].first, types[i].second), static_cast<int>(i));
+    }
+  }
+
+  rc = eval_keys(probe_chunk_, probe_keys_, probe_key_columns_);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  hash_keys(probe_chunk_, probe_key_columns_, probe_hashes_);
+  probe_row_ = 0;
+  probing_   = false;
+  return rc;
+}
+
+RC HashJoinVecPhysicalOperator::eval_keys(
+    Chunk &chunk, vector<unique_ptr<Expression>> &keys, vector<unique_ptr<Column>> &key_columns)
+{
+  key_columns.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (!key_columns[i]) {
+      key_columns[i] = make_unique<Column>();
+    }
+    RC rc = keys[i]->get_column(chunk, *key_columns[i]);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get column of join key. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+void HashJoinVecPhysicalOperator::hash_keys(
+    const Chunk &chunk, vector<unique_ptr<Column>> &key_columns, vector<uint64_t> &hashes)
+{
+  const int rows = chunk.selected_rows();
+  hashes.assign(rows, 0);
+  for (unique_ptr<Column> &column : key_columns) {
+    const AttrType attr_type = column->attr_type();
+    const int      attr_len  = column->attr_len();
+    for (int i = 0; i < rows; i++) {
+      hashes[i] = JoinHashTable::combine(
+          hashes[i], JoinHashTable::hash(attr_type, column_data(*column, chunk.row_index(i)), attr_len));
+    }
+  }
+}
+
+bool HashJoinVecPhysicalOperator::keys_equal(int build_row, int probe_row)
+{
+  for (size_t i = 0; i < build_key_columns_.size(); i++) {
+    BuildColumn  &build_column = build_key_columns_[i];
+    const Column &probe_column = *probe_key_columns_[i];
+    if (!JoinHashTable::equal(build_column.attr_type,
+            build_column.at(build_row),
+            build_column.attr_len,
+            column_data(probe_column, probe_row),
+            probe_column.attr_len())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RC HashJoinVecPhysicalOperator::append_row(int build_row, int probe_row)
+{
+  const int build_offset = build_left_ ? 0 : probe_chunk_.column_num();
+  const int probe_offset = build_left_ ? static_cast<int>(build_columns_.size()) : 0;
+
+  RC rc = RC::SUCCESS;
+  for (size_t i = 0; i < build_columns_.size() && OB_SUCC(rc); i++) {
+    rc = output_.column(build_offset + i).append_one(build_columns_[i].at(build_row));
+  }
+  for (int i = 0; i < probe_chunk_.column_num() && OB_SUCC(rc); i++) {
+    rc = output_.column(probe_offset + i).append_one(column_data(probe_chunk_.column(i), probe_row));
+  }
+  return rc;
+}
@@ -0,0 +1,96 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+
+#include "sql/expr/join_hash_table.h"
+#include "sql/operator/physical_operator.h"
+
+/**
+ * @brief 等值连接的 hash join 算子(vectorized)
+ * @ingroup PhysicalOperator
+ * @details 与 HashJoinPhysicalOperator 的流程一样，只是按照 chunk 处理数据。
+ * 构建侧的每一列都按行号连续地保存在一块内存中，探测时一次计算整个 chunk 的哈希值。
+ * 输出 chunk 的列是左子算子的所有列后面跟着右子算子的所有列，上层算子中的字段表达式需要
+ * 通过 pos 指定自己在输出 chunk 中的位置。
+ */
+class HashJoinVecPhysicalOperator : public PhysicalOperator
+{
+public:
+  /**
+   * @param build_keys 构建侧的连接键
+   * @param probe_keys 探测侧的连接键，与 build_keys 一一对应
+   * @param build_left 左子算子(children_[0])是否是构建侧
+   */
+  HashJoinVecPhysicalOperator(
+      vector<unique_ptr<Expression>> &&build_keys, vector<unique_ptr<Expression>> &&probe_keys, bool build_left);
+  virtual ~HashJoinVecPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::HASH_JOIN_VEC; }
+
+  string param() const override;
+
+  RC open(Trx *trx) override;
+  RC next(Chunk &chunk) override;
+  RC close() override;
+
+private:
+  /// 保存在连续内存中的一列数据
+  struct BuildColumn
+  {
+    AttrType     attr_type = AttrType::UNDEFINED;
+    int          attr_len  = 0;
+    vector<char> data;
+
+    char *at(int row) { return data.data() + static_cast<size_t>(row) * attr_len; }
+  };
+
+  RC build();
+
+  /// 读取探测侧下一个 chunk，并计算每一行连接键的哈希值
+  RC next_probe_chunk();
+
+  /// 计算 chunk 中的连接键
+  RC eval_keys(Chunk &chunk, vector<unique_ptr<Expression>> &keys, vector<unique_ptr<Column>> &key_columns);
+
+  /// 计算 chunk 中每个选中的行的连接键哈希值，hashes 按照选中的行的顺序存放
+  static void hash_keys(const Chunk &chunk, vector<unique_ptr<Column>> &key_columns, vector<uint64_t> &hashes);
+
+  bool keys_equal(int build_row, int probe_row);
+
+  /// 把构建侧的一行和探测侧的一行拼接起来写入输出 chunk
+  RC append_row(int build_row, int probe_row);
+
+private:
+  vector<unique_ptr<Expression>> build_keys_;
+  vector<unique_ptr<Expression>> probe_keys_;
+  bool                           build_left_ = false;
+
+  PhysicalOperator *build_ = nullptr;
+  PhysicalOperator *probe_ = nullptr;
+
+  JoinHashTable       hash_table_;
+  vector<BuildColumn> build_columns_;      ///< 构建侧所有的列
+  vector<BuildColumn> build_key_columns_;  ///< 构建侧的连接键
+
+  Chunk                      probe_chunk_;
+  vector<unique_ptr<Column>> probe_key_columns_;
+  vector<uint64_t>           probe_hashes_;
+  int                        probe_row_ = 0;      ///< 当前正在探测的行是 probe_chunk_ 中第几个选中的行
+  bool                       probing_   = false;  ///< probe_row_ 是否已经开始探测
+  size_t                     probe_pos_ = 0;
+  bool                       probe_done_ = false;  ///< 探测侧是否已经读完
+
+  Chunk output_;  ///< 输出的 chunk，在拿到第一个探测侧 chunk 时初始化
+};
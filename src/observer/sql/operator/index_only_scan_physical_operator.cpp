@@ -0,0 +1,205 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include "sql/operator/index_only_scan_physical_operator.h"
+#include "sql/operator/index_scan_physical_operator.h"
+#include "storage/index/index.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+IndexOnlyScanPhysicalOperator::IndexOnlyScanPhysicalOperator(Table *table, Index *index,
+    const std::vector<Value> &left_values, bool left_inclusive, const std::vector<Value> &right_values,
+    bool right_inclusive)
+    : table_(table),
+      index_(index),
+      left_values_(left_values),
+      right_values_(right_values),
+      left_inclusive_(left_inclusive),
+      right_inclusive_(right_inclusive)
+{}
+
+RC IndexOnlyScanPhysicalOperator::open(Trx *trx)
+{
+  if (nullptr == table_ || nullptr == index_) {
+    return RC::INTERNAL;
+  }
+
+  record_handler_ = table_->record_handler();
+  if (nullptr == record_handler_) {
+    LOG_WARN("invalid record handler");
+    return RC::INTERNAL;
+  }
+
+  RC rc = IndexScanPhysicalOperator::create_scanner(
+      index_, left_values_, left_inclusive_, right_values_, right_inclusive_, index_scanner_);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  int key_length     = 0;
+  int include_length = 0;
+  for (const FieldMeta &field_meta : index_->field_metas()) {
+    key_length += field_meta.len();
+  }
+  for (const FieldMeta &field_meta : index_->include_field_metas()) {
+    include_length += field_meta.len();
+  }
+  key_.resize(key_length);
+  include_data_.resize(include_length);
+
+  const int record_size = table_->table_meta().record_size();
+  current_record_.new_record(record_size);
+  memset(current_record_.data(), 0, record_size);
+  tuple_.set_schema(table_, table_->table_meta().field_metas());
+
+  need_visible_check_ = !table_->table_meta().trx_fields().empty();
+  checked_pages_.clear();
+
+  trx_ = trx;
+  return RC::SUCCESS;
+}
+
+void IndexOnlyScanPhysicalOperator::fill_record()
+{
+  char       *data = current_record_.data();
+  const char *key  = key_.data();
+  for (const FieldMeta &field_meta : index_->field_metas()) {
+    memcpy(data + field_meta.offset(), key, field_meta.len());
+    key += field_meta.len();
+  }
+
+  const char *include_data = include_data_.data();
+  for (const FieldMeta &field_meta : index_->include_field_metas()) {
+    memcpy(data + field_meta.offset(), include_data, field_meta.len());
+    include_data += field_meta.len();
+  }
+}
+
+RC IndexOnlyScanPhysicalOperator::check_visible(const RID &rid, bool &visible)
+{
+  visible = true;
+  if (!need_visible_check_ || record_handler_->is_all_visible(rid.page_num)) {
+    return RC::SUCCESS;
+  }
+
+  RC rc = record_handler_->get_record(rid, heap_record_);
+  if (OB_FAIL(rc)) {
+    LOG_TRACE("failed to get record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  rc = trx_->visit_record(table_, heap_record_, ReadWriteMode::READ_ONLY);
+  if (rc == RC::RECORD_INVISIBLE) {
+    visible = false;
+    rc      = RC::SUCCESS;
+  }
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  // 页面上的记录都对所有事务可见之后，后面的扫描就不需要再访问这个页面了
+  if (checked_pages_.insert(rid.page_num).second) {
+    bool marked = false;
+    rc          = record_handler_->try_mark_all_visible(
+        rid.page_num, [this](const Record &record) { return trx_->visible_to_all(table_, record); }, marked);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to mark page all visible. page num=%d, rc=%s", rid.page_num, strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC IndexOnlyScanPhysicalOperator::next()
+{
+  RID rid;
+  RC  rc = RC::SUCCESS;
+
+  bool filter_result = false;
+  bool visible       = false;
+  while (RC::SUCCESS == (rc = index_scanner_->next_entry(&rid, key_.data(), include_data_.data()))) {
+    fill_record();
+    current_record_.set_rid(rid);
+
+    tuple_.set_record(&current_record_);
+    rc = filter(tuple_, filter_result);
+    if (OB_FAIL(rc)) {
+      LOG_TRACE("failed to filter record. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    if (!filter_result) {
+      LOG_TRACE("record filtered");
+      continue;
+    }
+
+    rc = check_visible(rid, visible);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    if (!visible) {
+      LOG_TRACE("record invisible");
+      continue;
+    }
+    return rc;
+  }
+
+  return rc;
+}
+
+RC IndexOnlyScanPhysicalOperator::close()
+{
+  if (index_scanner_ != nullptr) {
+    index_scanner_->destroy();
+    index_scanner_ = nullptr;
+  }
+  return RC::SUCCESS;
+}
+
+Tuple *IndexOnlyScanPhysicalOperator::current_tuple()
+{
+  tuple_.set_record(&current_record_);
+  return &tuple_;
+}
+
+void IndexOnlyScanPhysicalOperator::set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs)
+{
+  predicates_ = std::move(exprs);
+}
+
+RC IndexOnlyScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
+{
+  RC    rc = RC::SUCCESS;
+  Value value;
+  for (std::unique_ptr<Expression> &expr : predicates_) {
+    rc = expr->get_value(tuple, value);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
+    bool tmp_result = value.get_boolean();
+    if (!tmp_result) {
+      result = false;
+      return rc;
+    }
+  }
+
+  result = true;
+  return rc;
+}
+
+std::string IndexOnlyScanPhysicalOperator::param() const
+{
+  return std::string(index_->index_meta().name()) + " ON " + table_->name();
+}
@@ -0,0 +1,87 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+
+#include "common/lang/unordered_set.h"
+#include "sql/expr/tuple.h"
+#include "sql/operator/physical_operator.h"
+#include "storage/record/record_manager.h"
+
+/**
+ * @brief 索引覆盖扫描物理算子
+ * @ingroup PhysicalOperator
+ * @details 查询用到的字段都在索引的键值或者包含列(INCLUDE)中时使用，直接用索引中的数据拼出记录，
+ * 没有用到的字段都是0。记录的可见性仍然要看数据页面上的事务字段，如果页面有 all-visible 标记
+ * (参考 RecordFileHandler::is_all_visible)，就不需要访问数据页面。
+ * 只用于只读的查询，扫描范围的表示方法与 IndexScanPhysicalOperator 相同。
+ */
+class IndexOnlyScanPhysicalOperator : public PhysicalOperator
+{
+public:
+  IndexOnlyScanPhysicalOperator(Table *table, Index *index, const std::vector<Value> &left_values,
+      bool left_inclusive, const std::vector<Value> &right_values, bool right_inclusive);
+
+  virtual ~IndexOnlyScanPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::INDEX_ONLY_SCAN; }
+
+  std::string param() const override;
+
+  RC open(Trx *trx) override;
+  RC next() override;
+  RC close() override;
+
+  Tuple *current_tuple() override;
+
+  void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
+
+private:
+  /// 把索引中的键值和包含列的数据复制到 current_record_ 中对应字段的位置
+  void fill_record();
+
+  /**
+   * @brief 检查记录对当前事务是否可见
+   * @details 页面没有 all-visible 标记时需要读取数据页面上的记录。
+   * 每个页面第一次被访问时，还会尝试给它加上 all-visible 标记
+   */
+  RC check_visible(const RID &rid, bool &visible);
+
+  // 与TableScanPhysicalOperator代码相同，可以优化
+  RC filter(RowTuple &tuple, bool &result);
+
+private:
+  Trx               *trx_            = nullptr;
+  Table             *table_          = nullptr;
+  Index             *index_          = nullptr;
+  IndexScanner      *index_scanner_  = nullptr;
+  RecordFileHandler *record_handler_ = nullptr;
+
+  /// 表中有事务字段时(MVCC)才需要检查可见性
+  bool need_visible_check_ = false;
+
+  std::vector<char>      key_;           ///< 从索引中取出的键值
+  std::vector<char>      include_data_;  ///< 从索引中取出的包含列数据
+  Record                 current_record_;
+  Record                 heap_record_;    ///< 检查可见性时从数据页面中读取的记录
+  unordered_set<PageNum> checked_pages_;  ///< 已经尝试过加 all-visible 标记的页面
+  RowTuple               tuple_;
+
+  std::vector<Value> left_values_;
+  std::vector<Value> right_values_;
+  bool               left_inclusive_  = false;
+  bool               right_inclusive_ = false;
+
+  std::vector<std::unique_ptr<Expression>> predicates_;
+};
@@ -13,23 +13,95 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "sql/operator/index_scan_physical_operator.h"
+#include "common/lang/limits.h"
 #include "storage/index/index.h"
 #include "storage/trx/trx.h"
 
-IndexScanPhysicalOperator::IndexScanPhysicalOperator(Table *table, Index *index, ReadWriteMode mode, const Value *left_value,
-    bool left_inclusive, const Value *right_value, bool right_inclusive)
+IndexScanPhysicalOperator::IndexScanPhysicalOperator(Table *table, Index *index, ReadWriteMode mode,
+    const std::vector<Value> &left_values, bool left_inclusive, const std::vector<Value> &right_values,
+    bool right_inclusive)
     : table_(table),
       index_(index),
       mode_(mode),
+      left_values_(left_values),
+      right_values_(right_values),
       left_inclusive_(left_inclusive),
       right_inclusive_(right_inclusive)
+{}
+
+RC IndexScanPhysicalOperator::make_key(
+    const Index *index, const std::vector<Value> &values, bool fill_max, std::vector<char> &key)
 {
-  if (left_value) {
-    left_value_ = *left_value;
+  const std::vector<FieldMeta> &field_metas = index->field_metas();
+  if (values.size() > field_metas.size()) {
+    LOG_WARN("too many values for index. index=%s, value num=%d", index->index_meta().name(), (int)values.size());
+    return RC::INVALID_ARGUMENT;
   }
-  if (right_value) {
-    right_value_ = *right_value;
+
+  key.clear();
+  for (size_t i = 0; i < field_metas.size(); i++) {
+    const FieldMeta &field_meta = field_metas[i];
+    const size_t     offset     = key.size();
+    key.resize(offset + field_meta.len(), 0);
+    char *data = key.data() + offset;
+
+    if (i < values.size()) {
+      const Value &value = values[i];
+      if (value.attr_type() != field_meta.type() || value.length() > field_meta.len()) {
+        LOG_WARN("invalid value for index field. field=%s, value=%s", field_meta.name(), value.to_string().c_str());
+        return RC::INVALID_ARGUMENT;
+      }
+      memcpy(data, value.data(), value.length());
+      continue;
+    }
+
+    switch (field_meta.type()) {
+      case AttrType::INTS:
+      case AttrType::DATES: {
+        const int v = fill_max ? std::numeric_limits<int>::max() : std::numeric_limits<int>::min();
+        memcpy(data, &v, sizeof(v));
+      } break;
+      case AttrType::FLOATS: {
+        const float v = fill_max ? std::numeric_limits<float>::max() : std::numeric_limits<float>::lowest();
+        memcpy(data, &v, sizeof(v));
+      } break;
+      case AttrType::CHARS: {
+        // 字符串按照无符号字符比较
+        memset(data, fill_max ? 0xFF : 0, field_meta.len());
+      } break;
+      default: {
+        LOG_WARN("unsupported index field type. field=%s, type=%d", field_meta.name(), field_meta.type());
+        return RC::INVALID_ARGUMENT;
+      }
+    }
   }
+  return RC::SUCCESS;
+}
+
+RC IndexScanPhysicalOperator::create_scanner(Index *index, const std::vector<Value> &left_values, bool left_inclusive,
+    const std::vector<Value> &right_values, bool right_inclusive, IndexScanner *&scanner)
+{
+  std::vector<char> left_key;
+  std::vector<char> right_key;
+  RC                rc = RC::SUCCESS;
+  if (!left_values.empty() && OB_FAIL(rc = make_key(index, left_values, !left_inclusive, left_key))) {
+    return rc;
+  }
+  if (!right_values.empty() && OB_FAIL(rc = make_key(index, right_values, right_inclusive, right_key))) {
+    return rc;
+  }
+
+  scanner = index->create_scanner(left_key.empty() ? nullptr : left_key.data(),
+      static_cast<int>(left_key.size()),
+      left_inclusive,
+      right_key.empty() ? nullptr : right_key.data(),
+      static_cast<int>(right_key.size()),
+      right_inclusive);
+  if (nullptr == scanner) {
+    LOG_WARN("failed to create index scanner");
+    return RC::INTERNAL;
+  }
+  return RC::SUCCESS;
 }
 
 RC IndexScanPhysicalOperator::open(Trx *trx)
@@ -38,15 +110,10 @@ RC IndexScanPhysicalOperator::open(Trx *trx)
     return RC::INTERNAL;
   }
 
-  IndexScanner *index_scanner = index_->create_scanner(left_value_.data(),
-      left_value_.length(),
-      left_inclusive_,
-      right_value_.data(),
-      right_value_.length(),
-      right_inclusive_);
-  if (nullptr == index_scanner) {
-    LOG_WARN("failed to create index scanner");
-    return RC::INTERNAL;
+  IndexScanner *index_scanner = nullptr;
+  RC rc = create_scanner(index_, left_values_, left_inclusive_, right_values_, right_inclusive_, index_scanner);
+  if (OB_FAIL(rc)) {
+    return rc;
   }
 
   record_handler_ = table_->record_handler();
@@ -78,6 +145,15 @@ RC IndexScanPhysicalOperator::next()
 
     LOG_TRACE("got a record. rid=%s", rid.to_string().c_str());
 
+    // 事务可能会把记录换成它能看到的旧版本，所以先判断可见性再过滤
+    rc = trx_->visit_record(table_, current_record_, mode_);
+    if (rc == RC::RECORD_INVISIBLE) {
+      LOG_TRACE("record invisible");
+      continue;
+    } else if (OB_FAIL(rc)) {
+      return rc;
+    }
+
     tuple_.set_record(&current_record_);
     rc = filter(tuple_, filter_result);
     if (OB_FAIL(rc)) {
@@ -89,14 +165,7 @@ RC IndexScanPhysicalOperator::next()
       LOG_TRACE("record filtered");
       continue;
     }
-
-    rc = trx_->visit_record(table_, current_record_, mode_);
-    if (rc == RC::RECORD_INVISIBLE) {
-      LOG_TRACE("record invisible");
-      continue;
-    } else {
-      return rc;
-    }
+    return rc;
   }
 
   return rc;
@@ -21,12 +21,15 @@ See the Mulan PSL v2 for more details. */
 /**
  * @brief 索引扫描物理算子
  * @ingroup PhysicalOperator
+ * @details 扫描范围的左右边界都是索引字段的一个前缀。比如联合索引(a,b,c)，
+ * 左边界可以是(1)或者(1,2)，剩下的字段会根据是否包含边界填充最小值或最大值。
+ * 边界为空表示这一边没有限制。
  */
 class IndexScanPhysicalOperator : public PhysicalOperator
 {
 public:
-  IndexScanPhysicalOperator(Table *table, Index *index, ReadWriteMode mode, const Value *left_value,
-      bool left_inclusive, const Value *right_value, bool right_inclusive);
+  IndexScanPhysicalOperator(Table *table, Index *index, ReadWriteMode mode, const std::vector<Value> &left_values,
+      bool left_inclusive, const std::vector<Value> &right_values, bool right_inclusive);
 
   virtual ~IndexScanPhysicalOperator() = default;
 
@@ -42,6 +45,19 @@ public:
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 根据边界的值生成索引的完整键值
+   * @param fill_max 没有指定值的字段是否填充最大值，否则填充最小值
+   */
+  static RC make_key(const Index *index, const std::vector<Value> &values, bool fill_max, std::vector<char> &key);
+
+  /**
+   * @brief 根据左右边界创建索引扫描器
+   * @details 包含左边界时，剩下的字段取最小值，才不会漏掉以边界为前缀的键值，不包含时取最大值。右边界相反
+   */
+  static RC create_scanner(Index *index, const std::vector<Value> &left_values, bool left_inclusive,
+      const std::vector<Value> &right_values, bool right_inclusive, IndexScanner *&scanner);
+
 private:
   // 与TableScanPhysicalOperator代码相同，可以优化
   RC filter(RowTuple &tuple, bool &result);
@@ -57,10 +73,10 @@ private:
   Record   current_record_;
   RowTuple tuple_;
 
-  Value left_value_;
-  Value right_value_;
-  bool  left_inclusive_  = false;
-  bool  right_inclusive_ = false;
+  std::vector<Value> left_values_;
+  std::vector<Value> right_values_;
+  bool               left_inclusive_  = false;
+  bool               right_inclusive_ = false;
 
   std::vector<std::unique_ptr<Expression>> predicates_;
 };
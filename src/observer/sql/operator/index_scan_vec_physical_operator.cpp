@@ -0,0 +1,156 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include "sql/operator/index_scan_vec_physical_operator.h"
+#include "common/lang/algorithm.h"
+#include "sql/operator/index_scan_physical_operator.h"
+#include "storage/index/index.h"
+#include "storage/table/table.h"
+
+using namespace std;
+
+IndexScanVecPhysicalOperator::IndexScanVecPhysicalOperator(Table *table, Index *index, ReadWriteMode mode,
+    const vector<Value> &left_values, bool left_inclusive, const vector<Value> &right_values, bool right_inclusive)
+    : table_(table),
+      index_(index),
+      mode_(mode),
+      left_values_(left_values),
+      right_values_(right_values),
+      left_inclusive_(left_inclusive),
+      right_inclusive_(right_inclusive)
+{}
+
+RC IndexScanVecPhysicalOperator::open(Trx *trx)
+{
+  if (nullptr == table_ || nullptr == index_) {
+    return RC::INTERNAL;
+  }
+
+  record_handler_ = table_->record_handler();
+  if (nullptr == record_handler_) {
+    LOG_WARN("invalid record handler");
+    return RC::INTERNAL;
+  }
+
+  RC rc = IndexScanPhysicalOperator::create_scanner(
+      index_, left_values_, left_inclusive_, right_values_, right_inclusive_, index_scanner_);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  index_eof_ = false;
+
+  // TODO: don't need to fetch all columns from record manager
+  for (int i = 0; i < table_->table_meta().field_num(); ++i) {
+    all_columns_.add_column(
+        make_unique<Column>(*table_->table_meta().field(i)), table_->table_meta().field(i)->field_id());
+  }
+  return rc;
+}
+
+RC IndexScanVecPhysicalOperator::fill_chunk()
+{
+  RC rc = RC::SUCCESS;
+  while (!index_eof_ && all_columns_.rows() < all_columns_.capacity()) {
+    rc = index_scanner_->next_entries(rids_, all_columns_.capacity() - all_columns_.rows());
+    if (RC::RECORD_EOF == rc) {
+      index_eof_ = true;
+      break;
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get rids from index. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    // 同一个页面上的记录排在一起，读取记录时每个页面只需要访问一次
+    sort(rids_.begin(), rids_.end(), [](const RID &a, const RID &b) { return RID::compare(&a, &b) < 0; });
+    rc = record_handler_->get_chunk(rids_, all_columns_);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get records. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC IndexScanVecPhysicalOperator::next(Chunk &chunk)
+{
+  RC rc = RC::SUCCESS;
+  while (true) {
+    all_columns_.reset_data();
+    rc = fill_chunk();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    if (all_columns_.rows() == 0) {
+      return RC::RECORD_EOF;
+    }
+
+    if (predicates_.empty()) {
+      return chunk.reference(all_columns_);
+    }
+
+    select_.assign(all_columns_.rows(), 1);
+    rc = filter(all_columns_);
+    if (rc != RC::SUCCESS) {
+      LOG_TRACE("filtered failed=%s", strrc(rc));
+      return rc;
+    }
+
+    all_columns_.select(select_);
+    if (all_columns_.selected_rows() == 0) {
+      continue;
+    }
+    if (all_columns_.sparse()) {
+      rc = all_columns_.compact(filterd_columns_);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to compact chunk. rc=%s", strrc(rc));
+        return rc;
+      }
+      return chunk.reference(filterd_columns_);
+    }
+    return chunk.reference(all_columns_);
+  }
+  return rc;
+}
+
+RC IndexScanVecPhysicalOperator::close()
+{
+  if (index_scanner_ != nullptr) {
+    index_scanner_->destroy();
+    index_scanner_ = nullptr;
+  }
+  return RC::SUCCESS;
+}
+
+string IndexScanVecPhysicalOperator::param() const
+{
+  return string(index_->index_meta().name()) + " ON " + table_->name();
+}
+
+void IndexScanVecPhysicalOperator::set_predicates(vector<unique_ptr<Expression>> &&exprs)
+{
+  predicates_ = std::move(exprs);
+}
+
+RC IndexScanVecPhysicalOperator::filter(Chunk &chunk)
+{
+  RC rc = RC::SUCCESS;
+  for (unique_ptr<Expression> &expr : predicates_) {
+    rc = expr->eval(chunk, select_);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  return rc;
+}
@@ -0,0 +1,76 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+
+#include "common/rc.h"
+#include "sql/operator/physical_operator.h"
+#include "storage/record/record_manager.h"
+#include "common/types.h"
+
+class Table;
+class Index;
+class IndexScanner;
+
+/**
+ * @brief 索引扫描物理算子(vectorized)
+ * @ingroup PhysicalOperator
+ * @details 每次从索引中取出一批 RID，按照页面排好序后再读取记录，
+ * 同一个页面上的记录只需要访问一次页面。输出的数据不再保持索引的顺序。
+ * 扫描范围的表示方法与 IndexScanPhysicalOperator 相同。
+ */
+class IndexScanVecPhysicalOperator : public PhysicalOperator
+{
+public:
+  IndexScanVecPhysicalOperator(Table *table, Index *index, ReadWriteMode mode, const std::vector<Value> &left_values,
+      bool left_inclusive, const std::vector<Value> &right_values, bool right_inclusive);
+
+  virtual ~IndexScanVecPhysicalOperator() = default;
+
+  std::string param() const override;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::INDEX_SCAN_VEC; }
+
+  RC open(Trx *trx) override;
+  RC next(Chunk &chunk) override;
+  RC close() override;
+
+  void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
+
+private:
+  /// 从索引中取出 RID 并读取记录，直到填满 all_columns_ 或者扫描结束
+  RC fill_chunk();
+
+  // 与TableScanVecPhysicalOperator代码相同，可以优化
+  RC filter(Chunk &chunk);
+
+private:
+  Table             *table_          = nullptr;
+  Index             *index_          = nullptr;
+  ReadWriteMode      mode_           = ReadWriteMode::READ_WRITE;
+  IndexScanner      *index_scanner_  = nullptr;
+  RecordFileHandler *record_handler_ = nullptr;
+  bool               index_eof_      = false;
+
+  std::vector<Value> left_values_;
+  std::vector<Value> right_values_;
+  bool               left_inclusive_  = false;
+  bool               right_inclusive_ = false;
+
+  std::vector<RID>                         rids_;
+  Chunk                                    all_columns_;
+  Chunk                                    filterd_columns_;
+  std::vector<uint8_t>                     select_;
+  std::vector<std::unique_ptr<Expression>> predicates_;
+};
@@ -23,11 +23,12 @@ class InsertStmt;
 /**
  * @brief 插入物理算子
  * @ingroup PhysicalOperator
+ * @details 插入多行数据时使用批量插入的接口，参考 Table::insert_records
  */
 class InsertPhysicalOperator : public PhysicalOperator
 {
 public:
-  InsertPhysicalOperator(Table *table, std::vector<Value> &&values);
+  InsertPhysicalOperator(Table *table, std::vector<std::vector<Value>> &&rows);
 
   virtual ~InsertPhysicalOperator() = default;
 
@@ -40,6 +41,6 @@ public:
   Tuple *current_tuple() override { return nullptr; }
 
 private:
-  Table             *table_ = nullptr;
-  std::vector<Value> values_;
+  Table                          *table_ = nullptr;
+  std::vector<std::vector<Value>> rows_;
 };
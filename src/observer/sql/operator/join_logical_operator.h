@@ -20,6 +20,8 @@ See the Mulan PSL v2 for more details. */
  * @brief 连接算子
  * @ingroup LogicalOperator
  * @details 连接算子，用于连接两个表。对应的物理算子或者实现，可能有NestedLoopJoin，HashJoin等等。
+ * expressions 中保存的是等值连接条件(ComparisonExpr)，由 JoinConditionPushdownRewriter 从谓词中移过来，
+ * 比较的左边只引用左子算子中的表，右边只引用右子算子中的表。没有连接条件时就是笛卡尔积。
  */
 class JoinLogicalOperator : public LogicalOperator
 {
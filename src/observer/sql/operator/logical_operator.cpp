@@ -22,9 +22,12 @@ bool LogicalOperator::can_generate_vectorized_operator(const LogicalOperatorType
     bool bool_ret = false;
     switch (type)
     {
+    // INSERT 没有子算子，写入的是 VALUES 中的常量行，已经通过 Table::insert_records 批量插入，向量化没有收益。
+    // DELETE 和 UPDATE 需要知道每条记录的 RID，chunk 中只有列数据
     case LogicalOperatorType::CALC:
     case LogicalOperatorType::DELETE:
     case LogicalOperatorType::INSERT:
+    case LogicalOperatorType::UPDATE:
         bool_ret = false;
         break;
     
@@ -40,7 +40,11 @@ enum class PhysicalOperatorType
   TABLE_SCAN,
   TABLE_SCAN_VEC,
   INDEX_SCAN,
+  INDEX_SCAN_VEC,
+  INDEX_ONLY_SCAN,
   NESTED_LOOP_JOIN,
+  HASH_JOIN,
+  HASH_JOIN_VEC,
   EXPLAIN,
   PREDICATE,
   PREDICATE_VEC,
@@ -0,0 +1,76 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include "sql/operator/predicate_vec_physical_operator.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+PredicateVecPhysicalOperator::PredicateVecPhysicalOperator(unique_ptr<Expression> expr) : expression_(std::move(expr))
+{
+  ASSERT(expression_->value_type() == AttrType::BOOLEANS, "predicate's expression should be BOOLEAN type");
+}
+
+RC PredicateVecPhysicalOperator::open(Trx *trx)
+{
+  if (children_.size() != 1) {
+    LOG_WARN("predicate operator must has one child");
+    return RC::INTERNAL;
+  }
+
+  output_.reset();
+  return children_[0]->open(trx);
+}
+
+RC PredicateVecPhysicalOperator::next(Chunk &chunk)
+{
+  RC                rc    = RC::SUCCESS;
+  PhysicalOperator *oper  = children_.front().get();
+  while (OB_SUCC(rc = oper->next(chunk_))) {
+    if (chunk_.selected_rows() == 0) {
+      continue;
+    }
+
+    // 子算子已经过滤掉的行不需要再计算，ComparisonExpr::eval 的结果会与 select_ 原有的值做与运算
+    chunk_.selection_mask(select_);
+
+    rc = expression_->eval(chunk_, select_);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to eval predicate. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    chunk_.select(select_);
+    if (chunk_.selected_rows() == 0) {
+      continue;
+    }
+    if (!chunk_.sparse()) {
+      return chunk.reference(chunk_);
+    }
+
+    rc = chunk_.compact(output_);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to compact chunk. rc=%s", strrc(rc));
+      return rc;
+    }
+    return chunk.reference(output_);
+  }
+  return rc;
+}
+
+RC PredicateVecPhysicalOperator::close()
+{
+  output_.reset();
+  return children_[0]->close();
+}
@@ -0,0 +1,44 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+
+#include "sql/expr/expression.h"
+#include "sql/operator/physical_operator.h"
+
+/**
+ * @brief 过滤/谓词物理算子(vectorized)
+ * @ingroup PhysicalOperator
+ * @details 一次计算整个 chunk 的过滤结果，输出 chunk 的列与子算子相同。过滤结果记录在输出 chunk 的
+ * 选择向量中(参考 Chunk::select)，只有选中的行很少时才把它们复制出来。所有的行都不满足时继续读取下一个 chunk。
+ */
+class PredicateVecPhysicalOperator : public PhysicalOperator
+{
+public:
+  PredicateVecPhysicalOperator(unique_ptr<Expression> expr);
+
+  virtual ~PredicateVecPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::PREDICATE_VEC; }
+
+  RC open(Trx *trx) override;
+  RC next(Chunk &chunk) override;
+  RC close() override;
+
+private:
+  unique_ptr<Expression> expression_;
+  Chunk                  chunk_;   ///< 子算子返回的数据
+  Chunk                  output_;  ///< 压缩之后的数据
+  vector<uint8_t>        select_;
+};
@@ -22,3 +22,9 @@ void TableGetLogicalOperator::set_predicates(std::vector<std::unique_ptr<Express
 {
   predicates_ = std::move(exprs);
 }
+
+void TableGetLogicalOperator::set_used_fields(std::vector<std::string> &&fields)
+{
+  used_fields_       = std::move(fields);
+  used_fields_known_ = true;
+}
@@ -36,10 +36,21 @@ public:
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
   auto predicates() -> std::vector<std::unique_ptr<Expression>> & { return predicates_; }
 
+  /**
+   * @brief 设置查询中用到的这张表的字段
+   * @details 用到的字段都在某个索引中时，可以只扫描索引而不需要回表。没有设置时认为用到了所有字段
+   */
+  void set_used_fields(std::vector<std::string> &&fields);
+  bool used_fields_known() const { return used_fields_known_; }
+  const std::vector<std::string> &used_fields() const { return used_fields_; }
+
 private:
   Table        *table_ = nullptr;
   ReadWriteMode mode_  = ReadWriteMode::READ_WRITE;
 
+  bool                     used_fields_known_ = false;
+  std::vector<std::string> used_fields_;
+
   // 与当前表相关的过滤操作，可以尝试在遍历数据时执行
   // 这里的表达式都是比较简单的比较运算，并且左右两边都是取字段表达式或值表达式
   // 不包含复杂的表达式运算，比如加减乘除、或者conjunction expression
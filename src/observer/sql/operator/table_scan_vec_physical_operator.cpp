@@ -25,8 +25,6 @@ RC TableScanVecPhysicalOperator::open(Trx *trx)
   for (int i = 0; i < table_->table_meta().field_num(); ++i) {
     all_columns_.add_column(
         make_unique<Column>(*table_->table_meta().field(i)), table_->table_meta().field(i)->field_id());
-    filterd_columns_.add_column(
-        make_unique<Column>(*table_->table_meta().field(i)), table_->table_meta().field(i)->field_id());
   }
   return rc;
 }
@@ -35,29 +33,38 @@ RC TableScanVecPhysicalOperator::next(Chunk &chunk)
 {
   RC rc = RC::SUCCESS;
   all_columns_.reset_data();
-  filterd_columns_.reset_data();
-  if (OB_SUCC(rc = chunk_scanner_.next_chunk(all_columns_))) {
-    select_.assign(all_columns_.rows(), 1);
+  while (OB_SUCC(rc = chunk_scanner_.next_chunk(all_columns_))) {
+    // PAX 页面的数据可能是直接引用的，页面上空闲的位置已经在选择向量中去掉了
+    if (all_columns_.selected_rows() == 0) {
+      all_columns_.reset_data();
+      continue;
+    }
     if (predicates_.empty()) {
-      chunk.reference(all_columns_);
-    } else {
-      rc = filter(all_columns_);
-      if (rc != RC::SUCCESS) {
-        LOG_TRACE("filtered failed=%s", strrc(rc));
+      return chunk.reference(all_columns_);
+    }
+
+    all_columns_.selection_mask(select_);
+    rc = filter(all_columns_);
+    if (rc != RC::SUCCESS) {
+      LOG_TRACE("filtered failed=%s", strrc(rc));
+      return rc;
+    }
+
+    // 过滤后只记录选择向量，选中的行很少时才把它们复制出来
+    all_columns_.select(select_);
+    if (all_columns_.selected_rows() == 0) {
+      all_columns_.reset_data();
+      continue;
+    }
+    if (all_columns_.sparse()) {
+      rc = all_columns_.compact(filterd_columns_);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to compact chunk. rc=%s", strrc(rc));
         return rc;
       }
-      // TODO: if all setted, it doesn't need to set one by one
-      for (int i = 0; i < all_columns_.rows(); i++) {
-        if (select_[i] == 0) {
-          continue;
-        }
-        for (int j = 0; j < all_columns_.column_num(); j++) {
-          filterd_columns_.column(j).append_one(
-              (char *)all_columns_.column(filterd_columns_.column_ids(j)).get_value(i).data());
-        }
-      }
-      chunk.reference(filterd_columns_);
+      return chunk.reference(filterd_columns_);
     }
+    return chunk.reference(all_columns_);
   }
   return rc;
 }
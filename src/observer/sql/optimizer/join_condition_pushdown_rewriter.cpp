@@ -0,0 +1,153 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include "sql/optimizer/join_condition_pushdown_rewriter.h"
+#include "common/log/log.h"
+#include "sql/expr/expression.h"
+#include "sql/expr/join_hash_table.h"
+#include "sql/operator/logical_operator.h"
+#include "sql/operator/table_get_logical_operator.h"
+
+using namespace std;
+
+RC JoinConditionPushdownRewriter::rewrite(unique_ptr<LogicalOperator> &oper, bool &change_made)
+{
+  RC rc = RC::SUCCESS;
+  if (oper->type() != LogicalOperatorType::PREDICATE || oper->children().size() != 1) {
+    return rc;
+  }
+
+  LogicalOperator &join_oper = *oper->children().front();
+  if (join_oper.type() != LogicalOperatorType::JOIN) {
+    return rc;
+  }
+
+  vector<unique_ptr<Expression>> &predicate_oper_exprs = oper->expressions();
+  if (predicate_oper_exprs.size() != 1) {
+    return rc;
+  }
+
+  unique_ptr<Expression> &predicate_expr = predicate_oper_exprs.front();
+  bool                    all_pushed     = false;
+  if (predicate_expr->type() == ExprType::COMPARISON) {
+    all_pushed = pushdown(predicate_expr, join_oper);
+    change_made |= all_pushed;
+  } else if (predicate_expr->type() == ExprType::CONJUNCTION) {
+    auto conjunction_expr = static_cast<ConjunctionExpr *>(predicate_expr.get());
+    if (conjunction_expr->conjunction_type() != ConjunctionExpr::Type::AND) {
+      return rc;
+    }
+
+    vector<unique_ptr<Expression>> &child_exprs = conjunction_expr->children();
+    for (auto iter = child_exprs.begin(); iter != child_exprs.end();) {
+      if (pushdown(*iter, join_oper)) {
+        iter        = child_exprs.erase(iter);
+        change_made = true;
+      } else {
+        ++iter;
+      }
+    }
+    all_pushed = child_exprs.empty();
+  }
+
+  if (all_pushed) {
+    // 与 PredicatePushdownRewriter 一样，留下一个恒为真的谓词，由 PredicateRewriteRule 删除
+    LOG_TRACE("all expressions of predicate operator were pushdown to join operator, then make a fake one");
+    Value value((bool)true);
+    predicate_expr = unique_ptr<Expression>(new ValueExpr(value));
+  }
+  return rc;
+}
+
+bool JoinConditionPushdownRewriter::pushdown(unique_ptr<Expression> &expr, LogicalOperator &join_oper)
+{
+  if (expr->type() != ExprType::COMPARISON) {
+    return false;
+  }
+
+  auto comparison_expr = static_cast<ComparisonExpr *>(expr.get());
+  if (comparison_expr->comp() != CompOp::EQUAL_TO) {
+    return false;
+  }
+
+  unique_ptr<Expression> &left_expr  = comparison_expr->left();
+  unique_ptr<Expression> &right_expr = comparison_expr->right();
+  if (left_expr->type() != ExprType::FIELD || right_expr->type() != ExprType::FIELD) {
+    return false;
+  }
+
+  // 类型不同的比较需要做类型转换，哈希值无法直接比较，留给 nested loop join 处理
+  if (left_expr->value_type() != right_expr->value_type() || !JoinHashTable::support(left_expr->value_type())) {
+    return false;
+  }
+
+  const Table *left_table  = static_cast<FieldExpr *>(left_expr.get())->field().table();
+  const Table *right_table = static_cast<FieldExpr *>(right_expr.get())->field().table();
+  if (left_table == right_table) {
+    return false;
+  }
+
+  bool             swapped = false;
+  LogicalOperator *target  = find_join(join_oper, left_table, right_table, swapped);
+  if (nullptr == target) {
+    return false;
+  }
+
+  if (swapped) {
+    left_expr.swap(right_expr);
+  }
+  target->expressions().emplace_back(std::move(expr));
+  return true;
+}
+
+LogicalOperator *JoinConditionPushdownRewriter::find_join(
+    LogicalOperator &oper, const Table *left, const Table *right, bool &swapped)
+{
+  if (oper.type() != LogicalOperatorType::JOIN || oper.children().size() != 2) {
+    return nullptr;
+  }
+
+  for (unique_ptr<LogicalOperator> &child_oper : oper.children()) {
+    LogicalOperator *target = find_join(*child_oper, left, right, swapped);
+    if (target != nullptr) {
+      return target;
+    }
+  }
+
+  LogicalOperator &left_oper  = *oper.children()[0];
+  LogicalOperator &right_oper = *oper.children()[1];
+  if (contains_table(left_oper, left) && contains_table(right_oper, right)) {
+    swapped = false;
+    return &oper;
+  }
+  if (contains_table(left_oper, right) && contains_table(right_oper, left)) {
+    swapped = true;
+    return &oper;
+  }
+  return nullptr;
+}
+
+bool JoinConditionPushdownRewriter::contains_table(LogicalOperator &oper, const Table *table)
+{
+  if (oper.type() == LogicalOperatorType::TABLE_GET) {
+    return static_cast<TableGetLogicalOperator &>(oper).table() == table;
+  }
+
+  for (unique_ptr<LogicalOperator> &child_oper : oper.children()) {
+    if (contains_table(*child_oper, table)) {
+      return true;
+    }
+  }
+  return false;
+}
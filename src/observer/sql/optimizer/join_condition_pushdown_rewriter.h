@@ -0,0 +1,50 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+
+#include "sql/optimizer/rewrite_rule.h"
+
+class Table;
+
+/**
+ * @brief 将谓词中的等值连接条件移动到连接算子中
+ * @ingroup Rewriter
+ * @details 谓词算子下面是连接算子时，把形如 t1.a = t2.b 的比较表达式移动到最低的一个同时能看到这两张表的
+ * 连接算子中，物理计划生成时就可以使用 hash join 代替 nested loop join。
+ * 移动后比较表达式的左边总是引用连接算子左边子算子中的表。
+ */
+class JoinConditionPushdownRewriter : public RewriteRule
+{
+public:
+  JoinConditionPushdownRewriter()          = default;
+  virtual ~JoinConditionPushdownRewriter() = default;
+
+  RC rewrite(std::unique_ptr<LogicalOperator> &oper, bool &change_made) override;
+
+private:
+  /**
+   * @brief 尝试把一个表达式移动到连接算子中
+   * @return 是否移动成功。移动成功后 expr 就失效了
+   */
+  bool pushdown(std::unique_ptr<Expression> &expr, LogicalOperator &join_oper);
+
+  /**
+   * @brief 找到最低的一个左右两边分别包含 left 和 right 表的连接算子
+   * @param swapped 如果 left 表在连接算子的右边，就设置为 true
+   */
+  LogicalOperator *find_join(LogicalOperator &oper, const Table *left, const Table *right, bool &swapped);
+
+  bool contains_table(LogicalOperator &oper, const Table *table);
+};
@@ -15,6 +15,8 @@ See the Mulan PSL v2 for more details. */
 #include "sql/optimizer/logical_plan_generator.h"
 
 #include <common/log/log.h>
+#include "common/lang/map.h"
+#include "common/lang/set.h"
 
 #include "sql/operator/calc_logical_operator.h"
 #include "sql/operator/delete_logical_operator.h"
@@ -100,10 +102,38 @@ RC LogicalPlanGenerator::create_plan(SelectStmt *select_stmt, unique_ptr<Logical
   unique_ptr<LogicalOperator> table_oper(nullptr);
   last_oper = &table_oper;
 
+  // 记录查询用到了每张表的哪些字段，生成物理计划时用来判断能不能只扫描索引
+  map<const Table *, set<string>>        used_fields;
+  function<RC(unique_ptr<Expression> &)> field_collector = [&](unique_ptr<Expression> &expr) -> RC {
+    if (expr->type() == ExprType::FIELD) {
+      const Field &field = static_cast<FieldExpr *>(expr.get())->field();
+      used_fields[field.table()].insert(field.field_name());
+      return RC::SUCCESS;
+    }
+    return ExpressionIterator::iterate_child_expr(*expr, field_collector);
+  };
+  for (unique_ptr<Expression> &expr : select_stmt->query_expressions()) {
+    field_collector(expr);
+  }
+  for (unique_ptr<Expression> &expr : select_stmt->group_by()) {
+    field_collector(expr);
+  }
+  for (const FilterUnit *filter_unit : select_stmt->filter_stmt()->filter_units()) {
+    for (const FilterObj *filter_obj : {&filter_unit->left(), &filter_unit->right()}) {
+      if (filter_obj->is_attr) {
+        used_fields[filter_obj->field.table()].insert(filter_obj->field.field_name());
+      }
+    }
+  }
+
   const std::vector<Table *> &tables = select_stmt->tables();
   for (Table *table : tables) {
 
-    unique_ptr<LogicalOperator> table_get_oper(new TableGetLogicalOperator(table, ReadWriteMode::READ_ONLY));
+    auto table_get = new TableGetLogicalOperator(table, ReadWriteMode::READ_ONLY);
+    const set<string> &fields_of_table = used_fields[table];
+    table_get->set_used_fields(vector<string>(fields_of_table.begin(), fields_of_table.end()));
+
+    unique_ptr<LogicalOperator> table_get_oper(table_get);
     if (table_oper == nullptr) {
       table_oper = std::move(table_get_oper);
     } else {
@@ -186,10 +216,8 @@ RC LogicalPlanGenerator::create_plan(FilterStmt *filter_stmt, unique_ptr<Logical
 
 RC LogicalPlanGenerator::create_plan(InsertStmt *insert_stmt, unique_ptr<LogicalOperator> &logical_operator)
 {
-  Table        *table = insert_stmt->table();
-  vector<Value> values(insert_stmt->values(), insert_stmt->values() + insert_stmt->value_amount());
-
-  InsertLogicalOperator *insert_operator = new InsertLogicalOperator(table, values);
+  Table                 *table           = insert_stmt->table();
+  InsertLogicalOperator *insert_operator = new InsertLogicalOperator(table, insert_stmt->rows());
   logical_operator.reset(insert_operator);
   return RC::SUCCESS;
 }
@@ -77,7 +77,9 @@ RC OptimizeStage::generate_physical_plan(
     unique_ptr<LogicalOperator> &logical_operator, unique_ptr<PhysicalOperator> &physical_operator, Session *session)
 {
   RC rc = RC::SUCCESS;
-  if (session->get_execution_mode() == ExecutionMode::CHUNK_ITERATOR && LogicalOperator::can_generate_vectorized_operator(logical_operator->type())) {
+  // 执行计划中有不支持向量化的算子或表达式时，按行执行
+  if (session->get_execution_mode() == ExecutionMode::CHUNK_ITERATOR &&
+      PhysicalPlanGenerator::can_create_vec(*logical_operator)) {
     LOG_INFO("use chunk iterator");
     session->set_used_chunk_mode(true);
     rc    = physical_plan_generator_.create_vec(*logical_operator, physical_operator);
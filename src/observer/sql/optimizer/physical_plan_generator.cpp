@@ -15,7 +15,9 @@ See the Mulan PSL v2 for more details. */
 #include <utility>
 
 #include "common/log/log.h"
+#include "common/lang/map.h"
 #include "sql/expr/expression.h"
+#include "sql/expr/expression_iterator.h"
 #include "sql/operator/aggregate_vec_physical_operator.h"
 #include "sql/operator/calc_logical_operator.h"
 #include "sql/operator/calc_physical_operator.h"
@@ -26,13 +28,18 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/explain_physical_operator.h"
 #include "sql/operator/expr_vec_physical_operator.h"
 #include "sql/operator/group_by_vec_physical_operator.h"
+#include "sql/operator/hash_join_physical_operator.h"
+#include "sql/operator/hash_join_vec_physical_operator.h"
+#include "sql/operator/index_only_scan_physical_operator.h"
 #include "sql/operator/index_scan_physical_operator.h"
+#include "sql/operator/index_scan_vec_physical_operator.h"
 #include "sql/operator/insert_logical_operator.h"
 #include "sql/operator/insert_physical_operator.h"
 #include "sql/operator/join_logical_operator.h"
 #include "sql/operator/join_physical_operator.h"
 #include "sql/operator/predicate_logical_operator.h"
 #include "sql/operator/predicate_physical_operator.h"
+#include "sql/operator/predicate_vec_physical_operator.h"
 #include "sql/operator/project_logical_operator.h"
 #include "sql/operator/project_physical_operator.h"
 #include "sql/operator/project_vec_physical_operator.h"
@@ -45,6 +52,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/table_scan_vec_physical_operator.h"
 #include "sql/optimizer/physical_plan_generator.h"
 #include "sql/operator/update_logical_operator.h"
+#include "storage/index/index.h"
 
 using namespace std;
 
@@ -118,6 +126,12 @@ RC PhysicalPlanGenerator::create_vec(LogicalOperator &logical_operator, unique_p
     case LogicalOperatorType::EXPLAIN: {
       return create_vec_plan(static_cast<ExplainLogicalOperator &>(logical_operator), oper);
     } break;
+    case LogicalOperatorType::JOIN: {
+      return create_vec_plan(static_cast<JoinLogicalOperator &>(logical_operator), oper);
+    } break;
+    case LogicalOperatorType::PREDICATE: {
+      return create_vec_plan(static_cast<PredicateLogicalOperator &>(logical_operator), oper);
+    } break;
     default: {
       return RC::INVALID_ARGUMENT;
     }
@@ -125,65 +139,351 @@ RC PhysicalPlanGenerator::create_vec(LogicalOperator &logical_operator, unique_p
   return rc;
 }
 
+namespace {
 
+/// 表达式能否通过 get_column 在 chunk 上计算
+bool can_get_column(Expression &expr)
+{
+  if (expr.pos() != -1) {
+    return true;
+  }
 
-RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, unique_ptr<PhysicalOperator> &oper)
+  switch (expr.type()) {
+    case ExprType::FIELD:
+    case ExprType::VALUE: return true;
+    case ExprType::ARITHMETIC: {
+      // 向量化的算术运算要求两边的类型与结果的类型相同，并且不支持取负
+      auto &arithmetic_expr = static_cast<ArithmeticExpr &>(expr);
+      if (!arithmetic_expr.right()) {
+        return false;
+      }
+      const AttrType attr_type = arithmetic_expr.value_type();
+      return (attr_type == AttrType::INTS || attr_type == AttrType::FLOATS) &&
+             arithmetic_expr.left()->value_type() == attr_type && arithmetic_expr.right()->value_type() == attr_type &&
+             can_get_column(*arithmetic_expr.left()) && can_get_column(*arithmetic_expr.right());
+    }
+    default: return false;
+  }
+}
+
+/// 表达式能否通过 eval 在 chunk 上计算过滤结果
+bool can_eval(Expression &expr)
 {
-  vector<unique_ptr<Expression>> &predicates = table_get_oper.predicates();
-  // 看看是否有可以用于索引查找的表达式
-  Table *table = table_get_oper.table();
+  switch (expr.type()) {
+    case ExprType::COMPARISON: {
+      auto &comparison_expr = static_cast<ComparisonExpr &>(expr);
+      if (comparison_expr.comp() == CompOp::LIKE || comparison_expr.comp() == CompOp::NOT_LIKE ||
+          comparison_expr.comp() == CompOp::NO_OP) {
+        return false;
+      }
+      const AttrType attr_type = comparison_expr.left()->value_type();
+      return (attr_type == AttrType::INTS || attr_type == AttrType::FLOATS || attr_type == AttrType::DATES ||
+                 attr_type == AttrType::BOOLEANS || attr_type == AttrType::CHARS) &&
+             comparison_expr.right()->value_type() == attr_type && can_get_column(*comparison_expr.left()) &&
+             can_get_column(*comparison_expr.right());
+    }
+    case ExprType::CONJUNCTION: {
+      for (unique_ptr<Expression> &child : static_cast<ConjunctionExpr &>(expr).children()) {
+        if (!can_eval(*child)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    default: return false;
+  }
+}
 
-  Index     *index      = nullptr;
-  ValueExpr *value_expr = nullptr;
-  for (auto &expr : predicates) {
-    if (expr->type() == ExprType::COMPARISON) {
-      auto comparison_expr = static_cast<ComparisonExpr *>(expr.get());
-      // 简单处理，就找等值查询
-      if (comparison_expr->comp() != EQUAL_TO) {
-        continue;
+/// 向量化的聚合算子只实现了整数和浮点数的 SUM
+bool can_aggregate(Expression &expr)
+{
+  if (expr.type() != ExprType::AGGREGATION) {
+    return false;
+  }
+  auto &aggregate_expr = static_cast<AggregateExpr &>(expr);
+  if (aggregate_expr.aggregate_type() != AggregateExpr::Type::SUM) {
+    return false;
+  }
+  const AttrType attr_type = aggregate_expr.value_type();
+  return (attr_type == AttrType::INTS || attr_type == AttrType::FLOATS) && can_get_column(*aggregate_expr.child());
+}
+
+}  // namespace
+
+bool PhysicalPlanGenerator::can_create_vec(LogicalOperator &logical_operator)
+{
+  if (!LogicalOperator::can_generate_vectorized_operator(logical_operator.type())) {
+    return false;
+  }
+
+  bool supported = true;
+  switch (logical_operator.type()) {
+    case LogicalOperatorType::TABLE_GET: {
+      for (unique_ptr<Expression> &expr : static_cast<TableGetLogicalOperator &>(logical_operator).predicates()) {
+        supported = supported && can_eval(*expr);
+      }
+    } break;
+    case LogicalOperatorType::PREDICATE: {
+      for (unique_ptr<Expression> &expr : logical_operator.expressions()) {
+        supported = supported && can_eval(*expr);
       }
+    } break;
+    case LogicalOperatorType::PROJECTION: {
+      for (unique_ptr<Expression> &expr : logical_operator.expressions()) {
+        supported = supported && can_get_column(*expr);
+      }
+    } break;
+    case LogicalOperatorType::GROUP_BY: {
+      auto &group_by_oper = static_cast<GroupByLogicalOperator &>(logical_operator);
+      for (unique_ptr<Expression> &expr : group_by_oper.group_by_expressions()) {
+        supported = supported && can_get_column(*expr);
+      }
+      for (Expression *expr : group_by_oper.aggregate_expressions()) {
+        supported = supported && can_aggregate(*expr);
+      }
+    } break;
+    case LogicalOperatorType::JOIN: {
+      // 只有 hash join 实现了向量化，需要有等值连接条件
+      supported = !logical_operator.expressions().empty();
+      for (unique_ptr<Expression> &expr : logical_operator.expressions()) {
+        auto &comparison_expr = static_cast<ComparisonExpr &>(*expr);
+        supported = supported && can_get_column(*comparison_expr.left()) && can_get_column(*comparison_expr.right());
+      }
+    } break;
+    case LogicalOperatorType::EXPLAIN: break;
+    default: supported = false; break;
+  }
 
-      unique_ptr<Expression> &left_expr  = comparison_expr->left();
-      unique_ptr<Expression> &right_expr = comparison_expr->right();
-      // 左右比较的一边最少是一个值
-      if (left_expr->type() != ExprType::VALUE && right_expr->type() != ExprType::VALUE) {
-        continue;
+  for (unique_ptr<LogicalOperator> &child_oper : logical_operator.children()) {
+    supported = supported && can_create_vec(*child_oper);
+  }
+  return supported;
+}
+
+
+
+namespace {
+
+/**
+ * @brief 一个字段上的取值范围，由这个字段上的多个比较条件合并而来
+ */
+struct FieldRange
+{
+  bool  has_left        = false;
+  Value left;
+  bool  left_inclusive  = false;
+  bool  has_right       = false;
+  Value right;
+  bool  right_inclusive = false;
+
+  /// 与 field >/>= value 取交集，取更紧的边界
+  void intersect_left(const Value &value, bool inclusive)
+  {
+    const int result = has_left ? value.compare(left) : 1;
+    if (result > 0 || (result == 0 && !inclusive)) {
+      has_left       = true;
+      left           = value;
+      left_inclusive = inclusive;
+    }
+  }
+
+  /// 与 field </<= value 取交集，取更紧的边界
+  void intersect_right(const Value &value, bool inclusive)
+  {
+    const int result = has_right ? value.compare(right) : -1;
+    if (result < 0 || (result == 0 && !inclusive)) {
+      has_right       = true;
+      right           = value;
+      right_inclusive = inclusive;
+    }
+  }
+
+  /// 是否是等值条件
+  bool is_point() const
+  {
+    return has_left && has_right && left_inclusive && right_inclusive && left.compare(right) == 0;
+  }
+
+  /// 是否是空的范围。空范围不用于索引扫描，交给过滤条件处理
+  bool is_empty() const
+  {
+    if (!has_left || !has_right) {
+      return false;
+    }
+    const int result = left.compare(right);
+    return result > 0 || (result == 0 && !(left_inclusive && right_inclusive));
+  }
+};
+
+/**
+ * @brief 把 FIELD op VALUE 形式的比较条件按照字段合并成取值范围
+ * @details 只处理值的类型与字段类型相同的条件。所有条件仍然会在扫描时过滤，所以这里的范围只要不小于真实的结果就可以
+ */
+void collect_field_ranges(Table *table, vector<unique_ptr<Expression>> &predicates, map<string, FieldRange> &ranges)
+{
+  for (unique_ptr<Expression> &expr : predicates) {
+    if (expr->type() != ExprType::COMPARISON) {
+      continue;
+    }
+
+    auto             comparison_expr = static_cast<ComparisonExpr *>(expr.get());
+    CompOp           comp            = comparison_expr->comp();
+    unique_ptr<Expression> &left_expr  = comparison_expr->left();
+    unique_ptr<Expression> &right_expr = comparison_expr->right();
+
+    FieldExpr *field_expr = nullptr;
+    ValueExpr *value_expr = nullptr;
+    if (left_expr->type() == ExprType::FIELD && right_expr->type() == ExprType::VALUE) {
+      field_expr = static_cast<FieldExpr *>(left_expr.get());
+      value_expr = static_cast<ValueExpr *>(right_expr.get());
+    } else if (left_expr->type() == ExprType::VALUE && right_expr->type() == ExprType::FIELD) {
+      // value op field 转换成 field op' value
+      field_expr = static_cast<FieldExpr *>(right_expr.get());
+      value_expr = static_cast<ValueExpr *>(left_expr.get());
+      switch (comp) {
+        case LESS_THAN: comp = GREAT_THAN; break;
+        case LESS_EQUAL: comp = GREAT_EQUAL; break;
+        case GREAT_THAN: comp = LESS_THAN; break;
+        case GREAT_EQUAL: comp = LESS_EQUAL; break;
+        default: break;
       }
+    } else {
+      continue;
+    }
+
+    const FieldMeta *field_meta = table->table_meta().field(field_expr->field_name());
+    const Value     &value      = value_expr->get_value();
+    if (nullptr == field_meta || value.attr_type() != field_meta->type()) {
+      continue;
+    }
+    // 超过字段长度的字符串无法放到索引的键值中
+    if (value.attr_type() == AttrType::CHARS && value.length() > field_meta->len()) {
+      continue;
+    }
+
+    switch (comp) {
+      case EQUAL_TO: {
+        FieldRange &range = ranges[field_meta->name()];
+        range.intersect_left(value, true);
+        range.intersect_right(value, true);
+      } break;
+      case LESS_THAN: ranges[field_meta->name()].intersect_right(value, false); break;
+      case LESS_EQUAL: ranges[field_meta->name()].intersect_right(value, true); break;
+      case GREAT_THAN: ranges[field_meta->name()].intersect_left(value, false); break;
+      case GREAT_EQUAL: ranges[field_meta->name()].intersect_left(value, true); break;
+      default: break;
+    }
+  }
+}
+
+/**
+ * @brief 索引扫描的范围
+ */
+struct IndexScanRange
+{
+  Index        *index           = nullptr;
+  vector<Value> left_values;
+  vector<Value> right_values;
+  bool          left_inclusive  = true;
+  bool          right_inclusive = true;
+};
+
+/**
+ * @brief 选择能用上的字段最多的索引：索引字段的前缀都是等值条件，之后最多再有一个范围条件
+ * @return 没有可用的索引时 index 为空
+ */
+IndexScanRange choose_index(Table *table, vector<unique_ptr<Expression>> &predicates)
+{
+  map<string, FieldRange> ranges;
+  collect_field_ranges(table, predicates, ranges);
 
-      FieldExpr *field_expr = nullptr;
-      if (left_expr->type() == ExprType::FIELD) {
-        ASSERT(right_expr->type() == ExprType::VALUE, "right expr should be a value expr while left is field expr");
-        field_expr = static_cast<FieldExpr *>(left_expr.get());
-        value_expr = static_cast<ValueExpr *>(right_expr.get());
-      } else if (right_expr->type() == ExprType::FIELD) {
-        ASSERT(left_expr->type() == ExprType::VALUE, "left expr should be a value expr while right is a field expr");
-        field_expr = static_cast<FieldExpr *>(right_expr.get());
-        value_expr = static_cast<ValueExpr *>(left_expr.get());
+  IndexScanRange best;
+  int            best_score = 0;
+
+  const TableMeta &table_meta = table->table_meta();
+  for (int i = 0; i < table_meta.index_num() && !ranges.empty(); i++) {
+    const IndexMeta *index_meta = table_meta.index(i);
+
+    int            score = 0;
+    IndexScanRange range_of_index;
+    for (const string &field_name : index_meta->fields()) {
+      auto iter = ranges.find(field_name);
+      if (iter == ranges.end() || iter->second.is_empty()) {
+        break;
       }
 
-      if (field_expr == nullptr) {
+      const FieldRange &range = iter->second;
+      if (range.is_point()) {
+        range_of_index.left_values.push_back(range.left);
+        range_of_index.right_values.push_back(range.right);
+        score += 2;
         continue;
       }
 
-      const Field &field = field_expr->field();
-      index              = table->find_index_by_field(field.field_name());
-      if (nullptr != index) {
-        break;
+      if (range.has_left) {
+        range_of_index.left_values.push_back(range.left);
+        range_of_index.left_inclusive = range.left_inclusive;
       }
+      if (range.has_right) {
+        range_of_index.right_values.push_back(range.right);
+        range_of_index.right_inclusive = range.right_inclusive;
+      }
+      score += 1;
+      break;
+    }
+
+    if (score > best_score) {
+      range_of_index.index = table->find_index(index_meta->name());
+      best                 = std::move(range_of_index);
+      best_score           = score;
     }
   }
+  return best;
+}
+
+/**
+ * @brief 只读的查询用到的字段都在索引的键值或包含列中时，可以只扫描索引
+ */
+bool can_scan_index_only(TableGetLogicalOperator &table_get_oper, const Index &index)
+{
+  if (table_get_oper.read_write_mode() != ReadWriteMode::READ_ONLY || !table_get_oper.used_fields_known()) {
+    return false;
+  }
 
-  if (index != nullptr) {
-    ASSERT(value_expr != nullptr, "got an index but value expr is null ?");
+  const IndexMeta &index_meta = index.index_meta();
+  for (const string &field_name : table_get_oper.used_fields()) {
+    if (!index_meta.covers(field_name.c_str())) {
+      return false;
+    }
+  }
+  return true;
+}
 
-    const Value               &value           = value_expr->get_value();
+}  // namespace
+
+RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, unique_ptr<PhysicalOperator> &oper)
+{
+  vector<unique_ptr<Expression>> &predicates = table_get_oper.predicates();
+  // 看看是否有可以用于索引查找的表达式
+  Table *table = table_get_oper.table();
+
+  IndexScanRange range = choose_index(table, predicates);
+  Index         *index = range.index;
+
+  if (index != nullptr && can_scan_index_only(table_get_oper, *index)) {
+    auto index_scan_oper = new IndexOnlyScanPhysicalOperator(
+        table, index, range.left_values, range.left_inclusive, range.right_values, range.right_inclusive);
+    index_scan_oper->set_predicates(std::move(predicates));
+    oper = unique_ptr<PhysicalOperator>(index_scan_oper);
+    LOG_TRACE("use index only scan");
+  } else if (index != nullptr) {
     IndexScanPhysicalOperator *index_scan_oper = new IndexScanPhysicalOperator(table,
         index,
         table_get_oper.read_write_mode(),
-        &value,
-        true /*left_inclusive*/,
-        &value,
-        true /*right_inclusive*/);
+        range.left_values,
+        range.left_inclusive,
+        range.right_values,
+        range.right_inclusive);
 
     index_scan_oper->set_predicates(std::move(predicates));
     oper = unique_ptr<PhysicalOperator>(index_scan_oper);
@@ -252,8 +552,8 @@ RC PhysicalPlanGenerator::create_plan(ProjectLogicalOperator &project_oper, uniq
 RC PhysicalPlanGenerator::create_plan(InsertLogicalOperator &insert_oper, unique_ptr<PhysicalOperator> &oper)
 {
   Table                  *table           = insert_oper.table();
-  vector<Value>          &values          = insert_oper.values();
-  InsertPhysicalOperator *insert_phy_oper = new InsertPhysicalOperator(table, std::move(values));
+  vector<vector<Value>>  &rows            = insert_oper.rows();
+  InsertPhysicalOperator *insert_phy_oper = new InsertPhysicalOperator(table, std::move(rows));
   oper.reset(insert_phy_oper);
   return RC::SUCCESS;
 }
@@ -340,7 +640,18 @@ RC PhysicalPlanGenerator::create_plan(JoinLogicalOperator &join_oper, unique_ptr
     return RC::INTERNAL;
   }
 
-  unique_ptr<PhysicalOperator> join_physical_oper(new NestedLoopJoinPhysicalOperator);
+  // 有等值连接条件时使用 hash join
+  unique_ptr<PhysicalOperator> join_physical_oper;
+  if (join_oper.expressions().empty()) {
+    join_physical_oper.reset(new NestedLoopJoinPhysicalOperator);
+  } else {
+    vector<unique_ptr<Expression>> build_keys;
+    vector<unique_ptr<Expression>> probe_keys;
+    bool                           build_left = false;
+    split_join_keys(join_oper, build_keys, probe_keys, build_left);
+    join_physical_oper.reset(new HashJoinPhysicalOperator(std::move(build_keys), std::move(probe_keys), build_left));
+  }
+
   for (auto &child_oper : child_opers) {
     unique_ptr<PhysicalOperator> child_physical_oper;
     rc = create(*child_oper, child_physical_oper);
@@ -398,6 +709,26 @@ RC PhysicalPlanGenerator::create_vec_plan(TableGetLogicalOperator &table_get_ope
 {
   vector<unique_ptr<Expression>> &predicates = table_get_oper.predicates();
   Table *table = table_get_oper.table();
+
+  // 只有 PAX 格式的页面能按照 RID 批量取出列数据(参考 PaxRecordPageHandler::get_chunk)，行存的表使用全表扫描
+  IndexScanRange range;
+  if (table->table_meta().storage_format() == StorageFormat::PAX_FORMAT) {
+    range = choose_index(table, predicates);
+  }
+  if (range.index != nullptr) {
+    auto index_scan_oper = new IndexScanVecPhysicalOperator(table,
+        range.index,
+        table_get_oper.read_write_mode(),
+        range.left_values,
+        range.left_inclusive,
+        range.right_values,
+        range.right_inclusive);
+    index_scan_oper->set_predicates(std::move(predicates));
+    oper = unique_ptr<PhysicalOperator>(index_scan_oper);
+    LOG_TRACE("use vectorized index scan");
+    return RC::SUCCESS;
+  }
+
   TableScanVecPhysicalOperator *table_scan_oper = new TableScanVecPhysicalOperator(table, table_get_oper.read_write_mode());
   table_scan_oper->set_predicates(std::move(predicates));
   oper = unique_ptr<PhysicalOperator>(table_scan_oper);
@@ -409,6 +740,20 @@ RC PhysicalPlanGenerator::create_vec_plan(TableGetLogicalOperator &table_get_ope
 RC PhysicalPlanGenerator::create_vec_plan(GroupByLogicalOperator &logical_oper, unique_ptr<PhysicalOperator> &oper)
 {
   RC rc = RC::SUCCESS;
+
+  ASSERT(logical_oper.children().size() == 1, "group by operator should have 1 child");
+  LogicalOperator &child_oper = *logical_oper.children().front();
+  for (unique_ptr<Expression> &expr : logical_oper.group_by_expressions()) {
+    if (OB_FAIL(rc = bind_join_columns(child_oper, *expr))) {
+      return rc;
+    }
+  }
+  for (Expression *expr : logical_oper.aggregate_expressions()) {
+    if (OB_FAIL(rc = bind_join_columns(child_oper, *expr))) {
+      return rc;
+    }
+  }
+
   unique_ptr<PhysicalOperator> physical_oper = nullptr;
   if (logical_oper.group_by_expressions().empty()) {
     physical_oper = make_unique<AggregateVecPhysicalOperator>(std::move(logical_oper.aggregate_expressions()));
@@ -418,9 +763,6 @@ RC PhysicalPlanGenerator::create_vec_plan(GroupByLogicalOperator &logical_oper,
 
   }
 
-  ASSERT(logical_oper.children().size() == 1, "group by operator should have 1 child");
-
-  LogicalOperator             &child_oper = *logical_oper.children().front();
   unique_ptr<PhysicalOperator> child_physical_oper;
   rc = create_vec(child_oper, child_physical_oper);
   if (OB_FAIL(rc)) {
@@ -445,7 +787,14 @@ RC PhysicalPlanGenerator::create_vec_plan(ProjectLogicalOperator &project_oper,
   RC rc = RC::SUCCESS;
   if (!child_opers.empty()) {
     LogicalOperator *child_oper = child_opers.front().get();
-    rc                          = create_vec(*child_oper, child_phy_oper);
+    for (unique_ptr<Expression> &expr : project_oper.expressions()) {
+      rc = bind_join_columns(*child_oper, *expr);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+
+    rc = create_vec(*child_oper, child_phy_oper);
     if (rc != RC::SUCCESS) {
       LOG_WARN("failed to create project logical operator's child physical operator. rc=%s", strrc(rc));
       return rc;
@@ -491,4 +840,159 @@ RC PhysicalPlanGenerator::create_vec_plan(ExplainLogicalOperator &explain_oper,
 
   oper = std::move(explain_physical_oper);
   return rc;
-}
\ No newline at end of file
+}
+
+RC PhysicalPlanGenerator::create_vec_plan(JoinLogicalOperator &join_oper, unique_ptr<PhysicalOperator> &oper)
+{
+  RC rc = RC::SUCCESS;
+
+  vector<unique_ptr<LogicalOperator>> &child_opers = join_oper.children();
+  if (child_opers.size() != 2) {
+    LOG_WARN("join operator should have 2 children, but have %d", child_opers.size());
+    return RC::INTERNAL;
+  }
+
+  if (join_oper.expressions().empty()) {
+    LOG_WARN("vectorized join without equal conditions is not supported");
+    return RC::UNIMPLENMENT;
+  }
+
+  // 连接键在子算子输出的 chunk 上计算
+  for (unique_ptr<Expression> &expr : join_oper.expressions()) {
+    auto comparison_expr = static_cast<ComparisonExpr *>(expr.get());
+    if (OB_FAIL(rc = bind_join_columns(*child_opers[0], *comparison_expr->left())) ||
+        OB_FAIL(rc = bind_join_columns(*child_opers[1], *comparison_expr->right()))) {
+      return rc;
+    }
+  }
+
+  vector<unique_ptr<Expression>> build_keys;
+  vector<unique_ptr<Expression>> probe_keys;
+  bool                           build_left = false;
+  split_join_keys(join_oper, build_keys, probe_keys, build_left);
+
+  unique_ptr<PhysicalOperator> join_physical_oper(
+      new HashJoinVecPhysicalOperator(std::move(build_keys), std::move(probe_keys), build_left));
+  for (auto &child_oper : child_opers) {
+    unique_ptr<PhysicalOperator> child_physical_oper;
+    rc = create_vec(*child_oper, child_physical_oper);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to create physical child oper. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    join_physical_oper->add_child(std::move(child_physical_oper));
+  }
+
+  oper = std::move(join_physical_oper);
+  return rc;
+}
+
+RC PhysicalPlanGenerator::create_vec_plan(PredicateLogicalOperator &pred_oper, unique_ptr<PhysicalOperator> &oper)
+{
+  vector<unique_ptr<LogicalOperator>> &children_opers = pred_oper.children();
+  ASSERT(children_opers.size() == 1, "predicate logical operator's sub oper number should be 1");
+
+  LogicalOperator &child_oper = *children_opers.front();
+
+  vector<unique_ptr<Expression>> &expressions = pred_oper.expressions();
+  ASSERT(expressions.size() == 1, "predicate logical operator's children should be 1");
+
+  RC rc = bind_join_columns(child_oper, *expressions.front());
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  unique_ptr<PhysicalOperator> child_phy_oper;
+  rc = create_vec(child_oper, child_phy_oper);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to create child operator of predicate operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  oper = make_unique<PredicateVecPhysicalOperator>(std::move(expressions.front()));
+  oper->add_child(std::move(child_phy_oper));
+  return rc;
+}
+
+void PhysicalPlanGenerator::split_join_keys(JoinLogicalOperator &join_oper, vector<unique_ptr<Expression>> &build_keys,
+    vector<unique_ptr<Expression>> &probe_keys, bool &build_left)
+{
+  vector<unique_ptr<LogicalOperator>> &child_opers = join_oper.children();
+  build_left = estimate_pages(*child_opers[0]) < estimate_pages(*child_opers[1]);
+
+  // JoinLogicalOperator 中的比较表达式左边总是对应左子算子
+  for (unique_ptr<Expression> &expr : join_oper.expressions()) {
+    auto comparison_expr = static_cast<ComparisonExpr *>(expr.get());
+    build_keys.emplace_back(std::move(build_left ? comparison_expr->left() : comparison_expr->right()));
+    probe_keys.emplace_back(std::move(build_left ? comparison_expr->right() : comparison_expr->left()));
+  }
+  join_oper.expressions().clear();
+}
+
+int64_t PhysicalPlanGenerator::estimate_pages(LogicalOperator &oper)
+{
+  if (oper.type() == LogicalOperatorType::TABLE_GET) {
+    return static_cast<TableGetLogicalOperator &>(oper).table()->data_page_count();
+  }
+
+  int64_t pages = 0;
+  for (unique_ptr<LogicalOperator> &child_oper : oper.children()) {
+    pages += estimate_pages(*child_oper);
+  }
+  return pages;
+}
+
+RC PhysicalPlanGenerator::bind_join_columns(LogicalOperator &join_oper, Expression &expr)
+{
+  // 过滤算子输出的列与它的子算子相同
+  if (join_oper.type() == LogicalOperatorType::PREDICATE && join_oper.children().size() == 1) {
+    return bind_join_columns(*join_oper.children().front(), expr);
+  }
+
+  if (join_oper.type() != LogicalOperatorType::JOIN) {
+    return RC::SUCCESS;
+  }
+
+  if (expr.type() != ExprType::FIELD) {
+    return ExpressionIterator::iterate_child_expr(
+        expr, [&join_oper](unique_ptr<Expression> &child) { return bind_join_columns(join_oper, *child); });
+  }
+
+  if (expr.pos() != -1) {
+    return RC::SUCCESS;
+  }
+
+  // 按照从左到右的顺序找到字段所在的表，前面所有表的列数就是这张表的列在 chunk 中的起始位置
+  auto                             &field_expr = static_cast<FieldExpr &>(expr);
+  int                               offset     = 0;
+  bool                              found      = false;
+  function<void(LogicalOperator &)> visitor    = [&](LogicalOperator &oper) {
+    if (found) {
+      return;
+    }
+    if (oper.type() == LogicalOperatorType::TABLE_GET) {
+      Table           *table      = static_cast<TableGetLogicalOperator &>(oper).table();
+      const TableMeta &table_meta = table->table_meta();
+      if (table == field_expr.field().table()) {
+        // TableScanVecPhysicalOperator 输出表的所有字段，包括系统字段
+        offset += table_meta.sys_field_num() + field_expr.field().meta()->field_id();
+        found = true;
+      } else {
+        offset += table_meta.field_num();
+      }
+      return;
+    }
+    for (unique_ptr<LogicalOperator> &child_oper : oper.children()) {
+      visitor(*child_oper);
+    }
+  };
+  visitor(join_oper);
+
+  if (!found) {
+    LOG_WARN("failed to find table of field in join. field=%s.%s", field_expr.table_name(), field_expr.field_name());
+    return RC::SCHEMA_FIELD_NOT_EXIST;
+  }
+  expr.set_pos(offset);
+  return RC::SUCCESS;
+}
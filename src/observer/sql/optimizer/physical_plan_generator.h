@@ -44,6 +44,13 @@ public:
   RC create(LogicalOperator &logical_operator, std::unique_ptr<PhysicalOperator> &oper);
   RC create_vec(LogicalOperator &logical_operator, std::unique_ptr<PhysicalOperator> &oper);
 
+  /**
+   * @brief 整个逻辑计划是否都可以生成向量化的物理算子
+   * @details 检查每个算子以及算子中的表达式，有一个不支持时就只能按行执行。
+   * 需要在 create_vec 之前调用，create_vec 会移走逻辑算子中的表达式，失败之后不能再按行生成物理计划。
+   */
+  static bool can_create_vec(LogicalOperator &logical_operator);
+
 private:
   RC create_plan(TableGetLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_plan(PredicateLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
@@ -59,4 +66,26 @@ private:
   RC create_vec_plan(TableGetLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_vec_plan(GroupByLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_vec_plan(ExplainLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
+  RC create_vec_plan(JoinLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
+  RC create_vec_plan(PredicateLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
+
+  /**
+   * @brief 把连接条件拆分成左右两边的连接键，并决定 hash join 的构建侧
+   * @details 选择估计数据量更小的一边作为构建侧
+   */
+  void split_join_keys(JoinLogicalOperator &join_oper, std::vector<std::unique_ptr<Expression>> &build_keys,
+      std::vector<std::unique_ptr<Expression>> &probe_keys, bool &build_left);
+
+  /**
+   * @brief 粗略估计逻辑算子输出的数据量(页面数)，目前只是把所有表的数据页面数加起来
+   */
+  static int64_t estimate_pages(LogicalOperator &oper);
+
+  /**
+   * @brief 向量化执行时，设置字段表达式在连接算子输出 chunk 中的位置
+   * @details 连接算子输出的列是所有表的列按照从左到右的顺序拼接起来的。
+   * 已经设置过位置的字段表达式不会修改。
+   * @param join_oper 表达式所在算子的子算子，如果不是连接算子(或者连接算子上面的过滤算子)就什么都不做
+   */
+  static RC bind_join_columns(LogicalOperator &join_oper, Expression &expr);
 };
@@ -112,8 +112,8 @@ struct CalcSqlNode
  */
 struct InsertSqlNode
 {
-  std::string        relation_name;  ///< Relation to insert into
-  std::vector<Value> values;         ///< 要插入的值
+  std::string                     relation_name;  ///< Relation to insert into
+  std::vector<std::vector<Value>> values;         ///< 要插入的值，每行一个 vector，可以有多行
 };
 
 /**
@@ -175,13 +175,14 @@ struct DropTableSqlNode
  * @brief 描述一个create index语句
  * @ingroup SQLParser
  * @details 创建索引时，需要指定索引名，表名，字段名。
- * 正常的SQL语句中，一个索引可能包含了多个字段，这里仅支持一个字段。
+ * 一个索引可以包含多个字段(联合索引)，字段的顺序就是键值比较的顺序。
  */
 struct CreateIndexSqlNode
 {
-  std::string index_name;      ///< Index name
-  std::string relation_name;   ///< Relation name
-  std::string attribute_name;  ///< Attribute name
+  std::string              index_name;       ///< Index name
+  std::string              relation_name;    ///< Relation name
+  std::vector<std::string> attribute_names;  ///< Attribute names
+  std::vector<std::string> include_names;    ///< INCLUDE 中的字段，只存放在索引的叶子节点中
 };
 
 /**
@@ -159,6 +159,7 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
   Expression *                               expression;
   std::vector<std::unique_ptr<Expression>> * expression_list;
   std::vector<Value> *                       value_list;
+  std::vector<std::vector<Value>> *          value_rows;
   std::vector<ConditionSqlNode> *            condition_list;
   std::vector<RelAttrSqlNode> *              rel_attr_list;
   std::vector<std::string> *                 relation_list;
@@ -187,10 +188,13 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
 %type <attr_infos>          attr_def_list
 %type <attr_info>           attr_def
 %type <value_list>          value_list
+%type <value_list>          value_row
+%type <value_rows>          value_row_list
 %type <condition_list>      where
 %type <condition_list>      condition_list
 %type <string>              storage_format
 %type <relation_list>       rel_list
+%type <relation_list>       attr_name_list
 %type <expression>          expression
 %type <expression_list>     expression_list
 %type <expression_list>     group_by
@@ -310,16 +314,53 @@ desc_table_stmt:
     ;
 
 create_index_stmt:    /*create index 语句的语法解析树*/
-    CREATE INDEX ID ON ID LBRACE ID RBRACE
+    CREATE INDEX ID ON ID LBRACE attr_name_list RBRACE
     {
       $$ = new ParsedSqlNode(SCF_CREATE_INDEX);
       CreateIndexSqlNode &create_index = $$->create_index;
       create_index.index_name = $3;
       create_index.relation_name = $5;
-      create_index.attribute_name = $7;
+      create_index.attribute_names.swap(*$7);
       free($3);
       free($5);
-      free($7);
+      delete $7;
+    }
+    /* INCLUDE 不是关键字，按照 ID 解析，这样也不会影响使用 include 作为表名或字段名 */
+    | CREATE INDEX ID ON ID LBRACE attr_name_list RBRACE ID LBRACE attr_name_list RBRACE
+    {
+      if (0 != strcasecmp($9, "include")) {
+        yyerror(&@9, sql_string, sql_result, scanner, "syntax error, expect INCLUDE");
+        free($3);
+        free($5);
+        delete $7;
+        free($9);
+        delete $11;
+        YYERROR;
+      }
+      $$ = new ParsedSqlNode(SCF_CREATE_INDEX);
+      CreateIndexSqlNode &create_index = $$->create_index;
+      create_index.index_name = $3;
+      create_index.relation_name = $5;
+      create_index.attribute_names.swap(*$7);
+      create_index.include_names.swap(*$11);
+      free($3);
+      free($5);
+      delete $7;
+      free($9);
+      delete $11;
+    }
+    ;
+
+attr_name_list:
+    ID {
+      $$ = new std::vector<std::string>();
+      $$->push_back($1);
+      free($1);
+    }
+    | ID COMMA attr_name_list {
+      $$ = $3;
+      $$->insert($$->begin(), $1);
+      free($1);
     }
     ;
 
@@ -402,21 +443,46 @@ type:
     | DATE_T  { $$ = static_cast<int>(AttrType::DATES);}
     ;
 insert_stmt:        /*insert   语句的语法解析树*/
-    INSERT INTO ID VALUES LBRACE value value_list RBRACE 
+    INSERT INTO ID VALUES value_row_list
     {
       $$ = new ParsedSqlNode(SCF_INSERT);
       $$->insertion.relation_name = $3;
-      if ($7 != nullptr) {
-        $$->insertion.values.swap(*$7);
-        delete $7;
-      }
-      $$->insertion.values.emplace_back(*$6);
-      std::reverse($$->insertion.values.begin(), $$->insertion.values.end());
-      delete $6;
+      $$->insertion.values.swap(*$5);
+      delete $5;
       free($3);
     }
     ;
 
+/* 一条语句可能插入几千行，这里使用左递归，避免解析栈过深 */
+value_row_list:
+    value_row
+    {
+      $$ = new std::vector<std::vector<Value>>;
+      $$->emplace_back(std::move(*$1));
+      delete $1;
+    }
+    | value_row_list COMMA value_row
+    {
+      $$ = $1;
+      $$->emplace_back(std::move(*$3));
+      delete $3;
+    }
+    ;
+
+value_row:
+    LBRACE value value_list RBRACE
+    {
+      if ($3 != nullptr) {
+        $$ = $3;
+      } else {
+        $$ = new std::vector<Value>;
+      }
+      $$->emplace_back(*$2);
+      std::reverse($$->begin(), $$->end());
+      delete $2;
+    }
+    ;
+
 value_list:
     /* empty */
     {
@@ -520,9 +586,6 @@ select_stmt:        /*  select 语句的语法解析树*/
         $$->selection.group_by.swap(*$6);
         delete $6;
       }
-    }
-    | SELECT expression_list FROM join_list where {
-
     }
     ;
 calc_stmt:
@@ -534,10 +597,6 @@ calc_stmt:
     }
     ;
 
-join_list:
-    relation COMMA rel_list INNER JOIN relation COMMA rel_list
-
-
 expression_list:
     expression
     {
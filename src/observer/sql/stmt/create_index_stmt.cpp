@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "sql/stmt/create_index_stmt.h"
 #include "common/lang/string.h"
+#include "common/lang/algorithm.h"
 #include "common/log/log.h"
 #include "storage/db/db.h"
 #include "storage/table/table.h"
@@ -26,10 +27,9 @@ RC CreateIndexStmt::create(Db *db, const CreateIndexSqlNode &create_index, Stmt
   stmt = nullptr;
 
   const char *table_name = create_index.relation_name.c_str();
-  if (is_blank(table_name) || is_blank(create_index.index_name.c_str()) ||
-      is_blank(create_index.attribute_name.c_str())) {
-    LOG_WARN("invalid argument. db=%p, table_name=%p, index name=%s, attribute name=%s",
-        db, table_name, create_index.index_name.c_str(), create_index.attribute_name.c_str());
+  if (is_blank(table_name) || is_blank(create_index.index_name.c_str()) || create_index.attribute_names.empty()) {
+    LOG_WARN("invalid argument. db=%p, table_name=%p, index name=%s, attribute num=%d",
+        db, table_name, create_index.index_name.c_str(), static_cast<int>(create_index.attribute_names.size()));
     return RC::INVALID_ARGUMENT;
   }
 
@@ -40,11 +40,52 @@ RC CreateIndexStmt::create(Db *db, const CreateIndexSqlNode &create_index, Stmt
     return RC::SCHEMA_TABLE_NOT_EXIST;
   }
 
-  const FieldMeta *field_meta = table->table_meta().field(create_index.attribute_name.c_str());
-  if (nullptr == field_meta) {
-    LOG_WARN("no such field in table. db=%s, table=%s, field name=%s", 
-             db->name(), table_name, create_index.attribute_name.c_str());
-    return RC::SCHEMA_FIELD_NOT_EXIST;
+  vector<const FieldMeta *> field_metas;
+  for (const string &attribute_name : create_index.attribute_names) {
+    const FieldMeta *field_meta = table->table_meta().field(attribute_name.c_str());
+    if (nullptr == field_meta) {
+      LOG_WARN("no such field in table. db=%s, table=%s, field name=%s", 
+               db->name(), table_name, attribute_name.c_str());
+      return RC::SCHEMA_FIELD_NOT_EXIST;
+    }
+
+    if (find(field_metas.begin(), field_metas.end(), field_meta) != field_metas.end()) {
+      LOG_WARN("duplicate field in index. db=%s, table=%s, field name=%s", 
+               db->name(), table_name, attribute_name.c_str());
+      return RC::INVALID_ARGUMENT;
+    }
+    field_metas.push_back(field_meta);
+  }
+
+  if (field_metas.size() > IndexMeta::MAX_FIELD_NUM) {
+    LOG_WARN("too many fields in index. db=%s, table=%s, field num=%d", 
+             db->name(), table_name, static_cast<int>(field_metas.size()));
+    return RC::INVALID_ARGUMENT;
+  }
+
+  // 包含列不能与索引字段或者其它包含列重复
+  vector<const FieldMeta *> include_field_metas;
+  for (const string &include_name : create_index.include_names) {
+    const FieldMeta *field_meta = table->table_meta().field(include_name.c_str());
+    if (nullptr == field_meta) {
+      LOG_WARN("no such field in table. db=%s, table=%s, field name=%s", 
+               db->name(), table_name, include_name.c_str());
+      return RC::SCHEMA_FIELD_NOT_EXIST;
+    }
+
+    if (find(field_metas.begin(), field_metas.end(), field_meta) != field_metas.end() ||
+        find(include_field_metas.begin(), include_field_metas.end(), field_meta) != include_field_metas.end()) {
+      LOG_WARN("duplicate include field in index. db=%s, table=%s, field name=%s", 
+               db->name(), table_name, include_name.c_str());
+      return RC::INVALID_ARGUMENT;
+    }
+    include_field_metas.push_back(field_meta);
+  }
+
+  if (include_field_metas.size() > IndexMeta::MAX_FIELD_NUM) {
+    LOG_WARN("too many include fields in index. db=%s, table=%s, field num=%d", 
+             db->name(), table_name, static_cast<int>(include_field_metas.size()));
+    return RC::INVALID_ARGUMENT;
   }
 
   Index *index = table->find_index(create_index.index_name.c_str());
@@ -53,6 +94,6 @@ RC CreateIndexStmt::create(Db *db, const CreateIndexSqlNode &create_index, Stmt
     return RC::SCHEMA_INDEX_NAME_REPEAT;
   }
 
-  stmt = new CreateIndexStmt(table, field_meta, create_index.index_name);
+  stmt = new CreateIndexStmt(table, field_metas, include_field_metas, create_index.index_name);
   return RC::SUCCESS;
 }
@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "sql/stmt/stmt.h"
 
@@ -29,8 +30,9 @@ class FieldMeta;
 class CreateIndexStmt : public Stmt
 {
 public:
-  CreateIndexStmt(Table *table, const FieldMeta *field_meta, const std::string &index_name)
-      : table_(table), field_meta_(field_meta), index_name_(index_name)
+  CreateIndexStmt(Table *table, const std::vector<const FieldMeta *> &field_metas,
+      const std::vector<const FieldMeta *> &include_field_metas, const std::string &index_name)
+      : table_(table), field_metas_(field_metas), include_field_metas_(include_field_metas), index_name_(index_name)
   {}
 
   virtual ~CreateIndexStmt() = default;
@@ -38,14 +40,16 @@ public:
   StmtType type() const override { return StmtType::CREATE_INDEX; }
 
   Table             *table() const { return table_; }
-  const FieldMeta   *field_meta() const { return field_meta_; }
+  const std::vector<const FieldMeta *> &field_metas() const { return field_metas_; }
+  const std::vector<const FieldMeta *> &include_field_metas() const { return include_field_metas_; }
   const std::string &index_name() const { return index_name_; }
 
 public:
   static RC create(Db *db, const CreateIndexSqlNode &create_index, Stmt *&stmt);
 
 private:
-  Table           *table_      = nullptr;
-  const FieldMeta *field_meta_ = nullptr;
-  std::string      index_name_;
+  Table                         *table_ = nullptr;
+  std::vector<const FieldMeta *> field_metas_;
+  std::vector<const FieldMeta *> include_field_metas_;
+  std::string                    index_name_;
 };
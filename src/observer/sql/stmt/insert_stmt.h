@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/lang/vector.h"
 #include "common/rc.h"
 #include "sql/stmt/stmt.h"
 
@@ -23,12 +24,13 @@ class Db;
 /**
  * @brief 插入语句
  * @ingroup Statement
+ * @details 一条语句可以插入多行数据
  */
 class InsertStmt : public Stmt
 {
 public:
   InsertStmt() = default;
-  InsertStmt(Table *table, const Value *values, int value_amount);
+  InsertStmt(Table *table, const vector<vector<Value>> *rows);
 
   StmtType type() const override { return StmtType::INSERT; }
 
@@ -36,12 +38,10 @@ public:
   static RC create(Db *db, const InsertSqlNode &insert_sql, Stmt *&stmt);
 
 public:
-  Table       *table() const { return table_; }
-  const Value *values() const { return values_; }
-  int          value_amount() const { return value_amount_; }
+  Table                       *table() const { return table_; }
+  const vector<vector<Value>> &rows() const { return *rows_; }
 
 private:
-  Table       *table_        = nullptr;
-  const Value *values_       = nullptr;
-  int          value_amount_ = 0;
+  Table                       *table_ = nullptr;
+  const vector<vector<Value>> *rows_  = nullptr;
 };
@@ -17,8 +17,12 @@ See the Mulan PSL v2 for more details. */
 #include "common/io/io.h"
 #include "common/lang/mutex.h"
 #include "common/lang/algorithm.h"
+#include "common/lang/limits.h"
 #include "common/log/log.h"
 #include "common/math/crc.h"
+#include "common/metrics/metrics.h"
+#include "common/metrics/metrics_registry.h"
+#include "common/thread/thread_util.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/buffer/buffer_pool_log.h"
 #include "storage/db/db.h"
@@ -27,6 +31,37 @@ using namespace common;
 
 static const int MEM_POOL_ITEM_NUM = 20;
 
+/**
+ * @brief 缓冲池的监控指标
+ * @details 所有的 BufferPoolManager 共用，注册到全局的 MetricsRegistry 中
+ */
+struct BufferPoolMetrics
+{
+  Meter flushed_pages;     ///< 页面清理线程每秒刷出去的页面数
+  Meter inline_evictions;  ///< 分配页帧时每秒同步刷脏页的次数
+  Meter read_ahead_pages;  ///< 预读线程每秒加载的页面数
+
+  BufferPoolMetrics()
+  {
+    get_metrics_registry().register_metric("buffer_pool.cleaner.flushed_pages", &flushed_pages);
+    get_metrics_registry().register_metric("buffer_pool.inline_evictions", &inline_evictions);
+    get_metrics_registry().register_metric("buffer_pool.read_ahead_pages", &read_ahead_pages);
+  }
+
+  ~BufferPoolMetrics()
+  {
+    get_metrics_registry().unregister("buffer_pool.cleaner.flushed_pages");
+    get_metrics_registry().unregister("buffer_pool.inline_evictions");
+    get_metrics_registry().unregister("buffer_pool.read_ahead_pages");
+  }
+};
+
+static BufferPoolMetrics &buffer_pool_metrics()
+{
+  static BufferPoolMetrics metrics;
+  return metrics;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 string BPFileHeader::to_string() const
@@ -38,7 +73,9 @@ string BPFileHeader::to_string() const
 
 ////////////////////////////////////////////////////////////////////////////////
 
-BPFrameManager::BPFrameManager(const char *name) : allocator_(name) {}
+BPFrameManager::BPFrameManager(const char *name, int shard_num /* = DEFAULT_SHARD_NUM */)
+    : shards_(max(shard_num, 1)), allocator_(name)
+{}
 
 RC BPFrameManager::init(int pool_num)
 {
@@ -51,22 +88,45 @@ RC BPFrameManager::init(int pool_num)
 
 RC BPFrameManager::cleanup()
 {
-  if (frames_.count() > 0) {
+  if (frame_num() > 0) {
     return RC::INTERNAL;
   }
 
-  frames_.destroy();
+  for (FrameShard &shard : shards_) {
+    lock_guard<mutex> lock_guard(shard.lock);
+    shard.frames.destroy();
+  }
   return RC::SUCCESS;
 }
 
-int BPFrameManager::purge_frames(int count, function<RC(Frame *frame)> purger)
+BPFrameManager::FrameShard &BPFrameManager::shard_of(const FrameId &frame_id)
 {
-  lock_guard<mutex> lock_guard(lock_);
+  // 同一个文件的页面编号是连续的，直接取模的话高位的buffer pool id不起作用，所以先打散一下
+  const size_t hash = frame_id.hash() * 0x9E3779B97F4A7C15ULL;
+  return shards_[(hash >> 32) % shards_.size()];
+}
 
-  vector<Frame *> frames_can_purge;
+int BPFrameManager::purge_frames(int count, function<RC(Frame *frame)> purger)
+{
   if (count <= 0) {
     count = 1;
   }
+
+  int          freed_count = 0;
+  const size_t start       = purge_cursor_.fetch_add(1);
+  for (size_t i = 0; i < shards_.size() && freed_count < count; i++) {
+    FrameShard &shard = shards_[(start + i) % shards_.size()];
+    freed_count += purge_shard_frames(shard, count - freed_count, purger);
+  }
+  LOG_INFO("purge frame done. number=%d", freed_count);
+  return freed_count;
+}
+
+int BPFrameManager::purge_shard_frames(FrameShard &shard, int count, function<RC(Frame *frame)> &purger)
+{
+  lock_guard<mutex> lock_guard(shard.lock);
+
+  vector<Frame *> frames_can_purge;
   frames_can_purge.reserve(count);
 
   auto purge_finder = [&frames_can_purge, count](const FrameId &frame_id, Frame *const frame) {
@@ -80,16 +140,16 @@ int BPFrameManager::purge_frames(int count, function<RC(Frame *frame)> purger)
     return true;  // true continue to look up
   };
 
-  frames_.foreach_reverse(purge_finder);
-  LOG_INFO("purge frames find %ld pages total", frames_can_purge.size());
+  shard.frames.foreach_reverse(purge_finder);
+  LOG_DEBUG("purge frames find %ld pages in shard", frames_can_purge.size());
 
-  /// 当前还在frameManager的锁内，而 purger 是一个非常耗时的操作
-  /// 他需要把脏页数据刷新到磁盘上去，所以这里会极大地降低并发度
+  /// 当前还在分片的锁内，而 purger 是一个非常耗时的操作
+  /// 他需要把脏页数据刷新到磁盘上去，不过只会阻塞当前分片上的页面访问
   int freed_count = 0;
   for (Frame *frame : frames_can_purge) {
     RC rc = purger(frame);
     if (RC::SUCCESS == rc) {
-      free_internal(frame->frame_id(), frame);
+      free_internal(shard, frame->frame_id(), frame);
       freed_count++;
     } else {
       frame->unpin();
@@ -97,35 +157,77 @@ int BPFrameManager::purge_frames(int count, function<RC(Frame *frame)> purger)
                frame->frame_id().to_string().c_str(), strrc(rc));
     }
   }
-  LOG_INFO("purge frame done. number=%d", freed_count);
   return freed_count;
 }
 
+vector<Frame *> BPFrameManager::find_purge_candidates(int count)
+{
+  vector<Frame *> frames;
+  if (count <= 0) {
+    return frames;
+  }
+  frames.reserve(count);
+
+  auto finder = [&frames, count](const FrameId &, Frame *const frame) {
+    if (frame->can_purge()) {
+      frame->pin();
+      frames.push_back(frame);
+    }
+    return frames.size() < static_cast<size_t>(count);
+  };
+
+  const size_t start = purge_cursor_.fetch_add(1);
+  for (size_t i = 0; i < shards_.size() && frames.size() < static_cast<size_t>(count); i++) {
+    FrameShard       &shard = shards_[(start + i) % shards_.size()];
+    lock_guard<mutex> lock_guard(shard.lock);
+    shard.frames.foreach_reverse(finder);
+  }
+  return frames;
+}
+
+bool BPFrameManager::free_if_clean(Frame *frame)
+{
+  const FrameId frame_id = frame->frame_id();
+  FrameShard   &shard    = shard_of(frame_id);
+
+  lock_guard<mutex> lock_guard(shard.lock);
+  // 引用计数只在分片锁内增加，只有当前线程引用这个页面时，其它线程也不可能再修改它
+  if (frame->pin_count() != 1 || frame->dirty()) {
+    frame->unpin();
+    return false;
+  }
+
+  free_internal(shard, frame_id, frame);
+  return true;
+}
+
 Frame *BPFrameManager::get(int buffer_pool_id, PageNum page_num)
 {
-  FrameId                     frame_id(buffer_pool_id, page_num);
+  FrameId     frame_id(buffer_pool_id, page_num);
+  FrameShard &shard = shard_of(frame_id);
 
-  lock_guard<mutex> lock_guard(lock_);
-  return get_internal(frame_id);
+  lock_guard<mutex> lock_guard(shard.lock);
+  return get_internal(shard, frame_id);
 }
 
-Frame *BPFrameManager::get_internal(const FrameId &frame_id)
+Frame *BPFrameManager::get_internal(FrameShard &shard, const FrameId &frame_id)
 {
   Frame *frame = nullptr;
-  (void)frames_.get(frame_id, frame);
+  (void)shard.frames.get(frame_id, frame);
   if (frame != nullptr) {
     frame->pin();
   }
   return frame;
 }
 
-Frame *BPFrameManager::alloc(int buffer_pool_id, PageNum page_num)
+Frame *BPFrameManager::alloc(int buffer_pool_id, PageNum page_num, bool write_latched /* = false */)
 {
-  FrameId frame_id(buffer_pool_id, page_num);
+  FrameId     frame_id(buffer_pool_id, page_num);
+  FrameShard &shard = shard_of(frame_id);
 
-  lock_guard<mutex> lock_guard(lock_);
+  lock_guard<mutex> lock_guard(shard.lock);
 
-  Frame                      *frame = get_internal(frame_id);
+  Frame *frame = get_internal(shard, frame_id);
   if (frame != nullptr) {
     return frame;
   }
@@ -137,54 +239,114 @@ Frame *BPFrameManager::alloc(int buffer_pool_id, PageNum page_num)
     frame->set_buffer_pool_id(buffer_pool_id);
     frame->set_page_num(page_num);
     frame->pin();
-    frames_.put(frame_id, frame);
+    if (write_latched) {
+      frame->write_latch();
+    }
+    shard.frames.put(frame_id, frame);
+    frame_num_.fetch_add(1);
   }
   return frame;
 }
 
 RC BPFrameManager::free(int buffer_pool_id, PageNum page_num, Frame *frame)
 {
-  FrameId frame_id(buffer_pool_id, page_num);
+  FrameId     frame_id(buffer_pool_id, page_num);
+  FrameShard &shard = shard_of(frame_id);
 
-  lock_guard<mutex> lock_guard(lock_);
-  return free_internal(frame_id, frame);
+  lock_guard<mutex> lock_guard(shard.lock);
+  return free_internal(shard, frame_id, frame);
 }
 
-RC BPFrameManager::free_internal(const FrameId &frame_id, Frame *frame)
+RC BPFrameManager::free_internal(FrameShard &shard, const FrameId &frame_id, Frame *frame)
 {
   Frame                *frame_source = nullptr;
-  [[maybe_unused]] bool found        = frames_.get(frame_id, frame_source);
+  [[maybe_unused]] bool found        = shard.frames.get(frame_id, frame_source);
   ASSERT(found && frame == frame_source && frame->pin_count() == 1,
       "failed to free frame. found=%d, frameId=%s, frame_source=%p, frame=%p, pinCount=%d, lbt=%s",
       found, frame_id.to_string().c_str(), frame_source, frame, frame->pin_count(), lbt());
 
   frame->set_page_num(-1);
   frame->unpin();
-  frames_.remove(frame_id);
+  shard.frames.remove(frame_id);
+  frame_num_.fetch_sub(1);
   allocator_.free(frame);
   return RC::SUCCESS;
 }
 
 list<Frame *> BPFrameManager::find_list(int buffer_pool_id)
 {
-  lock_guard<mutex> lock_guard(lock_);
-
   list<Frame *> frames;
-  auto               fetcher = [&frames, buffer_pool_id](const FrameId &frame_id, Frame *const frame) -> bool {
+  auto          fetcher = [&frames, buffer_pool_id](const FrameId &frame_id, Frame *const frame) -> bool {
     if (buffer_pool_id == frame_id.buffer_pool_id()) {
       frame->pin();
       frames.push_back(frame);
     }
     return true;
   };
-  frames_.foreach (fetcher);
+
+  for (FrameShard &shard : shards_) {
+    lock_guard<mutex> lock_guard(shard.lock);
+    shard.frames.foreach (fetcher);
+  }
+  return frames;
+}
+
+list<Frame *> BPFrameManager::find_dirty_list(LSN lsn, int max_count, const unordered_set<Frame *> &excluded)
+{
+  list<Frame *> frames;
+  auto fetcher = [&frames, lsn, max_count, &excluded](const FrameId &, Frame *const frame) -> bool {
+    LSN rec_lsn = frame->rec_lsn();
+    if (frame->dirty() && rec_lsn < lsn && excluded.count(frame) == 0) {
+      frame->pin();
+      frames.push_back(frame);
+    }
+    return static_cast<int>(frames.size()) < max_count;
+  };
+
+  for (FrameShard &shard : shards_) {
+    if (static_cast<int>(frames.size()) >= max_count) {
+      break;
+    }
+    lock_guard<mutex> lock_guard(shard.lock);
+    shard.frames.foreach (fetcher);
+  }
   return frames;
 }
 
+RC BPFrameManager::min_rec_lsn(LSN &lsn)
+{
+  RC   rc      = RC::SUCCESS;
+  auto visitor = [&lsn, &rc](const FrameId &, Frame *const frame) -> bool {
+    if (!frame->dirty()) {
+      return true;
+    }
+
+    LSN rec_lsn = frame->rec_lsn();
+    if (rec_lsn > 0) {
+      lsn = min(lsn, rec_lsn);
+    } else if (frame->pin_count() > 0) {
+      // 页面已经修改了，但是日志可能还没有写完，不知道它的recLSN是多少
+      LOG_TRACE("got a dirty frame without lsn. frame=%s", frame->to_string().c_str());
+      rc = RC::LOCKED_NEED_WAIT;
+      return false;
+    }
+    return true;
+  };
+
+  for (FrameShard &shard : shards_) {
+    lock_guard<mutex> lock_guard(shard.lock);
+    shard.frames.foreach (visitor);
+    if (OB_FAIL(rc)) {
+      break;
+    }
+  }
+  return rc;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 BufferPoolIterator::BufferPoolIterator() {}
 BufferPoolIterator::~BufferPoolIterator() {}
-RC BufferPoolIterator::init(DiskBufferPool &bp, PageNum start_page /* = 0 */)
+RC BufferPoolIterator::init(DiskBufferPool &bp, PageNum start_page /* = 0 */, int read_ahead_pages /* = 0 */)
 {
   bitmap_.init(bp.file_header_->bitmap, bp.file_header_->page_count);
   if (start_page <= 0) {
@@ -192,6 +354,10 @@ RC BufferPoolIterator::init(DiskBufferPool &bp, PageNum start_page /* = 0 */)
   } else {
     current_page_num_ = start_page - 1;
   }
+
+  buffer_pool_         = &bp;
+  read_ahead_pages_    = max(read_ahead_pages, 0);
+  read_ahead_page_num_ = current_page_num_;
   return RC::SUCCESS;
 }
 
@@ -202,16 +368,46 @@ PageNum BufferPoolIterator::next()
   PageNum next_page = bitmap_.next_setted_bit(current_page_num_ + 1);
   if (next_page != -1) {
     current_page_num_ = next_page;
+
+    // 预读的页面用掉一半后就开始预读下一批
+    if (read_ahead_pages_ > 0 && read_ahead_page_num_ - current_page_num_ <= read_ahead_pages_ / 2) {
+      read_ahead();
+    }
   }
   return next_page;
 }
 
 RC BufferPoolIterator::reset()
 {
-  current_page_num_ = 0;
+  current_page_num_    = 0;
+  read_ahead_page_num_ = 0;
   return RC::SUCCESS;
 }
 
+void BufferPoolIterator::read_ahead()
+{
+  vector<PageNum> page_nums;
+  page_nums.reserve(read_ahead_pages_);
+
+  PageNum page_num = max(read_ahead_page_num_, current_page_num_);
+  while (static_cast<int>(page_nums.size()) < read_ahead_pages_) {
+    page_num = bitmap_.next_setted_bit(page_num + 1);
+    if (page_num == -1) {
+      break;
+    }
+    page_nums.push_back(page_num);
+  }
+
+  if (page_nums.empty()) {
+    // 后面没有页面了，不用再预读
+    read_ahead_page_num_ = numeric_limits<PageNum>::max();
+    return;
+  }
+
+  read_ahead_page_num_ = page_nums.back();
+  buffer_pool_->read_ahead(page_nums);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 DiskBufferPool::DiskBufferPool(
     BufferPoolManager &bp_manager, BPFrameManager &frame_manager, DoubleWriteBuffer &dblwr_manager, LogHandler &log_handler)
@@ -281,6 +477,9 @@ RC DiskBufferPool::close_file()
     return rc;
   }
 
+  unique_lock<mutex> clean_guard(bp_manager_.clean_lock_);
+  unique_lock<shared_mutex> read_ahead_guard(bp_manager_.read_ahead_close_lock_);
+
   hdr_frame_->unpin();
 
   // TODO: 理论上是在回放时回滚未提交事务，但目前没有undo log，因此不下刷数据page，只通过redo log回放
@@ -305,6 +504,7 @@ RC DiskBufferPool::close_file()
   LOG_INFO("Successfully close file %d:%s.", file_desc_, file_name_.c_str());
   file_desc_ = -1;
 
+  clean_guard.unlock();
   bp_manager_.close_file(file_name_.c_str());
   return RC::SUCCESS;
 }
@@ -323,6 +523,14 @@ RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame)
 
   scoped_lock lock_guard(lock_);  // 直接加了一把大锁，其实可以根据访问的页面来细化提高并行度
 
+  // 等锁的时候，页面可能已经被其它线程(比如预读线程)加载了
+  used_match_frame = frame_manager_.get(id(), page_num);
+  if (used_match_frame != nullptr) {
+    used_match_frame->access();
+    *frame = used_match_frame;
+    return RC::SUCCESS;
+  }
+
   // Allocate one page and load the data into this page
   Frame *allocated_frame = nullptr;
 
@@ -538,6 +746,17 @@ RC DiskBufferPool::flush_page(Frame &frame)
   return flush_page_internal(frame);
 }
 
+RC DiskBufferPool::try_flush_page(Frame &frame)
+{
+  if (!lock_.try_lock()) {
+    return RC::LOCKED_NEED_WAIT;
+  }
+
+  RC rc = flush_page_internal(frame);
+  lock_.unlock();
+  return rc;
+}
+
 RC DiskBufferPool::flush_page_internal(Frame &frame)
 {
   // The better way is use mmap the block into memory,
@@ -610,6 +829,74 @@ RC DiskBufferPool::write_page(PageNum page_num, Page &page)
   return RC::SUCCESS;
 }
 
+void DiskBufferPool::read_ahead(span<const PageNum> page_nums)
+{
+  vector<PageNum> missing_pages;
+  missing_pages.reserve(page_nums.size());
+  for (PageNum page_num : page_nums) {
+    Frame *frame = frame_manager_.get(id(), page_num);
+    if (frame != nullptr) {
+      frame->unpin();
+    } else {
+      missing_pages.push_back(page_num);
+    }
+  }
+
+  if (!missing_pages.empty()) {
+    bp_manager_.read_ahead(id(), missing_pages);
+  }
+}
+
+RC DiskBufferPool::read_ahead_page(PageNum page_num)
+{
+  // 加载页面都在这把锁中，拿到锁之后页面还不在内存中，就不会有其它线程在加载或者修改它
+  scoped_lock lock_guard(lock_);
+
+  // 页面可能在预读请求提交之后被释放了
+  if (page_num >= file_header_->page_count ||
+      (file_header_->bitmap[page_num / 8] & (1 << (page_num % 8))) == 0) {
+    return RC::SUCCESS;
+  }
+
+  Frame *frame = frame_manager_.get(id(), page_num);
+  if (frame != nullptr) {
+    frame->unpin();
+    return RC::SUCCESS;
+  }
+
+  // 页帧分配出来后其它线程就能看到了，在此之前加上写锁，加载完成之前不让它们访问页面数据
+  RC rc = allocate_frame(page_num, &frame, true /*write_latched*/);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate frame for read ahead. file=%s, page_num=%d, rc=%s",
+             file_name_.c_str(), page_num, strrc(rc));
+    return rc;
+  }
+
+  frame->set_buffer_pool_id(id());
+  frame->access();
+  rc = load_page(page_num, frame);
+  frame->write_unlatch();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to load page for read ahead. file=%s, page_num=%d, rc=%s",
+             file_name_.c_str(), page_num, strrc(rc));
+    purge_frame(page_num, frame);
+    return rc;
+  }
+
+  frame->unpin();
+  buffer_pool_metrics().read_ahead_pages.inc();
+  return RC::SUCCESS;
+}
+
+RC DiskBufferPool::sync_file()
+{
+  if (fsync(file_desc_) != 0) {
+    LOG_ERROR("Failed to sync file %s due to %s.", file_name_.c_str(), strerror(errno));
+    return RC::IOERR_SYNC;
+  }
+  return RC::SUCCESS;
+}
+
 RC DiskBufferPool::redo_allocate_page(LSN lsn, PageNum page_num)
 {
   if (hdr_frame_->lsn() >= lsn) {
@@ -648,7 +935,21 @@ RC DiskBufferPool::redo_allocate_page(LSN lsn, PageNum page_num)
   hdr_frame_->set_lsn(lsn);
   hdr_frame_->mark_dirty();
   
-  // TODO 应该检查文件是否足够大，包含了当前新分配的页面
+  // 分配页面时写入的空页面可能还在double write buffer中没有落盘，这里需要把文件扩展到包含新分配的页面
+  struct stat st;
+  if (fstat(file_desc_, &st) != 0) {
+    LOG_ERROR("Failed to stat file %s due to %s.", file_name_.c_str(), strerror(errno));
+    return RC::IOERR_READ;
+  }
+  if (st.st_size < static_cast<int64_t>(page_num + 1) * BP_PAGE_SIZE) {
+    Page page;
+    memset(&page, 0, sizeof(page));
+    RC rc = write_page(page_num, page);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to extend file. file=%s, pageNum=%d, rc=%s", file_name_.c_str(), page_num, strrc(rc));
+      return rc;
+    }
+  }
 
   Bitmap bitmap(file_header_->bitmap, file_header_->page_count);
   bitmap.set_bit(page_num);
@@ -681,13 +982,16 @@ RC DiskBufferPool::redo_deallocate_page(LSN lsn, PageNum page_num)
   return RC::SUCCESS;
 }
 
-RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
+RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer, bool write_latched /* = false */)
 {
   auto purger = [this](Frame *frame) {
     if (!frame->dirty()) {
       return RC::SUCCESS;
     }
 
+    // 前台线程同步刷脏页，页面清理线程没有跟上
+    buffer_pool_metrics().inline_evictions.inc();
+
     RC rc = RC::SUCCESS;
     if (frame->buffer_pool_id() == id()) {
       rc = this->flush_page_internal(*frame);
@@ -702,8 +1006,9 @@ RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
   };
 
   while (true) {
-    Frame *frame = frame_manager_.alloc(id(), page_num);
+    Frame *frame = frame_manager_.alloc(id(), page_num, write_latched);
     if (frame != nullptr) {
+      bp_manager_.notify_page_cleaner();
       *buffer = frame;
       LOG_DEBUG("allocate frame %p, page num %d", frame, page_num);
       return RC::SUCCESS;
@@ -774,6 +1079,9 @@ BufferPoolManager::BufferPoolManager(int memory_size /* = 0 */)
 
 BufferPoolManager::~BufferPoolManager()
 {
+  stop_read_ahead();
+  stop_page_cleaner();
+
   unordered_map<string, DiskBufferPool *> tmp_bps;
   tmp_bps.swap(buffer_pools_);
 
@@ -901,6 +1209,244 @@ RC BufferPoolManager::flush_page(Frame &frame)
   return bp->flush_page(frame);
 }
 
+RC BufferPoolManager::flush_pages_before(LSN lsn, int &count)
+{
+  count = 0;
+
+  // 每个页面只处理一次，刷不出去的页面留给下一次检查点
+  RC                     rc = RC::SUCCESS;
+  unordered_set<Frame *> visited;
+  while (OB_SUCC(rc)) {
+    // 与 clean_frames 一样，处理一批页面时持有 clean_lock_，避免刷页面时 buffer pool 被关闭并删除
+    lock_guard<mutex> clean_guard(clean_lock_);
+
+    list<Frame *> frames = frame_manager_.find_dirty_list(lsn, FLUSH_BATCH_SIZE, visited);
+    if (frames.empty()) {
+      break;
+    }
+
+    for (Frame *frame : frames) {
+      visited.insert(frame);
+
+      // 拿到读锁后，就没有其它线程在修改这个页面了
+      if (OB_SUCC(rc) && frame->try_read_latch()) {
+        DiskBufferPool *bp = nullptr;
+        if (frame->dirty() && OB_SUCC(get_buffer_pool(frame->buffer_pool_id(), bp))) {
+          // 分配页帧的线程可能拿着 buffer pool 的锁等待页面淘汰，这里不能阻塞
+          rc = bp->try_flush_page(*frame);
+          if (OB_SUCC(rc)) {
+            count++;
+          } else if (rc == RC::LOCKED_NEED_WAIT) {
+            rc = RC::SUCCESS;
+          } else {
+            LOG_WARN("failed to flush page. frame=%s, rc=%s", frame->to_string().c_str(), strrc(rc));
+          }
+        }
+        frame->read_unlatch();
+      }
+      frame->unpin();
+    }
+  }
+  return rc;
+}
+
+RC BufferPoolManager::sync_pages() { return dblwr_buffer_->flush_all(); }
+
+RC BufferPoolManager::start_page_cleaner(int free_frame_target /* = 0 */)
+{
+  lock_guard<mutex> guard(page_cleaner_lock_);
+  if (page_cleaner_) {
+    LOG_WARN("page cleaner has been started");
+    return RC::INTERNAL;
+  }
+
+  if (free_frame_target <= 0) {
+    free_frame_target = max(static_cast<int>(frame_manager_.total_frame_num() / 16), 1);
+  }
+  free_frame_target_.store(free_frame_target);
+
+  page_cleaner_running_ = true;
+  page_cleaner_         = make_unique<thread>(&BufferPoolManager::page_cleaner_func, this);
+  LOG_INFO("page cleaner started. free frame target=%d", free_frame_target);
+  return RC::SUCCESS;
+}
+
+void BufferPoolManager::stop_page_cleaner()
+{
+  {
+    lock_guard<mutex> guard(page_cleaner_lock_);
+    if (!page_cleaner_) {
+      return;
+    }
+    page_cleaner_running_ = false;
+    page_cleaner_cv_.notify_all();
+  }
+
+  page_cleaner_->join();
+  page_cleaner_.reset();
+  free_frame_target_.store(0);
+  LOG_INFO("page cleaner stopped");
+}
+
+void BufferPoolManager::notify_page_cleaner()
+{
+  if (frame_manager_.free_frame_num() < static_cast<size_t>(free_frame_target_.load())) {
+    page_cleaner_cv_.notify_one();
+  }
+}
+
+void BufferPoolManager::page_cleaner_func()
+{
+  thread_set_name("PageCleaner");
+
+  unique_lock<mutex> lock(page_cleaner_lock_);
+  while (page_cleaner_running_) {
+    const size_t target   = static_cast<size_t>(free_frame_target_.load());
+    const size_t free_num = frame_manager_.free_frame_num();
+    int          cleaned  = 0;
+    if (free_num < target) {
+      lock.unlock();
+      RC rc = clean_frames(static_cast<int>(target - free_num), cleaned);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to clean frames. rc=%s", strrc(rc));
+      }
+      lock.lock();
+    }
+
+    // 没有可以清理的页面时(比如所有页面都在使用中)，等一会再试
+    if (cleaned == 0 && page_cleaner_running_) {
+      page_cleaner_cv_.wait_for(lock, PAGE_CLEANER_INTERVAL);
+    }
+  }
+}
+
+RC BufferPoolManager::start_read_ahead(int thread_num /* = 2 */)
+{
+  lock_guard<mutex> guard(read_ahead_lock_);
+  if (read_ahead_running_) {
+    LOG_WARN("read ahead threads have been started");
+    return RC::INTERNAL;
+  }
+
+  read_ahead_running_ = true;
+  for (int i = 0; i < max(thread_num, 1); i++) {
+    read_ahead_threads_.emplace_back(&BufferPoolManager::read_ahead_func, this);
+  }
+  LOG_INFO("read ahead threads started. thread num=%d", static_cast<int>(read_ahead_threads_.size()));
+  return RC::SUCCESS;
+}
+
+void BufferPoolManager::stop_read_ahead()
+{
+  {
+    lock_guard<mutex> guard(read_ahead_lock_);
+    if (!read_ahead_running_) {
+      return;
+    }
+    read_ahead_running_ = false;
+    read_ahead_queue_.clear();
+    read_ahead_cv_.notify_all();
+  }
+
+  for (thread &read_ahead_thread : read_ahead_threads_) {
+    read_ahead_thread.join();
+  }
+  read_ahead_threads_.clear();
+  LOG_INFO("read ahead threads stopped");
+}
+
+void BufferPoolManager::read_ahead(int32_t buffer_pool_id, span<const PageNum> page_nums)
+{
+  lock_guard<mutex> guard(read_ahead_lock_);
+  if (!read_ahead_running_) {
+    return;
+  }
+
+  for (PageNum page_num : page_nums) {
+    if (read_ahead_queue_.size() >= MAX_READ_AHEAD_PENDING) {
+      break;
+    }
+    read_ahead_queue_.emplace_back(buffer_pool_id, page_num);
+  }
+  read_ahead_cv_.notify_all();
+}
+
+void BufferPoolManager::read_ahead_func()
+{
+  thread_set_name("ReadAhead");
+
+  unique_lock<mutex> lock(read_ahead_lock_);
+  while (true) {
+    read_ahead_cv_.wait(lock, [this]() { return !read_ahead_running_ || !read_ahead_queue_.empty(); });
+    if (!read_ahead_running_) {
+      break;
+    }
+
+    const FrameId frame_id = read_ahead_queue_.front();
+    read_ahead_queue_.pop_front();
+    lock.unlock();
+
+    {
+      // 预读线程之间、预读与页面清理之间不需要互斥，只要保证预读时buffer pool不会被关闭
+      shared_lock<shared_mutex> close_guard(read_ahead_close_lock_);
+
+      DiskBufferPool *bp = nullptr;
+      if (OB_SUCC(get_buffer_pool(frame_id.buffer_pool_id(), bp))) {
+        RC rc = bp->read_ahead_page(frame_id.page_num());
+        if (OB_FAIL(rc)) {
+          LOG_WARN("failed to read ahead page. frame id=%s, rc=%s", frame_id.to_string().c_str(), strrc(rc));
+        }
+      }
+    }
+
+    lock.lock();
+  }
+}
+
+RC BufferPoolManager::clean_frames(int count, int &cleaned)
+{
+  cleaned = 0;
+
+  lock_guard<mutex> clean_guard(clean_lock_);
+
+  vector<Frame *> frames = frame_manager_.find_purge_candidates(count);
+
+  // 按照recLSN从小到大刷页面，等待日志落盘(WAL)时LSN也是递增的，前面的等待可以覆盖后面的页面
+  sort(frames.begin(), frames.end(), [](Frame *left, Frame *right) { return left->rec_lsn() < right->rec_lsn(); });
+
+  RC  rc      = RC::SUCCESS;
+  int flushed = 0;
+  for (Frame *frame : frames) {
+    // 拿到读锁后，就没有其它线程在修改这个页面了。拿不到锁说明页面正在被使用，跳过即可
+    if (OB_SUCC(rc) && frame->dirty() && frame->try_read_latch()) {
+      DiskBufferPool *bp = nullptr;
+      rc                 = get_buffer_pool(frame->buffer_pool_id(), bp);
+      if (OB_SUCC(rc)) {
+        // 页面会先写到 double write buffer 中，攒够一批之后再一起写到磁盘
+        rc = bp->try_flush_page(*frame);
+      }
+
+      if (OB_SUCC(rc)) {
+        flushed++;
+      } else if (rc == RC::LOCKED_NEED_WAIT) {
+        // buffer pool 正忙，跳过这个页面，下一轮再刷
+        rc = RC::SUCCESS;
+      } else {
+        LOG_WARN("failed to flush page. frame=%s, rc=%s", frame->to_string().c_str(), strrc(rc));
+      }
+      frame->read_unlatch();
+    }
+
+    if (frame_manager_.free_if_clean(frame)) {
+      cleaned++;
+    }
+  }
+
+  buffer_pool_metrics().flushed_pages.inc(flushed);
+  LOG_DEBUG("clean frames done. candidates=%ld, flushed=%d, cleaned=%d", frames.size(), flushed, cleaned);
+  return rc;
+}
+
 RC BufferPoolManager::get_buffer_pool(int32_t id, DiskBufferPool *&bp)
 {
   bp = nullptr;
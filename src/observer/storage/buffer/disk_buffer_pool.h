@@ -26,10 +26,16 @@ See the Mulan PSL v2 for more details. */
 #include <optional>
 
 #include "common/lang/bitmap.h"
-#include "common/lang/lru_cache.h"
+#include "common/lang/chrono.h"
+#include "common/lang/deque.h"
+#include "common/lang/segmented_lru_cache.h"
+#include "common/lang/span.h"
+#include "common/lang/vector.h"
 #include "common/lang/mutex.h"
 #include "common/lang/memory.h"
+#include "common/lang/thread.h"
 #include "common/lang/unordered_map.h"
+#include "common/lang/unordered_set.h"
 #include "common/mm/mem_pool.h"
 #include "common/rc.h"
 #include "common/types.h"
@@ -83,11 +89,16 @@ struct BPFileHeader
  * 当内存中的页帧不够用时，需要从内存中淘汰一些页帧，以便为新的页帧腾出空间。
  * 这个管理器负责为所有的BufferPool提供页帧管理服务，也就是所有的BufferPool磁盘文件
  * 在访问时都使用这个管理器映射到内存。
+ *
+ * 为了减少多线程访问时的锁冲突，页帧按照 FrameId 的哈希值划分到多个分片(shard)中，
+ * 每个分片有自己的锁和淘汰链表，不同分片上的页面访问互不影响。
+ * 每个分片使用分段LRU(SegmentedLruCache)作为淘汰策略，全表扫描这种只访问一次的页面
+ * 会优先被淘汰，不会把B+树内部节点等热点页面挤出内存。
  */
 class BPFrameManager
 {
 public:
-  BPFrameManager(const char *tag);
+  BPFrameManager(const char *tag, int shard_num = DEFAULT_SHARD_NUM);
 
   RC init(int pool_num);
   RC cleanup();
@@ -109,14 +120,31 @@ public:
    */
   list<Frame *> find_list(int buffer_pool_id);
 
+  /**
+   * @brief 列出recLSN比指定LSN小的脏页
+   * @details 没有recLSN的脏页也会返回。返回的页帧都增加了引用计数，使用完后需要unpin
+   * @param lsn 只返回recLSN小于这个值的页面
+   * @param max_count 最多返回多少个页面。固定的页帧不能淘汰，一次固定太多时其它线程可能分配不到页帧
+   * @param excluded 不需要返回的页帧
+   */
+  list<Frame *> find_dirty_list(LSN lsn, int max_count, const unordered_set<Frame *> &excluded);
+
+  /**
+   * @brief 计算所有脏页中最小的recLSN
+   * @param[in,out] lsn 如果有脏页的recLSN比它小，就修改为这个recLSN
+   * @return 如果有页面已经变脏但还没有设置LSN(正在修改中)，返回 LOCKED_NEED_WAIT，这时无法确定检查点
+   */
+  RC min_rec_lsn(LSN &lsn);
+
   /**
    * @brief 分配一个新的页面
    *
    * @param buffer_pool_id buffer Pool标识
    * @param page_num 页面编号
+   * @param write_latched 新分配的页帧在对其它线程可见之前先加上写锁，加载完页面数据后由调用者释放
    * @return Frame* 页帧指针
    */
-  Frame *alloc(int buffer_pool_id, PageNum page_num);
+  Frame *alloc(int buffer_pool_id, PageNum page_num, bool write_latched = false);
 
   /**
    * 尽管frame中已经包含了buffer_pool_id和page_num，但是依然要求
@@ -127,22 +155,42 @@ public:
   /**
    * 如果不能从空闲链表中分配新的页面，就使用这个接口，
    * 尝试从pin count=0的页面中淘汰一些
+   * @details 从一个轮转的分片开始查找可以淘汰的页面，当前分片不够时再查找下一个分片。
    * @param count 想要purge多少个页面
    * @param purger 需要在释放frame之前，对页面做些什么操作。当前是刷新脏数据到磁盘
    * @return 返回本次清理了多少个页面
    */
   int purge_frames(int count, function<RC(Frame *frame)> purger);
 
-  size_t frame_num() const { return frames_.count(); }
+  /**
+   * @brief 从淘汰链表的尾部开始，找出一些可以淘汰的页面
+   * @details 与 purge_frames 不同，这里只是把页面找出来，不会在分片的锁内刷脏页。
+   * 返回的页帧都增加了引用计数，使用完后需要调用 free_if_clean 或者 unpin。
+   * @param count 最多找多少个页面
+   */
+  vector<Frame *> find_purge_candidates(int count);
+
+  /**
+   * @brief 如果页面没有其它线程在使用，并且不是脏页，就释放掉这个页帧
+   * @details frame 需要是 find_purge_candidates 返回的页帧，无论是否释放成功，调用者都不能再使用它
+   * @return 是否释放了页帧
+   */
+  bool free_if_clean(Frame *frame);
+
+  size_t frame_num() const { return frame_num_.load(); }
+
+  /// 还可以分配多少个页帧
+  size_t free_frame_num() const { return total_frame_num() - frame_num(); }
 
   /**
    * 测试使用。返回已经从内存申请的个数
    */
   size_t total_frame_num() const { return allocator_.get_size(); }
 
-private:
-  Frame *get_internal(const FrameId &frame_id);
-  RC     free_internal(const FrameId &frame_id, Frame *frame);
+  int shard_num() const { return static_cast<int>(shards_.size()); }
+
+public:
+  static constexpr int DEFAULT_SHARD_NUM = 16;
 
 private:
   class BPFrameIdHasher
@@ -151,32 +199,71 @@ private:
     size_t operator()(const FrameId &frame_id) const { return frame_id.hash(); }
   };
 
-  using FrameLruCache  = common::LruCache<FrameId, Frame *, BPFrameIdHasher>;
+  using FrameLruCache  = common::SegmentedLruCache<FrameId, Frame *, BPFrameIdHasher>;
   using FrameAllocator = common::MemPoolSimple<Frame>;
 
-  mutex          lock_;
-  FrameLruCache  frames_;
-  FrameAllocator allocator_;
+  /**
+   * @brief 页帧分片
+   * @details 分片内部的操作都需要加分片自己的锁
+   */
+  struct FrameShard
+  {
+    mutex         lock;
+    FrameLruCache frames;
+  };
+
+private:
+  FrameShard &shard_of(const FrameId &frame_id);
+
+  Frame *get_internal(FrameShard &shard, const FrameId &frame_id);
+  RC     free_internal(FrameShard &shard, const FrameId &frame_id, Frame *frame);
+  int    purge_shard_frames(FrameShard &shard, int count, function<RC(Frame *frame)> &purger);
+
+private:
+  vector<FrameShard> shards_;
+  atomic<size_t>     frame_num_{0};     /// 所有分片中页帧的个数
+  atomic<size_t>     purge_cursor_{0};  /// 下次淘汰时从哪个分片开始查找
+  FrameAllocator     allocator_;
 };
 
 /**
  * @brief 用于遍历BufferPool中的所有页面
  * @ingroup BufferPool
+ * @details 可以指定预读的页面数，遍历时会把后面的页面提前交给预读线程加载。
+ * 已经预读的页面消耗了一半之后，再预读下一批，这样IO和处理当前页面可以同时进行。
  */
 class BufferPoolIterator
 {
+public:
+  /// 顺序扫描时默认预读的页面数
+  static constexpr int DEFAULT_READ_AHEAD_PAGES = 16;
+
 public:
   BufferPoolIterator();
   ~BufferPoolIterator();
 
-  RC      init(DiskBufferPool &bp, PageNum start_page = 0);
+  /**
+   * @param bp               遍历的buffer pool
+   * @param start_page       从哪个页面开始遍历
+   * @param read_ahead_pages 每次预读的页面数，0表示不预读
+   */
+  RC      init(DiskBufferPool &bp, PageNum start_page = 0, int read_ahead_pages = 0);
   bool    has_next();
   PageNum next();
   RC      reset();
 
 private:
-  common::Bitmap bitmap_;
-  PageNum        current_page_num_ = -1;
+  /**
+   * @brief 预读已经预读过的页面之后的 read_ahead_pages_ 个页面
+   */
+  void read_ahead();
+
+private:
+  common::Bitmap  bitmap_;
+  PageNum         current_page_num_    = -1;
+  DiskBufferPool *buffer_pool_         = nullptr;
+  int             read_ahead_pages_    = 0;
+  PageNum         read_ahead_page_num_ = -1;  ///< 已经提交预读的最大页面编号
 };
 
 /**
@@ -250,6 +337,13 @@ public:
    */
   RC flush_page(Frame &frame);
 
+  /**
+   * @brief 与 flush_page 相同，但是拿不到 buffer pool 的锁时直接返回 RC::LOCKED_NEED_WAIT
+   * @details 页面清理线程会 pin 住一批页面再刷盘。前台线程分配页帧时持有 buffer pool 的锁，
+   * 如果清理线程在这里等锁，前台线程就可能因为找不到可以淘汰的页面而一直等下去。
+   */
+  RC try_flush_page(Frame &frame);
+
   /**
    * 刷新所有页面到double write buffer，即使pin count不是0
    */
@@ -265,6 +359,23 @@ public:
    */
   RC write_page(PageNum page_num, Page &page);
 
+  /**
+   * @brief 把指定的页面交给后台预读线程，异步加载到内存中
+   * @details 预读只是一个提示，不保证页面一定会被加载。已经在内存中的页面会被跳过，
+   * 没有启动预读线程或者预读队列已满时直接忽略。
+   */
+  void read_ahead(span<const PageNum> page_nums);
+
+  /**
+   * @brief 如果页面不在内存中，就把它加载到内存中。由预读线程调用
+   */
+  RC read_ahead_page(PageNum page_num);
+
+  /**
+   * @brief 把write_page写入的数据持久化到磁盘(fsync)
+   */
+  RC sync_file();
+
   RC redo_allocate_page(LSN lsn, PageNum page_num);
   RC redo_deallocate_page(LSN lsn, PageNum page_num);
 
@@ -273,8 +384,14 @@ public:
 
   const char *filename() const { return file_name_.c_str(); }
 
+  /// 已经分配的页面数，包括文件头页面
+  int32_t allocated_pages() const { return file_header_->allocated_pages; }
+
+  /// 文件中的页面数，包括文件头页面和已经释放的页面
+  int32_t page_count() const { return file_header_->page_count; }
+
 protected:
-  RC allocate_frame(PageNum page_num, Frame **buf);
+  RC allocate_frame(PageNum page_num, Frame **buf, bool write_latched = false);
 
   /**
    * 刷新指定页面到磁盘(flush)，并且释放关联的Frame
@@ -332,6 +449,61 @@ public:
 
   RC flush_page(Frame &frame);
 
+  /**
+   * @brief 把recLSN比指定LSN小的脏页刷出去
+   * @details 做检查点时使用，不会阻塞正在修改页面的线程：拿不到页面读锁或者 buffer pool 正忙的页面会被跳过，
+   * 检查点根据剩下的脏页计算位置。每次只固定一批页帧，避免分配页帧的线程等待被固定的页面。
+   * 处理每批页面时与关闭文件互斥，可以与删除索引、删除表并发执行。
+   * @param lsn 刷新recLSN小于这个值的页面
+   * @param[out] count 刷出去了多少个页面
+   */
+  RC flush_pages_before(LSN lsn, int &count);
+
+  /**
+   * @brief 保证所有已经刷出去的页面都持久化到磁盘上
+   */
+  RC sync_pages();
+
+  /**
+   * @brief 启动后台页面清理线程
+   * @details 页帧用完时，分配页帧的线程需要淘汰一个页面，如果是脏页，就要同步刷到磁盘上。
+   * 清理线程在空闲页帧少于 free_frame_target 时，把淘汰链表尾部的页面按照recLSN从小到大刷出去并释放页帧，
+   * 让前台线程总是能够直接拿到空闲的页帧。
+   * @param free_frame_target 希望保持的空闲页帧个数，小于等于0时使用页帧总数的1/16
+   */
+  RC start_page_cleaner(int free_frame_target = 0);
+
+  /**
+   * @brief 停止后台页面清理线程
+   */
+  void stop_page_cleaner();
+
+  /**
+   * @brief 淘汰一批页面，脏页会先刷出去
+   * @details 页面清理线程调用，也可以在测试中直接调用
+   * @param count 最多淘汰多少个页面
+   * @param[out] cleaned 释放了多少个页帧
+   */
+  RC clean_frames(int count, int &cleaned);
+
+  /**
+   * @brief 空闲页帧不足时唤醒页面清理线程
+   */
+  void notify_page_cleaner();
+
+  /**
+   * @brief 启动后台预读线程
+   * @details 顺序扫描时，扫描器把接下来要访问的页面交给预读线程提前加载，
+   * 扫描线程处理当前页面的同时，后面页面的磁盘IO也在进行，不需要每个页面都同步等待一次读盘。
+   * @param thread_num 预读线程的个数
+   */
+  RC start_read_ahead(int thread_num = 2);
+
+  /**
+   * @brief 停止后台预读线程，还没有处理的预读请求会被丢弃
+   */
+  void stop_read_ahead();
+
   BPFrameManager    &get_frame_manager() { return frame_manager_; }
   DoubleWriteBuffer *get_dblwr_buffer() { return dblwr_buffer_.get(); }
 
@@ -344,6 +516,17 @@ public:
   RC get_buffer_pool(int32_t id, DiskBufferPool *&bp);
 
 private:
+  void page_cleaner_func();
+
+  /**
+   * @brief 提交预读请求，预读线程没有启动或者队列满了就丢弃
+   */
+  void read_ahead(int32_t buffer_pool_id, span<const PageNum> page_nums);
+  void read_ahead_func();
+
+private:
+  friend class DiskBufferPool;
+
   BPFrameManager frame_manager_{"BufPool"};
 
   unique_ptr<DoubleWriteBuffer> dblwr_buffer_;
@@ -352,4 +535,24 @@ private:
   unordered_map<string, DiskBufferPool *>  buffer_pools_;
   unordered_map<int32_t, DiskBufferPool *> id_to_buffer_pools_;
   atomic<int32_t>                          next_buffer_pool_id_{1};  // 系统启动时，会打开所有的表，这样就可以知道当前系统最大的ID是多少了
+
+  static constexpr int FLUSH_BATCH_SIZE = 16;  ///< 检查点刷脏页时每批固定的页帧数
+
+  static constexpr chrono::milliseconds PAGE_CLEANER_INTERVAL{100};  ///< 页面清理线程检查空闲页帧的间隔
+
+  unique_ptr<thread> page_cleaner_;                      ///< 页面清理线程
+  mutex              page_cleaner_lock_;                 ///< 保护 page_cleaner_running_
+  condition_variable page_cleaner_cv_;                   ///< 用于唤醒页面清理线程
+  bool               page_cleaner_running_ = false;      ///< 页面清理线程是否在运行
+  atomic<int>        free_frame_target_{0};              ///< 希望保持的空闲页帧个数
+  mutex              clean_lock_;  ///< 清理页面、检查点刷页面与关闭文件互斥，避免访问页面时buffer pool被删除
+
+  static constexpr size_t MAX_READ_AHEAD_PENDING = 1024;  ///< 预读队列中最多的请求数
+
+  vector<thread>     read_ahead_threads_;          ///< 预读线程
+  shared_mutex       read_ahead_close_lock_;       ///< 预读线程共享持有，关闭文件时独占，避免预读时buffer pool被删除
+  mutex              read_ahead_lock_;             ///< 保护预读队列
+  condition_variable read_ahead_cv_;               ///< 有新的预读请求时唤醒预读线程
+  deque<FrameId>     read_ahead_queue_;            ///< 等待加载的页面
+  bool               read_ahead_running_ = false;  ///< 预读线程是否在运行
 };
@@ -12,6 +12,8 @@ See the Mulan PSL v2 for more details. */
 // Created by Wenbin1002 on 2024/04/16
 //
 #include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
 #include <mutex>
 #include <algorithm>
@@ -46,7 +48,7 @@ const int32_t DoubleWritePage::SIZE = sizeof(DoubleWritePage);
 
 const int32_t DoubleWriteBufferHeader::SIZE = sizeof(DoubleWriteBufferHeader);
 
-DiskDoubleWriteBuffer::DiskDoubleWriteBuffer(BufferPoolManager &bp_manager, int max_pages /*=16*/) 
+DiskDoubleWriteBuffer::DiskDoubleWriteBuffer(BufferPoolManager &bp_manager, int max_pages /*=128*/)
   : max_pages_(max_pages), bp_manager_(bp_manager)
 {
 }
@@ -55,9 +57,7 @@ DiskDoubleWriteBuffer::~DiskDoubleWriteBuffer()
 {
   flush_page();
 
-  for (auto &node : dblwr_pages_) {
-    delete node.second;
-  }
+  clear_all_pages();
   close(file_desc_);
 }
 
@@ -80,19 +80,25 @@ RC DiskDoubleWriteBuffer::open_file(const char *filename)
 
 RC DiskDoubleWriteBuffer::flush_page()
 {
-  sync();
+  if (dblwr_pages_.empty()) {
+    return RC::SUCCESS;
+  }
 
-  for (const auto &pair : dblwr_pages_) {
-    RC rc = write_page(pair.second);
-    if (rc != RC::SUCCESS) {
-      return rc;
-    }
-    delete pair.second;
+  vector<DoubleWritePage *> pages = sorted_pages();
+
+  RC rc = write_batch(pages);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to write pages into double write buffer file. page count=%d, rc=%s",
+             static_cast<int>(pages.size()), strrc(rc));
+    return rc;
   }
 
-  dblwr_pages_.clear();
-  header_.page_cnt = 0;
+  rc = write_data_pages(pages);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
 
+  clear_all_pages();
   return RC::SUCCESS;
 }
 
@@ -105,35 +111,15 @@ RC DiskDoubleWriteBuffer::add_page(DiskBufferPool *bp, PageNum page_num, Page &p
     iter->second->page = page;
     LOG_TRACE("[cache hit]add page into double write buffer. buffer_pool_id:%d,page_num:%d,lsn=%d, dwb size=%d",
               bp->id(), page_num, page.lsn, static_cast<int>(dblwr_pages_.size()));
-    return write_page_internal(iter->second);
+    return RC::SUCCESS;
   }
 
-  int64_t          page_cnt   = dblwr_pages_.size();
-  DoubleWritePage *dblwr_page = new DoubleWritePage(bp->id(), page_num, page_cnt, page);
+  // 页面在文件中的位置在刷盘时才确定
+  DoubleWritePage *dblwr_page = new DoubleWritePage(bp->id(), page_num, -1, page);
   dblwr_pages_.insert(std::pair<DoubleWritePageKey, DoubleWritePage *>(key, dblwr_page));
   LOG_TRACE("insert page into double write buffer. buffer_pool_id:%d,page_num:%d,lsn=%d, dwb size:%d",
             bp->id(), page_num, page.lsn, static_cast<int>(dblwr_pages_.size()));
 
-  RC rc = write_page_internal(dblwr_page);
-  if (OB_FAIL(rc)) {
-    LOG_WARN("failed to write page into double write buffer. rc=%s buffer_pool_id:%d,page_num:%d,lsn=%d.",
-        strrc(rc), bp->id(), page_num, page.lsn);
-    return rc;
-  }
-
-  if (page_cnt + 1 > header_.page_cnt) {
-    header_.page_cnt = page_cnt + 1;
-    if (lseek(file_desc_, 0, SEEK_SET) == -1) {
-      LOG_ERROR("Failed to add page header due to failed to seek %s.", strerror(errno));
-      return RC::IOERR_SEEK;
-    }
-
-    if (writen(file_desc_, &header_, sizeof(header_)) != 0) {
-      LOG_ERROR("Failed to add page header due to %s.", strerror(errno));
-      return RC::IOERR_WRITE;
-    }
-  }
-
   if (static_cast<int>(dblwr_pages_.size()) >= max_pages_) {
     RC rc = flush_page();
     if (rc != RC::SUCCESS) {
@@ -145,33 +131,95 @@ RC DiskDoubleWriteBuffer::add_page(DiskBufferPool *bp, PageNum page_num, Page &p
   return RC::SUCCESS;
 }
 
-RC DiskDoubleWriteBuffer::write_page_internal(DoubleWritePage *page)
+vector<DoubleWritePage *> DiskDoubleWriteBuffer::sorted_pages() const
+{
+  vector<DoubleWritePage *> pages;
+  pages.reserve(dblwr_pages_.size());
+  for (const auto &pair : dblwr_pages_) {
+    pages.push_back(pair.second);
+  }
+
+  sort(pages.begin(), pages.end(), [](const DoubleWritePage *a, const DoubleWritePage *b) {
+    if (a->key.buffer_pool_id != b->key.buffer_pool_id) {
+      return a->key.buffer_pool_id < b->key.buffer_pool_id;
+    }
+    return a->key.page_num < b->key.page_num;
+  });
+  return pages;
+}
+
+RC DiskDoubleWriteBuffer::write_batch(const vector<DoubleWritePage *> &pages)
 {
-  int32_t page_index = page->page_index;
-  int64_t offset = page_index * DoubleWritePage::SIZE + DoubleWriteBufferHeader::SIZE;
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to add page %lld of %d due to failed to seek %s.", offset, file_desc_, strerror(errno));
+  header_.page_cnt = static_cast<int32_t>(pages.size());
+
+  vector<struct iovec> iovs(pages.size() + 1);
+  iovs[0].iov_base = &header_;
+  iovs[0].iov_len  = DoubleWriteBufferHeader::SIZE;
+  for (size_t i = 0; i < pages.size(); i++) {
+    pages[i]->page_index = static_cast<int32_t>(i);
+    iovs[i + 1].iov_base = pages[i];
+    iovs[i + 1].iov_len  = DoubleWritePage::SIZE;
+  }
+
+  if (lseek(file_desc_, 0, SEEK_SET) == -1) {
+    LOG_ERROR("Failed to write double write buffer due to failed to seek %s.", strerror(errno));
     return RC::IOERR_SEEK;
   }
 
-  if (writen(file_desc_, page, DoubleWritePage::SIZE) != 0) {
-    LOG_ERROR("Failed to add page %lld of %d due to %s.", offset, file_desc_, strerror(errno));
+  int ret = writevn(file_desc_, iovs.data(), static_cast<int>(iovs.size()));
+  if (ret != 0) {
+    LOG_ERROR("Failed to write double write buffer. fd=%d, page count=%d, error=%s",
+              file_desc_, header_.page_cnt, strerror(ret));
     return RC::IOERR_WRITE;
   }
 
+  if (fdatasync(file_desc_) != 0) {
+    LOG_ERROR("Failed to sync double write buffer. fd=%d, error=%s", file_desc_, strerror(errno));
+    return RC::IOERR_SYNC;
+  }
   return RC::SUCCESS;
 }
 
-RC DiskDoubleWriteBuffer::write_page(DoubleWritePage *dblwr_page)
+RC DiskDoubleWriteBuffer::write_data_pages(const vector<DoubleWritePage *> &pages)
 {
-  DiskBufferPool *disk_buffer = nullptr;
-  RC rc = bp_manager_.get_buffer_pool(dblwr_page->key.buffer_pool_id, disk_buffer);
-  ASSERT(OB_SUCC(rc) && disk_buffer != nullptr, "failed to get disk buffer pool of %d", dblwr_page->key.buffer_pool_id);
+  // 页面已经按照buffer pool排好序，同一个数据文件的页面是连续的
+  vector<DiskBufferPool *> buffer_pools;
+  for (DoubleWritePage *dblwr_page : pages) {
+    DiskBufferPool *disk_buffer = nullptr;
+    RC rc = bp_manager_.get_buffer_pool(dblwr_page->key.buffer_pool_id, disk_buffer);
+    ASSERT(OB_SUCC(rc) && disk_buffer != nullptr, "failed to get disk buffer pool of %d", dblwr_page->key.buffer_pool_id);
 
-  LOG_TRACE("double write buffer write page. buffer_pool_id:%d,page_num:%d,lsn=%d",
-            dblwr_page->key.buffer_pool_id, dblwr_page->key.page_num, dblwr_page->page.lsn);
+    LOG_TRACE("double write buffer write page. buffer_pool_id:%d,page_num:%d,lsn=%d",
+              dblwr_page->key.buffer_pool_id, dblwr_page->key.page_num, dblwr_page->page.lsn);
 
-  return disk_buffer->write_page(dblwr_page->key.page_num, dblwr_page->page);
+    rc = disk_buffer->write_page(dblwr_page->key.page_num, dblwr_page->page);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("Failed to write page %s:%d to disk buffer pool. rc=%s",
+               disk_buffer->filename(), dblwr_page->key.page_num, strrc(rc));
+      return rc;
+    }
+
+    if (buffer_pools.empty() || buffer_pools.back() != disk_buffer) {
+      buffer_pools.push_back(disk_buffer);
+    }
+  }
+
+  for (DiskBufferPool *disk_buffer : buffer_pools) {
+    RC rc = disk_buffer->sync_file();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+void DiskDoubleWriteBuffer::clear_all_pages()
+{
+  for (auto &node : dblwr_pages_) {
+    delete node.second;
+  }
+  dblwr_pages_.clear();
+  header_.page_cnt = 0;
 }
 
 RC DiskDoubleWriteBuffer::read_page(DiskBufferPool *bp, PageNum page_num, Page &page)
@@ -223,11 +271,29 @@ RC DiskDoubleWriteBuffer::clear_pages(DiskBufferPool *buffer_pool)
     }
   }
 
+  if (OB_SUCC(rc) && !spec_pages.empty()) {
+    rc = buffer_pool->sync_file();
+  }
+
   for_each(spec_pages.begin(), spec_pages.end(), [](DoubleWritePage *dbl_page) { delete dbl_page; });
 
   return RC::SUCCESS;
 }
 
+RC DiskDoubleWriteBuffer::flush_all()
+{
+  scoped_lock lock_guard(lock_);
+
+  RC rc = flush_page();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush pages in double write buffer. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  // flush_page 已经把涉及到的数据文件都fsync过了
+  return RC::SUCCESS;
+}
+
 RC DiskDoubleWriteBuffer::load_pages()
 {
   if (file_desc_ < 0) {
@@ -286,7 +352,17 @@ RC DiskDoubleWriteBuffer::load_pages()
 
 RC DiskDoubleWriteBuffer::recover()
 {
-  return flush_page();
+  scoped_lock lock_guard(lock_);
+
+  // 加载的页面都已经在double write buffer文件中持久化了，直接写入数据文件即可
+  RC rc = write_data_pages(sorted_pages());
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to recover pages from double write buffer. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  clear_all_pages();
+  return RC::SUCCESS;
 }
 
 ////////////////////////////////////////////////////////////////
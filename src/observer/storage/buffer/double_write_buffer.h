@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/lang/mutex.h"
 #include "common/lang/unordered_map.h"
+#include "common/lang/vector.h"
 #include "common/types.h"
 #include "common/rc.h"
 #include "storage/buffer/page.h"
@@ -41,6 +42,12 @@ public:
    * @brief 清空所有与指定buffer pool关联的页面
    */
   virtual RC clear_pages(DiskBufferPool *bp) = 0;
+
+  /**
+   * @brief 把所有页面写入数据文件，并保证已经持久化到磁盘上
+   * @details 做检查点时使用，检查点之前刷出去的页面必须都已经落盘
+   */
+  virtual RC flush_all() = 0;
 };
 
 struct DoubleWriteBufferHeader
@@ -79,8 +86,11 @@ struct DoubleWritePageKeyHash
  * DoubleWriteBuffer会先在一个共享磁盘文件中写入页面数据，在确定写入成功后，再写入真实的页面。
  * 当我们从磁盘中读取页面时，会校验页面的checksum，如果校验失败，则说明页面写入不完整，这时候可以从
  * DoubleWriteBuffer中读取数据。
+ * 页面先攒在内存中，攒够一批(max_pages)后，按照页面编号排序，用一次顺序写把整批页面写入共享文件并fsync，
+ * 然后再按顺序写入各个数据文件，每个数据文件只fsync一次。
  *
- * @note 每次都要保证，不管在内存中还是在文件中，这里的数据都是最新的，都比Buffer pool中的数据要新
+ * @note 内存中的页面总是最新的，都比Buffer pool中的数据要新。文件中只保存最近一次刷盘的那一批页面，
+ * 还在内存中的页面没有写入任何文件，崩溃后由日志恢复。
  */
 class DiskDoubleWriteBuffer : public DoubleWriteBuffer
 {
@@ -89,9 +99,9 @@ public:
    * @brief 构造函数
    *
    * @param bp_manager 关联的buffer pool manager
-   * @param max_pages  内存中保存的最大页面数
+   * @param max_pages  内存中保存的最大页面数，也就是一次批量刷盘的页面数
    */
-  DiskDoubleWriteBuffer(BufferPoolManager &bp_manager, int max_pages = 16);
+  DiskDoubleWriteBuffer(BufferPoolManager &bp_manager, int max_pages = 128);
   virtual ~DiskDoubleWriteBuffer();
 
   /**
@@ -101,12 +111,13 @@ public:
 
   /**
    * 将buffer中的页全部写入磁盘，并且清空buffer
+   * @details 先把整批页面顺序写入共享表空间并fsync，再按页面顺序写入数据文件，每个数据文件fsync一次。
    * TODO 目前的解决方案是等buffer装满后再刷盘，可能会导致程序卡住一段时间
    */
   RC flush_page();
 
   /**
-   * 将页面加入buffer，并且写入磁盘中的共享表空间
+   * 将页面加入buffer，buffer满了之后整批写入磁盘
    */
   RC add_page(DiskBufferPool *bp, PageNum page_num, Page &page) override;
 
@@ -117,6 +128,8 @@ public:
    */
   RC clear_pages(DiskBufferPool *bp) override;
 
+  RC flush_all() override;
+
   /**
    * 将共享表空间的页读入buffer
    */
@@ -124,16 +137,26 @@ public:
 
 private:
   /**
-   * 将buffer中的页面写入对应的磁盘
+   * @brief 取出buffer中的所有页面，按照(buffer_pool_id, page_num)排序
+   */
+  vector<DoubleWritePage *> sorted_pages() const;
+
+  /**
+   * @brief 把一批页面用一次顺序写写到当前double write buffer文件中，并fsync
+   * @details 文件头中的页面数与这批页面一起写入，页面在文件中的位置就是它在这批页面中的下标
+   */
+  RC write_batch(const vector<DoubleWritePage *> &pages);
+
+  /**
+   * @brief 将一批页面写入对应的数据文件，每个涉及到的数据文件最后fsync一次
+   * @param pages 已经排好序的页面
    */
-  RC write_page(DoubleWritePage *page);
+  RC write_data_pages(const vector<DoubleWritePage *> &pages);
 
   /**
-   * 将页面写到当前double write buffer文件中
-   * @details 每次页面更新都应该写入到磁盘中。保证double write buffer
-   * 内存和文件中的数据都是最新的。
+   * @brief 释放buffer中的所有页面
    */
-  RC write_page_internal(DoubleWritePage *page);
+  void clear_all_pages();
 
   /**
    * @brief 将磁盘文件中的内容加载到内存中。在启动时调用
@@ -166,4 +189,6 @@ public:
    * @brief 清空所有与指定buffer pool关联的页面
    */
   RC clear_pages(DiskBufferPool *bp) override { return RC::SUCCESS; }
+
+  RC flush_all() override { return RC::SUCCESS; }
 };
@@ -75,7 +75,7 @@ public:
    * @details 在 MemPoolSimple 分配和释放一个Frame对象时，不会调用构造函数和析构函数，
    * 而是调用reinit和reset。
    */
-  void reinit() {}
+  void reinit() { rec_lsn_.store(0); }
   void reset() {}
 
   void clear_page() { memset(&page_, 0, sizeof(page_)); }
@@ -104,7 +104,19 @@ public:
    * 序列号要小，那就可以从日志中读取这些更大序列号的日志，做重做操作，将页面恢复到最新状态，也就是redo。
    */
   LSN  lsn() const { return page_.lsn; }
-  void set_lsn(LSN lsn) { page_.lsn = lsn; }
+  void set_lsn(LSN lsn)
+  {
+    page_.lsn = lsn;
+    LSN zero  = 0;
+    rec_lsn_.compare_exchange_strong(zero, lsn);
+  }
+
+  /**
+   * @brief 页面变脏之后第一条修改日志的LSN(recLSN)
+   * @details 比它小的日志对这个页面来说都已经落盘了，不需要再重做。
+   * 所有脏页中最小的recLSN就是做检查点时可以使用的LSN。页面刷盘后会清零。
+   */
+  LSN rec_lsn() const { return rec_lsn_.load(); }
 
   /**
    * @brief 页面校验和
@@ -132,7 +144,11 @@ public:
    * @brief 重置“脏”标记
    * @details 如果页面已经被写入磁盘文件，则应调用此函数。
    */
-  void clear_dirty() { dirty_ = false; }
+  void clear_dirty()
+  {
+    dirty_ = false;
+    rec_lsn_.store(0);
+  }
   bool dirty() const { return dirty_; }
 
   char *data() { return page_.data; }
@@ -172,6 +188,7 @@ private:
   friend class BufferPool;
 
   bool          dirty_ = false;
+  atomic<LSN>   rec_lsn_{0};
   atomic<int>   pin_count_{0};
   unsigned long acc_time_ = 0;
   FrameId       frame_id_;
@@ -51,6 +51,12 @@ RC DiskLogHandler::stop()
 
   running_.store(false);
 
+  {
+    lock_guard<mutex> guard(flush_mutex_);
+    flush_cv_.notify_all();
+    flushed_cv_.notify_all();
+  }
+
   LOG_INFO("log handler stopped");
   return RC::SUCCESS;
 }
@@ -89,6 +95,11 @@ RC DiskLogHandler::replay(LogReplayer &replayer, LSN start_lsn)
     return rc;
   }
 
+  // 检查点之前的日志都已经落盘，但是日志文件可能已经被删除了，检查点之后也可能一条日志都没有
+  if (start_lsn > 0 && max_lsn < start_lsn - 1) {
+    max_lsn = start_lsn - 1;
+  }
+
   rc = entry_buffer_.init(max_lsn);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to init log entry buffer. rc=%s", strrc(rc));
@@ -99,6 +110,16 @@ RC DiskLogHandler::replay(LogReplayer &replayer, LSN start_lsn)
   return rc;
 }
 
+RC DiskLogHandler::truncate(LSN lsn)
+{
+  RC rc = file_manager_.remove_files_before(lsn);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to remove clog files. lsn=%ld, rc=%s", lsn, strrc(rc));
+    return rc;
+  }
+  return RC::SUCCESS;
+}
+
 RC DiskLogHandler::iterate(function<RC(LogEntry&)> consumer, LSN start_lsn)
 {
   vector<string> log_files;
@@ -133,27 +154,43 @@ RC DiskLogHandler::iterate(function<RC(LogEntry&)> consumer, LSN start_lsn)
   return RC::SUCCESS;
 }
 
-RC DiskLogHandler::_append(LSN &lsn, LogModule module, vector<char> &&data)
+RC DiskLogHandler::_append(LSN &lsn, LogModule module, span<const char> data)
 {
   ASSERT(running_.load(), "log handler is not running. lsn=%ld, module=%s, size=%d", 
         lsn, module.name(), data.size());
 
-  RC rc = entry_buffer_.append(lsn, module, std::move(data));
+  RC rc = entry_buffer_.append(lsn, module, data);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to append log entry to buffer. rc=%s", strrc(rc));
     return rc;
   }
 
+  if (entry_buffer_.bytes() >= flush_bytes_threshold_) {
+    // 这里不加锁，即使错过了唤醒，刷盘线程也会在超时后刷新日志
+    flush_cv_.notify_one();
+  }
   return RC::SUCCESS;
 }
 
+void DiskLogHandler::set_group_commit_options(chrono::microseconds group_commit_delay, int64_t flush_bytes_threshold)
+{
+  group_commit_delay_    = group_commit_delay;
+  flush_bytes_threshold_ = flush_bytes_threshold;
+}
+
 RC DiskLogHandler::wait_lsn(LSN lsn)
 {
-  // 直接强制等待。在生产系统中，我们可能会使用条件变量来等待。
-  while (running_.load() && current_flushed_lsn() < lsn) {
-    this_thread::sleep_for(chrono::milliseconds(100));
+  if (current_flushed_lsn() >= lsn) {
+    return RC::SUCCESS;
   }
 
+  unique_lock<mutex> lock(flush_mutex_);
+  if (lsn > waiting_lsn_) {
+    waiting_lsn_ = lsn;
+  }
+  flush_cv_.notify_one();
+  flushed_cv_.wait(lock, [this, lsn]() { return !running_.load() || current_flushed_lsn() >= lsn; });
+
   if (current_flushed_lsn() >= lsn) {
     return RC::SUCCESS;
   } else {
@@ -161,12 +198,27 @@ RC DiskLogHandler::wait_lsn(LSN lsn)
   }
 }
 
+void DiskLogHandler::wait_for_flush_request()
+{
+  unique_lock<mutex> lock(flush_mutex_);
+  flush_cv_.wait_for(lock, idle_flush_interval_, [this]() {
+    return !running_.load() || waiting_lsn_ > current_flushed_lsn() ||
+           entry_buffer_.bytes() >= flush_bytes_threshold_;
+  });
+}
+
+void DiskLogHandler::notify_flushed()
+{
+  lock_guard<mutex> guard(flush_mutex_);
+  flushed_cv_.notify_all();
+}
+
 void DiskLogHandler::thread_func()
 {
   /*
-  这个线程一直不停的循环，检查日志缓冲区中是否有日志在内存中，如果在内存中就刷新到磁盘。
-  这种做法很粗暴简单，与生产数据库的做法不同。生产数据库通常会在内存达到一定量，或者一定时间
-  之后，会刷新一下磁盘。这样做的好处是减少磁盘的IO次数，提高性能。
+  这个线程平时在条件变量上等待，有事务等待日志落盘或者缓冲区中的日志比较多时被唤醒，
+  没有被唤醒时也会定期醒来刷新一下。每次刷新都会把缓冲区中所有的日志一起写入，并且只刷一次盘，
+  这样多个并发提交的事务可以共享一次IO，也就是组提交(group commit)。
   */
   thread_set_name("LogHandler");
   LOG_INFO("log handler thread started");
@@ -190,6 +242,13 @@ void DiskLogHandler::thread_func()
         continue;
       }
       LOG_INFO("open log file success. file=%s", file_writer.to_string().c_str());
+    } else {
+      wait_for_flush_request();
+
+      if (group_commit_delay_.count() > 0 && running_.load()) {
+        // 稍微等待一下，让更多的事务加入到这次提交中
+        this_thread::sleep_for(group_commit_delay_);
+      }
     }
 
     int flush_count = 0;
@@ -198,11 +257,11 @@ void DiskLogHandler::thread_func()
       LOG_WARN("failed to flush log entry buffer. rc=%s", strrc(rc));
     }
 
-    if (flush_count == 0 && rc == RC::SUCCESS) {
-      this_thread::sleep_for(chrono::milliseconds(100));
-      continue;
+    if (flush_count > 0) {
+      notify_flushed();
     }
   }
 
+  notify_flushed();
   LOG_INFO("log handler thread stopped");
 }
@@ -20,6 +20,8 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/deque.h"
 #include "common/lang/memory.h"
 #include "common/lang/thread.h"
+#include "common/lang/mutex.h"
+#include "common/lang/chrono.h"
 #include "storage/clog/log_module.h"
 #include "storage/clog/log_file.h"
 #include "storage/clog/log_buffer.h"
@@ -31,7 +33,10 @@ class LogReplayer;
  * @brief 对外提供服务的CLog模块
  * @ingroup CLog
  * @details 该模块负责日志的写入、读取、回放等功能。
- * 会在后台开启一个线程，一直尝试刷新内存中的日志到磁盘。
+ * 会在后台开启一个线程，负责把内存中的日志刷新到磁盘。
+ * 刷盘线程使用组提交(group commit)的方式工作：有事务等待日志落盘(wait_lsn)或者缓冲区中的日志
+ * 超过一定大小时，立即被唤醒，把缓冲区中所有的日志一次写入并刷盘，然后唤醒所有已经落盘的等待者。
+ * 没有事务等待时，每隔一段时间刷新一次。
  * 所有的CLog日志文件都存放在指定的目录下，每个日志文件按照日志条数来划分。
  * 调用的顺序应该是：
  * @code {.cpp}
@@ -77,6 +82,7 @@ public:
    * @brief 回放日志
    * @details 日志回放后，会记录当前日志的最新状态，包括当前最大的LSN。
    * 所以这个接口应该在启动之前调用一次。
+   * start_lsn 是检查点的LSN，它之前的日志都已经落盘了，所以当前最大的LSN至少是start_lsn-1。
    * @param replayer 回放日志接口
    * @param start_lsn 从哪个位置开始回放
    */
@@ -102,6 +108,20 @@ public:
   /// @brief 当前刷新到哪个日志
   LSN current_flushed_lsn() const { return entry_buffer_.flushed_lsn(); }
 
+  /**
+   * @brief 删除所有日志都比lsn小的日志文件
+   * @details 正在写的日志文件不会删除
+   */
+  RC truncate(LSN lsn) override;
+
+  /**
+   * @brief 设置组提交的参数
+   * @details 需要在start之前调用
+   * @param group_commit_delay 刷盘线程被唤醒后先等待这么久再刷盘，让更多的事务一起提交。0表示不等待
+   * @param flush_bytes_threshold 缓冲区中的日志超过这么多字节时，即使没有人等待也立即刷盘
+   */
+  void set_group_commit_options(chrono::microseconds group_commit_delay, int64_t flush_bytes_threshold);
+
 private:
   /**
    * @brief 在缓存中增加一条日志
@@ -110,7 +130,7 @@ private:
    * @param[in] module  日志模块
    * @param[in] data    日志数据。具体的数据由各个模块自己定义
    */
-  RC _append(LSN &lsn, LogModule module, vector<char> &&data) override;
+  RC _append(LSN &lsn, LogModule module, span<const char> data) override;
 
 private:
   /**
@@ -118,10 +138,28 @@ private:
    */
   void thread_func();
 
+  /**
+   * @brief 刷盘线程等待被唤醒
+   * @details 有人等待日志落盘、缓冲区中的日志过多、超时或者停止时返回
+   */
+  void wait_for_flush_request();
+
+  /// @brief 唤醒所有等待日志落盘的线程
+  void notify_flushed();
+
 private:
   unique_ptr<thread> thread_;          /// 刷新日志的线程
   atomic_bool        running_{false};  /// 是否还要继续运行
 
+  mutex              flush_mutex_;
+  condition_variable flush_cv_;        /// 用来唤醒刷盘线程
+  condition_variable flushed_cv_;      /// 用来唤醒等待日志落盘的线程
+  LSN                waiting_lsn_ = 0; /// 等待落盘的最大LSN，由 flush_mutex_ 保护
+
+  chrono::microseconds group_commit_delay_{0};                  /// 组提交时刷盘前的等待时间
+  int64_t              flush_bytes_threshold_ = 1024 * 1024;     /// 缓冲区中日志超过这个大小就立即刷盘
+  chrono::milliseconds idle_flush_interval_{100};                /// 没有人等待时的刷盘间隔
+
   LogFileManager file_manager_;  /// 管理所有的日志文件
   LogEntryBuffer entry_buffer_;  /// 缓存日志
 
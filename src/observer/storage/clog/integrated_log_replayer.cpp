@@ -13,36 +13,186 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "storage/clog/integrated_log_replayer.h"
+#include "common/lang/serializer.h"
+#include "common/thread/thread_util.h"
 #include "storage/clog/log_entry.h"
 
-IntegratedLogReplayer::IntegratedLogReplayer(BufferPoolManager &bpm)
+using namespace common;
+
+IntegratedLogReplayer::IntegratedLogReplayer(BufferPoolManager &bpm, int worker_num /*= 1*/)
     : buffer_pool_log_replayer_(bpm),
       record_log_replayer_(bpm),
       bplus_tree_log_replayer_(bpm),
       trx_log_replayer_(nullptr)
-{}
+{
+  start_workers(worker_num);
+}
 
-IntegratedLogReplayer::IntegratedLogReplayer(BufferPoolManager &bpm, unique_ptr<LogReplayer> trx_log_replayer)
+IntegratedLogReplayer::IntegratedLogReplayer(
+    BufferPoolManager &bpm, unique_ptr<LogReplayer> trx_log_replayer, int worker_num /*= 1*/)
     : buffer_pool_log_replayer_(bpm),
       record_log_replayer_(bpm),
       bplus_tree_log_replayer_(bpm),
       trx_log_replayer_(std::move(trx_log_replayer))
-{}
+{
+  start_workers(worker_num);
+}
+
+IntegratedLogReplayer::~IntegratedLogReplayer() { (void)stop_workers(); }
+
+void IntegratedLogReplayer::start_workers(int worker_num)
+{
+  // 只有一个线程时，没有必要再启动额外的线程，直接在调用者线程中回放
+  if (worker_num <= 1) {
+    return;
+  }
+
+  for (int i = 0; i < worker_num; i++) {
+    workers_.push_back(make_unique<ReplayWorker>());
+  }
+  for (auto &worker : workers_) {
+    worker->worker = thread(&IntegratedLogReplayer::worker_func, this, worker.get());
+  }
+  LOG_INFO("start log replay workers. worker num=%d", worker_num);
+}
+
+void IntegratedLogReplayer::worker_func(ReplayWorker *worker)
+{
+  thread_set_name("LogReplayer");
+
+  while (true) {
+    LogEntry entry;
+    {
+      unique_lock<mutex> guard(worker->lock);
+      worker->not_empty.wait(guard, [worker] { return !worker->entries.empty() || worker->stopped; });
+      if (worker->entries.empty()) {
+        break;  // stopped
+      }
+
+      entry = std::move(worker->entries.front());
+      worker->entries.pop_front();
+    }
+    worker->not_full.notify_one();
+
+    // 出现错误后，后面的日志已经没有回放的意义了，只需要把队列清空即可
+    if (worker_rc_.load() != RC::SUCCESS) {
+      continue;
+    }
+
+    RC rc = replay_page_entry(entry);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to replay log entry. entry=%s, rc=%s", entry.to_string().c_str(), strrc(rc));
+      RC expected = RC::SUCCESS;
+      worker_rc_.compare_exchange_strong(expected, rc);
+    }
+  }
+}
+
+RC IntegratedLogReplayer::stop_workers()
+{
+  for (auto &worker : workers_) {
+    lock_guard<mutex> guard(worker->lock);
+    worker->stopped = true;
+    worker->not_empty.notify_all();
+  }
+
+  for (auto &worker : workers_) {
+    if (worker->worker.joinable()) {
+      worker->worker.join();
+    }
+  }
+  workers_.clear();
+  return worker_rc_.load();
+}
+
+int IntegratedLogReplayer::partition(const LogEntry &entry) const
+{
+  const size_t worker_num = workers_.size();
+
+  switch (entry.module().id()) {
+    case LogModule::Id::BUFFER_POOL: {
+      // 缓冲池日志修改的是文件头页面
+      auto *header = reinterpret_cast<const BufferPoolLogEntry *>(entry.data());
+      return static_cast<int>(hash<int32_t>()(header->buffer_pool_id) % worker_num);
+    }
+    case LogModule::Id::RECORD_MANAGER: {
+      // 页面可能是刚分配的，还没有写到磁盘上。需要与分配页面的缓冲池日志在同一个线程中按顺序回放
+      auto *header = reinterpret_cast<const RecordLogHeader *>(entry.data());
+      return static_cast<int>(hash<int32_t>()(header->buffer_pool_id) % worker_num);
+    }
+    case LogModule::Id::BPLUS_TREE: {
+      // 一条B+树日志可能修改同一个索引文件中的多个页面，因此整个文件由同一个线程回放
+      Deserializer buffer(entry.data(), entry.payload_size());
+      int32_t      buffer_pool_id = -1;
+      (void)buffer.read_int32(buffer_pool_id);
+      return static_cast<int>(hash<int32_t>()(buffer_pool_id) % worker_num);
+    }
+    default: return 0;
+  }
+}
 
 RC IntegratedLogReplayer::replay(const LogEntry &entry)
+{
+  switch (entry.module().id()) {
+    case LogModule::Id::BUFFER_POOL:
+    case LogModule::Id::RECORD_MANAGER:
+    case LogModule::Id::BPLUS_TREE: break;
+    // 事务日志不修改数据页面，直接在当前线程中按照日志顺序回放
+    case LogModule::Id::TRANSACTION: return trx_log_replayer_->replay(entry);
+    default: return RC::INVALID_ARGUMENT;
+  }
+
+  if (workers_.empty()) {
+    return replay_page_entry(entry);
+  }
+
+  RC rc = worker_rc_.load();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  const size_t min_size = entry.module().id() == LogModule::Id::BPLUS_TREE ? sizeof(int32_t) : sizeof(BufferPoolLogEntry);
+  if (entry.payload_size() < static_cast<int32_t>(min_size)) {
+    LOG_WARN("invalid log entry. entry=%s", entry.to_string().c_str());
+    return RC::LOG_ENTRY_INVALID;
+  }
+
+  // 日志回放器拿到的是一个临时对象，放到队列中需要复制一份
+  LogEntry     copied_entry;
+  vector<char> data(entry.data(), entry.data() + entry.payload_size());
+  rc = copied_entry.init(entry.lsn(), entry.module(), std::move(data));
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  ReplayWorker      *worker = workers_[partition(entry)].get();
+  unique_lock<mutex> guard(worker->lock);
+  worker->not_full.wait(guard, [worker] { return worker->entries.size() < MAX_PENDING_ENTRIES; });
+  worker->entries.push_back(std::move(copied_entry));
+  worker->not_empty.notify_one();
+  return RC::SUCCESS;
+}
+
+RC IntegratedLogReplayer::replay_page_entry(const LogEntry &entry)
 {
   switch (entry.module().id()) {
     case LogModule::Id::BUFFER_POOL: return buffer_pool_log_replayer_.replay(entry);
     case LogModule::Id::RECORD_MANAGER: return record_log_replayer_.replay(entry);
     case LogModule::Id::BPLUS_TREE: return bplus_tree_log_replayer_.replay(entry);
-    case LogModule::Id::TRANSACTION: return trx_log_replayer_->replay(entry);
     default: return RC::INVALID_ARGUMENT;
   }
 }
 
 RC IntegratedLogReplayer::on_done()
 {
-  RC rc = buffer_pool_log_replayer_.on_done();
+  // 所有页面日志都回放完成之后，才能回滚未提交的事务
+  RC rc = stop_workers();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to replay logs in parallel. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = buffer_pool_log_replayer_.on_done();
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to do buffer pool log replay. rc=%s", strrc(rc));
     return rc;
@@ -59,7 +209,7 @@ RC IntegratedLogReplayer::on_done()
     return rc;
   }
 
-  rc = trx_log_replayer_->on_done();
+  rc = trx_log_replayer_ ? trx_log_replayer_->on_done() : RC::SUCCESS;
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to do mvcc trx log replay. rc=%s", strrc(rc));
     return rc;
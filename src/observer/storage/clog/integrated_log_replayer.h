@@ -14,6 +14,12 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/lang/atomic.h"
+#include "common/lang/deque.h"
+#include "common/lang/mutex.h"
+#include "common/lang/thread.h"
+#include "common/lang/vector.h"
+#include "storage/clog/log_entry.h"
 #include "storage/clog/log_replayer.h"
 #include "storage/buffer/buffer_pool_log.h"
 #include "storage/record/record_log.h"
@@ -25,7 +31,12 @@ class BufferPoolManager;
 /**
  * @brief 整体日志回放类
  * @ingroup Clog
- * @details 负责回放所有日志，是其它各模块日志回放的分发器
+ * @details 负责回放所有日志，是其它各模块日志回放的分发器。
+ * 缓冲池、record manager和B+树的日志只修改数据页，不同文件之间没有依赖，因此可以按照缓冲池(文件)把日志分发到
+ * 多个回放线程上并行执行，同一个文件的日志总是由同一个线程按照LSN顺序回放。
+ * 页面上的日志依赖分配页面的缓冲池日志(页面可能还没有落盘，需要先扩展文件)，B+树的一条日志也会修改多个页面，
+ * 所以不能再按照页面分区。
+ * 事务日志仅在内存中构造事务的操作列表，由分发线程直接回放；on_done 时等待所有回放线程结束，再回滚未提交的事务。
  */
 class IntegratedLogReplayer : public LogReplayer
 {
@@ -36,15 +47,15 @@ public:
    * BufferPoolManager 在对应MySQL中，可以类比table space 的管理器。但是在这里，一个表可能会有多个table space(buffer
    * pool)。 比如一个数据文件、多个索引文件。
    */
-  IntegratedLogReplayer(BufferPoolManager &bpm);
+  IntegratedLogReplayer(BufferPoolManager &bpm, int worker_num = 1);
 
   /**
    * @brief 构造函数
    * @details
    * 区别于另一个构造函数，这个构造函数可以指定不同的事务日志回放器。比如进程启动时可以指定选择使用VacuousTrx还是MvccTrx。
    */
-  IntegratedLogReplayer(BufferPoolManager &bpm, unique_ptr<LogReplayer> trx_log_replayer);
-  virtual ~IntegratedLogReplayer() = default;
+  IntegratedLogReplayer(BufferPoolManager &bpm, unique_ptr<LogReplayer> trx_log_replayer, int worker_num = 1);
+  virtual ~IntegratedLogReplayer();
 
   //! @copydoc LogReplayer::replay
   RC replay(const LogEntry &entry) override;
@@ -53,8 +64,40 @@ public:
   RC on_done() override;
 
 private:
+  /**
+   * @brief 回放线程
+   * @details 每个线程有一个自己的日志队列。队列长度有上限，避免回放比读取日志慢时占用过多内存
+   */
+  struct ReplayWorker
+  {
+    mutex              lock;
+    condition_variable not_empty;
+    condition_variable not_full;
+    deque<LogEntry>    entries;
+    bool               stopped = false;
+    thread             worker;
+  };
+
+  /// @brief 回放页面相关的日志，即除了事务日志之外的日志
+  RC replay_page_entry(const LogEntry &entry);
+
+  /// @brief 计算一条日志应该由哪个回放线程处理
+  int partition(const LogEntry &entry) const;
+
+  void start_workers(int worker_num);
+  void worker_func(ReplayWorker *worker);
+
+  /// @brief 等待所有已经分发的日志回放完成，并停止回放线程
+  RC stop_workers();
+
+private:
+  static constexpr size_t MAX_PENDING_ENTRIES = 1024;  ///< 每个回放线程队列中最多缓存的日志条数
+
   BufferPoolLogReplayer   buffer_pool_log_replayer_;  ///< 缓冲池日志回放器
   RecordLogReplayer       record_log_replayer_;       ///< record manager 日志回放器
   BplusTreeLogReplayer    bplus_tree_log_replayer_;   ///< bplus tree 日志回放器
   unique_ptr<LogReplayer> trx_log_replayer_;          ///< trx 日志回放器
+
+  vector<unique_ptr<ReplayWorker>> workers_;                ///< 并行回放线程，为空时在当前线程回放
+  atomic<RC>                       worker_rc_{RC::SUCCESS};  ///< 回放线程遇到的第一个错误
 };
\ No newline at end of file
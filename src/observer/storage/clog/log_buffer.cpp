@@ -12,95 +12,181 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai on 2024/01/31
 //
 
+#include <string.h>
+#include <sys/uio.h>
+
 #include "storage/clog/log_buffer.h"
 #include "storage/clog/log_file.h"
 #include "common/lang/chrono.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/thread.h"
 
 using namespace common;
 
+LogEntryBuffer::LogEntryBuffer() { (void)init(0); }
+
 RC LogEntryBuffer::init(LSN lsn, int32_t max_bytes /*= 0*/)
 {
-  current_lsn_.store(lsn);
-  flushed_lsn_.store(lsn);
-
   if (max_bytes > 0) {
     max_bytes_ = max_bytes;
   }
+
+  if (max_bytes_ < LogEntry::max_size()) {
+    LOG_WARN("log buffer is too small. max_bytes=%d, max entry size=%d", max_bytes_, LogEntry::max_size());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  buffer_.resize(max_bytes_);
+  if (!slots_) {
+    slots_ = make_unique<atomic<LSN>[]>(SLOT_NUM);
+  }
+  for (int64_t i = 0; i < SLOT_NUM; i++) {
+    slots_[i].store(0);
+  }
+
+  current_lsn_.store(lsn);
+  flushed_lsn_.store(lsn);
+  reserved_offset_.store(0);
+  flushed_offset_.store(0);
   return RC::SUCCESS;
 }
 
-RC LogEntryBuffer::append(LSN &lsn, LogModule::Id module_id, vector<char> &&data)
+RC LogEntryBuffer::append(LSN &lsn, LogModule::Id module_id, span<const char> data)
 {
-  return append(lsn, LogModule(module_id), std::move(data));
+  return append(lsn, LogModule(module_id), data);
 }
 
-RC LogEntryBuffer::append(LSN &lsn, LogModule module, vector<char> &&data)
+RC LogEntryBuffer::append(LSN &lsn, LogModule module, span<const char> data)
 {
-  /// 控制当前buffer使用的内存
-  /// 简单粗暴，强制原地等待
-  /// 但是如果当前想要新插入的日志比较大，不会做控制。所以理论上容纳的最大buffer内存是2*max_bytes_
-  while (bytes_.load() >= max_bytes_) {
-    this_thread::sleep_for(chrono::milliseconds(10));
+  if (static_cast<int64_t>(data.size()) > LogEntry::max_payload_size()) {
+    LOG_WARN("log entry size is too large. size=%ld, max_payload_size=%d", data.size(), LogEntry::max_payload_size());
+    return RC::INVALID_ARGUMENT;
   }
 
-  LogEntry entry;
-  RC rc = entry.init(lsn, module, std::move(data));
-  if (OB_FAIL(rc)) {
-    LOG_WARN("failed to init log entry. rc=%s", strrc(rc));
-    return rc;
+  LogHeader header;
+  header.size      = static_cast<int32_t>(data.size());
+  header.module_id = module.index();
+
+  const int64_t total_size = LogHeader::SIZE + header.size;
+  int64_t       offset     = 0;
+  reserve(total_size, lsn, offset);
+  header.lsn = lsn;
+
+  /// 控制当前buffer使用的内存，等待刷盘线程把前面的日志刷出去
+  /// 更早的日志总是先刷盘，所以这里不会死锁
+  while (offset + total_size - flushed_offset_.load(std::memory_order_acquire) > max_bytes_ ||
+         lsn - flushed_lsn_.load(std::memory_order_acquire) > SLOT_NUM) {
+    this_thread::sleep_for(chrono::microseconds(100));
   }
 
-  lock_guard guard(mutex_);
-  lsn = ++current_lsn_;
-  entry.set_lsn(lsn);
+  write_at(offset, reinterpret_cast<const char *>(&header), LogHeader::SIZE);
+  write_at(offset + LogHeader::SIZE, data.data(), header.size);
 
-  entries_.push_back(std::move(entry));
-  bytes_ += entry.total_size();
+  slots_[lsn % SLOT_NUM].store(lsn, std::memory_order_release);
   return RC::SUCCESS;
 }
 
+void LogEntryBuffer::reserve(int64_t size, LSN &lsn, int64_t &offset)
+{
+  while (reserve_lock_.test_and_set(std::memory_order_acquire)) {
+    this_thread::yield();
+  }
+
+  lsn = current_lsn_.load(std::memory_order_relaxed) + 1;
+  current_lsn_.store(lsn, std::memory_order_relaxed);
+  offset = reserved_offset_.load(std::memory_order_relaxed);
+  reserved_offset_.store(offset + size, std::memory_order_relaxed);
+
+  reserve_lock_.clear(std::memory_order_release);
+}
+
+void LogEntryBuffer::write_at(int64_t offset, const char *data, int64_t size)
+{
+  const int64_t pos   = offset % max_bytes_;
+  const int64_t first = min(size, max_bytes_ - pos);
+  memcpy(buffer_.data() + pos, data, first);
+  if (first < size) {
+    memcpy(buffer_.data(), data + first, size - first);
+  }
+}
+
+void LogEntryBuffer::read_at(int64_t offset, char *data, int64_t size) const
+{
+  const int64_t pos   = offset % max_bytes_;
+  const int64_t first = min(size, max_bytes_ - pos);
+  memcpy(data, buffer_.data() + pos, first);
+  if (first < size) {
+    memcpy(data + first, buffer_.data(), size - first);
+  }
+}
+
 RC LogEntryBuffer::flush(LogFileWriter &writer, int &count)
 {
   count = 0;
 
-  while (entry_number() > 0) {
-    LogEntry entry;
-    {
-      lock_guard guard(mutex_);
-      if (entries_.empty()) {
-        break;
-      }
-
-      LogEntry &front_entry = entries_.front();
-      ASSERT(front_entry.lsn() > 0 && front_entry.payload_size() > 0, "invalid log entry");
-      entry = std::move(entries_.front());
-      ASSERT(entry.payload_size() > 0 && entry.lsn() > 0, "invalid log entry");
-      entries_.pop_front();
-      bytes_ -= entry.total_size();
-    }
-    
-    RC rc = writer.write(entry);
-    if (OB_FAIL(rc)) {
-      lock_guard guard(mutex_);
-      entries_.emplace_front(std::move(entry));
-      LogEntry &front_entry = entries_.front();
-      ASSERT(front_entry.lsn() > 0 && front_entry.payload_size() > 0, "invalid log entry");
-      return rc;
-    } else {
-      ++count;
-      flushed_lsn_ = entry.lsn();
+  lock_guard guard(flush_mutex_);
+
+  const LSN     first_lsn    = flushed_lsn_.load() + 1;
+  const int64_t begin_offset = flushed_offset_.load();
+
+  /// 找到所有连续的已经拷贝完成的日志，一次写入，这就是组提交(group commit)
+  LSN     last_lsn   = first_lsn - 1;
+  int64_t end_offset = begin_offset;
+  bool    file_full  = false;
+  while (slots_[(last_lsn + 1) % SLOT_NUM].load(std::memory_order_acquire) == last_lsn + 1) {
+    if (last_lsn + 1 > writer.end_lsn()) {
+      file_full = true;
+      break;
     }
+
+    LogHeader header;
+    read_at(end_offset, reinterpret_cast<char *>(&header), LogHeader::SIZE);
+    ASSERT(header.lsn == last_lsn + 1 && header.size >= 0, "invalid log entry. header=%s, expect lsn=%ld",
+           header.to_string().c_str(), last_lsn + 1);
+
+    end_offset += LogHeader::SIZE + header.size;
+    last_lsn++;
   }
-  
-  return RC::SUCCESS;
+
+  if (last_lsn < first_lsn) {
+    return file_full ? RC::LOG_FILE_FULL : RC::SUCCESS;
+  }
+
+  // 数据在环形缓冲区中可能回绕，最多分成两段
+  const int64_t  pos   = begin_offset % max_bytes_;
+  const int64_t  size  = end_offset - begin_offset;
+  const int64_t  first = min(size, max_bytes_ - pos);
+  struct iovec   iovs[2];
+  int            iovcnt = 1;
+  iovs[0].iov_base      = buffer_.data() + pos;
+  iovs[0].iov_len       = first;
+  if (first < size) {
+    iovs[1].iov_base = buffer_.data();
+    iovs[1].iov_len  = size - first;
+    iovcnt           = 2;
+  }
+
+  RC rc = writer.write(first_lsn, last_lsn, span<struct iovec>(iovs, iovcnt));
+  if (OB_SUCC(rc)) {
+    rc = writer.sync();
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to write log entries. first_lsn=%ld, last_lsn=%ld, rc=%s", first_lsn, last_lsn, strrc(rc));
+    return rc;
+  }
+
+  flushed_offset_.store(end_offset, std::memory_order_release);
+  flushed_lsn_.store(last_lsn, std::memory_order_release);
+  count = static_cast<int>(last_lsn - first_lsn + 1);
+  return file_full ? RC::LOG_FILE_FULL : RC::SUCCESS;
 }
 
 int64_t LogEntryBuffer::bytes() const
 {
-  return bytes_.load();
+  return reserved_offset_.load() - flushed_offset_.load();
 }
 
 int32_t LogEntryBuffer::entry_number() const
 {
-  return entries_.size();
+  return static_cast<int32_t>(current_lsn_.load() - flushed_lsn_.load());
 }
@@ -18,7 +18,8 @@ See the Mulan PSL v2 for more details. */
 #include "common/types.h"
 #include "common/lang/mutex.h"
 #include "common/lang/vector.h"
-#include "common/lang/deque.h"
+#include "common/lang/memory.h"
+#include "common/lang/span.h"
 #include "common/lang/atomic.h"
 #include "storage/clog/log_module.h"
 #include "storage/clog/log_entry.h"
@@ -28,27 +29,39 @@ class LogFileWriter;
 /**
  * @brief 日志数据缓冲区
  * @ingroup CLog
- * @details 缓存一部分日志在内存中而不是直接写入磁盘。
- * 这里的缓存没有考虑高性能操作，比如使用预分配内存、环形缓冲池等。
- * 在生产数据库中，通常会使用预分配内存形式的缓存来提高性能，并且可以减少内存碎片。
+ * @details 预先分配一块连续的环形内存，日志直接拷贝到这块内存中，格式与日志文件中的格式完全一样(日志头+数据)，
+ * 写日志时不需要为每条日志单独申请内存。
+ * 写日志分为两步：
+ * 1. 预留：分配LSN和环形缓冲区中的位置。LSN是按条递增的，而位置是按字节递增的，两者必须一起分配，
+ *    所以这一步使用一个自旋锁，锁内只有两次加法；
+ * 2. 拷贝：不加锁，把日志头和数据拷贝到预留的位置，然后在这条日志对应的槽位上标记完成。
+ * 刷盘时，从上次刷盘的位置开始，找到连续的已经拷贝完成的日志，一次写入文件。
  */
 class LogEntryBuffer
 {
 public:
-  LogEntryBuffer()  = default;
+  /// @brief 使用默认大小分配好缓冲区，即使没有调用init(比如没有回放日志)也可以直接使用
+  LogEntryBuffer();
   ~LogEntryBuffer() = default;
 
+  /**
+   * @brief 初始化
+   * @param lsn 当前最大的LSN，新的日志从lsn+1开始
+   * @param max_bytes 环形缓冲区的大小，不能小于一条日志的最大大小
+   */
   RC init(LSN lsn, int32_t max_bytes = 0);
 
   /**
    * @brief 在缓冲区中追加一条日志
+   * @details 如果缓冲区满了，会等待刷盘腾出空间
    */
-  RC append(LSN &lsn, LogModule::Id module_id, vector<char> &&data);
-  RC append(LSN &lsn, LogModule module, vector<char> &&data);
+  RC append(LSN &lsn, LogModule::Id module_id, span<const char> data);
+  RC append(LSN &lsn, LogModule module, span<const char> data);
 
   /**
    * @brief 刷新缓冲区中的日志到磁盘
-   *
+   * @details 会把所有连续的已经拷贝完成的日志使用一次写操作写入文件，并刷盘一次。
+   * 如果遇到当前文件不能容纳的日志，返回 LOG_FILE_FULL。
    * @param file_handle 使用它来写文件
    * @param count 刷了多少条日志
    */
@@ -68,12 +81,26 @@ public:
   LSN flushed_lsn() const { return flushed_lsn_.load(); }
 
 private:
-  mutex           mutex_;  /// 当前数据结构一定会在多线程中访问，所以强制使用有效的锁，而不是有条件生效的common::Mutex
-  deque<LogEntry> entries_;  /// 日志缓冲区
-  atomic<int64_t> bytes_;    /// 当前缓冲区中的日志数据大小
+  /// @brief 预留一条日志的LSN和缓冲区中的位置
+  void reserve(int64_t size, LSN &lsn, int64_t &offset);
+
+  /// @brief 在环形缓冲区中读写数据，offset 是逻辑位置，会处理回绕
+  void write_at(int64_t offset, const char *data, int64_t size);
+  void read_at(int64_t offset, char *data, int64_t size) const;
+
+private:
+  static constexpr int64_t SLOT_NUM = 64 * 1024;  /// 完成标记的槽位个数，也是缓冲区中最多容纳的日志条数
+
+  std::atomic_flag reserve_lock_ = ATOMIC_FLAG_INIT;  /// 保护LSN和位置的分配
+  atomic<LSN>     current_lsn_{0};
+  atomic<int64_t> reserved_offset_{0};  /// 已经分配出去的逻辑位置，单调递增
+
+  mutex           flush_mutex_;  /// 同一时间只允许一个线程刷盘
+  atomic<LSN>     flushed_lsn_{0};
+  atomic<int64_t> flushed_offset_{0};  /// 已经刷盘的逻辑位置
 
-  atomic<LSN> current_lsn_{0};
-  atomic<LSN> flushed_lsn_{0};
+  vector<char>              buffer_;  /// 环形缓冲区
+  unique_ptr<atomic<LSN>[]> slots_;   /// slots_[lsn % SLOT_NUM] == lsn 表示这条日志已经拷贝完成
 
-  int32_t max_bytes_ = 4 * 1024 * 1024;  /// 缓冲区最大字节数
+  int32_t max_bytes_ = 8 * 1024 * 1024;  /// 缓冲区最大字节数
 };
@@ -13,6 +13,8 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
 #include "common/lang/string_view.h"
 #include "common/lang/charconv.h"
@@ -155,7 +157,8 @@ RC LogFileWriter::open(const char *filename, int end_lsn)
   filename_ = filename;
   end_lsn_ = end_lsn;
 
-  fd_ = ::open(filename, O_WRONLY | O_APPEND | O_CREAT | O_SYNC, 0644);
+  // 不使用 O_SYNC，由调用方在写完一批日志后调用 sync，这样多条日志只需要一次刷盘
+  fd_ = ::open(filename, O_WRONLY | O_APPEND | O_CREAT, 0644);
   if (fd_ < 0) {
     LOG_WARN("open file failed. filename=%s, error=%s", filename, strerror(errno));
     return RC::FILE_OPEN;
@@ -214,6 +217,56 @@ RC LogFileWriter::write(LogEntry &entry)
   return RC::SUCCESS;
 }
 
+RC LogFileWriter::write(LSN first_lsn, LSN last_lsn, span<struct iovec> data)
+{
+  // 一个日志文件写的日志条数是有限制的
+  if (last_lsn > end_lsn_) {
+    return RC::LOG_FILE_FULL;
+  }
+
+  if (fd_ < 0) {
+    return RC::FILE_NOT_OPENED;
+  }
+
+  if (first_lsn <= last_lsn_ || first_lsn > last_lsn) {
+    LOG_WARN("write log entries failed. invalid lsn. filename=%s, last_lsn=%ld, first_lsn=%ld, last_lsn=%ld", 
+             filename_.c_str(), last_lsn_, first_lsn, last_lsn);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  /// WARNING 这里需要处理日志写一半的情况
+  /// 日志只写成功一部分到文件中非常难处理
+  int ret = writevn(fd_, data.data(), static_cast<int>(data.size()));
+  if (0 != ret) {
+    LOG_WARN("write log entries failed. filename=%s, ret = %d, error=%s, first_lsn=%ld, last_lsn=%ld", 
+             filename_.c_str(), ret, strerror(ret), first_lsn, last_lsn);
+    return RC::IOERR_WRITE;
+  }
+
+  last_lsn_ = last_lsn;
+  LOG_TRACE("write log entries success. filename=%s, first_lsn=%ld, last_lsn=%ld", 
+            filename_.c_str(), first_lsn, last_lsn);
+  return RC::SUCCESS;
+}
+
+RC LogFileWriter::sync()
+{
+  if (fd_ < 0) {
+    return RC::FILE_NOT_OPENED;
+  }
+
+#ifdef __MACH__
+  int ret = ::fsync(fd_);
+#else
+  int ret = ::fdatasync(fd_);
+#endif
+  if (0 != ret) {
+    LOG_WARN("sync log file failed. filename=%s, error=%s", filename_.c_str(), strerror(errno));
+    return RC::IOERR_SYNC;
+  }
+  return RC::SUCCESS;
+}
+
 bool LogFileWriter::valid() const
 {
   return fd_ >= 0;
@@ -300,6 +353,7 @@ RC LogFileManager::list_files(vector<string> &files, LSN start_lsn)
 {
   files.clear();
 
+  lock_guard<mutex> guard(lock_);
   // 这里的代码是AI自动生成的
   // 其实写的不好，我们只需要找到比start_lsn相等或者小的第一个日志文件就可以了
   for (auto &file : log_files_) {
@@ -313,7 +367,9 @@ RC LogFileManager::list_files(vector<string> &files, LSN start_lsn)
 
 RC LogFileManager::last_file(LogFileWriter &file_writer)
 {
+  unique_lock<mutex> guard(lock_);
   if (log_files_.empty()) {
+    guard.unlock();
     return next_file(file_writer);
   }
 
@@ -328,6 +384,7 @@ RC LogFileManager::next_file(LogFileWriter &file_writer)
 {
   file_writer.close();
 
+  lock_guard<mutex> guard(lock_);
   LSN lsn = 0;
   if (!log_files_.empty()) {
     lsn = log_files_.rbegin()->first + max_entry_number_per_file_;
@@ -339,3 +396,30 @@ RC LogFileManager::next_file(LogFileWriter &file_writer)
 
   return file_writer.open(file_path.c_str(), lsn + max_entry_number_per_file_ - 1);
 }
+
+RC LogFileManager::remove_files_before(LSN lsn)
+{
+  lock_guard<mutex> guard(lock_);
+  if (log_files_.empty()) {
+    return RC::SUCCESS;
+  }
+
+  const LSN last_file_lsn = log_files_.rbegin()->first;
+  for (auto iter = log_files_.begin(); iter != log_files_.end() && iter->first != last_file_lsn;) {
+    if (iter->first + max_entry_number_per_file_ - 1 >= lsn) {
+      break;
+    }
+
+    error_code ec;
+    filesystem::remove(iter->second, ec);
+    if (ec) {
+      LOG_WARN("failed to remove log file. file=%s, error=%s", iter->second.c_str(), ec.message().c_str());
+      return RC::FILE_REMOVE;
+    }
+
+    LOG_INFO("remove log file. file=%s, lsn=%ld", iter->second.c_str(), lsn);
+    iter = log_files_.erase(iter);
+  }
+
+  return RC::SUCCESS;
+}
@@ -14,6 +14,8 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <sys/uio.h>
+
 #include "common/rc.h"
 #include "common/types.h"
 #include "common/lang/map.h"
@@ -21,6 +23,8 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/filesystem.h"
 #include "common/lang/fstream.h"
 #include "common/lang/string.h"
+#include "common/lang/span.h"
+#include "common/lang/mutex.h"
 
 class LogEntry;
 
@@ -74,8 +78,22 @@ public:
   RC close();
 
   /// @brief 写入一条日志
+  /// @details 只是写入操作系统缓存，需要调用 sync 才能保证日志落盘
   RC write(LogEntry &entry);
 
+  /**
+   * @brief 使用一次writev写入多条已经序列化好的日志
+   * @details 数据是连续的日志头+日志数据，与文件中的格式相同。调用方需要保证日志不会超过当前文件的范围。
+   * 与 write 一样，需要调用 sync 才能保证日志落盘。
+   * @param first_lsn 第一条日志的LSN
+   * @param last_lsn 最后一条日志的LSN
+   * @param data 日志数据，写入过程中会被修改
+   */
+  RC write(LSN first_lsn, LSN last_lsn, span<struct iovec> data);
+
+  /// @brief 将已经写入的日志刷新到磁盘
+  RC sync();
+
   /**
    * @brief 当前文件是否已经打开
    */
@@ -90,11 +108,14 @@ public:
 
   const char *filename() const { return filename_.c_str(); }
 
+  /// @brief 当前文件允许写入的最大LSN
+  LSN end_lsn() const { return end_lsn_; }
+
 private:
   string filename_;       /// 日志文件名
   int    fd_       = -1;  /// 日志文件描述符
-  int    last_lsn_ = 0;   /// 写入的最后一条日志LSN
-  int    end_lsn_  = 0;   /// 当前日志文件中允许写入的最大的LSN，包括这条日志
+  LSN    last_lsn_ = 0;   /// 写入的最后一条日志LSN
+  LSN    end_lsn_  = 0;   /// 当前日志文件中允许写入的最大的LSN，包括这条日志
 };
 
 /**
@@ -137,6 +158,13 @@ public:
    */
   RC next_file(LogFileWriter &file_writer);
 
+  /**
+   * @brief 删除所有日志都在指定LSN之前的日志文件
+   * @details 做完检查点后调用。最后一个日志文件正在写入，永远不会删除。
+   * @param lsn 比这个LSN小的日志都不再需要了
+   */
+  RC remove_files_before(LSN lsn);
+
 private:
   /**
    * @brief 从文件名称中获取LSN
@@ -151,5 +179,6 @@ private:
   filesystem::path directory_;                  /// 日志文件存放的目录
   int              max_entry_number_per_file_;  /// 一个文件最大允许存放多少条日志
 
+  mutex                      lock_;       /// 保护 log_files_，删除日志文件和刷盘线程可能并发
   map<LSN, filesystem::path> log_files_;  /// 日志文件名和第一个LSN的映射
 };
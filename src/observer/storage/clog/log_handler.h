@@ -96,6 +96,13 @@ public:
 
   virtual LSN current_lsn() const = 0;
 
+  /**
+   * @brief 截断日志
+   * @details 做完检查点后调用，恢复时不再需要比lsn小的日志，可以删除这些日志文件
+   * @param lsn 检查点的LSN
+   */
+  virtual RC truncate(LSN lsn) = 0;
+
   static RC create(const char *name, LogHandler *&handler);
 
 private:
@@ -103,5 +110,5 @@ private:
    * @brief 写入一条日志
    * @details 子类应该重现实现这个函数
    */
-  virtual RC _append(LSN &lsn, LogModule module, vector<char> &&data) = 0;
+  virtual RC _append(LSN &lsn, LogModule module, span<const char> data) = 0;
 };
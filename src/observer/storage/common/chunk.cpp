@@ -9,6 +9,7 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include "storage/common/chunk.h"
+#include "common/lang/algorithm.h"
 
 void Chunk::add_column(unique_ptr<Column> col, int col_id)
 {
@@ -27,9 +28,118 @@ RC Chunk::reference(Chunk &chunk)
     columns_[i]->reference(chunk.column(i));
     column_ids_.push_back(chunk.column_ids(i));
   }
+  copy_selection(chunk);
   return RC::SUCCESS;
 }
 
+void Chunk::select(const vector<uint8_t> &select)
+{
+  selection_.clear();
+  const int rows = static_cast<int>(select.size());
+  for (int i = 0; i < rows; i++) {
+    if (select[i] != 0) {
+      selection_.push_back(i);
+    }
+  }
+  // 全部选中时不需要选择向量
+  has_selection_ = static_cast<int>(selection_.size()) != rows;
+  if (!has_selection_) {
+    selection_.clear();
+  }
+}
+
+void Chunk::set_selection(vector<int> &&selection)
+{
+  has_selection_ = static_cast<int>(selection.size()) != rows();
+  if (has_selection_) {
+    selection_ = std::move(selection);
+  } else {
+    selection_.clear();
+  }
+}
+
+void Chunk::selection_mask(vector<uint8_t> &select) const
+{
+  if (!has_selection_) {
+    select.assign(rows(), 1);
+    return;
+  }
+
+  select.assign(rows(), 0);
+  for (int row : selection_) {
+    select[row] = 1;
+  }
+}
+
+void Chunk::copy_selection(const Chunk &chunk)
+{
+  if (this == &chunk) {
+    return;
+  }
+  has_selection_ = chunk.has_selection_;
+  selection_     = chunk.selection_;
+}
+
+RC Chunk::compact(Chunk &output) const
+{
+  bool same_schema = output.column_num() == column_num();
+  for (int i = 0; same_schema && i < column_num(); i++) {
+    const Column &column = *columns_[i];
+    const Column &out    = *output.columns_[i];
+    same_schema          = out.attr_type() == column.attr_type() && out.attr_len() == column.attr_len() &&
+                  out.column_type() == column.column_type() && out.capacity() >= selected_rows();
+  }
+
+  if (!same_schema) {
+    output.reset();
+    for (int i = 0; i < column_num(); i++) {
+      const Column &column   = *columns_[i];
+      const int     capacity = column.column_type() == Column::Type::CONSTANT_COLUMN
+                                   ? 1
+                                   : std::max(std::max(column.capacity(), selected_rows()), 1);
+      output.add_column(make_unique<Column>(column.attr_type(), column.attr_len(), capacity), column_ids_[i]);
+    }
+  } else {
+    output.reset_data();
+  }
+
+  RC rc = RC::SUCCESS;
+  for (int i = 0; i < column_num() && OB_SUCC(rc); i++) {
+    const Column &column = *columns_[i];
+    Column       &out    = *output.columns_[i];
+    if (column.column_type() == Column::Type::CONSTANT_COLUMN) {
+      out.set_column_type(Column::Type::CONSTANT_COLUMN);
+      rc = out.append_one(column.data());
+    } else {
+      rc = gather(column, out);
+    }
+  }
+  return rc;
+}
+
+RC Chunk::gather(const Column &column, Column &output) const
+{
+  const int attr_len = column.attr_len();
+  const int count    = selected_rows();
+  if (column.column_type() == Column::Type::CONSTANT_COLUMN) {
+    RC rc = RC::SUCCESS;
+    for (int i = 0; i < count && OB_SUCC(rc); i++) {
+      rc = output.append_one(column.data());
+    }
+    return rc;
+  }
+
+  if (!has_selection_) {
+    return output.append(column.data(), count);
+  }
+
+  RC rc = RC::SUCCESS;
+  for (int i = 0; i < count && OB_SUCC(rc); i++) {
+    rc = output.append_one(column.data() + static_cast<size_t>(selection_[i]) * attr_len);
+  }
+  return rc;
+}
+
 int Chunk::rows() const
 {
   if (!columns_.empty()) {
@@ -51,10 +161,12 @@ void Chunk::reset_data()
   for (auto &col : columns_) {
     col->reset_data();
   }
+  clear_selection();
 }
 
 void Chunk::reset()
 {
   columns_.clear();
   column_ids_.clear();
+  clear_selection();
 }
\ No newline at end of file
@@ -71,6 +71,66 @@ public:
    */
   Value get_value(int col_idx, int row_idx) const { return columns_[col_idx]->get_value(row_idx); }
 
+  /**
+   * @brief 根据过滤的结果设置选择向量
+   * @details 选择向量按照从小到大的顺序记录有效的行号，没有选择向量时所有的行都有效。
+   * 过滤时只记录选择向量而不复制数据，下游的向量化算子只处理选中的行。
+   * @param select 每一行的过滤结果，长度与 rows() 相同
+   */
+  void select(const vector<uint8_t> &select);
+
+  /**
+   * @brief 直接设置选择向量
+   * @param selection 从小到大排列的行号，包含所有的行时不会记录选择向量
+   */
+  void set_selection(vector<int> &&selection);
+
+  /**
+   * @brief 使用另一个 Chunk 的选择向量，两个 Chunk 的行要一一对应
+   */
+  void copy_selection(const Chunk &chunk);
+
+  /**
+   * @brief 把选择向量转换成每一行的过滤结果，作为 Expression::eval 的初始值
+   */
+  void selection_mask(vector<uint8_t> &select) const;
+
+  void clear_selection()
+  {
+    has_selection_ = false;
+    selection_.clear();
+  }
+
+  bool               has_selection() const { return has_selection_; }
+  const vector<int> &selection() const { return selection_; }
+
+  /**
+   * @brief 获取选中的行数，没有选择向量时与 rows() 相同
+   */
+  int selected_rows() const { return has_selection_ ? static_cast<int>(selection_.size()) : rows(); }
+
+  /**
+   * @brief 获取第 i 个选中的行在列中的行号
+   */
+  int row_index(int i) const { return has_selection_ ? selection_[i] : i; }
+
+  /**
+   * @brief 选中的行占比低于 1/COMPACT_RATIO 时，继续带着选择向量向下传递就不划算了
+   */
+  bool sparse() const { return has_selection_ && static_cast<int>(selection_.size()) * COMPACT_RATIO < rows(); }
+
+  /**
+   * @brief 把选中的行复制到 output 中，output 中没有选择向量
+   * @details output 的列与当前 Chunk 不一致时会重新创建。常量列仍然是常量列
+   */
+  RC compact(Chunk &output) const;
+
+  /**
+   * @brief 把 column 中选中的行追加到 output 中，常量列会展开成选中的行数
+   * @param column 与当前 Chunk 的行一一对应的列，比如表达式在当前 Chunk 上的计算结果
+   */
+  RC gather(const Column &column, Column &output) const;
+
   /**
    * @brief 重置 Chunk 中的数据，不会修改 Chunk 的列属性。
    */
@@ -78,9 +138,14 @@ public:
 
   void reset();
 
+  static constexpr int COMPACT_RATIO = 4;
+
 private:
   vector<unique_ptr<Column>> columns_;
   // TODO: remove it and support multi-tables,
   // `columnd_ids` store the ids of child operator that need to be output
   vector<int> column_ids_;
+
+  bool        has_selection_ = false;
+  vector<int> selection_;  ///< 选中的行号
 };
\ No newline at end of file
@@ -127,4 +127,19 @@ void Column::reference(const Column &column)
   this->column_type_ = column.column_type();
   this->attr_type_   = column.attr_type();
   this->attr_len_    = column.attr_len();
-}
\ No newline at end of file
+}
+
+void Column::reference(char *data, int count)
+{
+  AttrType attr_type = attr_type_;
+  int      attr_len  = attr_len_;
+  reset();
+
+  data_        = data;
+  count_       = count;
+  capacity_    = count;
+  own_         = false;
+  attr_type_   = attr_type;
+  attr_len_    = attr_len;
+  column_type_ = Type::NORMAL_COLUMN;
+}
@@ -73,6 +73,14 @@ public:
    */
   void reference(const Column &column);
 
+  /**
+   * @brief 引用外部的一段连续的列数据，比如 PAX 页面中的一列，不修改列属性
+   * @details Column 不会释放这块内存，调用者要保证在使用 Column 期间内存有效
+   * @param data  列数据的起始地址
+   * @param count 列值的个数
+   */
+  void reference(char *data, int count);
+
   void set_column_type(Type column_type) { column_type_ = column_type; }
   void set_count(int count) { count_ = count; }
 
@@ -81,6 +89,7 @@ public:
   AttrType attr_type() const { return attr_type_; }
   int      attr_len() const { return attr_len_; }
   Type     column_type() const { return column_type_; }
+  bool     own() const { return own_; }
 
 private:
   static constexpr size_t DEFAULT_CAPACITY = 8192;
@@ -19,9 +19,11 @@ See the Mulan PSL v2 for more details. */
 #include <vector>
 #include <filesystem>
 
+#include "common/lang/algorithm.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "common/os/path.h"
+#include "common/thread/thread_util.h"
 #include "common/global_context.h"
 #include "storage/common/meta_util.h"
 #include "storage/table/table.h"
@@ -34,6 +36,21 @@ using namespace common;
 
 Db::~Db()
 {
+  if (checkpoint_thread_) {
+    {
+      lock_guard<mutex> guard(checkpoint_thread_lock_);
+      checkpoint_running_ = false;
+      checkpoint_cv_.notify_all();
+    }
+    checkpoint_thread_->join();
+    checkpoint_thread_.reset();
+  }
+
+  if (buffer_pool_manager_) {
+    buffer_pool_manager_->stop_read_ahead();
+    buffer_pool_manager_->stop_page_cleaner();
+  }
+
   for (auto &iter : opened_tables_) {
     delete iter.second;
   }
@@ -133,6 +150,20 @@ RC Db::init(const char *name, const char *dbpath, const char *trx_kit_name, cons
     return rc;
   }
 
+  rc = buffer_pool_manager_->start_page_cleaner();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to start page cleaner. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = buffer_pool_manager_->start_read_ahead();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to start read ahead threads. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  checkpoint_running_ = true;
+  checkpoint_thread_  = make_unique<thread>(&Db::checkpoint_thread_func, this);
   return rc;
 }
 
@@ -171,6 +202,9 @@ Table *Db::find_table(const char *table_name) const
 }
 
 RC Db::drop_table(const char *table_name) {
+  // 检查点线程可能正在刷这张表的页面
+  lock_guard<mutex> guard(checkpoint_lock_);
+
   auto it = find_table(table_name);
 
   if(it == nullptr) {
@@ -245,6 +279,8 @@ void Db::all_tables(vector<string> &table_names) const
 
 RC Db::sync()
 {
+  lock_guard<mutex> guard(checkpoint_lock_);
+
   RC rc = RC::SUCCESS;
   // 调用所有表的sync函数刷新数据到磁盘
   for (const auto &table_pair : opened_tables_) {
@@ -278,8 +314,91 @@ RC Db::sync()
     LOG_ERROR("Failed to flush meta. db=%s, rc=%d:%s", name_.c_str(), rc, strrc(rc));
     return rc;
   }
+
+  rc = log_handler_->truncate(check_point_lsn_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to truncate log. db=%s, lsn=%ld, rc=%s", name_.c_str(), check_point_lsn_, strrc(rc));
+  }
   LOG_INFO("Successfully sync db. db=%s", name_.c_str());
-  return rc;
+  return RC::SUCCESS;
+}
+
+RC Db::checkpoint()
+{
+  lock_guard<mutex> guard(checkpoint_lock_);
+
+  // 先拿到当前的LSN，之后写的日志都比它大，一定会保留下来
+  LSN lsn = log_handler_->current_lsn() + 1;
+
+  // 脏页刷出去之后，检查点才能往前推进
+  int flushed_count = 0;
+  RC  rc            = buffer_pool_manager_->flush_pages_before(lsn, flushed_count);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush pages. db=%s, rc=%s", name_.c_str(), strrc(rc));
+    return rc;
+  }
+
+  trx_kit_->min_active_lsn(lsn);
+  rc = buffer_pool_manager_->get_frame_manager().min_rec_lsn(lsn);
+  if (OB_FAIL(rc)) {
+    LOG_INFO("cannot get min rec lsn of dirty pages. db=%s, rc=%s", name_.c_str(), strrc(rc));
+    return rc;
+  }
+
+  // 已经刷出去的页面和检查点之前的日志都要落盘。日志落盘后，重启时新的日志才会从检查点之后开始编号
+  rc = buffer_pool_manager_->sync_pages();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to sync pages. db=%s, rc=%s", name_.c_str(), strrc(rc));
+    return rc;
+  }
+
+  rc = log_handler_->wait_lsn(lsn - 1);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to wait lsn. db=%s, lsn=%ld, rc=%s", name_.c_str(), lsn - 1, strrc(rc));
+    return rc;
+  }
+
+  if (lsn <= check_point_lsn_) {
+    return RC::SUCCESS;
+  }
+
+  LSN old_check_point_lsn = check_point_lsn_;
+  check_point_lsn_        = lsn;
+  rc                      = flush_meta();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush meta. db=%s, rc=%s", name_.c_str(), strrc(rc));
+    check_point_lsn_ = old_check_point_lsn;
+    return rc;
+  }
+
+  rc = log_handler_->truncate(check_point_lsn_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to truncate log. db=%s, lsn=%ld, rc=%s", name_.c_str(), check_point_lsn_, strrc(rc));
+  }
+
+  LOG_INFO("checkpoint done. db=%s, check_point_lsn=%ld, flushed pages=%d", name_.c_str(), check_point_lsn_, flushed_count);
+  return RC::SUCCESS;
+}
+
+void Db::checkpoint_thread_func()
+{
+  thread_set_name("Checkpoint");
+
+  unique_lock<mutex> lock(checkpoint_thread_lock_);
+  while (checkpoint_running_) {
+    checkpoint_cv_.wait_for(lock, checkpoint_interval_);
+    if (!checkpoint_running_) {
+      break;
+    }
+
+    lock.unlock();
+    RC rc = checkpoint();
+    if (OB_FAIL(rc) && rc != RC::LOCKED_NEED_WAIT) {
+      LOG_WARN("failed to do checkpoint. db=%s, rc=%s", name_.c_str(), strrc(rc));
+    }
+    lock.lock();
+  }
+  LOG_INFO("checkpoint thread exit. db=%s", name_.c_str());
 }
 
 RC Db::recover()
@@ -292,7 +411,9 @@ RC Db::recover()
     return RC::INTERNAL;
   }
 
-  IntegratedLogReplayer log_replayer(*buffer_pool_manager_, unique_ptr<LogReplayer>(trx_log_replayer));
+  // 页面日志按照页面分区后并行回放，线程数与CPU核数一致
+  const int             worker_num = max(1, static_cast<int>(thread::hardware_concurrency()));
+  IntegratedLogReplayer log_replayer(*buffer_pool_manager_, unique_ptr<LogReplayer>(trx_log_replayer), worker_num);
   RC                    rc = log_handler_->replay(log_replayer, check_point_lsn_ /*start_lsn*/);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to replay log. rc=%s", strrc(rc));
@@ -345,10 +466,14 @@ RC Db::init_meta()
       return RC::IOERR_TOO_LONG;
     }
 
+    // 元数据是检查点LSN和当时的最大事务号，旧版本的元数据只有检查点LSN
     buffer[n]        = '\0';
-    check_point_lsn_ = atoll(buffer);  // 当前元数据就这一个数字
-    LOG_INFO("Successfully read db meta file. db=%s, file=%s, check_point_lsn=%ld", 
-             name_.c_str(), db_meta_file_path.c_str(), check_point_lsn_);
+    char *end        = nullptr;
+    check_point_lsn_ = strtoll(buffer, &end, 10);
+    int32_t trx_id   = static_cast<int32_t>(strtol(end, nullptr, 10));
+    trx_kit_->update_trx_id(trx_id);
+    LOG_INFO("Successfully read db meta file. db=%s, file=%s, check_point_lsn=%ld, trx_id=%d", 
+             name_.c_str(), db_meta_file_path.c_str(), check_point_lsn_, trx_id);
   }
   close(fd);
 
@@ -373,7 +498,9 @@ RC Db::flush_meta()
     return RC::IOERR_WRITE;
   }
 
-  string buffer = std::to_string(check_point_lsn_);
+  // 检查点之前的提交日志会被删除，需要记录下已经分配的事务号，重启后新事务的事务号要比它们大
+  const int32_t trx_id = trx_kit_->current_trx_id();
+  string        buffer = std::to_string(check_point_lsn_) + " " + std::to_string(trx_id);
   int    n      = write(fd, buffer.c_str(), buffer.size());
   if (n < 0) {
     LOG_ERROR("Failed to write db meta file. db=%s, file=%s, errno=%s", 
@@ -392,8 +519,8 @@ RC Db::flush_meta()
       rc = RC::IOERR_WRITE;
     } else {
 
-      LOG_INFO("Successfully write db meta file. db=%s, file=%s, check_point_lsn=%ld", 
-               name_.c_str(), temp_meta_file_path.c_str(), check_point_lsn_);
+      LOG_INFO("Successfully write db meta file. db=%s, file=%s, check_point_lsn=%ld, trx_id=%d", 
+               name_.c_str(), temp_meta_file_path.c_str(), check_point_lsn_, trx_id);
     }
   }
 
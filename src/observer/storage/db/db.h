@@ -20,6 +20,9 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/unordered_map.h"
 #include "common/lang/memory.h"
 #include "common/lang/span.h"
+#include "common/lang/mutex.h"
+#include "common/lang/thread.h"
+#include "common/lang/chrono.h"
 #include "sql/parser/parse_defs.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/clog/disk_log_handler.h"
@@ -89,6 +92,16 @@ public:
    */
   RC sync();
 
+  /**
+   * @brief 做一次模糊检查点(fuzzy checkpoint)
+   * @details 不需要停止事务。先把脏页刷出去(正在修改的页面会跳过)，然后取当前LSN、所有脏页的recLSN和
+   * 活跃事务第一条日志的LSN中最小的那个作为检查点，记录到元数据中。
+   * 恢复时从检查点开始重做，所有日志都在检查点之前的日志文件会被删除。
+   * 数据库启动后，会有一个后台线程定期调用这个函数。
+   * @return 如果有页面正在修改，不能确定检查点，返回 LOCKED_NEED_WAIT，检查点不会推进
+   */
+  RC checkpoint();
+
   /// @brief 获取当前数据库的日志处理器
   LogHandler &log_handler();
 
@@ -112,6 +125,9 @@ private:
   /// @brief 初始化数据库的double buffer pool
   RC init_dblwr_buffer();
 
+  /// @brief 后台定期做检查点的线程
+  void checkpoint_thread_func();
+
 private:
   string                         name_;                 ///< 数据库名称
   string                         path_;                 ///< 数据库文件存放的目录
@@ -124,4 +140,12 @@ private:
   int32_t next_table_id_ = 0;
 
   LSN check_point_lsn_ = 0;  ///< 当前数据库的检查点LSN。会记录到磁盘中。
+
+  mutex checkpoint_lock_;  ///< 同一时间只能做一个检查点，也保护 check_point_lsn_
+
+  unique_ptr<thread> checkpoint_thread_;               ///< 定期做检查点的线程
+  mutex              checkpoint_thread_lock_;
+  condition_variable checkpoint_cv_;                   ///< 用来唤醒检查点线程退出
+  bool               checkpoint_running_ = false;      ///< 由 checkpoint_thread_lock_ 保护
+  chrono::seconds    checkpoint_interval_{60};         ///< 做检查点的时间间隔
 };
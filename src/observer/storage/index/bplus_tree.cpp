@@ -14,8 +14,11 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include <span>
+#include <type_traits>
 
 #include "storage/index/bplus_tree.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/limits.h"
 #include "common/lang/lower_bound.h"
 #include "common/log/log.h"
 #include "common/global_context.h"
@@ -38,13 +41,75 @@ int calc_internal_page_capacity(int attr_length)
   return capacity;
 }
 
-int calc_leaf_page_capacity(int attr_length)
+int calc_leaf_page_capacity(int attr_length, int value_length)
 {
-  int item_size = attr_length + sizeof(RID) + sizeof(RID);
+  int item_size = attr_length + sizeof(RID) + value_length;
   int capacity  = ((int)BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE) / item_size;
   return capacity;
 }
 
+/**
+ * @brief 前缀压缩格式的叶子节点最多能放多少键值对
+ * @details 能放下的数量与键值的内容有关，这里按照键值内容全部被压缩掉计算，节点是否放得下由实际使用的空间决定
+ */
+int calc_prefix_leaf_page_capacity(int value_length)
+{
+  int item_size = sizeof(PrefixLeafSlot) + sizeof(RID) + value_length;
+  int capacity  = ((int)BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE - (int)sizeof(PrefixLeafHeader)) / item_size;
+  return capacity;
+}
+
+static_assert(BP_PAGE_DATA_SIZE <= numeric_limits<uint16_t>::max(), "page offset of prefix leaf should fit in uint16");
+
+namespace {
+
+int common_prefix_length(const char *s1, const char *s2, int length)
+{
+  int i = 0;
+  while (i < length && s1[i] == s2[i]) {
+    i++;
+  }
+  return i;
+}
+
+/// 去掉末尾的'\0'之后的长度
+int trimmed_length(const char *data, int length)
+{
+  while (length > 0 && data[length - 1] == 0) {
+    length--;
+  }
+  return length;
+}
+
+/// 公共前缀之后的4个字节按照大端组成的整数，整数的大小顺序与这4个字节按照 memcmp 比较的顺序一致
+uint32_t make_hint(const char *field, int field_length, int prefix_length)
+{
+  uint32_t hint = 0;
+  for (int i = prefix_length; i < prefix_length + 4; i++) {
+    const uint8_t byte = i < field_length ? static_cast<uint8_t>(field[i]) : 0;
+    hint               = (hint << 8) | byte;
+  }
+  return hint;
+}
+
+/// 找到第一个 hint 不小于指定值的 slot。没有分支的二分查找，循环次数只与 slot 的数量有关
+int hint_lower_bound(const PrefixLeafSlot *slots, int size, uint32_t hint)
+{
+  if (size <= 0) {
+    return 0;
+  }
+
+  const PrefixLeafSlot *base = slots;
+  while (size > 1) {
+    const int half = size / 2;
+    base           = (base[half].hint < hint) ? base + half : base;
+    size -= half;
+  }
+  return static_cast<int>(base - slots) + (base->hint < hint ? 1 : 0);
+}
+
+}  // namespace
+
 /////////////////////////////////////////////////////////////////////////////////
 IndexNodeHandler::IndexNodeHandler(BplusTreeMiniTransaction &mtr, const IndexFileHeader &header, Frame *frame)
     : mtr_(mtr), header_(header), frame_(frame), node_((IndexNode *)frame->data())
@@ -54,18 +119,14 @@ bool IndexNodeHandler::is_leaf() const { return node_->is_leaf; }
 void IndexNodeHandler::init_empty(bool leaf)
 {
   node_->is_leaf = leaf;
+  node_->format  = static_cast<uint8_t>(IndexFileHeader::CURRENT_FORMAT_VERSION);
   node_->key_num = 0;
-  node_->parent  = BP_INVALID_PAGE_NUM;
 }
 PageNum IndexNodeHandler::page_num() const { return frame_->page_num(); }
 
 int IndexNodeHandler::key_size() const { return header_.key_length; }
 
-int IndexNodeHandler::value_size() const
-{
-  // return header_.value_size;
-  return sizeof(RID);
-}
+int IndexNodeHandler::value_size() const { return header_.leaf_value_length(); }
 
 int IndexNodeHandler::item_size() const { return key_size() + value_size(); }
 
@@ -84,19 +145,6 @@ void IndexNodeHandler::increase_size(int n)
   node_->key_num += n; 
 }
 
-PageNum IndexNodeHandler::parent_page_num() const { return node_->parent; }
-
-RC IndexNodeHandler::set_parent_page_num(PageNum page_num) 
-{ 
-  RC rc = mtr_.logger().set_parent_page(*this, page_num, this->node_->parent);
-  if (OB_FAIL(rc)) {
-    LOG_WARN("failed to log set parent page. rc=%s", strrc(rc));
-    return rc;
-  }
-  this->node_->parent = page_num;
-  return rc;
-}
-
 /**
  * 检查一个节点经过插入或删除操作后是否需要分裂或合并操作
  * @return true 需要分裂或合并；
@@ -109,6 +157,12 @@ bool IndexNodeHandler::is_safe(BplusTreeOperationType op, bool is_root_node)
       return true;
     } break;
     case BplusTreeOperationType::INSERT: {
+      if (is_prefix_leaf()) {
+        // 不知道要插入的键值是什么，按照最坏的情况计算：键值完全不能压缩，并且公共前缀没有了
+        const int max_entry_size = sizeof(PrefixLeafSlot) + value_size() + key_size();
+        const int max_growth     = size() * prefix_header()->prefix_length;
+        return size() < max_size() && prefix_used_bytes() + max_entry_size + max_growth <= BP_PAGE_DATA_SIZE;
+      }
       return size() < max_size();
     } break;
     case BplusTreeOperationType::DELETE: {
@@ -120,6 +174,11 @@ bool IndexNodeHandler::is_safe(BplusTreeOperationType op, bool is_root_node)
         // 根节点还有子节点，但是如果删除一个子节点后，只剩一个子节点，就要把自己删除，把唯一的子节点变更为根节点
         return size() > 2;
       }
+      if (is_prefix_leaf() && size() <= min_size()) {
+        // 参考 is_underflow，删除最大的一个键值对之后空间仍然用了一半以上
+        const int max_entry_size = sizeof(PrefixLeafSlot) + value_size() + key_size();
+        return (prefix_used_bytes() - max_entry_size) * 2 >= BP_PAGE_DATA_SIZE;
+      }
       return size() > min_size();
     } break;
     default: {
@@ -131,21 +190,73 @@ bool IndexNodeHandler::is_safe(BplusTreeOperationType op, bool is_root_node)
   return false;
 }
 
+bool IndexNodeHandler::is_underflow() const
+{
+  if (size() >= min_size()) {
+    return false;
+  }
+
+  if (is_prefix_leaf()) {
+    // 压缩格式的节点能放下的键值对数量与键值的内容有关，空间也用了不到一半时才算数据太少
+    return prefix_used_bytes() * 2 < BP_PAGE_DATA_SIZE;
+  }
+  return true;
+}
+
+bool IndexNodeHandler::can_coalesce(const IndexNodeHandler &other) const
+{
+  if (size() + other.size() > max_size()) {
+    return false;
+  }
+
+  if (!is_prefix_leaf() || size() == 0 || other.size() == 0) {
+    return true;
+  }
+
+  // 合并后的公共前缀可能会变短，每个键值对最多增加公共前缀缩短的长度
+  const int this_prefix_length  = prefix_header()->prefix_length;
+  const int other_prefix_length = other.prefix_header()->prefix_length;
+  const int prefix_length       = common_prefix_length(
+      prefix_data(), other.prefix_data(), min(this_prefix_length, other_prefix_length));
+
+  const int this_bytes  = prefix_used_bytes() - prefix_slots_offset(this_prefix_length) +
+                         size() * (this_prefix_length - prefix_length);
+  const int other_bytes = other.prefix_used_bytes() - prefix_slots_offset(other_prefix_length) +
+                          other.size() * (other_prefix_length - prefix_length);
+  return prefix_slots_offset(prefix_length) + this_bytes + other_bytes <= BP_PAGE_DATA_SIZE;
+}
+
+int IndexNodeHandler::prefix_slots_offset(int prefix_length)
+{
+  const int offset = LeafIndexNode::HEADER_SIZE + sizeof(PrefixLeafHeader) + prefix_length;
+  return (offset + alignof(PrefixLeafSlot) - 1) / alignof(PrefixLeafSlot) * alignof(PrefixLeafSlot);
+}
+
+int IndexNodeHandler::prefix_used_bytes() const
+{
+  const PrefixLeafHeader *header = prefix_header();
+  return prefix_slots_offset(header->prefix_length) + size() * static_cast<int>(sizeof(PrefixLeafSlot)) +
+         (BP_PAGE_DATA_SIZE - header->heap_offset - header->garbage);
+}
+
 string to_string(const IndexNodeHandler &handler)
 {
   stringstream ss;
 
   ss << "PageNum:" << handler.page_num() << ",is_leaf:" << handler.is_leaf() << ","
-     << "key_num:" << handler.size() << ","
-     << "parent:" << handler.parent_page_num() << ",";
+     << "key_num:" << handler.size() << ",";
 
   return ss.str();
 }
 
-bool IndexNodeHandler::validate() const
+bool IndexNodeHandler::validate(bool is_root_node) const
 {
-  if (parent_page_num() == BP_INVALID_PAGE_NUM) {
-    // this is a root page
+  if (node_->format != static_cast<uint8_t>(IndexFileHeader::CURRENT_FORMAT_VERSION)) {
+    LOG_WARN("invalid node format. page num=%d, format=%d", page_num(), node_->format);
+    return false;
+  }
+
+  if (is_root_node) {
     if (size() < 1) {
       LOG_WARN("root page has no item");
       return false;
@@ -196,18 +307,21 @@ RC LeafIndexNodeHandler::init_empty()
   }
   IndexNodeHandler::init_empty(true/*leaf*/);
   leaf_node_->next_brother = BP_INVALID_PAGE_NUM;
+  if (is_prefix_leaf()) {
+    prefix_rebuild(nullptr, 0);
+  }
   return RC::SUCCESS;
 }
 
-RC LeafIndexNodeHandler::set_next_page(PageNum page_num) 
-{ 
+RC LeafIndexNodeHandler::set_next_page(PageNum page_num)
+{
   RC rc = mtr_.logger().leaf_set_next_page(*this, page_num, leaf_node_->next_brother);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log set next page. rc=%s", strrc(rc));
     return rc;
   }
 
-  leaf_node_->next_brother = page_num; 
+  leaf_node_->next_brother = page_num;
   return RC::SUCCESS;
 }
 
@@ -216,17 +330,25 @@ PageNum LeafIndexNodeHandler::next_page() const { return leaf_node_->next_brothe
 char *LeafIndexNodeHandler::key_at(int index)
 {
   assert(index >= 0 && index < size());
-  return __key_at(index);
+  return decode_key_at(index);
 }
 
 char *LeafIndexNodeHandler::value_at(int index)
 {
   assert(index >= 0 && index < size());
+  if (is_prefix_leaf()) {
+    // 堆区中的键值对以 value 开头
+    return reinterpret_cast<char *>(node_) + prefix_slots()[index].offset;
+  }
   return __value_at(index);
 }
 
 int LeafIndexNodeHandler::lookup(const KeyComparator &comparator, const char *key, bool *found /* = nullptr */) const
 {
+  if (is_prefix_leaf()) {
+    return prefix_lookup(comparator, key, found);
+  }
+
   const int                    size = this->size();
   common::BinaryIterator<char> iter_begin(item_size(), __key_at(0));
   common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
@@ -234,6 +356,147 @@ int LeafIndexNodeHandler::lookup(const KeyComparator &comparator, const char *ke
   return iter - iter_begin;
 }
 
+bool LeafIndexNodeHandler::can_insert(const char *key) const
+{
+  if (size() >= max_size()) {
+    return false;
+  }
+
+  if (!is_prefix_leaf() || size() == 0) {
+    return true;
+  }
+
+  char item[PREFIX_MAX_ITEM_SIZE];
+  memcpy(item, key, key_size());
+  normalize_key(item);
+
+  // 键值与当前的公共前缀不同时，公共前缀会变短，每个已有的键值对最多增加公共前缀缩短的长度
+  const PrefixLeafHeader *header         = prefix_header();
+  const int               prefix_length  = common_prefix_length(item, prefix_data(), header->prefix_length);
+  const int               growth         = size() * (header->prefix_length - prefix_length);
+  const int               new_entry_size = sizeof(PrefixLeafSlot) + prefix_entry_length(item, prefix_length);
+  const int used_bytes = prefix_used_bytes() - prefix_slots_offset(header->prefix_length) + prefix_slots_offset(prefix_length);
+  return used_bytes + growth + new_entry_size <= BP_PAGE_DATA_SIZE;
+}
+
+int LeafIndexNodeHandler::split_position(const char *key, int insert_position, bool &insert_left) const
+{
+  const int size = this->size();
+  if (!is_prefix_leaf()) {
+    const int move_index = size / 2;
+    insert_left          = insert_position < move_index;
+    return move_index;
+  }
+
+  // 把新的键值放进去，模拟拆分之后两个节点实际使用的空间
+  const int    item_size   = this->item_size();
+  const int    num         = size + 1;
+  const int    field_length = header_.attr_lengths[0];
+  vector<char> items(static_cast<size_t>(num) * item_size);
+  copy_items(0, insert_position, items.data());
+  char *new_item = items.data() + static_cast<size_t>(insert_position) * item_size;
+  memcpy(new_item, key, key_size());
+  memset(new_item + key_size(), 0, value_size());
+  normalize_key(new_item);
+  copy_items(insert_position, size - insert_position, new_item + item_size);
+
+  vector<int> lengths(num);
+  for (int i = 0; i < num; i++) {
+    lengths[i] = trimmed_length(items.data() + static_cast<size_t>(i) * item_size, header_.attr_length);
+  }
+
+  const int fixed_entry_size = sizeof(PrefixLeafSlot) + value_size() + sizeof(RID);
+  auto      used_bytes       = [&](int begin, int end) {
+    const int prefix_length = common_prefix_length(items.data() + static_cast<size_t>(begin) * item_size,
+        items.data() + static_cast<size_t>(end - 1) * item_size, field_length);
+    int bytes = prefix_slots_offset(prefix_length) + (end - begin) * fixed_entry_size;
+    for (int i = begin; i < end; i++) {
+      bytes += max(0, lengths[i] - prefix_length);
+    }
+    return bytes;
+  };
+
+  // 先找到按照空间对半拆分的位置，再从这个位置向两边找，直到两边都能放下
+  const int total_prefix_length = common_prefix_length(
+      items.data(), items.data() + static_cast<size_t>(num - 1) * item_size, field_length);
+  int total_bytes = 0;
+  for (int i = 0; i < num; i++) {
+    total_bytes += fixed_entry_size + max(0, lengths[i] - total_prefix_length);
+  }
+  int half_index = 1;
+  for (int bytes = 0; half_index < num - 1; half_index++) {
+    bytes += fixed_entry_size + max(0, lengths[half_index - 1] - total_prefix_length);
+    if (bytes * 2 >= total_bytes) {
+      break;
+    }
+  }
+
+  int split_index = -1;
+  for (int distance = 0; split_index < 0 && distance < num; distance++) {
+    for (int index : {half_index + distance, half_index - distance}) {
+      if (index < 1 || index > num - 1 || index > max_size() || num - index > max_size()) {
+        continue;
+      }
+      if (used_bytes(0, index) <= BP_PAGE_DATA_SIZE && used_bytes(index, num) <= BP_PAGE_DATA_SIZE) {
+        split_index = index;
+        break;
+      }
+    }
+  }
+
+  if (split_index < 0) {
+    LOG_ERROR("cannot find a split position for leaf node. page num=%d, size=%d", page_num(), size);
+    split_index = num / 2;
+  }
+
+  // 拆分后左边的节点保留 [0, split_index) 的键值对，其中包括新的键值
+  insert_left = insert_position < split_index;
+  return insert_left ? split_index - 1 : split_index;
+}
+
+int LeafIndexNodeHandler::fit_count(const char *items, int num) const
+{
+  const int limit = min(num, max_size());
+  if (!is_prefix_leaf() || limit <= 0) {
+    return limit;
+  }
+
+  // 有序的键值对的公共前缀就是第一个和最后一个的公共前缀，公共前缀只会越来越短，占用的空间只会越来越大
+  const int item_size        = this->item_size();
+  const int field_length     = header_.attr_lengths[0];
+  const int fixed_entry_size = sizeof(PrefixLeafSlot) + value_size() + sizeof(RID);
+
+  vector<char> first(item_size);
+  vector<char> item(item_size);
+  vector<int>  lengths;
+  lengths.reserve(limit);
+  memcpy(first.data(), items, item_size);
+  normalize_key(first.data());
+
+  int prefix_length = field_length;
+  int suffix_bytes  = 0;
+  for (int i = 0; i < limit; i++) {
+    memcpy(item.data(), items + static_cast<size_t>(i) * item_size, item_size);
+    normalize_key(item.data());
+    lengths.push_back(trimmed_length(item.data(), header_.attr_length));
+
+    const int new_prefix_length = min(prefix_length, common_prefix_length(first.data(), item.data(), field_length));
+    if (new_prefix_length != prefix_length) {
+      prefix_length = new_prefix_length;
+      suffix_bytes  = 0;
+      for (int j = 0; j < i; j++) {
+        suffix_bytes += max(0, lengths[j] - prefix_length);
+      }
+    }
+    suffix_bytes += max(0, lengths[i] - prefix_length);
+
+    if (prefix_slots_offset(prefix_length) + (i + 1) * fixed_entry_size + suffix_bytes > BP_PAGE_DATA_SIZE) {
+      return i;
+    }
+  }
+  return limit;
+}
+
 RC LeafIndexNodeHandler::insert(int index, const char *key, const char *value)
 {
   vector<char> item(key_size() + value_size());
@@ -254,7 +517,9 @@ RC LeafIndexNodeHandler::remove(int index)
 {
   assert(index >= 0 && index < size());
 
-  RC rc = mtr_.logger().node_remove_items(*this, index, span<const char>(__item_at(index), item_size()), 1);
+  vector<char> item(item_size());
+  copy_items(index, 1, item.data());
+  RC rc = mtr_.logger().node_remove_items(*this, index, item, 1);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log remove item. rc=%s", strrc(rc));
     return rc;
@@ -275,15 +540,23 @@ int LeafIndexNodeHandler::remove(const char *key, const KeyComparator &comparato
   return 0;
 }
 
-RC LeafIndexNodeHandler::move_half_to(LeafIndexNodeHandler &other)
+RC LeafIndexNodeHandler::move_half_to(LeafIndexNodeHandler &other, int move_index /* = -1 */)
 {
-  const int size       = this->size();
-  const int move_index = size / 2;
+  const int size = this->size();
+  if (move_index < 0) {
+    move_index = size / 2;
+  }
   const int move_item_num = size - move_index;
+  if (move_item_num <= 0) {
+    return RC::SUCCESS;
+  }
+
+  vector<char> items(static_cast<size_t>(move_item_num) * item_size());
+  copy_items(move_index, move_item_num, items.data());
 
-  other.append(__item_at(move_index), move_item_num);
+  other.append(items.data(), move_item_num);
 
-  RC rc = mtr_.logger().node_remove_items(*this, move_index, span<const char>(__item_at(move_index), move_item_num * item_size()), move_item_num);
+  RC rc = mtr_.logger().node_remove_items(*this, move_index, items, move_item_num);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink leaf node. rc=%s", strrc(rc));
     return rc;
@@ -294,14 +567,18 @@ RC LeafIndexNodeHandler::move_half_to(LeafIndexNodeHandler &other)
 }
 RC LeafIndexNodeHandler::move_first_to_end(LeafIndexNodeHandler &other)
 {
-  other.append(__item_at(0));
+  vector<char> item(item_size());
+  copy_items(0, 1, item.data());
+  other.append(item.data());
 
   return this->remove(0);
 }
 
 RC LeafIndexNodeHandler::move_last_to_front(LeafIndexNodeHandler &other)
 {
-  other.preappend(__item_at(size() - 1));
+  vector<char> item(item_size());
+  copy_items(size() - 1, 1, item.data());
+  other.preappend(item.data());
 
   this->remove(size() - 1);
   return RC::SUCCESS;
@@ -311,14 +588,17 @@ RC LeafIndexNodeHandler::move_last_to_front(LeafIndexNodeHandler &other)
  */
 RC LeafIndexNodeHandler::move_to(LeafIndexNodeHandler &other)
 {
-  other.append(__item_at(0), this->size());
+  vector<char> items(static_cast<size_t>(this->size()) * item_size());
+  copy_items(0, this->size(), items.data());
+
+  other.append(items.data(), this->size());
   other.set_next_page(this->next_page());
 
-  RC rc = mtr_.logger().node_remove_items(*this, 0, span<const char>(__item_at(0), this->size() * item_size()), this->size());
+  RC rc = mtr_.logger().node_remove_items(*this, 0, items, this->size());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink leaf node. rc=%s", strrc(rc));
   }
-  this->increase_size(-this->size());
+  recover_remove_items(0, this->size());
 
   return RC::SUCCESS;
 }
@@ -345,37 +625,280 @@ RC LeafIndexNodeHandler::preappend(const char *item)
   return insert(0, item, item + key_size());
 }
 
-char *LeafIndexNodeHandler::__item_at(int index) const { return leaf_node_->array + (index * item_size()); }
+RC LeafIndexNodeHandler::recover_insert_items(int index, const char *items, int num)
+{
+  if (!is_prefix_leaf()) {
+    return IndexNodeHandler::recover_insert_items(index, items, num);
+  }
+
+  const int    item_size = this->item_size();
+  const int    size      = this->size();
+  vector<char> new_items(items, items + static_cast<size_t>(num) * item_size);
+  for (int i = 0; i < num; i++) {
+    normalize_key(new_items.data() + static_cast<size_t>(i) * item_size);
+  }
+
+  // 大部分情况是插入一个键值对，公共前缀没有变化，并且空闲空间足够，直接放到堆区中
+  PrefixLeafHeader *header = prefix_header();
+  if (num == 1 && size > 0 && 0 == memcmp(new_items.data(), prefix_data(), header->prefix_length)) {
+    const int prefix_length = header->prefix_length;
+    const int entry_length  = prefix_entry_length(new_items.data(), prefix_length);
+    const int slots_end     = prefix_slots_offset(prefix_length) + (size + 1) * static_cast<int>(sizeof(PrefixLeafSlot));
+    if (slots_end + entry_length <= header->heap_offset) {
+      PrefixLeafSlot *slots = prefix_slots();
+      memmove(&slots[index + 1], &slots[index], (static_cast<size_t>(size) - index) * sizeof(PrefixLeafSlot));
+
+      header->heap_offset -= entry_length;
+      prefix_write_entry(reinterpret_cast<char *>(node_) + header->heap_offset, new_items.data(), prefix_length);
+      slots[index].hint   = make_hint(new_items.data(), header_.attr_lengths[0], prefix_length);
+      slots[index].offset = header->heap_offset;
+      slots[index].length = entry_length;
+      increase_size(1);
+      return RC::SUCCESS;
+    }
+  }
+
+  // 公共前缀变短了，或者连续的空闲空间不够，就重新生成整个页面
+  vector<char> all_items(static_cast<size_t>(size + num) * item_size);
+  copy_items(0, index, all_items.data());
+  memcpy(all_items.data() + static_cast<size_t>(index) * item_size, new_items.data(), new_items.size());
+  copy_items(index, size - index, all_items.data() + static_cast<size_t>(index + num) * item_size);
+  prefix_rebuild(all_items.data(), size + num);
+  return RC::SUCCESS;
+}
+
+RC LeafIndexNodeHandler::recover_remove_items(int index, int num)
+{
+  if (!is_prefix_leaf()) {
+    return IndexNodeHandler::recover_remove_items(index, num);
+  }
+
+  PrefixLeafHeader *header = prefix_header();
+  PrefixLeafSlot   *slots  = prefix_slots();
+  for (int i = index; i < index + num; i++) {
+    header->garbage += slots[i].length;
+  }
+  memmove(&slots[index], &slots[index + num], (static_cast<size_t>(size()) - index - num) * sizeof(PrefixLeafSlot));
+  increase_size(-num);
+
+  if (size() == 0) {
+    prefix_rebuild(nullptr, 0);
+  }
+  return RC::SUCCESS;
+}
+
+char *LeafIndexNodeHandler::__item_at(int index) const
+{
+  ASSERT(!is_prefix_leaf(), "cannot access item by address in prefix compressed leaf");
+  return leaf_node_->array + (index * item_size());
+}
+
+char *LeafIndexNodeHandler::decode_key_at(int index) const
+{
+  if (!is_prefix_leaf()) {
+    return __key_at(index);
+  }
+
+  prefix_decode_item(index, key_buffer_);
+  return key_buffer_;
+}
+
+void LeafIndexNodeHandler::copy_items(int index, int num, char *items) const
+{
+  if (num <= 0) {
+    return;
+  }
+
+  if (!is_prefix_leaf()) {
+    memcpy(items, __item_at(index), static_cast<size_t>(num) * item_size());
+    return;
+  }
+
+  for (int i = 0; i < num; i++) {
+    prefix_decode_item(index + i, items + static_cast<size_t>(i) * item_size());
+  }
+}
+
+void LeafIndexNodeHandler::normalize_key(char *key) const
+{
+  const int field_length = header_.attr_lengths[0];
+  char     *end          = static_cast<char *>(memchr(key, 0, field_length));
+  if (end != nullptr) {
+    memset(end, 0, key + field_length - end);
+  }
+}
+
+PrefixLeafSlot *LeafIndexNodeHandler::prefix_slots() const
+{
+  return reinterpret_cast<PrefixLeafSlot *>(
+      reinterpret_cast<char *>(node_) + prefix_slots_offset(prefix_header()->prefix_length));
+}
+
+int LeafIndexNodeHandler::prefix_lookup(const KeyComparator &comparator, const char *key, bool *found) const
+{
+  if (found != nullptr) {
+    *found = false;
+  }
+
+  const int size = this->size();
+  if (size == 0) {
+    return 0;
+  }
+
+  const int field_length = header_.attr_lengths[0];
+  char      field[PREFIX_MAX_ITEM_SIZE];
+  memcpy(field, key, field_length);
+  normalize_key(field);
+
+  // 与公共前缀不同的键值，一定比所有的键值都小或者都大
+  const PrefixLeafHeader *header        = prefix_header();
+  const int               prefix_length = header->prefix_length;
+  const int               cmp           = memcmp(field, prefix_data(), prefix_length);
+  if (cmp < 0) {
+    return 0;
+  }
+  if (cmp > 0) {
+    return size;
+  }
+
+  // 先用 hint 找到可能相等的范围，只有 hint 相同的键值对才需要解码比较
+  const PrefixLeafSlot *slots = prefix_slots();
+  const uint32_t        hint  = make_hint(field, field_length, prefix_length);
+  int                   low   = hint_lower_bound(slots, size, hint);
+  int                   high  = low;
+  while (high < size && slots[high].hint == hint) {
+    high++;
+  }
+  const int hint_end = high;
+
+  while (low < high) {
+    const int mid = low + (high - low) / 2;
+    if (comparator(decode_key_at(mid), key) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  if (found != nullptr && low < hint_end) {
+    *found = (0 == comparator(decode_key_at(low), key));
+  }
+  return low;
+}
+
+void LeafIndexNodeHandler::prefix_decode_item(int index, char *item) const
+{
+  const PrefixLeafSlot &slot          = prefix_slots()[index];
+  const char           *entry         = reinterpret_cast<const char *>(node_) + slot.offset;
+  const int             prefix_length = prefix_header()->prefix_length;
+  const int             suffix_length = slot.length - value_size() - static_cast<int>(sizeof(RID));
+
+  memcpy(item, prefix_data(), prefix_length);
+  memcpy(item + prefix_length, entry + value_size() + sizeof(RID), suffix_length);
+  memset(item + prefix_length + suffix_length, 0, header_.attr_length - prefix_length - suffix_length);
+  memcpy(item + header_.attr_length, entry + value_size(), sizeof(RID));
+  memcpy(item + key_size(), entry, value_size());
+}
+
+int LeafIndexNodeHandler::prefix_entry_length(const char *item, int prefix_length) const
+{
+  const int suffix_length = max(0, trimmed_length(item, header_.attr_length) - prefix_length);
+  return value_size() + sizeof(RID) + suffix_length;
+}
+
+void LeafIndexNodeHandler::prefix_write_entry(char *entry, const char *item, int prefix_length) const
+{
+  const int suffix_length = prefix_entry_length(item, prefix_length) - value_size() - static_cast<int>(sizeof(RID));
+  memcpy(entry, item + key_size(), value_size());
+  memcpy(entry + value_size(), item + header_.attr_length, sizeof(RID));
+  memcpy(entry + value_size() + sizeof(RID), item + prefix_length, suffix_length);
+}
+
+void LeafIndexNodeHandler::prefix_rebuild(const char *items, int num)
+{
+  const int item_size    = this->item_size();
+  const int field_length = header_.attr_lengths[0];
+
+  int prefix_length = 0;
+  if (num > 0) {
+    prefix_length = common_prefix_length(items, items + static_cast<size_t>(num - 1) * item_size, field_length);
+  }
+
+  // 先在临时的页面中生成，因为 items 可能就是从当前页面解码出来的
+  vector<char>      page(BP_PAGE_DATA_SIZE);
+  PrefixLeafHeader *header = reinterpret_cast<PrefixLeafHeader *>(page.data() + LeafIndexNode::HEADER_SIZE);
+  PrefixLeafSlot   *slots  = reinterpret_cast<PrefixLeafSlot *>(page.data() + prefix_slots_offset(prefix_length));
+  if (num > 0) {
+    memcpy(reinterpret_cast<char *>(header + 1), items, prefix_length);
+  }
+
+  int heap_offset = BP_PAGE_DATA_SIZE;
+  for (int i = 0; i < num; i++) {
+    const char *item         = items + static_cast<size_t>(i) * item_size;
+    const int   entry_length = prefix_entry_length(item, prefix_length);
+    heap_offset -= entry_length;
+    prefix_write_entry(page.data() + heap_offset, item, prefix_length);
+    slots[i].hint   = make_hint(item, field_length, prefix_length);
+    slots[i].offset = heap_offset;
+    slots[i].length = entry_length;
+  }
+  ASSERT(reinterpret_cast<char *>(slots + num) <= page.data() + heap_offset,
+         "prefix leaf page overflow. page num=%d, item num=%d", page_num(), num);
+
+  header->prefix_length = prefix_length;
+  header->heap_offset   = heap_offset;
+  header->garbage       = 0;
+  header->reserved      = 0;
+
+  memcpy(reinterpret_cast<char *>(node_) + LeafIndexNode::HEADER_SIZE,
+      page.data() + LeafIndexNode::HEADER_SIZE,
+      BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE);
+  node_->key_num = num;
+}
 
 string to_string(const LeafIndexNodeHandler &handler, const KeyPrinter &printer)
 {
   stringstream ss;
   ss << to_string((const IndexNodeHandler &)handler) << ",next page:" << handler.next_page();
-  ss << ",values=[" << printer(handler.__key_at(0));
-  for (int i = 1; i < handler.size(); i++) {
-    ss << "," << printer(handler.__key_at(i));
+  ss << ",values=[";
+  for (int i = 0; i < handler.size(); i++) {
+    if (i > 0) {
+      ss << ",";
+    }
+    ss << printer(handler.decode_key_at(i));
   }
   ss << "]";
   return ss.str();
 }
 
-bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferPool *bp) const
+bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferPool *bp, PageNum parent_page_num) const
 {
-  bool result = IndexNodeHandler::validate();
+  bool result = IndexNodeHandler::validate(parent_page_num == BP_INVALID_PAGE_NUM);
   if (false == result) {
     return false;
   }
 
+  if (is_prefix_leaf()) {
+    const PrefixLeafHeader *header    = prefix_header();
+    const int               slots_end = prefix_slots_offset(header->prefix_length) + size() * sizeof(PrefixLeafSlot);
+    if (slots_end > header->heap_offset || prefix_used_bytes() > BP_PAGE_DATA_SIZE) {
+      LOG_WARN("invalid prefix leaf node. page num=%d, slots end=%d, heap offset=%d, garbage=%d",
+               page_num(), slots_end, header->heap_offset, header->garbage);
+      return false;
+    }
+  }
+
   const int node_size = size();
+  vector<char> prev_key(key_size());
   for (int i = 1; i < node_size; i++) {
-    if (comparator(__key_at(i - 1), __key_at(i)) >= 0) {
+    memcpy(prev_key.data(), decode_key_at(i - 1), key_size());
+    if (comparator(prev_key.data(), decode_key_at(i)) >= 0) {
       LOG_WARN("page number = %d, invalid key order. id1=%d,id2=%d, this=%s",
                page_num(), i - 1, i, to_string(*this).c_str());
       return false;
     }
   }
 
-  PageNum parent_page_num = this->parent_page_num();
   if (parent_page_num == BP_INVALID_PAGE_NUM) {
     return true;
   }
@@ -397,7 +920,7 @@ bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferP
   }
 
   if (0 != index_in_parent) {
-    int cmp_result = comparator(__key_at(0), parent_node.key_at(index_in_parent));
+    int cmp_result = comparator(decode_key_at(0), parent_node.key_at(index_in_parent));
     if (cmp_result < 0) {
       LOG_WARN("invalid leaf node. first item should be greate than or equal to parent item. "
                "this page num=%d, parent page num=%d, index in parent=%d",
@@ -408,7 +931,7 @@ bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferP
   }
 
   if (index_in_parent < parent_node.size() - 1) {
-    int cmp_result = comparator(__key_at(size() - 1), parent_node.key_at(index_in_parent + 1));
+    int cmp_result = comparator(decode_key_at(size() - 1), parent_node.key_at(index_in_parent + 1));
     if (cmp_result >= 0) {
       LOG_WARN("invalid leaf node. last item should be less than the item at the first after item in parent."
                "this page num=%d, parent page num=%d, parent item to compare=%d",
@@ -469,8 +992,7 @@ RC InternalIndexNodeHandler::create_new_root(PageNum first_page_num, const char
  * @brief insert one entry
  * @details the entry to be inserted will never at the first slot.
  * the right child page after split will always have bigger keys.
- * @NOTE We don't need to set child's parent page num here. You can see the callers for details
- * It's also friendly to unittest that we don't set the child's parent page num.
+ * @NOTE 子节点中不记录父节点，所以这里不需要修改子节点
  */
 RC InternalIndexNodeHandler::insert(const char *key, PageNum page_num, const KeyComparator &comparator)
 {
@@ -637,28 +1159,8 @@ RC InternalIndexNodeHandler::insert_items(int index, const char *items, int num)
     return rc;
   }
 
-  recover_insert_items(index, items, num);
-
-  LatchMemo &latch_memo = mtr_.latch_memo();
-  PageNum this_page_num = this->page_num();
-  Frame *frame = nullptr;
-
-  // 设置所有页面的父页面为当前页面
-  // 这里会访问大量的页面，可能会将他们从磁盘加载到内存中而占用大量的buffer pool页面
-  for (int i = 0; i < num; i++) {
-    const PageNum page_num = *(const PageNum *)((items + i * item_size()) + key_size());
-    rc = latch_memo.get_page(page_num, frame);
-    if (OB_FAIL(rc)) {
-      LOG_WARN("failed to set child's page num. child page num:%d, this page num=%d, rc=%d:%s",
-               page_num, this_page_num, rc, strrc(rc));
-      return rc;
-    }
-    IndexNodeHandler child_node(mtr_, header_, frame);
-    child_node.set_parent_page_num(this_page_num); // 这里虽然对页面做了修改，但是并没有加写锁，因为父页面加了锁
-    frame->mark_dirty();
-  }
-
-  return RC::SUCCESS;
+  // 子节点中不记录父节点，所以不需要访问和修改移动过来的子节点
+  return recover_insert_items(index, items, num);
 }
 
 /**
@@ -682,9 +1184,9 @@ int InternalIndexNodeHandler::value_size() const { return sizeof(PageNum); }
 
 int InternalIndexNodeHandler::item_size() const { return key_size() + this->value_size(); }
 
-bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferPool *bp) const
+bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferPool *bp, PageNum parent_page_num) const
 {
-  bool result = IndexNodeHandler::validate();
+  bool result = IndexNodeHandler::validate(parent_page_num == BP_INVALID_PAGE_NUM);
   if (false == result) {
     return false;
   }
@@ -698,33 +1200,14 @@ bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, DiskBuf
     }
   }
 
-  for (int i = 0; result && i < node_size; i++) {
+  for (int i = 0; i < node_size; i++) {
     PageNum page_num = *(PageNum *)__value_at(i);
     if (page_num < 0) {
       LOG_WARN("this page num=%d, got invalid child page. page num=%d", this->page_num(), page_num);
-    } else {
-      Frame *child_frame = nullptr;
-      RC     rc = bp->get_this_page(page_num, &child_frame);
-      if (OB_FAIL(rc)) {
-        LOG_WARN("failed to fetch child page while validate internal page. page num=%d, rc=%d:%s", 
-                 page_num, rc, strrc(rc));
-      } else {
-        IndexNodeHandler child_node(mtr_, header_, child_frame);
-        if (child_node.parent_page_num() != this->page_num()) {
-          LOG_WARN("child's parent page num is invalid. child page num=%d, parent page num=%d, this page num=%d",
-              child_node.page_num(), child_node.parent_page_num(), this->page_num());
-          result = false;
-        }
-        bp->unpin_page(child_frame);
-      }
+      return false;
     }
   }
 
-  if (!result) {
-    return result;
-  }
-
-  const PageNum parent_page_num = this->parent_page_num();
   if (parent_page_num == BP_INVALID_PAGE_NUM) {
     return result;
   }
@@ -801,6 +1284,24 @@ RC BplusTreeHandler::create(LogHandler &log_handler,
                             int attr_length, 
                             int internal_max_size /* = -1*/,
                             int leaf_max_size /* = -1 */)
+{
+  return this->create(log_handler,
+      bpm,
+      file_name,
+      vector<AttrType>{attr_type},
+      vector<int>{attr_length},
+      internal_max_size,
+      leaf_max_size);
+}
+
+RC BplusTreeHandler::create(LogHandler &log_handler,
+                            BufferPoolManager &bpm,
+                            const char *file_name, 
+                            const vector<AttrType> &attr_types, 
+                            const vector<int> &attr_lengths, 
+                            int internal_max_size /* = -1*/,
+                            int leaf_max_size /* = -1 */,
+                            int include_length /* = 0 */)
 {
   RC rc = bpm.create_file(file_name);
   if (OB_FAIL(rc)) {
@@ -818,7 +1319,7 @@ RC BplusTreeHandler::create(LogHandler &log_handler,
   }
   LOG_INFO("Successfully open index file %s.", file_name);
 
-  rc = this->create(log_handler, *bp, attr_type, attr_length, internal_max_size, leaf_max_size);
+  rc = this->create(log_handler, *bp, attr_types, attr_lengths, internal_max_size, leaf_max_size, include_length);
   if (OB_FAIL(rc)) {
     bpm.close_file(file_name);
     return rc;
@@ -835,11 +1336,52 @@ RC BplusTreeHandler::create(LogHandler &log_handler,
             int internal_max_size /* = -1 */,
             int leaf_max_size /* = -1 */)
 {
+  return this->create(
+      log_handler, buffer_pool, vector<AttrType>{attr_type}, vector<int>{attr_length}, internal_max_size, leaf_max_size);
+}
+
+RC BplusTreeHandler::create(LogHandler &log_handler,
+            DiskBufferPool &buffer_pool,
+            const vector<AttrType> &attr_types,
+            const vector<int> &attr_lengths,
+            int internal_max_size /* = -1 */,
+            int leaf_max_size /* = -1 */,
+            int include_length /* = 0 */)
+{
+  if (attr_types.empty() || attr_types.size() != attr_lengths.size() ||
+      attr_types.size() > static_cast<size_t>(IndexFileHeader::MAX_ATTR_NUM)) {
+    LOG_WARN("invalid attributes of bplus tree. attr num=%d, length num=%d",
+             static_cast<int>(attr_types.size()), static_cast<int>(attr_lengths.size()));
+    return RC::INVALID_ARGUMENT;
+  }
+
+  int attr_length = 0;
+  for (int length : attr_lengths) {
+    attr_length += length;
+  }
+
+  // 包含列太长时一个叶子节点放不下几个键值对，不如直接回表
+  const int value_length = static_cast<int>(sizeof(RID)) + include_length;
+  const int leaf_item_size = attr_length + static_cast<int>(sizeof(RID)) + value_length;
+  if (include_length < 0 || (include_length > 0 && leaf_item_size > BP_PAGE_DATA_SIZE / 8)) {
+    LOG_WARN("invalid include length of bplus tree. include length=%d, leaf item size=%d",
+             include_length, leaf_item_size);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  // 第一个字段是字符串时，叶子节点使用前缀压缩的格式。键值太长时一个页面放不了几个键值对，就不压缩了
+  int32_t leaf_format = IndexFileHeader::LEAF_FORMAT_PLAIN;
+  if (attr_types[0] == AttrType::CHARS && leaf_item_size <= LeafIndexNodeHandler::PREFIX_MAX_ITEM_SIZE) {
+    leaf_format = IndexFileHeader::LEAF_FORMAT_PREFIX;
+  }
+
   if (internal_max_size < 0) {
     internal_max_size = calc_internal_page_capacity(attr_length);
   }
   if (leaf_max_size < 0) {
-    leaf_max_size = calc_leaf_page_capacity(attr_length);
+    leaf_max_size = (leaf_format == IndexFileHeader::LEAF_FORMAT_PREFIX)
+                        ? calc_prefix_leaf_page_capacity(value_length)
+                        : calc_leaf_page_capacity(attr_length, value_length);
   }
 
   log_handler_      = &log_handler;
@@ -867,10 +1409,18 @@ RC BplusTreeHandler::create(LogHandler &log_handler,
   IndexFileHeader *file_header   = (IndexFileHeader *)pdata;
   file_header->attr_length       = attr_length;
   file_header->key_length        = attr_length + sizeof(RID);
-  file_header->attr_type         = attr_type;
+  file_header->attr_type         = attr_types[0];
+  file_header->attr_num          = static_cast<int32_t>(attr_types.size());
+  for (size_t i = 0; i < attr_types.size(); i++) {
+    file_header->attr_types[i]   = attr_types[i];
+    file_header->attr_lengths[i] = attr_lengths[i];
+  }
   file_header->internal_max_size = internal_max_size;
   file_header->leaf_max_size     = leaf_max_size;
   file_header->root_page         = BP_INVALID_PAGE_NUM;
+  file_header->format_version    = IndexFileHeader::CURRENT_FORMAT_VERSION;
+  file_header->leaf_format       = leaf_format;
+  file_header->value_length      = value_length;
 
   // 取消记录日志的原因请参考下面的sync调用的地方。
   // mtr.logger().init_header_page(header_frame, *file_header);
@@ -887,8 +1437,7 @@ RC BplusTreeHandler::create(LogHandler &log_handler,
     return RC::NOMEM;
   }
 
-  key_comparator_.init(file_header->attr_type, file_header->attr_length);
-  key_printer_.init(file_header->attr_type, file_header->attr_length);
+  init_key_comparator();
 
   /*
   虽然我们针对B+树记录了WAL，但是我们记录的都是逻辑日志，并没有记录某个页面如何修改的物理日志。
@@ -921,9 +1470,22 @@ RC BplusTreeHandler::open(LogHandler &log_handler, BufferPoolManager &bpm, const
   }
 
   rc = this->open(log_handler, *disk_buffer_pool);
-  if (OB_SUCC(rc)) {
-    LOG_INFO("open b+tree success. filename=%s", file_name);
+  if (OB_FAIL(rc)) {
+    return rc;
   }
+
+  // 回放日志时也会打开索引，那时头页面可能还没有恢复，所以只在这里升级文件格式。
+  // 头页面还没有初始化(key_length是0)说明文件内容都要从日志中恢复，也不需要升级
+  if (file_header_.key_length > 0 && file_header_.format_version < IndexFileHeader::CURRENT_FORMAT_VERSION) {
+    rc = upgrade_format();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to upgrade index format. filename=%s, rc=%s", file_name, strrc(rc));
+      close();
+      return rc;
+    }
+  }
+
+  LOG_INFO("open b+tree success. filename=%s", file_name);
   return rc;
 }
 
@@ -959,12 +1521,69 @@ RC BplusTreeHandler::open(LogHandler &log_handler, DiskBufferPool &buffer_pool)
   // close old page_handle
   buffer_pool.unpin_page(frame);
 
-  key_comparator_.init(file_header_.attr_type, file_header_.attr_length);
-  key_printer_.init(file_header_.attr_type, file_header_.attr_length);
+  init_key_comparator();
+
   LOG_INFO("Successfully open index");
   return RC::SUCCESS;
 }
 
+RC BplusTreeHandler::upgrade_format()
+{
+  LOG_INFO("begin to upgrade index format. version from %d to %d",
+           file_header_.format_version, IndexFileHeader::CURRENT_FORMAT_VERSION);
+
+  // 去掉节点头部中的父节点页面编号，把后面的数据都向前移动
+  const int removed_size = IndexNode::HEADER_SIZE_WITH_PARENT - IndexNode::HEADER_SIZE;
+
+  int                upgraded_count = 0;
+  BufferPoolIterator iterator;
+  iterator.init(*disk_buffer_pool_, FIRST_INDEX_PAGE + 1);
+  while (iterator.has_next()) {
+    const PageNum page_num = iterator.next();
+
+    Frame *frame = nullptr;
+    RC     rc    = disk_buffer_pool_->get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to fetch page while upgrading index format. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    frame->write_latch();
+    char      *data = frame->data();
+    IndexNode *node = reinterpret_cast<IndexNode *>(data);
+    if (node->format == static_cast<uint8_t>(IndexFileHeader::FORMAT_VERSION_WITH_PARENT)) {
+      memmove(data + IndexNode::HEADER_SIZE,
+              data + IndexNode::HEADER_SIZE_WITH_PARENT,
+              BP_PAGE_DATA_SIZE - IndexNode::HEADER_SIZE_WITH_PARENT);
+      memset(data + BP_PAGE_DATA_SIZE - removed_size, 0, removed_size);
+      node->format = static_cast<uint8_t>(IndexFileHeader::CURRENT_FORMAT_VERSION);
+      frame->mark_dirty();
+      upgraded_count++;
+    }
+    frame->write_unlatch();
+    disk_buffer_pool_->unpin_page(frame);
+  }
+
+  // 先把所有的节点页面刷到磁盘，再修改文件头中的版本号。
+  // 如果中间崩溃了，下次打开时还会再升级一次，已经升级过的页面会被跳过
+  RC rc = disk_buffer_pool_->flush_all_pages();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush pages after upgrading index format. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  file_header_.format_version = IndexFileHeader::CURRENT_FORMAT_VERSION;
+  header_dirty_               = true;
+  rc                          = sync();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to sync index header after upgrading index format. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  LOG_INFO("upgrade index format done. upgraded pages=%d", upgraded_count);
+  return RC::SUCCESS;
+}
+
 RC BplusTreeHandler::close()
 {
   if (disk_buffer_pool_ != nullptr) {
@@ -1089,16 +1708,16 @@ RC BplusTreeHandler::print_leafs()
   return rc;
 }
 
-bool BplusTreeHandler::validate_node_recursive(BplusTreeMiniTransaction &mtr, Frame *frame)
+bool BplusTreeHandler::validate_node_recursive(BplusTreeMiniTransaction &mtr, Frame *frame, PageNum parent_page_num)
 {
   bool             result = true;
   IndexNodeHandler node(mtr, file_header_, frame);
   if (node.is_leaf()) {
     LeafIndexNodeHandler leaf_node(mtr, file_header_, frame);
-    result = leaf_node.validate(key_comparator_, disk_buffer_pool_);
+    result = leaf_node.validate(key_comparator_, disk_buffer_pool_, parent_page_num);
   } else {
     InternalIndexNodeHandler internal_node(mtr, file_header_, frame);
-    result = internal_node.validate(key_comparator_, disk_buffer_pool_);
+    result = internal_node.validate(key_comparator_, disk_buffer_pool_, parent_page_num);
     for (int i = 0; result && i < internal_node.size(); i++) {
       PageNum page_num = internal_node.value_at(i);
       Frame  *child_frame = nullptr;
@@ -1109,7 +1728,7 @@ bool BplusTreeHandler::validate_node_recursive(BplusTreeMiniTransaction &mtr, Fr
         break;
       }
 
-      result = validate_node_recursive(mtr, child_frame);
+      result = validate_node_recursive(mtr, child_frame, frame->page_num());
     }
   }
 
@@ -1174,7 +1793,7 @@ bool BplusTreeHandler::validate_tree()
     return false;
   }
 
-  if (!validate_node_recursive(mtr, frame) || !validate_leaf_link(mtr)) {
+  if (!validate_node_recursive(mtr, frame, BP_INVALID_PAGE_NUM) || !validate_leaf_link(mtr)) {
     LOG_WARN("Current B+ Tree is invalid");
     print_tree();
     return false;
@@ -1194,6 +1813,57 @@ RC BplusTreeHandler::find_leaf(BplusTreeMiniTransaction &mtr, BplusTreeOperation
   return find_leaf_internal(mtr, op, child_page_getter, frame);
 }
 
+RC BplusTreeHandler::find_leaf_optimistic(
+    BplusTreeMiniTransaction &mtr, BplusTreeOperationType op, const char *key, Frame *&frame, bool &safe)
+{
+  LatchMemo &latch_memo = mtr.latch_memo();
+
+  safe = false;
+  mtr.clear_path();
+
+  // 根节点的变更需要加 root_lock_ 的写锁，这里加读锁就可以保证根节点不会变化
+  latch_memo.slatch(&root_lock_);
+  if (is_empty()) {
+    return RC::EMPTY;
+  }
+
+  RC      rc           = RC::SUCCESS;
+  PageNum page_num     = file_header_.root_page;
+  bool    is_root_node = true;
+  while (true) {
+    const int memo_point = latch_memo.memo_point();
+
+    rc = latch_memo.get_page(page_num, frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get frame. pageNum=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+    mtr.push_path(page_num);
+
+    // 持有父节点(或root_lock_)的读锁时，当前节点不会被分裂、合并或释放，节点的类型也不会变化，
+    // 所以可以在加锁之前判断是否是叶子节点
+    const bool is_leaf = reinterpret_cast<IndexNode *>(frame->data())->is_leaf;
+    latch_memo.latch(frame, is_leaf ? LatchMemoType::EXCLUSIVE : LatchMemoType::SHARED);
+    latch_memo.release_to(memo_point);
+
+    if (is_leaf) {
+      break;
+    }
+
+    InternalIndexNodeHandler internal_node(mtr, file_header_, frame);
+    page_num     = internal_node.value_at(internal_node.lookup(key_comparator_, key));
+    is_root_node = false;
+  }
+
+  LeafIndexNodeHandler leaf_node(mtr, file_header_, frame);
+  if (op == BplusTreeOperationType::INSERT) {
+    safe = leaf_node.can_insert(key);
+  } else {
+    safe = leaf_node.is_safe(op, is_root_node);
+  }
+  return RC::SUCCESS;
+}
+
 RC BplusTreeHandler::left_most_page(BplusTreeMiniTransaction &mtr, Frame *&frame)
 {
   auto child_page_getter = [](InternalIndexNodeHandler &internal_node) { return internal_node.value_at(0); };
@@ -1216,6 +1886,7 @@ RC BplusTreeHandler::find_leaf_internal(BplusTreeMiniTransaction &mtr, BplusTree
     return RC::EMPTY;
   }
 
+  mtr.clear_path();
   RC rc = crabing_protocal_fetch_page(mtr, op, file_header_.root_page, true /* is_root_node */, frame);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to fetch root page. page id=%d, rc=%d:%s", file_header_.root_page, rc, strrc(rc));
@@ -1250,6 +1921,7 @@ RC BplusTreeHandler::crabing_protocal_fetch_page(
     LOG_WARN("failed to get frame. pageNum=%d, rc=%s", page_num, strrc(rc));
     return rc;
   }
+  mtr.push_path(page_num);
 
   LatchMemoType latch_type = readonly ? LatchMemoType::SHARED : LatchMemoType::EXCLUSIVE;
   mtr.latch_memo().latch(frame, latch_type);
@@ -1260,7 +1932,8 @@ RC BplusTreeHandler::crabing_protocal_fetch_page(
   return rc;
 }
 
-RC BplusTreeHandler::insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr, Frame *frame, const char *key, const RID *rid)
+RC BplusTreeHandler::insert_entry_into_leaf_node(
+    BplusTreeMiniTransaction &mtr, Frame *frame, const char *key, const char *value)
 {
   LeafIndexNodeHandler leaf_node(mtr, file_header_, frame);
   bool                 exists          = false;  // 该数据是否已经存在指定的叶子节点中了
@@ -1270,15 +1943,18 @@ RC BplusTreeHandler::insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr,
     return RC::RECORD_DUPLICATE_KEY;
   }
 
-  if (leaf_node.size() < leaf_node.max_size()) {
-    leaf_node.insert(insert_position, key, (const char *)rid);
+  if (leaf_node.can_insert(key)) {
+    leaf_node.insert(insert_position, key, value);
     frame->mark_dirty();
     // disk_buffer_pool_->unpin_page(frame); // unpin pages 由latch memo 来操作
     return RC::SUCCESS;
   }
 
+  bool      insert_left = false;
+  const int move_index  = leaf_node.split_position(key, insert_position, insert_left);
+
   Frame *new_frame = nullptr;
-  RC     rc        = split<LeafIndexNodeHandler>(mtr, frame, new_frame);
+  RC     rc        = split<LeafIndexNodeHandler>(mtr, frame, new_frame, move_index);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to split leaf node. rc=%d:%s", rc, strrc(rc));
     return rc;
@@ -1286,13 +1962,12 @@ RC BplusTreeHandler::insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr,
 
   LeafIndexNodeHandler new_index_node(mtr, file_header_, new_frame);
   new_index_node.set_next_page(leaf_node.next_page());
-  new_index_node.set_parent_page_num(leaf_node.parent_page_num());
   leaf_node.set_next_page(new_frame->page_num());
 
-  if (insert_position < leaf_node.size()) {
-    leaf_node.insert(insert_position, key, (const char *)rid);
+  if (insert_left) {
+    leaf_node.insert(insert_position, key, value);
   } else {
-    new_index_node.insert(insert_position - leaf_node.size(), key, (const char *)rid);
+    new_index_node.insert(insert_position - leaf_node.size(), key, value);
   }
 
   return insert_entry_into_parent(mtr, frame, new_frame, new_index_node.key_at(0));
@@ -1302,11 +1977,13 @@ RC BplusTreeHandler::insert_entry_into_parent(BplusTreeMiniTransaction &mtr, Fra
 {
   RC rc = RC::SUCCESS;
 
-  IndexNodeHandler node_handler(mtr, file_header_, frame);
-  IndexNodeHandler new_node_handler(mtr, file_header_, new_frame);
-  PageNum          parent_page_num = node_handler.parent_page_num();
+  // 父节点就是查找时路径上的前一个页面，查找路径上需要修改的页面都持有写锁
+  const PageNum parent_page_num = mtr.parent_page_num(frame->page_num());
 
   if (parent_page_num == BP_INVALID_PAGE_NUM) {
+    ASSERT(frame->page_num() == file_header_.root_page,
+           "cannot find parent page in the path. page num=%d, root page=%d",
+           frame->page_num(), file_header_.root_page);
 
     // create new root page
     Frame *root_frame = nullptr;
@@ -1319,8 +1996,6 @@ RC BplusTreeHandler::insert_entry_into_parent(BplusTreeMiniTransaction &mtr, Fra
     InternalIndexNodeHandler root_node(mtr, file_header_, root_frame);
     root_node.init_empty();
     root_node.create_new_root(frame->page_num(), key, new_frame->page_num());
-    node_handler.set_parent_page_num(root_frame->page_num());
-    new_node_handler.set_parent_page_num(root_frame->page_num());
 
     frame->mark_dirty();
     new_frame->mark_dirty();
@@ -1352,7 +2027,6 @@ RC BplusTreeHandler::insert_entry_into_parent(BplusTreeMiniTransaction &mtr, Fra
     /// 当前这个父节点还没有满，直接将新节点数据插进入就行了
     if (parent_node.size() < parent_node.max_size()) {
       parent_node.insert(key, new_frame->page_num(), key_comparator_);
-      new_node_handler.set_parent_page_num(parent_page_num);
 
       frame->mark_dirty();
       new_frame->mark_dirty();
@@ -1377,10 +2051,8 @@ RC BplusTreeHandler::insert_entry_into_parent(BplusTreeMiniTransaction &mtr, Fra
         InternalIndexNodeHandler new_node(mtr, file_header_, new_parent_frame);
         if (key_comparator_(key, new_node.key_at(0)) > 0) {
           new_node.insert(key, new_frame->page_num(), key_comparator_);
-          new_node_handler.set_parent_page_num(new_node.page_num());
         } else {
           parent_node.insert(key, new_frame->page_num(), key_comparator_);
-          new_node_handler.set_parent_page_num(parent_node.page_num());
         }
 
         // disk_buffer_pool_->unpin_page(frame);
@@ -1400,7 +2072,7 @@ RC BplusTreeHandler::insert_entry_into_parent(BplusTreeMiniTransaction &mtr, Fra
  * split one full node into two
  */
 template <typename IndexNodeHandlerType>
-RC BplusTreeHandler::split(BplusTreeMiniTransaction &mtr, Frame *frame, Frame *&new_frame)
+RC BplusTreeHandler::split(BplusTreeMiniTransaction &mtr, Frame *frame, Frame *&new_frame, int move_index /* = -1 */)
 {
   IndexNodeHandlerType old_node(mtr, file_header_, frame);
 
@@ -1415,9 +2087,12 @@ RC BplusTreeHandler::split(BplusTreeMiniTransaction &mtr, Frame *frame, Frame *&
 
   IndexNodeHandlerType new_node(mtr, file_header_, new_frame);
   new_node.init_empty();
-  new_node.set_parent_page_num(old_node.parent_page_num());
 
-  old_node.move_half_to(new_node);
+  if constexpr (std::is_same_v<IndexNodeHandlerType, LeafIndexNodeHandler>) {
+    old_node.move_half_to(new_node, move_index);
+  } else {
+    old_node.move_half_to(new_node);
+  }
 
   frame->mark_dirty();
   new_frame->mark_dirty();
@@ -1438,12 +2113,23 @@ RC BplusTreeHandler::recover_init_header_page(BplusTreeMiniTransaction &mtr, Fra
   header_dirty_ = false;
   frame->mark_dirty();
 
-  key_comparator_.init(file_header_.attr_type, file_header_.attr_length);
-  key_printer_.init(file_header_.attr_type, file_header_.attr_length);
+  init_key_comparator();
 
   return RC::SUCCESS;
 }
 
+void BplusTreeHandler::init_key_comparator()
+{
+  if (file_header_.attr_num <= 0) {
+    // 旧版本的索引文件只有一个字段
+    key_comparator_.init(file_header_.attr_type, file_header_.attr_length);
+    key_printer_.init(file_header_.attr_type, file_header_.attr_length);
+  } else {
+    key_comparator_.init(file_header_.attr_types, file_header_.attr_lengths, file_header_.attr_num);
+    key_printer_.init(file_header_.attr_types, file_header_.attr_lengths, file_header_.attr_num);
+  }
+}
+
 void BplusTreeHandler::update_root_page_num_locked(BplusTreeMiniTransaction &mtr, PageNum root_page_num)
 {
   Frame *frame = nullptr;
@@ -1458,7 +2144,7 @@ void BplusTreeHandler::update_root_page_num_locked(BplusTreeMiniTransaction &mtr
   LOG_DEBUG("set root page to %d", root_page_num);
 }
 
-RC BplusTreeHandler::create_new_tree(BplusTreeMiniTransaction &mtr, const char *key, const RID *rid)
+RC BplusTreeHandler::create_new_tree(BplusTreeMiniTransaction &mtr, const char *key, const char *value)
 {
   RC rc = RC::SUCCESS;
   if (file_header_.root_page != BP_INVALID_PAGE_NUM) {
@@ -1477,7 +2163,7 @@ RC BplusTreeHandler::create_new_tree(BplusTreeMiniTransaction &mtr, const char *
 
   LeafIndexNodeHandler leaf_node(mtr, file_header_, frame);
   leaf_node.init_empty();
-  leaf_node.insert(0, key, (const char *)rid);
+  leaf_node.insert(0, key, value);
   update_root_page_num_locked(mtr, frame->page_num());
   frame->mark_dirty();
 
@@ -1497,7 +2183,7 @@ MemPoolItem::item_unique_ptr BplusTreeHandler::make_key(const char *user_key, co
   return key;
 }
 
-RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
+RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid, const char *include_data /* = nullptr */)
 {
   if (user_key == nullptr || rid == nullptr) {
     LOG_WARN("Invalid arguments, key is empty or rid is empty");
@@ -1516,10 +2202,22 @@ RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
 
   char *key = static_cast<char *>(pkey.get());
 
+  // 叶子节点中的值是 RID，有包含列时后面再跟上包含列的数据
+  const char  *value = reinterpret_cast<const char *>(rid);
+  vector<char> value_buffer;
+  if (file_header_.include_length() > 0) {
+    value_buffer.resize(file_header_.leaf_value_length());
+    memcpy(value_buffer.data(), rid, sizeof(*rid));
+    if (include_data != nullptr) {
+      memcpy(value_buffer.data() + sizeof(*rid), include_data, file_header_.include_length());
+    }
+    value = value_buffer.data();
+  }
+
   if (is_empty()) {
     root_lock_.lock();
     if (is_empty()) {
-      rc = create_new_tree(mtr, key, rid);
+      rc = create_new_tree(mtr, key, value);
       root_lock_.unlock();
       return rc;
     }
@@ -1528,13 +2226,19 @@ RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
 
   Frame *frame = nullptr;
 
-  rc = find_leaf(mtr, BplusTreeOperationType::INSERT, key, frame);
+  // 大部分插入不会导致叶子节点分裂，先乐观地只对叶子节点加写锁，不行再加写锁重新查找
+  bool safe = false;
+  rc        = find_leaf_optimistic(mtr, BplusTreeOperationType::INSERT, key, frame, safe);
+  if (OB_SUCC(rc) && !safe) {
+    mtr.latch_memo().release();
+    rc = find_leaf(mtr, BplusTreeOperationType::INSERT, key, frame);
+  }
   if (OB_FAIL(rc)) {
     LOG_WARN("Failed to find leaf %s. rc=%d:%s", rid->to_string().c_str(), rc, strrc(rc));
     return rc;
   }
 
-  rc = insert_entry_into_leaf_node(mtr, frame, key, rid);
+  rc = insert_entry_into_leaf_node(mtr, frame, key, value);
   if (OB_FAIL(rc)) {
     LOG_TRACE("Failed to insert into leaf of index, rid:%s. rc=%s", rid->to_string().c_str(), strrc(rc));
     return rc;
@@ -1586,16 +2290,8 @@ RC BplusTreeHandler::adjust_root(BplusTreeMiniTransaction &mtr, Frame *root_fram
     // 根节点只有一个子节点了，需要把自己删掉，把子节点提升为根节点
     InternalIndexNodeHandler internal_node(mtr, file_header_, root_frame);
 
+    // 子节点中没有记录父节点，只需要修改文件头中的根节点页号
     const PageNum child_page_num = internal_node.value_at(0);
-    Frame        *child_frame    = nullptr;
-    RC            rc             = latch_memo.get_page(child_page_num, child_frame);
-    if (OB_FAIL(rc)) {
-      LOG_WARN("failed to fetch child page. page num=%d, rc=%d:%s", child_page_num, rc, strrc(rc));
-      return rc;
-    }
-
-    IndexNodeHandler child_node(mtr, file_header_, child_frame);
-    child_node.set_parent_page_num(BP_INVALID_PAGE_NUM);
 
     // file_header_.root_page = child_page_num;
     new_root_page_num = child_page_num;
@@ -1614,13 +2310,16 @@ RC BplusTreeHandler::coalesce_or_redistribute(BplusTreeMiniTransaction &mtr, Fra
   LatchMemo &latch_memo = mtr.latch_memo();
 
   IndexNodeHandlerType index_node(mtr, file_header_, frame);
-  if (index_node.size() >= index_node.min_size()) {
+  if (!index_node.is_underflow()) {
     return RC::SUCCESS;
   }
 
-  const PageNum parent_page_num = index_node.parent_page_num();
+  const PageNum parent_page_num = mtr.parent_page_num(frame->page_num());
   if (BP_INVALID_PAGE_NUM == parent_page_num) {
     // this is the root page
+    ASSERT(frame->page_num() == file_header_.root_page,
+           "cannot find parent page in the path. page num=%d, root page=%d",
+           frame->page_num(), file_header_.root_page);
     if (index_node.size() > 1) {
     } else {
       // adjust the root node
@@ -1664,7 +2363,7 @@ RC BplusTreeHandler::coalesce_or_redistribute(BplusTreeMiniTransaction &mtr, Fra
   latch_memo.xlatch(neighbor_frame);
 
   IndexNodeHandlerType neighbor_node(mtr, file_header_, neighbor_frame);
-  if (index_node.size() + neighbor_node.size() > index_node.max_size()) {
+  if (!index_node.can_coalesce(neighbor_node)) {
     rc = redistribute<IndexNodeHandlerType>(mtr, neighbor_frame, frame, parent_frame, index);
   } else {
     rc = coalesce<IndexNodeHandlerType>(mtr, neighbor_frame, frame, parent_frame, index);
@@ -1737,9 +2436,19 @@ RC BplusTreeHandler::redistribute(BplusTreeMiniTransaction &mtr, Frame *neighbor
   InternalIndexNodeHandler parent_node(mtr, file_header_, parent_frame);
   IndexNodeHandlerType     neighbor_node(mtr, file_header_, neighbor_frame);
   IndexNodeHandlerType     node(mtr, file_header_, frame);
-  if (neighbor_node.size() < node.size()) {
+  if (neighbor_node.size() < node.size() &&
+      (!node.is_leaf() || file_header_.leaf_format != IndexFileHeader::LEAF_FORMAT_PREFIX)) {
     LOG_ERROR("got invalid nodes. neighbor node size %d, this node size %d", neighbor_node.size(), node.size());
   }
+
+  if constexpr (std::is_same_v<IndexNodeHandlerType, LeafIndexNodeHandler>) {
+    // 压缩格式的叶子节点，移动过来的键值可能让公共前缀变短，放不下时就不调整了，不影响B+树的正确性
+    const int neighbor_index = (index == 0) ? 0 : neighbor_node.size() - 1;
+    if (!node.can_insert(neighbor_node.key_at(neighbor_index))) {
+      return RC::SUCCESS;
+    }
+  }
+
   if (index == 0) {
     // the neighbor is at right
     neighbor_node.move_first_to_end(node);
@@ -1777,7 +2486,7 @@ RC BplusTreeHandler::delete_entry_internal(BplusTreeMiniTransaction &mtr, Frame
 
   leaf_frame->mark_dirty();
 
-  if (leaf_index_node.size() >= leaf_index_node.min_size()) {
+  if (!leaf_index_node.is_underflow()) {
     return RC::SUCCESS;
   }
 
@@ -1804,7 +2513,12 @@ RC BplusTreeHandler::delete_entry(const char *user_key, const RID *rid)
 
   Frame *leaf_frame = nullptr;
 
-  rc = find_leaf(mtr, op, key, leaf_frame);
+  bool safe = false;
+  rc        = find_leaf_optimistic(mtr, op, key, leaf_frame, safe);
+  if (OB_SUCC(rc) && !safe) {
+    mtr.latch_memo().release();
+    rc = find_leaf(mtr, op, key, leaf_frame);
+  }
   if (rc == RC::EMPTY) {
     rc = RC::RECORD_NOT_EXIST;
     return rc;
@@ -1867,7 +2581,7 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
     iter_index_ = 0;
   } else {
     char *fixed_left_key = const_cast<char *>(left_user_key);
-    if (tree_handler_.file_header_.attr_type == AttrType::CHARS) {
+    if (need_fix_user_key()) {
       bool should_inclusive_after_fix = false;
       rc = fix_user_key(left_user_key, left_len, true /*greater*/, &fixed_left_key, &should_inclusive_after_fix);
       if (OB_FAIL(rc)) {
@@ -1934,7 +2648,7 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
 
     char *fixed_right_key          = const_cast<char *>(right_user_key);
     bool  should_include_after_fix = false;
-    if (tree_handler_.file_header_.attr_type == AttrType::CHARS) {
+    if (need_fix_user_key()) {
       rc = fix_user_key(right_user_key, right_len, false /*want_greater*/, &fixed_right_key, &should_include_after_fix);
       if (OB_FAIL(rc)) {
         LOG_WARN("failed to fix right user key. rc=%s", strrc(rc));
@@ -1959,6 +2673,8 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
 
   if (touch_end()) {
     current_frame_ = nullptr;
+  } else {
+    read_ahead_next_leaf();
   }
 
   return RC::SUCCESS;
@@ -1970,6 +2686,42 @@ void BplusTreeScanner::fetch_item(RID &rid)
   memcpy(&rid, node.value_at(iter_index_), sizeof(rid));
 }
 
+RC BplusTreeScanner::next_entry(RID &rid, char *user_key, char *include_data)
+{
+  RC rc = next_entry(rid);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  // next_entry 返回之后，当前叶子节点仍然持有读锁，iter_index_ 指向刚刚返回的数据
+  const IndexFileHeader &header = tree_handler_.file_header_;
+  LeafIndexNodeHandler   node(mtr_, header, current_frame_);
+  if (user_key != nullptr) {
+    memcpy(user_key, node.key_at(iter_index_), header.attr_length);
+  }
+  if (include_data != nullptr && header.include_length() > 0) {
+    memcpy(include_data, node.value_at(iter_index_) + sizeof(RID), header.include_length());
+  }
+  return rc;
+}
+
+void BplusTreeScanner::read_ahead_next_leaf()
+{
+  LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
+  const PageNum        next_page_num = node.next_page();
+  if (BP_INVALID_PAGE_NUM == next_page_num || node.size() <= 0) {
+    return;
+  }
+
+  // 右边界在当前叶子节点中，不会访问下一个叶子节点
+  if (right_key_ != nullptr &&
+      tree_handler_.key_comparator_(node.key_at(node.size() - 1), static_cast<char *>(right_key_.get())) > 0) {
+    return;
+  }
+
+  tree_handler_.disk_buffer_pool_->read_ahead(span<const PageNum>(&next_page_num, 1));
+}
+
 bool BplusTreeScanner::touch_end()
 {
   if (right_key_ == nullptr) {
@@ -2007,8 +2759,56 @@ RC BplusTreeScanner::next_entry(RID &rid)
     return RC::SUCCESS;
   }
 
-  RC      rc            = RC::SUCCESS;
-  PageNum next_page_num = node.next_page();
+  RC rc = move_to_next_leaf();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  iter_index_ = -1;  // `next` will add 1
+  return next_entry(rid);
+}
+
+RC BplusTreeScanner::next_entries(vector<RID> &rids, int max_num)
+{
+  rids.clear();
+  if (max_num <= 0) {
+    return RC::INVALID_ARGUMENT;
+  }
+  if (nullptr == current_frame_) {
+    return RC::RECORD_EOF;
+  }
+
+  // 下一条要返回的数据的位置
+  int index = first_emitted_ ? iter_index_ + 1 : iter_index_;
+  while (index >= LeafIndexNodeHandler(mtr_, tree_handler_.file_header_, current_frame_).size()) {
+    RC rc = move_to_next_leaf();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    index = 0;
+  }
+
+  LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
+  const int            size = node.size();
+  first_emitted_            = true;
+  for (; index < size && static_cast<int>(rids.size()) < max_num; index++) {
+    iter_index_ = index;
+    if (touch_end()) {
+      break;
+    }
+
+    RID rid;
+    fetch_item(rid);
+    rids.push_back(rid);
+  }
+
+  return rids.empty() ? RC::RECORD_EOF : RC::SUCCESS;
+}
+
+RC BplusTreeScanner::move_to_next_leaf()
+{
+  LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
+  PageNum              next_page_num = node.next_page();
   if (BP_INVALID_PAGE_NUM == next_page_num) {
     return RC::RECORD_EOF;
   }
@@ -2016,7 +2816,7 @@ RC BplusTreeScanner::next_entry(RID &rid)
   LatchMemo &latch_memo = mtr_.latch_memo();
 
   const int memo_point = latch_memo.memo_point();
-  rc                   = latch_memo.get_page(next_page_num, current_frame_);
+  RC        rc         = latch_memo.get_page(next_page_num, current_frame_);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to get next page. page num=%d, rc=%s", next_page_num, strrc(rc));
     return rc;
@@ -2033,8 +2833,8 @@ RC BplusTreeScanner::next_entry(RID &rid)
   }
 
   latch_memo.release_to(memo_point);
-  iter_index_ = -1;  // `next` will add 1
-  return next_entry(rid);
+  read_ahead_next_leaf();
+  return RC::SUCCESS;
 }
 
 RC BplusTreeScanner::close()
@@ -2044,6 +2844,12 @@ RC BplusTreeScanner::close()
   return RC::SUCCESS;
 }
 
+bool BplusTreeScanner::need_fix_user_key() const
+{
+  // 联合索引的键值由调用者按照字段拼接好，长度一定与 attr_length 一致
+  return tree_handler_.file_header_.attr_type == AttrType::CHARS && tree_handler_.file_header_.attr_num <= 1;
+}
+
 RC BplusTreeScanner::fix_user_key(
     const char *user_key, int key_len, bool want_greater, char **fixed_key, bool *should_inclusive)
 {
@@ -2053,7 +2859,6 @@ RC BplusTreeScanner::fix_user_key(
 
   // 这里很粗暴，变长字段才需要做调整，其它默认都不需要做调整
   assert(tree_handler_.file_header_.attr_type == AttrType::CHARS);
-  assert(strlen(user_key) >= static_cast<size_t>(key_len));
 
   *should_inclusive = false;
 
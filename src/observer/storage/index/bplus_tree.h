@@ -23,6 +23,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/memory.h"
 #include "common/lang/sstream.h"
 #include "common/lang/functional.h"
+#include "common/lang/vector.h"
 #include "common/log/log.h"
 #include "sql/parser/parse_defs.h"
 #include "storage/buffer/disk_buffer_pool.h"
@@ -51,22 +52,43 @@ enum class BplusTreeOperationType
 
 /**
  * @brief 属性比较(BplusTree)
+ * @details 键值可以由多个定长的字段拼接而成(联合索引)，按照字段的顺序依次比较
  * @ingroup BPlusTree
  */
 class AttrComparator
 {
 public:
-  void init(AttrType type, int length)
+  void init(AttrType type, int length) { init(&type, &length, 1); }
+  void init(const AttrType types[], const int lengths[], int attr_num)
   {
-    attr_type_   = type;
-    attr_length_ = length;
+    attr_types_.assign(types, types + attr_num);
+    attr_lengths_.assign(lengths, lengths + attr_num);
+    attr_length_ = 0;
+    for (int i = 0; i < attr_num; i++) {
+      attr_length_ += lengths[i];
+    }
   }
 
+  /// 所有字段的总长度
   int attr_length() const { return attr_length_; }
 
   int operator()(const char *v1, const char *v2) const
   {
-    switch (attr_type_) {
+    for (size_t i = 0; i < attr_types_.size(); i++) {
+      const int result = compare(attr_types_[i], attr_lengths_[i], v1, v2);
+      if (result != 0) {
+        return result;
+      }
+      v1 += attr_lengths_[i];
+      v2 += attr_lengths_[i];
+    }
+    return 0;
+  }
+
+private:
+  static int compare(AttrType attr_type, int attr_length, const char *v1, const char *v2)
+  {
+    switch (attr_type) {
       case AttrType::INTS: {
         return common::compare_int((void *)v1, (void *)v2);
       } break;
@@ -74,21 +96,22 @@ public:
         return common::compare_float((void *)v1, (void *)v2);
       }
       case AttrType::CHARS: {
-        return common::compare_string((void *)v1, attr_length_, (void *)v2, attr_length_);
+        return common::compare_string((void *)v1, attr_length, (void *)v2, attr_length);
       }
       case AttrType::DATES: {
         return common::compare_int((void *)v1, (void *)v2);
       } break;
       default: {
-        ASSERT(false, "unknown attr type. %d", attr_type_);
+        ASSERT(false, "unknown attr type. %d", attr_type);
         return 0;
       }
     }
   }
 
 private:
-  AttrType attr_type_;
-  int      attr_length_;
+  vector<AttrType> attr_types_;
+  vector<int>      attr_lengths_;
+  int              attr_length_ = 0;
 };
 
 /**
@@ -100,6 +123,10 @@ class KeyComparator
 {
 public:
   void init(AttrType type, int length) { attr_comparator_.init(type, length); }
+  void init(const AttrType types[], const int lengths[], int attr_num)
+  {
+    attr_comparator_.init(types, lengths, attr_num);
+  }
 
   const AttrComparator &attr_comparator() const { return attr_comparator_; }
 
@@ -126,23 +153,37 @@ private:
 class AttrPrinter
 {
 public:
-  void init(AttrType type, int length)
+  void init(AttrType type, int length) { init(&type, &length, 1); }
+  void init(const AttrType types[], const int lengths[], int attr_num)
   {
-    attr_type_   = type;
-    attr_length_ = length;
+    attr_types_.assign(types, types + attr_num);
+    attr_lengths_.assign(lengths, lengths + attr_num);
+    attr_length_ = 0;
+    for (int i = 0; i < attr_num; i++) {
+      attr_length_ += lengths[i];
+    }
   }
 
   int attr_length() const { return attr_length_; }
 
   string operator()(const char *v) const
   {
-    Value value(attr_type_, const_cast<char *>(v), attr_length_);
-    return value.to_string();
+    string result;
+    for (size_t i = 0; i < attr_types_.size(); i++) {
+      if (i > 0) {
+        result += ",";
+      }
+      Value value(attr_types_[i], const_cast<char *>(v), attr_lengths_[i]);
+      result += value.to_string();
+      v += attr_lengths_[i];
+    }
+    return result;
   }
 
 private:
-  AttrType attr_type_;
-  int      attr_length_;
+  vector<AttrType> attr_types_;
+  vector<int>      attr_lengths_;
+  int              attr_length_ = 0;
 };
 
 /**
@@ -153,6 +194,10 @@ class KeyPrinter
 {
 public:
   void init(AttrType type, int length) { attr_printer_.init(type, length); }
+  void init(const AttrType types[], const int lengths[], int attr_num)
+  {
+    attr_printer_.init(types, lengths, attr_num);
+  }
 
   const AttrPrinter &attr_printer() const { return attr_printer_; }
 
@@ -174,21 +219,51 @@ private:
  * @brief the meta information of bplus tree
  * @ingroup BPlusTree
  * @details this is the first page of bplus tree.
- * only one field can be supported, can you extend it to multi-fields?
+ * 键值可以包含多个字段，每个字段的类型和长度记录在 attr_types 和 attr_lengths 中，
+ * attr_length 是所有字段的总长度，attr_type 是第一个字段的类型。
+ * 旧版本的索引文件只有一个字段，attr_num 是 0。
+ * format_version 是节点页面的格式版本，旧版本的索引文件是 0，打开时会升级到最新的版本。
+ * leaf_format 是叶子节点存放键值对的格式，在创建索引时确定，旧版本的索引文件是 0(LEAF_FORMAT_PLAIN)。
+ * 叶子节点中的值是 RID，后面可以再跟着包含列(INCLUDE)的数据，value_length 是它们的总长度。
+ * 旧版本的索引文件 value_length 是 0，表示值只有 RID。
  */
 struct IndexFileHeader
 {
+  static constexpr int MAX_ATTR_NUM = 8;  ///< 键值最多包含的字段数
+
+  /// 节点页面中记录了父节点页面编号的格式版本
+  static constexpr int32_t FORMAT_VERSION_WITH_PARENT = 0;
+  /// 节点页面中不再记录父节点，父节点从查找时记录的路径中获取
+  static constexpr int32_t FORMAT_VERSION_NO_PARENT   = 1;
+  static constexpr int32_t CURRENT_FORMAT_VERSION     = FORMAT_VERSION_NO_PARENT;
+
+  /// 叶子节点中的键值对都是定长的，按顺序存放
+  static constexpr int32_t LEAF_FORMAT_PLAIN  = 0;
+  /// 叶子节点对第一个字符串字段做前缀压缩，参考 PrefixLeafHeader
+  static constexpr int32_t LEAF_FORMAT_PREFIX = 1;
+
   IndexFileHeader()
   {
     memset(this, 0, sizeof(IndexFileHeader));
     root_page = BP_INVALID_PAGE_NUM;
   }
-  PageNum  root_page;          ///< 根节点在磁盘中的页号
-  int32_t  internal_max_size;  ///< 内部节点最大的键值对数
-  int32_t  leaf_max_size;      ///< 叶子节点最大的键值对数
-  int32_t  attr_length;        ///< 键值的长度
-  int32_t  key_length;         ///< attr length + sizeof(RID)
-  AttrType attr_type;          ///< 键值的类型
+  PageNum  root_page;                   ///< 根节点在磁盘中的页号
+  int32_t  internal_max_size;           ///< 内部节点最大的键值对数
+  int32_t  leaf_max_size;               ///< 叶子节点最大的键值对数
+  int32_t  attr_length;                 ///< 键值的长度
+  int32_t  key_length;                  ///< attr length + sizeof(RID)
+  AttrType attr_type;                   ///< 键值的类型
+  int32_t  attr_num;                    ///< 键值包含的字段数
+  AttrType attr_types[MAX_ATTR_NUM];    ///< 每个字段的类型
+  int32_t  attr_lengths[MAX_ATTR_NUM];  ///< 每个字段的长度
+  int32_t  format_version;              ///< 节点页面的格式版本
+  int32_t  leaf_format;                 ///< 叶子节点的存储格式
+  int32_t  value_length;                ///< 叶子节点中值的长度，RID + 包含列的长度
+
+  /// 叶子节点中值的长度
+  int leaf_value_length() const { return value_length > 0 ? value_length : static_cast<int>(sizeof(RID)); }
+  /// 叶子节点中包含列数据的长度
+  int include_length() const { return leaf_value_length() - static_cast<int>(sizeof(RID)); }
 
   const string to_string() const
   {
@@ -197,6 +272,10 @@ struct IndexFileHeader
     ss << "attr_length:" << attr_length << ","
        << "key_length:" << key_length << ","
        << "attr_type:" << attr_type_to_string(attr_type) << ","
+       << "attr_num:" << attr_num << ","
+       << "format_version:" << format_version << ","
+       << "leaf_format:" << leaf_format << ","
+       << "value_length:" << value_length << ","
        << "root_page:" << root_page << ","
        << "internal_max_size:" << internal_max_size << ","
        << "leaf_max_size:" << leaf_max_size << ";";
@@ -210,17 +289,25 @@ struct IndexFileHeader
  * @ingroup BPlusTree
  * @code
  * storage format:
- * | page type | item number | parent page id |
+ * | page type | format | item number |
  * @endcode
+ * 节点中不记录父节点页面编号。分裂或合并时需要的父节点，都是从根节点向下查找时记录的路径中获取的，
+ * 参考 BplusTreeMiniTransaction::parent_page_num。这样分裂时就不需要修改所有移动过的子节点。
+ * 旧版本(IndexFileHeader::FORMAT_VERSION_WITH_PARENT)的节点头部在 key_num 后面还有4字节的父节点页面编号，
+ * format 字段在旧版本中是填充字节，一定是0。
  */
 struct IndexNode
 {
-  static constexpr int HEADER_SIZE = 12;
+  static constexpr int HEADER_SIZE = 8;
+
+  /// 旧版本节点的头部大小
+  static constexpr int HEADER_SIZE_WITH_PARENT = 12;
 
   bool    is_leaf;  /// 当前是叶子节点还是内部节点
+  uint8_t format;   /// 节点页面的格式版本，与 IndexFileHeader::format_version 对应
   int     key_num;  /// 当前页面上一共有多少个键值对
-  PageNum parent;   /// 父节点页面编号
 };
+static_assert(sizeof(IndexNode) == IndexNode::HEADER_SIZE, "invalid index node header size");
 
 /**
  * @brief leaf page of bplus tree
@@ -246,6 +333,41 @@ struct LeafIndexNode : public IndexNode
   char array[0];
 };
 
+/**
+ * @brief 前缀压缩格式(IndexFileHeader::LEAF_FORMAT_PREFIX)的叶子节点
+ * @ingroup BPlusTree
+ * @code
+ * storage format:
+ * | leaf header | prefix header | prefix | slot0 | slot1 | ... | slotn | free space | entryn | ... | entry0 |
+ * @endcode
+ * 当键值的第一个字段是字符串时，同一个页面上的键值常常有很长的公共前缀，比如URL、路径等。
+ * 压缩格式的页面只保存一份第一个字段的公共前缀，每个键值对保存在页面末尾向前增长的堆区中，
+ * 格式是 | value(rid) | key rid | 去掉公共前缀并且去掉末尾的'\0'的字段内容 |。
+ * slot 数组按照键值的顺序排列，记录每个键值对在堆区的位置，以及公共前缀之后的4个字节(hint)。
+ * 查找时先用 hint 做整数比较的二分查找，只有 hint 相同时才需要解码出完整的键值比较。
+ * 字符串字段按照 strncmp 的规则比较，第一个'\0'之后的内容不影响比较，因此存储时都会置为'\0'，
+ * 这样字段的顺序就与 memcmp 的顺序一致，公共前缀和 hint 都可以按字节比较。
+ * 删除键值对时只移动 slot，堆区中的空间记录到 garbage 中，在空间不足时重建页面回收。
+ */
+struct PrefixLeafHeader
+{
+  uint16_t prefix_length;  ///< 公共前缀的长度
+  uint16_t heap_offset;    ///< 堆区的开始位置，相对于页面数据的开头
+  uint16_t garbage;        ///< 堆区中已经删除的数据大小
+  uint16_t reserved;
+};
+
+/**
+ * @brief 前缀压缩格式的叶子节点中，指向每个键值对的槽位
+ * @ingroup BPlusTree
+ */
+struct PrefixLeafSlot
+{
+  uint32_t hint;    ///< 公共前缀之后的4个字节，按照大端组成整数，不足4个字节的补0
+  uint16_t offset;  ///< 键值对在页面中的位置
+  uint16_t length;  ///< 键值对在堆区中占用的空间
+};
+
 /**
  * @brief internal page of bplus tree
  * @ingroup BPlusTree
@@ -297,8 +419,6 @@ public:
   int     size() const;
   int     max_size() const;
   int     min_size() const;
-  RC      set_parent_page_num(PageNum page_num);
-  PageNum parent_page_num() const;
   PageNum page_num() const;
 
   /**
@@ -309,19 +429,48 @@ public:
    */
   bool is_safe(BplusTreeOperationType op, bool is_root_node);
 
+  /**
+   * @brief 节点中的数据是否太少了，需要与邻居节点合并或者重新分配
+   */
+  bool is_underflow() const;
+
+  /**
+   * @brief 当前节点与另一个节点的数据是否可以合并到一个节点中
+   */
+  bool can_coalesce(const IndexNodeHandler &other) const;
+
   /**
    * @brief 验证当前节点是否有问题
+   * @param is_root_node 是否根节点
    */
-  bool validate() const;
+  bool validate(bool is_root_node) const;
 
   Frame *frame() const { return frame_; }
 
   friend string to_string(const IndexNodeHandler &handler);
 
-  RC recover_insert_items(int index, const char *items, int num);
-  RC recover_remove_items(int index, int num);
+  virtual RC recover_insert_items(int index, const char *items, int num);
+  virtual RC recover_remove_items(int index, int num);
 
 protected:
+  /// 是否前缀压缩格式的叶子节点
+  bool is_prefix_leaf() const
+  {
+    return is_leaf() && header_.leaf_format == IndexFileHeader::LEAF_FORMAT_PREFIX;
+  }
+
+  PrefixLeafHeader *prefix_header() const
+  {
+    return reinterpret_cast<PrefixLeafHeader *>(reinterpret_cast<char *>(node_) + LeafIndexNode::HEADER_SIZE);
+  }
+  char *prefix_data() const { return reinterpret_cast<char *>(prefix_header() + 1); }
+
+  /// 前缀压缩格式的叶子节点中，slot 数组的开始位置
+  static int prefix_slots_offset(int prefix_length);
+
+  /// 前缀压缩格式的叶子节点已经使用的空间，包括页面头
+  int prefix_used_bytes() const;
+
   /**
    * @brief 获取指定元素的开始内存位置
    * @note 这并不是一个纯虚函数，是为了可以直接使用 IndexNodeHandler 类。
@@ -352,6 +501,10 @@ public:
   RC      set_next_page(PageNum page_num);
   PageNum next_page() const;
 
+  /**
+   * @brief 获取指定位置的键值
+   * @note 前缀压缩格式的页面返回的是解码到当前对象中的键值，下一次调用 key_at 时就会被覆盖
+   */
   char *key_at(int index);
   char *value_at(int index);
 
@@ -361,10 +514,29 @@ public:
    */
   int lookup(const KeyComparator &comparator, const char *key, bool *found = nullptr) const;
 
+  /**
+   * @brief 当前节点是否还能放下指定的键值，不需要分裂
+   */
+  bool can_insert(const char *key) const;
+
+  /**
+   * @brief 节点放不下新的键值时，计算分裂的位置
+   * @details 前缀压缩格式的页面按照占用的空间拆分，并且保证新的键值一定可以放到拆分后的某个节点中
+   * @param key 将要插入的键值
+   * @param insert_position 新键值在当前节点中的插入位置
+   * @param[out] insert_left 新的键值应该插入到拆分后左边的节点(当前节点)还是右边的节点
+   * @return 从这个位置开始的键值对都移动到新的节点中
+   */
+  int split_position(const char *key, int insert_position, bool &insert_left) const;
+
   RC  insert(int index, const char *key, const char *value);
   RC  remove(int index);
   int remove(const char *key, const KeyComparator &comparator);
-  RC  move_half_to(LeafIndexNodeHandler &other);
+  /**
+   * @brief 把从 move_index 开始的键值对都移动到 other 节点
+   * @param move_index 默认(-1)移动一半
+   */
+  RC  move_half_to(LeafIndexNodeHandler &other, int move_index = -1);
   RC  move_first_to_end(LeafIndexNodeHandler &other);
   RC  move_last_to_front(LeafIndexNodeHandler &other);
   /**
@@ -372,19 +544,60 @@ public:
    */
   RC move_to(LeafIndexNodeHandler &other);
 
-  bool validate(const KeyComparator &comparator, DiskBufferPool *bp) const;
+  /**
+   * @brief 验证当前节点是否有问题
+   * @param parent_page_num 父节点页面编号，根节点是 BP_INVALID_PAGE_NUM
+   */
+  bool validate(const KeyComparator &comparator, DiskBufferPool *bp, PageNum parent_page_num) const;
 
   friend string to_string(const LeafIndexNodeHandler &handler, const KeyPrinter &printer);
 
+  RC recover_insert_items(int index, const char *items, int num) override;
+  RC recover_remove_items(int index, int num) override;
+
+  /**
+   * @brief 复制一些键值对到当前节点的最右边
+   * @details 键值对必须比当前节点中的都大，并且能够放得下
+   */
+  RC append(const char *items, int num);
+
+  /**
+   * @brief 一个空的节点最多能放下 items 开头的多少个键值对
+   * @param items 已经排好序的键值对，格式与定长格式的页面一样
+   */
+  int fit_count(const char *items, int num) const;
+
+public:
+  /// 前缀压缩格式的叶子节点，一个键值对(key + value)的最大长度
+  static constexpr int PREFIX_MAX_ITEM_SIZE = BP_PAGE_DATA_SIZE / 8;
+
 protected:
   char *__item_at(int index) const override;
 
-  RC append(const char *items, int num);
   RC append(const char *item);
   RC preappend(const char *item);
 
+private:
+  /// 获取指定位置的键值，两种格式的页面都可以使用
+  char *decode_key_at(int index) const;
+  /// 把从 index 开始的 num 个键值对复制出来，格式与定长格式的页面一样
+  void copy_items(int index, int num, char *items) const;
+
+  /// 字符串字段中第一个'\0'之后的内容都置为'\0'，不影响比较的结果
+  void normalize_key(char *key) const;
+
+  PrefixLeafSlot *prefix_slots() const;
+  int             prefix_lookup(const KeyComparator &comparator, const char *key, bool *found) const;
+  void            prefix_decode_item(int index, char *item) const;
+  int             prefix_entry_length(const char *item, int prefix_length) const;
+  void            prefix_write_entry(char *entry, const char *item, int prefix_length) const;
+  /// 使用已经排好序的键值对重新生成整个页面，会重新计算公共前缀并回收堆区中的空间
+  void            prefix_rebuild(const char *items, int num);
+
 private:
   LeafIndexNode *leaf_node_ = nullptr;
+
+  mutable char key_buffer_[PREFIX_MAX_ITEM_SIZE];  ///< 前缀压缩格式的页面解码出来的键值
 };
 
 /**
@@ -432,13 +645,21 @@ public:
   RC move_last_to_front(InternalIndexNodeHandler &other);
   RC move_half_to(InternalIndexNodeHandler &other);
 
-  bool validate(const KeyComparator &comparator, DiskBufferPool *bp) const;
+  /**
+   * @brief 验证当前节点是否有问题
+   * @param parent_page_num 父节点页面编号，根节点是 BP_INVALID_PAGE_NUM
+   */
+  bool validate(const KeyComparator &comparator, DiskBufferPool *bp, PageNum parent_page_num) const;
 
   friend string to_string(const InternalIndexNodeHandler &handler, const KeyPrinter &printer);
 
+  /**
+   * @brief 复制一些键值对到当前节点的最右边
+   */
+  RC append(const char *items, int num);
+
 private:
   RC insert_items(int index, const char *items, int num);
-  RC append(const char *items, int num);
   RC append(const char *item);
   RC preappend(const char *item);
 
@@ -474,6 +695,18 @@ public:
   RC create(LogHandler &log_handler, DiskBufferPool &buffer_pool, AttrType attr_type, int attr_length,
       int internal_max_size = -1, int leaf_max_size = -1);
 
+  /**
+   * @brief 创建一个键值包含多个字段的B+树
+   * @details 键值是按照顺序拼接起来的各个字段，比较时依次比较每个字段
+   * @param attr_types 每个字段的类型
+   * @param attr_lengths 每个字段的长度
+   * @param include_length 叶子节点中跟在 RID 后面存放的包含列数据的长度
+   */
+  RC create(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name, const vector<AttrType> &attr_types,
+      const vector<int> &attr_lengths, int internal_max_size = -1, int leaf_max_size = -1, int include_length = 0);
+  RC create(LogHandler &log_handler, DiskBufferPool &buffer_pool, const vector<AttrType> &attr_types,
+      const vector<int> &attr_lengths, int internal_max_size = -1, int leaf_max_size = -1, int include_length = 0);
+
   /**
    * @brief 打开一个B+树
    * @param log_handler 记录日志
@@ -492,9 +725,10 @@ public:
    * @brief 此函数向IndexHandle对应的索引中插入一个索引项。
    * @details 参数user_key指向要插入的属性值，参数rid标识该索引项对应的元组，
    * 即向索引中插入一个值为（user_key，rid）的键值对
+   * @param include_data 包含列的数据，长度是 IndexFileHeader::include_length。没有包含列时可以是空的
    * @note 这里假设user_key的内存大小与attr_length 一致
    */
-  RC insert_entry(const char *user_key, const RID *rid);
+  RC insert_entry(const char *user_key, const RID *rid, const char *include_data = nullptr);
 
   /**
    * @brief 从IndexHandle句柄对应的索引中删除一个值为（user_key，rid）的索引项
@@ -523,6 +757,7 @@ public:
 
 public:
   const IndexFileHeader &file_header() const { return file_header_; }
+  const KeyComparator   &key_comparator() const { return key_comparator_; }
   DiskBufferPool        &buffer_pool() const { return *disk_buffer_pool_; }
   LogHandler            &log_handler() const { return *log_handler_; }
 
@@ -553,7 +788,7 @@ private:
   RC print_internal_node_recursive(Frame *frame);
 
   bool validate_leaf_link(BplusTreeMiniTransaction &mtr);
-  bool validate_node_recursive(BplusTreeMiniTransaction &mtr, Frame *frame);
+  bool validate_node_recursive(BplusTreeMiniTransaction &mtr, Frame *frame, PageNum parent_page_num);
 
 protected:
   /**
@@ -564,6 +799,19 @@ protected:
    */
   RC find_leaf(BplusTreeMiniTransaction &mtr, BplusTreeOperationType op, const char *key, Frame *&frame);
 
+  /**
+   * @brief 乐观地查找要修改的叶子节点
+   * @details 从根节点向下只对内部节点加读锁，并且拿到子节点的锁后就释放父节点的锁，只对叶子节点加写锁。
+   * 如果叶子节点修改之后不需要分裂或合并，就可以直接修改叶子节点，不会与其它的写操作串行。
+   * 否则调用者需要释放所有的锁，再使用 find_leaf 悲观地查找一次。
+   * @param op 插入或删除
+   * @param key 查找的键值
+   * @param[out] frame 返回找到的叶子节点，加了写锁
+   * @param[out] safe 叶子节点修改之后是否不需要分裂或合并
+   */
+  RC find_leaf_optimistic(
+      BplusTreeMiniTransaction &mtr, BplusTreeOperationType op, const char *key, Frame *&frame, bool &safe);
+
   /**
    * @brief 找到最左边的叶子节点
    */
@@ -592,9 +840,10 @@ protected:
   /**
    * @brief 拆分节点
    * @details 当节点中的键值对超过最大值时，需要拆分节点
+   * @param move_index 叶子节点从这个位置开始的键值对移动到新的节点，默认(-1)移动一半
    */
   template <typename IndexNodeHandlerType>
-  RC split(BplusTreeMiniTransaction &mtr, Frame *frame, Frame *&new_frame);
+  RC split(BplusTreeMiniTransaction &mtr, Frame *frame, Frame *&new_frame, int move_index = -1);
 
   /**
    * @brief 合并或重新分配
@@ -625,12 +874,12 @@ protected:
   /**
    * @brief 在叶子节点插入一个元素
    */
-  RC insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr, Frame *frame, const char *pkey, const RID *rid);
+  RC insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr, Frame *frame, const char *pkey, const char *value);
 
   /**
    * @brief 创建一个新的B+树
    */
-  RC create_new_tree(BplusTreeMiniTransaction &mtr, const char *key, const RID *rid);
+  RC create_new_tree(BplusTreeMiniTransaction &mtr, const char *key, const char *value);
 
   /**
    * @brief 更新根节点的页号
@@ -645,6 +894,16 @@ protected:
 private:
   common::MemPoolItem::item_unique_ptr make_key(const char *user_key, const RID &rid);
 
+  /// 根据文件头中的字段信息初始化键值比较器和打印器
+  void init_key_comparator();
+
+  /**
+   * @brief 把旧版本的索引文件升级到最新的节点格式
+   * @details 把所有节点页面的头部改成不带父节点的格式，刷到磁盘之后再更新文件头中的版本号。
+   * 每个页面是否已经升级可以从页面的 format 字段判断，所以升级过程中崩溃了，下次打开时可以继续升级。
+   */
+  RC upgrade_format();
+
 protected:
   LogHandler     *log_handler_      = nullptr;  /// 日志处理器
   DiskBufferPool *disk_buffer_pool_ = nullptr;  /// 磁盘缓冲池
@@ -663,6 +922,7 @@ protected:
 private:
   friend class BplusTreeScanner;
   friend class BplusTreeTester;
+  friend class BplusTreeBulkLoader;
 };
 
 /**
@@ -699,6 +959,23 @@ public:
    */
   RC next_entry(RID &rid);
 
+  /**
+   * @brief 获取下一批记录
+   * @details 在持有叶子节点锁的情况下连续取出数据，减少逐条调用 next_entry 的开销。
+   * 每次只从一个叶子节点中取数据，当前叶子节点取完之后，下次调用时才会移动到下一个叶子节点。
+   * @param rids 返回的数据，会先清空
+   * @param max_num 最多返回多少条数据
+   * @return RC RECORD_EOF 表示遍历完成，此时 rids 是空的
+   */
+  RC next_entries(vector<RID> &rids, int max_num);
+
+  /**
+   * @brief 获取下一条记录，同时返回键值和包含列的数据
+   * @param user_key 返回用户键值，内存大小至少是 attr_length。可以是空的
+   * @param include_data 返回包含列的数据，内存大小至少是 include_length。可以是空的
+   */
+  RC next_entry(RID &rid, char *user_key, char *include_data);
+
   /**
    * @brief 关闭当前扫描器
    * @details 可以不调用，在析构函数时会自动执行
@@ -706,6 +983,9 @@ public:
   RC close();
 
 private:
+  /// 单字段的CHARS索引需要调整user_key的大小
+  bool need_fix_user_key() const;
+
   /**
    * 如果key的类型是CHARS, 扩展或缩减user_key的大小刚好是schema中定义的大小
    */
@@ -718,6 +998,19 @@ private:
    */
   bool touch_end();
 
+  /**
+   * @brief 当前叶子节点已经遍历完，移动到下一个叶子节点
+   * @return RC RECORD_EOF 表示没有下一个叶子节点
+   */
+  RC move_to_next_leaf();
+
+  /**
+   * @brief 扫描还会访问下一个叶子节点时，提前预读它
+   * @details 叶子节点不一定在文件中连续存放，只能沿着兄弟指针每次预读一个页面，
+   * 这样处理当前叶子节点的同时，下一个叶子节点的IO也在进行
+   */
+  void read_ahead_next_leaf();
+
 private:
   bool                     inited_ = false;
   BplusTreeHandler        &tree_handler_;
@@ -0,0 +1,519 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include "storage/index/bplus_tree_bulk_loader.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/filesystem.h"
+#include "common/lang/fstream.h"
+#include "common/lang/queue.h"
+
+/**
+ * @brief 按照顺序输出排好序的键值对
+ */
+class BplusTreeBulkLoader::ItemSource
+{
+public:
+  virtual ~ItemSource() = default;
+
+  /**
+   * @brief 获取下一个键值对
+   * @details 返回的指针在下一次调用 next 之前有效
+   * @return 没有更多数据时返回 RC::RECORD_EOF
+   */
+  virtual RC next(const char *&item) = 0;
+};
+
+/**
+ * @brief 没有写临时文件时，直接输出内存中排好序的数据
+ */
+class BplusTreeBulkLoader::MemoryItemSource : public ItemSource
+{
+public:
+  explicit MemoryItemSource(const vector<const char *> &items) : items_(items) {}
+
+  RC next(const char *&item) override
+  {
+    if (index_ >= items_.size()) {
+      return RC::RECORD_EOF;
+    }
+    item = items_[index_++];
+    return RC::SUCCESS;
+  }
+
+private:
+  const vector<const char *> &items_;
+  size_t                      index_ = 0;
+};
+
+/**
+ * @brief 对多个有序段做多路归并
+ * @details 每个有序段有一块读缓冲区，使用小顶堆找到所有有序段中最小的键值对
+ */
+class BplusTreeBulkLoader::MergeItemSource : public ItemSource
+{
+public:
+  MergeItemSource(const KeyComparator &comparator, int item_size)
+      : item_size_(item_size), heap_(HeapComparator{comparator})
+  {}
+
+  RC init(const vector<string> &files, size_t memory_limit)
+  {
+    // 读缓冲区平分内存，但是不能太小，否则读文件的次数太多
+    const size_t min_buffer_size = 64 * 1024;
+    const size_t buffer_size     = max(memory_limit / max(files.size(), size_t(1)), min_buffer_size);
+    const int    buffer_items    = max(static_cast<int>(buffer_size / item_size_), 1);
+
+    for (const string &file : files) {
+      auto run = make_unique<Run>();
+      run->stream.open(file, ios::binary | ios::in);
+      if (!run->stream.is_open()) {
+        LOG_WARN("failed to open sorted run file. file=%s", file.c_str());
+        return RC::IOERR_OPEN;
+      }
+      run->buffer.resize(static_cast<size_t>(buffer_items) * item_size_);
+      runs_.push_back(std::move(run));
+    }
+
+    for (int i = 0; i < static_cast<int>(runs_.size()); i++) {
+      RC rc = push(i);
+      if (OB_FAIL(rc) && rc != RC::RECORD_EOF) {
+        return rc;
+      }
+    }
+    return RC::SUCCESS;
+  }
+
+  RC next(const char *&item) override
+  {
+    // 上一次输出的键值对所在的有序段，现在才能读它的下一个键值对，否则会覆盖上次返回的数据
+    if (last_run_ >= 0) {
+      RC rc = push(last_run_);
+      if (OB_FAIL(rc) && rc != RC::RECORD_EOF) {
+        return rc;
+      }
+      last_run_ = -1;
+    }
+
+    if (heap_.empty()) {
+      return RC::RECORD_EOF;
+    }
+
+    const HeapItem &top = heap_.top();
+    item                = top.item;
+    last_run_           = top.run;
+    heap_.pop();
+    return RC::SUCCESS;
+  }
+
+private:
+  struct Run
+  {
+    ifstream     stream;
+    vector<char> buffer;
+    int          item_num = 0;  ///< 缓冲区中的键值对个数
+    int          index    = 0;  ///< 下一个要输出的键值对
+  };
+
+  struct HeapItem
+  {
+    const char *item = nullptr;
+    int         run  = -1;
+  };
+
+  struct HeapComparator
+  {
+    const KeyComparator &comparator;
+    bool operator()(const HeapItem &left, const HeapItem &right) const { return comparator(left.item, right.item) > 0; }
+  };
+
+  /// 把有序段中下一个键值对放到堆中
+  RC push(int run_index)
+  {
+    Run &run = *runs_[run_index];
+    if (run.index >= run.item_num) {
+      run.stream.read(run.buffer.data(), static_cast<std::streamsize>(run.buffer.size()));
+      const std::streamsize bytes = run.stream.gcount();
+      if (bytes % item_size_ != 0 || (bytes == 0 && !run.stream.eof())) {
+        LOG_WARN("failed to read sorted run file. read bytes=%ld", static_cast<long>(bytes));
+        return RC::IOERR_READ;
+      }
+      run.item_num = static_cast<int>(bytes / item_size_);
+      run.index    = 0;
+      if (run.item_num == 0) {
+        return RC::RECORD_EOF;
+      }
+    }
+
+    heap_.push(HeapItem{run.buffer.data() + static_cast<size_t>(run.index) * item_size_, run_index});
+    run.index++;
+    return RC::SUCCESS;
+  }
+
+private:
+  int                                                        item_size_ = 0;
+  vector<unique_ptr<Run>>                                    runs_;
+  priority_queue<HeapItem, vector<HeapItem>, HeapComparator> heap_;
+  int                                                        last_run_ = -1;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+BplusTreeBulkLoader::BplusTreeBulkLoader(BplusTreeHandler &tree_handler, size_t memory_limit /* = DEFAULT_MEMORY_LIMIT */)
+    : tree_handler_(tree_handler), memory_limit_(memory_limit)
+{
+  key_size_  = tree_handler_.file_header_.key_length;
+  item_size_ = key_size_ + tree_handler_.file_header_.leaf_value_length();
+}
+
+BplusTreeBulkLoader::~BplusTreeBulkLoader() { remove_run_files(); }
+
+RC BplusTreeBulkLoader::add(const char *user_key, const RID &rid, const char *include_data /* = nullptr */)
+{
+  // 叶子节点中的键值对是 用户键值 + RID 作为 key，RID + 包含列的数据 作为 value
+  const int attr_length    = tree_handler_.file_header_.attr_length;
+  const int include_length = tree_handler_.file_header_.include_length();
+  items_.insert(items_.end(), user_key, user_key + attr_length);
+  items_.insert(items_.end(), reinterpret_cast<const char *>(&rid), reinterpret_cast<const char *>(&rid + 1));
+  items_.insert(items_.end(), reinterpret_cast<const char *>(&rid), reinterpret_cast<const char *>(&rid + 1));
+  if (include_length > 0) {
+    if (include_data != nullptr) {
+      items_.insert(items_.end(), include_data, include_data + include_length);
+    } else {
+      items_.resize(items_.size() + include_length, 0);
+    }
+  }
+  item_count_++;
+
+  // 排序时每个键值对还需要一个指针
+  if (items_.size() + items_.size() / item_size_ * sizeof(const char *) >= memory_limit_) {
+    return spill();
+  }
+  return RC::SUCCESS;
+}
+
+void BplusTreeBulkLoader::sort_items()
+{
+  const size_t item_num = items_.size() / item_size_;
+  sorted_items_.resize(item_num);
+  for (size_t i = 0; i < item_num; i++) {
+    sorted_items_[i] = items_.data() + i * item_size_;
+  }
+
+  const KeyComparator &comparator = tree_handler_.key_comparator_;
+  std::sort(sorted_items_.begin(), sorted_items_.end(), [&comparator](const char *left, const char *right) {
+    return comparator(left, right) < 0;
+  });
+}
+
+RC BplusTreeBulkLoader::spill()
+{
+  if (items_.empty()) {
+    return RC::SUCCESS;
+  }
+
+  sort_items();
+
+  string   file_name = string(tree_handler_.disk_buffer_pool_->filename()) + ".sort." + std::to_string(run_files_.size());
+  ofstream stream(file_name, ios::binary | ios::out | ios::trunc);
+  if (!stream.is_open()) {
+    LOG_WARN("failed to create sorted run file. file=%s", file_name.c_str());
+    return RC::IOERR_OPEN;
+  }
+  run_files_.push_back(file_name);
+
+  // 先在缓冲区中拼接，避免每个键值对都调用一次 write
+  const size_t buffer_items = max(static_cast<size_t>(64 * 1024 / item_size_), size_t(1));
+  vector<char> buffer;
+  buffer.reserve(buffer_items * item_size_);
+  for (size_t i = 0; i < sorted_items_.size(); i++) {
+    buffer.insert(buffer.end(), sorted_items_[i], sorted_items_[i] + item_size_);
+    if (buffer.size() >= buffer_items * item_size_ || i + 1 == sorted_items_.size()) {
+      stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      buffer.clear();
+    }
+  }
+
+  stream.close();
+  if (stream.fail()) {
+    LOG_WARN("failed to write sorted run file. file=%s", file_name.c_str());
+    return RC::IOERR_WRITE;
+  }
+
+  LOG_INFO("spilled sorted run. file=%s, item num=%ld", file_name.c_str(), static_cast<long>(sorted_items_.size()));
+  items_.clear();
+  sorted_items_.clear();
+  return RC::SUCCESS;
+}
+
+void BplusTreeBulkLoader::remove_run_files()
+{
+  for (const string &file : run_files_) {
+    error_code ec;
+    filesystem::remove(file, ec);
+    if (ec) {
+      LOG_WARN("failed to remove sorted run file. file=%s, error=%s", file.c_str(), ec.message().c_str());
+    }
+  }
+  run_files_.clear();
+}
+
+RC BplusTreeBulkLoader::finish()
+{
+  if (!tree_handler_.is_empty()) {
+    LOG_WARN("cannot bulk load a non-empty bplus tree");
+    return RC::INTERNAL;
+  }
+
+  RC rc = RC::SUCCESS;
+
+  unique_ptr<ItemSource> source;
+  if (run_files_.empty()) {
+    sort_items();
+    source = make_unique<MemoryItemSource>(sorted_items_);
+  } else {
+    rc = spill();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    auto merge_source = make_unique<MergeItemSource>(tree_handler_.key_comparator_, item_size_);
+    rc                = merge_source->init(run_files_, memory_limit_);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init merge of sorted runs. rc=%s", strrc(rc));
+      return rc;
+    }
+    source = std::move(merge_source);
+  }
+
+  vector<char>    keys;
+  vector<PageNum> pages;
+  rc = build_leaves(*source, keys, pages);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to build leaf nodes. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  if (pages.empty()) {
+    return RC::SUCCESS;
+  }
+
+  const int leaf_num = static_cast<int>(pages.size());
+  int       level    = 1;
+  while (pages.size() > 1) {
+    rc = build_internal_level(keys, pages);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to build internal nodes. rc=%s", strrc(rc));
+      return rc;
+    }
+    level++;
+  }
+
+  rc = update_root_page(pages[0]);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  LOG_INFO("bulk load bplus tree done. file=%s, item num=%ld, sorted runs=%d, leaf num=%d, level=%d",
+           tree_handler_.disk_buffer_pool_->filename(), static_cast<long>(item_count_), run_count(), leaf_num, level);
+
+  items_.clear();
+  items_.shrink_to_fit();
+  sorted_items_.clear();
+  sorted_items_.shrink_to_fit();
+  remove_run_files();
+  return RC::SUCCESS;
+}
+
+RC BplusTreeBulkLoader::build_leaves(ItemSource &source, vector<char> &keys, vector<PageNum> &pages)
+{
+  const KeyComparator &comparator = tree_handler_.key_comparator_;
+  const int            max_items  = tree_handler_.file_header_.leaf_max_size;
+
+  // 攒够两个节点的数据再写一个节点，这样最后剩下的数据可以平分到两个节点中，不会留下一个很小的节点
+  vector<char> pending;
+  pending.reserve(static_cast<size_t>(max_items) * 2 * item_size_);
+  int     pending_num = 0;
+  PageNum prev_page   = BP_INVALID_PAGE_NUM;
+
+  auto flush = [&](bool last) {
+    int written = 0;
+    RC  rc      = write_leaf(pending.data(), pending_num, last, written, prev_page, keys, pages);
+    if (OB_SUCC(rc)) {
+      pending.erase(pending.begin(), pending.begin() + static_cast<size_t>(written) * item_size_);
+      pending_num -= written;
+    }
+    return rc;
+  };
+
+  RC          rc   = RC::SUCCESS;
+  const char *item = nullptr;
+  while (OB_SUCC(rc = source.next(item))) {
+    if (pending_num > 0 && comparator(pending.data() + pending.size() - item_size_, item) >= 0) {
+      LOG_WARN("duplicate key while bulk loading bplus tree");
+      return RC::RECORD_DUPLICATE_KEY;
+    }
+
+    pending.insert(pending.end(), item, item + item_size_);
+    pending_num++;
+    if (pending_num >= max_items * 2) {
+      rc = flush(false /*last*/);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+  }
+
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to read sorted items. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  while (pending_num > 0) {
+    rc = flush(true /*last*/);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC BplusTreeBulkLoader::write_leaf(
+    const char *items, int num, bool last, int &written, PageNum &prev_page, vector<char> &keys, vector<PageNum> &pages)
+{
+  RC                       rc = RC::SUCCESS;
+  BplusTreeMiniTransaction mtr(tree_handler_, &rc);
+
+  Frame *frame = nullptr;
+  rc           = mtr.latch_memo().allocate_page(frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate leaf page. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  LeafIndexNodeHandler leaf(mtr, tree_handler_.file_header_, frame);
+  leaf.init_empty();
+
+  written = leaf.fit_count(items, num);
+  if (last && written < num) {
+    // 剩下的数据放不到一个节点中时，尽量平分到两个节点中
+    const int half = num / 2;
+    if (leaf.fit_count(items, half) == half &&
+        leaf.fit_count(items + static_cast<size_t>(half) * item_size_, num - half) == num - half) {
+      written = half;
+    }
+  }
+  if (written <= 0) {
+    LOG_WARN("leaf node cannot hold any item. page num=%d", frame->page_num());
+    rc = RC::INTERNAL;
+    return rc;
+  }
+
+  rc = leaf.append(items, written);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to append items to leaf node. rc=%s", strrc(rc));
+    return rc;
+  }
+  frame->mark_dirty();
+
+  if (prev_page != BP_INVALID_PAGE_NUM) {
+    Frame *prev_frame = nullptr;
+    rc                = mtr.latch_memo().get_page(prev_page, prev_frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to fetch previous leaf page. page num=%d, rc=%s", prev_page, strrc(rc));
+      return rc;
+    }
+    mtr.latch_memo().xlatch(prev_frame);
+
+    LeafIndexNodeHandler prev_leaf(mtr, tree_handler_.file_header_, prev_frame);
+    rc = prev_leaf.set_next_page(frame->page_num());
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    prev_frame->mark_dirty();
+  }
+
+  prev_page = frame->page_num();
+  keys.insert(keys.end(), items, items + key_size_);
+  pages.push_back(frame->page_num());
+  return rc;
+}
+
+RC BplusTreeBulkLoader::build_internal_level(vector<char> &keys, vector<PageNum> &pages)
+{
+  const int child_num     = static_cast<int>(pages.size());
+  const int max_children  = tree_handler_.file_header_.internal_max_size;
+  const int node_num      = (child_num + max_children - 1) / max_children;
+  const int internal_item = key_size_ + static_cast<int>(sizeof(PageNum));
+
+  vector<char>    parent_keys;
+  vector<PageNum> parent_pages;
+  vector<char>    items;
+
+  // 子节点平均分配到每个内部节点中，每个内部节点都不会少于最少的子节点个数
+  int child_index = 0;
+  for (int node_index = 0; node_index < node_num; node_index++) {
+    const int children = child_num / node_num + (node_index < child_num % node_num ? 1 : 0);
+
+    items.assign(static_cast<size_t>(children) * internal_item, 0);
+    for (int i = 0; i < children; i++) {
+      char *item = items.data() + static_cast<size_t>(i) * internal_item;
+      // 内部节点的第一个键值不使用
+      if (i > 0) {
+        memcpy(item, keys.data() + static_cast<size_t>(child_index + i) * key_size_, key_size_);
+      }
+      memcpy(item + key_size_, &pages[child_index + i], sizeof(PageNum));
+    }
+
+    RC                       rc = RC::SUCCESS;
+    BplusTreeMiniTransaction mtr(tree_handler_, &rc);
+
+    Frame *frame = nullptr;
+    rc           = mtr.latch_memo().allocate_page(frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate internal page. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    InternalIndexNodeHandler node(mtr, tree_handler_.file_header_, frame);
+    node.init_empty();
+    rc = node.append(items.data(), children);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to append items to internal node. rc=%s", strrc(rc));
+      return rc;
+    }
+    frame->mark_dirty();
+
+    parent_keys.insert(parent_keys.end(),
+        keys.data() + static_cast<size_t>(child_index) * key_size_,
+        keys.data() + static_cast<size_t>(child_index + 1) * key_size_);
+    parent_pages.push_back(frame->page_num());
+    child_index += children;
+  }
+
+  keys.swap(parent_keys);
+  pages.swap(parent_pages);
+  return RC::SUCCESS;
+}
+
+RC BplusTreeBulkLoader::update_root_page(PageNum root_page)
+{
+  RC rc = RC::SUCCESS;
+
+  tree_handler_.root_lock_.lock();
+  {
+    BplusTreeMiniTransaction mtr(tree_handler_, &rc);
+    tree_handler_.update_root_page_num_locked(mtr, root_page);
+  }
+  tree_handler_.root_lock_.unlock();
+  return rc;
+}
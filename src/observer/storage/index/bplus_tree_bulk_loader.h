@@ -0,0 +1,96 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "storage/index/bplus_tree.h"
+
+/**
+ * @brief 自底向上地批量构建B+树
+ * @ingroup BPlusTree
+ * @details 用于给已经有数据的表创建索引。逐条调用 insert_entry 时，每条数据都要从根节点查找到叶子节点，
+ * 还会不断地分裂节点，每条数据都会生成日志。批量构建的过程是：
+ * 1. 调用 add 加入所有的数据，数据先放在内存中，超过内存限制后排好序写到临时文件中(一个有序段)；
+ * 2. 调用 finish 时对所有的有序段做多路归并，得到全局有序的数据，从左到右依次填满叶子节点；
+ * 3. 再使用每个叶子节点的第一个键值，一层一层地向上构建内部节点，最后设置根节点。
+ * 每个节点在一个 mini transaction 中一次写满，日志也是以页面为单位记录的。
+ * 只能用于空的B+树，构建过程中不能有其它线程访问这棵树。
+ */
+class BplusTreeBulkLoader
+{
+public:
+  /// 默认的内存限制，排序时超过这个大小就写到临时文件中
+  static constexpr size_t DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
+
+  /**
+   * @param tree_handler 需要构建的B+树，必须是空的
+   * @param memory_limit 排序时最多使用的内存
+   */
+  BplusTreeBulkLoader(BplusTreeHandler &tree_handler, size_t memory_limit = DEFAULT_MEMORY_LIMIT);
+  ~BplusTreeBulkLoader();
+
+  /**
+   * @brief 加入一条数据，不要求有序
+   * @param include_data 包含列的数据，没有包含列时可以是空的
+   */
+  RC add(const char *user_key, const RID &rid, const char *include_data = nullptr);
+
+  /**
+   * @brief 排序所有的数据并构建B+树
+   * @details 有重复的数据(键值和RID都相同)时返回 RC::RECORD_DUPLICATE_KEY
+   */
+  RC finish();
+
+  /// 已经加入的数据条数
+  int64_t item_count() const { return item_count_; }
+  /// 写到临时文件中的有序段个数
+  int run_count() const { return static_cast<int>(run_files_.size()); }
+
+private:
+  class ItemSource;
+  class MemoryItemSource;
+  class MergeItemSource;
+
+  /// 把内存中的数据排好序，写到一个新的临时文件中
+  RC spill();
+  /// 按照键值排序内存中的数据，结果放在 sorted_items_ 中
+  void sort_items();
+  void remove_run_files();
+
+  /// 从有序的数据构建叶子节点，每个叶子节点的第一个键值和页面编号放到 keys/pages 中
+  RC build_leaves(ItemSource &source, vector<char> &keys, vector<PageNum> &pages);
+  /**
+   * @brief 分配一个叶子节点，尽量多地放入 items 开头的数据，并链接到上一个叶子节点后面
+   * @param last 是否是最后剩下的数据，放不下时会平分到两个节点中
+   * @param[out] written 放入节点中的数据条数
+   */
+  RC write_leaf(const char *items, int num, bool last, int &written, PageNum &prev_page, vector<char> &keys,
+      vector<PageNum> &pages);
+  /// 使用下一层节点的第一个键值和页面编号构建一层内部节点，结果替换到 keys/pages 中
+  RC build_internal_level(vector<char> &keys, vector<PageNum> &pages);
+  RC update_root_page(PageNum root_page);
+
+private:
+  BplusTreeHandler &tree_handler_;
+  size_t            memory_limit_ = DEFAULT_MEMORY_LIMIT;
+  int               key_size_     = 0;  ///< 键值(用户键值 + RID)的长度
+  int               item_size_    = 0;  ///< 叶子节点中一个键值对的长度
+
+  vector<char>         items_;         ///< 还没有写到临时文件中的数据
+  vector<const char *> sorted_items_;  ///< 排好序的 items_
+  vector<string>       run_files_;     ///< 有序段的临时文件
+  int64_t              item_count_ = 0;
+};
@@ -13,13 +13,16 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "storage/index/bplus_tree_index.h"
+#include "common/lang/algorithm.h"
 #include "common/log/log.h"
+#include "storage/index/bplus_tree_bulk_loader.h"
 #include "storage/table/table.h"
 #include "storage/db/db.h"
 
 BplusTreeIndex::~BplusTreeIndex() noexcept { close(); }
 
-RC BplusTreeIndex::create(Table *table, const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta)
+RC BplusTreeIndex::create(Table *table, const char *file_name, const IndexMeta &index_meta,
+    const vector<const FieldMeta *> &field_metas, const vector<const FieldMeta *> &include_field_metas)
 {
   if (inited_) {
     LOG_WARN("Failed to create index due to the index has been created before. file_name:%s, index:%s, field:%s",
@@ -27,10 +30,22 @@ RC BplusTreeIndex::create(Table *table, const char *file_name, const IndexMeta &
     return RC::RECORD_OPENNED;
   }
 
-  Index::init(index_meta, field_meta);
+  Index::init(index_meta, field_metas, include_field_metas);
 
   BufferPoolManager &bpm = table->db()->buffer_pool_manager();
-  RC rc = index_handler_.create(table->db()->log_handler(), bpm, file_name, field_meta.type(), field_meta.len());
+  vector<AttrType> attr_types;
+  vector<int>      attr_lengths;
+  for (const FieldMeta *field_meta : field_metas) {
+    attr_types.push_back(field_meta->type());
+    attr_lengths.push_back(field_meta->len());
+  }
+  int include_length = 0;
+  for (const FieldMeta *field_meta : include_field_metas) {
+    include_length += field_meta->len();
+  }
+
+  RC rc = index_handler_.create(table->db()->log_handler(), bpm, file_name, attr_types, attr_lengths,
+      -1 /*internal_max_size*/, -1 /*leaf_max_size*/, include_length);
   if (RC::SUCCESS != rc) {
     LOG_WARN("Failed to create index_handler, file_name:%s, index:%s, field:%s, rc:%s",
         file_name, index_meta.name(), index_meta.field(), strrc(rc));
@@ -44,7 +59,8 @@ RC BplusTreeIndex::create(Table *table, const char *file_name, const IndexMeta &
   return RC::SUCCESS;
 }
 
-RC BplusTreeIndex::open(Table *table, const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta)
+RC BplusTreeIndex::open(Table *table, const char *file_name, const IndexMeta &index_meta,
+    const vector<const FieldMeta *> &field_metas, const vector<const FieldMeta *> &include_field_metas)
 {
   if (inited_) {
     LOG_WARN("Failed to open index due to the index has been initedd before. file_name:%s, index:%s, field:%s",
@@ -52,7 +68,7 @@ RC BplusTreeIndex::open(Table *table, const char *file_name, const IndexMeta &in
     return RC::RECORD_OPENNED;
   }
 
-  Index::init(index_meta, field_meta);
+  Index::init(index_meta, field_metas, include_field_metas);
 
   BufferPoolManager &bpm = table->db()->buffer_pool_manager();
   RC rc = index_handler_.open(table->db()->log_handler(), bpm, file_name);
@@ -80,14 +96,106 @@ RC BplusTreeIndex::close()
   return RC::SUCCESS;
 }
 
+const char *BplusTreeIndex::make_user_key(const char *record, vector<char> &buffer) const
+{
+  if (field_metas_.size() == 1) {
+    return record + field_metas_[0].offset();
+  }
+
+  buffer.clear();
+  for (const FieldMeta &field_meta : field_metas_) {
+    buffer.insert(buffer.end(), record + field_meta.offset(), record + field_meta.offset() + field_meta.len());
+  }
+  return buffer.data();
+}
+
+const char *BplusTreeIndex::make_include_data(const char *record, vector<char> &buffer) const
+{
+  if (include_field_metas_.empty()) {
+    return nullptr;
+  }
+
+  buffer.clear();
+  for (const FieldMeta &field_meta : include_field_metas_) {
+    buffer.insert(buffer.end(), record + field_meta.offset(), record + field_meta.offset() + field_meta.len());
+  }
+  return buffer.data();
+}
+
 RC BplusTreeIndex::insert_entry(const char *record, const RID *rid)
 {
-  return index_handler_.insert_entry(record + field_meta_.offset(), rid);
+  vector<char> buffer;
+  vector<char> include_buffer;
+  return index_handler_.insert_entry(make_user_key(record, buffer), rid, make_include_data(record, include_buffer));
+}
+
+RC BplusTreeIndex::insert_entries(span<const Record> records)
+{
+  // 键值与 B+ 树中的一样，是用户键值后面跟着 RID，这样可以直接使用树的比较器
+  const KeyComparator &comparator = index_handler_.key_comparator();
+  const int            attr_length = comparator.attr_comparator().attr_length();
+  const int            key_length  = attr_length + static_cast<int>(sizeof(RID));
+
+  vector<char> keys(records.size() * key_length);
+  vector<int>  order(records.size());
+  vector<char> buffer;
+  for (size_t i = 0; i < records.size(); i++) {
+    char *key = keys.data() + i * key_length;
+    memcpy(key, make_user_key(records[i].data(), buffer), attr_length);
+    memcpy(key + attr_length, &records[i].rid(), sizeof(RID));
+    order[i] = static_cast<int>(i);
+  }
+
+  std::sort(order.begin(), order.end(), [&comparator, &keys, key_length](int left, int right) {
+    return comparator(keys.data() + left * key_length, keys.data() + right * key_length) < 0;
+  });
+
+  vector<char> include_buffer;
+  for (int index : order) {
+    const Record &record = records[index];
+    RC rc = index_handler_.insert_entry(keys.data() + index * key_length, &record.rid(),
+        make_include_data(record.data(), include_buffer));
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to insert index entry. rid=%s, rc=%s", record.rid().to_string().c_str(), strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
 }
 
 RC BplusTreeIndex::delete_entry(const char *record, const RID *rid)
 {
-  return index_handler_.delete_entry(record + field_meta_.offset(), rid);
+  vector<char> buffer;
+  return index_handler_.delete_entry(make_user_key(record, buffer), rid);
+}
+
+RC BplusTreeIndex::bulk_load(RecordFileScanner &scanner)
+{
+  BplusTreeBulkLoader loader(index_handler_);
+
+  RC           rc = RC::SUCCESS;
+  Record       record;
+  vector<char> buffer;
+  vector<char> include_buffer;
+  while (OB_SUCC(rc = scanner.next(record))) {
+    rc = loader.add(
+        make_user_key(record.data(), buffer), record.rid(), make_include_data(record.data(), include_buffer));
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to add record into bulk loader. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to scan records while bulk loading index. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = loader.finish();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to bulk load index. rc=%s", strrc(rc));
+  }
+  return rc;
 }
 
 IndexScanner *BplusTreeIndex::create_scanner(
@@ -118,6 +226,16 @@ RC BplusTreeIndexScanner::open(
 
 RC BplusTreeIndexScanner::next_entry(RID *rid) { return tree_scanner_.next_entry(*rid); }
 
+RC BplusTreeIndexScanner::next_entry(RID *rid, char *key, char *include_data)
+{
+  return tree_scanner_.next_entry(*rid, key, include_data);
+}
+
+RC BplusTreeIndexScanner::next_entries(vector<RID> &rids, int max_num)
+{
+  return tree_scanner_.next_entries(rids, max_num);
+}
+
 RC BplusTreeIndexScanner::destroy()
 {
   delete this;
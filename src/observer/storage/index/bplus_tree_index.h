@@ -27,13 +27,27 @@ public:
   BplusTreeIndex() = default;
   virtual ~BplusTreeIndex() noexcept;
 
-  RC create(Table *table, const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta);
-  RC open(Table *table, const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta);
+  RC create(Table *table, const char *file_name, const IndexMeta &index_meta,
+      const vector<const FieldMeta *> &field_metas, const vector<const FieldMeta *> &include_field_metas = {});
+  RC open(Table *table, const char *file_name, const IndexMeta &index_meta,
+      const vector<const FieldMeta *> &field_metas, const vector<const FieldMeta *> &include_field_metas = {});
   RC close();
 
   RC insert_entry(const char *record, const RID *rid) override;
+
+  /**
+   * @brief 插入多条数据
+   * @details 先按照键值排序再逐条插入，相邻的键值大多落在同一个叶子节点上，访问的页面更集中
+   */
+  RC insert_entries(span<const Record> records) override;
   RC delete_entry(const char *record, const RID *rid) override;
 
+  /**
+   * @brief 使用表中已有的数据批量构建索引，索引必须是空的
+   * @details 先对所有的键值排序，再自底向上地构建B+树，比逐条插入快很多
+   */
+  RC bulk_load(RecordFileScanner &scanner);
+
   /**
    * 扫描指定范围的数据
    */
@@ -42,6 +56,16 @@ public:
 
   RC sync() override;
 
+private:
+  /**
+   * @brief 从记录中取出索引的键值
+   * @details 单字段索引直接返回记录中字段的位置，联合索引需要把各个字段拼接到 buffer 中
+   */
+  const char *make_user_key(const char *record, vector<char> &buffer) const;
+
+  /// 从记录中取出包含列的数据，拼接到 buffer 中。没有包含列时返回空
+  const char *make_include_data(const char *record, vector<char> &buffer) const;
+
 private:
   bool             inited_ = false;
   Table           *table_  = nullptr;
@@ -59,6 +83,8 @@ public:
   ~BplusTreeIndexScanner() noexcept override;
 
   RC next_entry(RID *rid) override;
+  RC next_entry(RID *rid, char *key, char *include_data) override;
+  RC next_entries(vector<RID> &rids, int max_num) override;
   RC destroy() override;
 
   RC open(const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len,
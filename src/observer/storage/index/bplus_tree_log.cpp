@@ -85,11 +85,6 @@ RC BplusTreeLogger::internal_update_key(
   return append_log_entry(make_unique<InternalUpdateKeyLogEntryHandler>(node_handler.frame(), index, key, old_key));
 }
 
-RC BplusTreeLogger::set_parent_page(IndexNodeHandler &node_handler, PageNum page_num, PageNum old_page_num)
-{
-  return append_log_entry(make_unique<SetParentPageLogEntryHandler>(node_handler.frame(), page_num, old_page_num));
-}
-
 RC BplusTreeLogger::append_log_entry(unique_ptr<bplus_tree::LogEntryHandler> entry)
 {
   if (!need_log_) {
@@ -285,6 +280,16 @@ RC BplusTreeMiniTransaction::commit() { return logger_.commit(); }
 
 RC BplusTreeMiniTransaction::rollback() { return logger_.rollback(*this, tree_handler_); }
 
+PageNum BplusTreeMiniTransaction::parent_page_num(PageNum page_num) const
+{
+  for (size_t i = 1; i < path_.size(); i++) {
+    if (path_[i] == page_num) {
+      return path_[i - 1];
+    }
+  }
+  return BP_INVALID_PAGE_NUM;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // class BplusTreeLogReplayer
 BplusTreeLogReplayer::BplusTreeLogReplayer(BufferPoolManager &bpm) : buffer_pool_manager_(bpm) {}
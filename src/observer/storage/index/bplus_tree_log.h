@@ -122,11 +122,6 @@ public:
    */
   RC internal_update_key(IndexNodeHandler &node_handler, int index, span<const char> key, span<const char> old_key);
 
-  /**
-   * @brief 修改某个页面的父节点编号
-   */
-  RC set_parent_page(IndexNodeHandler &node_handler, PageNum page_num, PageNum old_page_num);
-
   /**
    * @brief 提交。表示整个操作成功
    */
@@ -180,6 +175,19 @@ public:
   LatchMemo       &latch_memo() { return latch_memo_; }
   BplusTreeLogger &logger() { return logger_; }
 
+  /// 开始一次新的从根节点向下的查找，清空之前记录的路径
+  void clear_path() { path_.clear(); }
+  /// 记录查找路径上的一个页面，需要按照从根节点到叶子节点的顺序
+  void push_path(PageNum page_num) { path_.push_back(page_num); }
+
+  /**
+   * @brief 从查找路径中获取某个页面的父节点
+   * @details 节点页面中不记录父节点，分裂或合并时，父节点就是查找路径上的前一个页面。
+   * 路径上的页面只有一直持有写锁时，结果才是可靠的。
+   * @return 父节点的页面编号。页面是根节点或者不在路径上时返回 BP_INVALID_PAGE_NUM
+   */
+  PageNum parent_page_num(PageNum page_num) const;
+
   RC commit();
   RC rollback();
 
@@ -188,6 +196,7 @@ private:
   RC               *operation_result_ = nullptr;
   LatchMemo         latch_memo_;
   BplusTreeLogger   logger_;
+  vector<PageNum>   path_;  ///< 最近一次从根节点向下查找时经过的页面
 };
 
 /**
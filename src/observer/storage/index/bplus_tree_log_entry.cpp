@@ -262,17 +262,13 @@ RC SetParentPageLogEntryHandler::deserialize(Frame *frame, Deserializer &buffer,
 
 RC SetParentPageLogEntryHandler::rollback(BplusTreeMiniTransaction &mtr, BplusTreeHandler &tree_handler)
 {
-  if (nullptr == frame()) {
-    return RC::INTERNAL;
-  }
-  IndexNodeHandler node_handler(mtr, tree_handler.file_header(), frame());
-  return node_handler.set_parent_page_num(old_parent_page_num_);
+  // 节点页面中已经不再记录父节点，这类日志只会出现在旧版本生成的日志中，不需要做任何事情
+  return RC::SUCCESS;
 }
 
 RC SetParentPageLogEntryHandler::redo(BplusTreeMiniTransaction &mtr, BplusTreeHandler &tree_handler)
 {
-  IndexNodeHandler node_handler(mtr, tree_handler.file_header(), frame());
-  return node_handler.set_parent_page_num(parent_page_num_);
+  return RC::SUCCESS;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -328,11 +324,18 @@ RC NormalOperationLogEntryHandler::rollback(BplusTreeMiniTransaction &mtr, Bplus
   if (nullptr == frame()) {
     return RC::INTERNAL;
   }
-  IndexNodeHandler node_handler(mtr, tree_handler.file_header(), frame());
+  InternalIndexNodeHandler internal_node(mtr, tree_handler.file_header(), frame());
+  LeafIndexNodeHandler     leaf_node(mtr, tree_handler.file_header(), frame());
+  IndexNodeHandler        *real_handler = nullptr;
+  if (leaf_node.is_leaf()) {
+    real_handler = &leaf_node;
+  } else {
+    real_handler = &internal_node;
+  }
   if (operation_type().type() == LogOperation::Type::NODE_INSERT) {
-    return node_handler.recover_remove_items(index_, item_num_);
+    return real_handler->recover_remove_items(index_, item_num_);
   } else {  // should be NODE_REMOVE
-    return node_handler.recover_insert_items(index_, items_.data(), item_num_);
+    return real_handler->recover_insert_items(index_, items_.data(), item_num_);
   }
 }
 
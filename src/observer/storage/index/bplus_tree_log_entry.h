@@ -42,7 +42,7 @@ public:
   {
     INIT_HEADER_PAGE,          /// 初始化B+树文件头
     UPDATE_ROOT_PAGE,          /// 更新根节点
-    SET_PARENT_PAGE,           /// 设置父节点
+    SET_PARENT_PAGE,           /// 设置父节点。已经废弃，只会出现在旧版本的日志中
     LEAF_INIT_EMPTY,           /// 初始化叶子节点
     LEAF_SET_NEXT_PAGE,        /// 设置叶子节点的兄弟节点
     INTERNAL_INIT_EMPTY,       /// 初始化内部节点
@@ -204,6 +204,7 @@ private:
 /**
  * @brief 设置父节点日志处理类
  * @ingroup CLog
+ * @details 节点页面中已经不再记录父节点，不会再生成这类日志。保留这个类是为了能够解析旧版本生成的日志，重做和回滚都不做任何事情。
  */
 class SetParentPageLogEntryHandler : public NodeLogEntryHandler
 {
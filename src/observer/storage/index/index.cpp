@@ -12,11 +12,60 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai.wyl on 2021/5/19.
 //
 
+#include <string.h>
+
 #include "storage/index/index.h"
 
-RC Index::init(const IndexMeta &index_meta, const FieldMeta &field_meta)
+RC Index::init(const IndexMeta &index_meta, const std::vector<const FieldMeta *> &field_metas,
+    const std::vector<const FieldMeta *> &include_field_metas)
 {
   index_meta_ = index_meta;
-  field_meta_ = field_meta;
+  field_metas_.clear();
+  for (const FieldMeta *field_meta : field_metas) {
+    field_metas_.push_back(*field_meta);
+  }
+  include_field_metas_.clear();
+  for (const FieldMeta *field_meta : include_field_metas) {
+    include_field_metas_.push_back(*field_meta);
+  }
+  return RC::SUCCESS;
+}
+
+RC Index::insert_entries(span<const Record> records)
+{
+  for (const Record &record : records) {
+    RC rc = insert_entry(record.data(), &record.rid());
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
   return RC::SUCCESS;
 }
+
+bool Index::entry_changed(const char *old_record, const char *new_record) const
+{
+  auto changed = [old_record, new_record](const std::vector<FieldMeta> &field_metas) {
+    for (const FieldMeta &field_meta : field_metas) {
+      if (0 != memcmp(old_record + field_meta.offset(), new_record + field_meta.offset(), field_meta.len())) {
+        return true;
+      }
+    }
+    return false;
+  };
+  return changed(field_metas_) || changed(include_field_metas_);
+}
+
+RC IndexScanner::next_entries(std::vector<RID> &rids, int max_num)
+{
+  rids.clear();
+  RC  rc = RC::SUCCESS;
+  RID rid;
+  while (static_cast<int>(rids.size()) < max_num && OB_SUCC(rc = next_entry(&rid))) {
+    rids.push_back(rid);
+  }
+
+  if (RC::RECORD_EOF == rc && !rids.empty()) {
+    return RC::SUCCESS;
+  }
+  return rc;
+}
@@ -42,6 +42,12 @@ public:
 
   const IndexMeta &index_meta() const { return index_meta_; }
 
+  /// 索引包含的字段，与键值中的顺序一致
+  const std::vector<FieldMeta> &field_metas() const { return field_metas_; }
+
+  /// 索引的包含列，值存放在索引中但是不参与排序
+  const std::vector<FieldMeta> &include_field_metas() const { return include_field_metas_; }
+
   /**
    * @brief 插入一条数据
    *
@@ -50,6 +56,13 @@ public:
    */
   virtual RC insert_entry(const char *record, const RID *rid) = 0;
 
+  /**
+   * @brief 插入多条数据
+   * @details 默认逐条插入。出错时返回，已经插入的数据不会删除，由调用者处理
+   * @param records 插入的记录，需要已经有RID
+   */
+  virtual RC insert_entries(span<const Record> records);
+
   /**
    * @brief 删除一条数据
    *
@@ -58,6 +71,12 @@ public:
    */
   virtual RC delete_entry(const char *record, const RID *rid) = 0;
 
+  /**
+   * @brief 记录从 old_record 修改成 new_record 之后，索引项是否需要修改
+   * @details 比较索引字段和包含列的数据，其它字段的修改不影响索引
+   */
+  bool entry_changed(const char *old_record, const char *new_record) const;
+
   /**
    * @brief 创建一个索引数据的扫描器
    *
@@ -78,11 +97,13 @@ public:
   virtual RC sync() = 0;
 
 protected:
-  RC init(const IndexMeta &index_meta, const FieldMeta &field_meta);
+  RC init(const IndexMeta &index_meta, const std::vector<const FieldMeta *> &field_metas,
+      const std::vector<const FieldMeta *> &include_field_metas = {});
 
 protected:
-  IndexMeta index_meta_;  ///< 索引的元数据
-  FieldMeta field_meta_;  ///< 当前实现仅考虑一个字段的索引
+  IndexMeta              index_meta_;           ///< 索引的元数据
+  std::vector<FieldMeta> field_metas_;          ///< 索引包含的字段，多个字段时键值是这些字段按顺序拼接起来的
+  std::vector<FieldMeta> include_field_metas_;  ///< 包含列，数据是这些字段按顺序拼接起来的
 };
 
 /**
@@ -100,5 +121,22 @@ public:
    * 如果没有更多的元素，返回RECORD_EOF
    */
   virtual RC next_entry(RID *rid) = 0;
-  virtual RC destroy()            = 0;
+
+  /**
+   * @brief 遍历元素数据，同时返回键值和包含列的数据
+   * @details 键值是索引字段按顺序拼接起来的，包含列的数据也是一样。不支持的索引返回 UNIMPLENMENT
+   * @param key 返回键值，可以是空的
+   * @param include_data 返回包含列的数据，可以是空的
+   */
+  virtual RC next_entry(RID *rid, char *key, char *include_data) { return RC::UNIMPLENMENT; }
+
+  /**
+   * @brief 遍历一批元素数据
+   * @details 默认逐条调用 next_entry。如果没有更多的元素，返回RECORD_EOF
+   * @param rids 返回的数据，会先清空
+   * @param max_num 最多返回多少条数据
+   */
+  virtual RC next_entries(std::vector<RID> &rids, int max_num);
+
+  virtual RC destroy() = 0;
 };
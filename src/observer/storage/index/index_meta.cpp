@@ -13,6 +13,7 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "storage/index/index_meta.h"
+#include "common/lang/algorithm.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "storage/field/field_meta.h"
@@ -21,23 +22,97 @@ See the Mulan PSL v2 for more details. */
 
 const static Json::StaticString FIELD_NAME("name");
 const static Json::StaticString FIELD_FIELD_NAME("field_name");
+const static Json::StaticString FIELD_FIELD_NAMES("field_names");
+const static Json::StaticString FIELD_INCLUDE_FIELD_NAMES("include_field_names");
+
+namespace {
+
+RC field_names_from_json(const Json::Value &index_name, const Json::Value &fields_value, vector<string> &field_names)
+{
+  for (int i = 0; i < static_cast<int>(fields_value.size()); i++) {
+    if (!fields_value[i].isString()) {
+      LOG_ERROR("Field name of index [%s] is not a string. json value=%s",
+          index_name.asCString(), fields_value[i].toStyledString().c_str());
+      return RC::INTERNAL;
+    }
+    field_names.emplace_back(fields_value[i].asString());
+  }
+  return RC::SUCCESS;
+}
+
+RC fields_of_table(const TableMeta &table, const Json::Value &index_name, const vector<string> &field_names,
+    vector<const FieldMeta *> &fields)
+{
+  for (const string &field_name : field_names) {
+    const FieldMeta *field = table.field(field_name.c_str());
+    if (nullptr == field) {
+      LOG_ERROR("Deserialize index [%s]: no such field: %s", index_name.asCString(), field_name.c_str());
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+    fields.push_back(field);
+  }
+  return RC::SUCCESS;
+}
+
+}  // namespace
 
 RC IndexMeta::init(const char *name, const FieldMeta &field)
+{
+  return init(name, vector<const FieldMeta *>{&field});
+}
+
+RC IndexMeta::init(
+    const char *name, const vector<const FieldMeta *> &fields, const vector<const FieldMeta *> &include_fields)
 {
   if (common::is_blank(name)) {
     LOG_ERROR("Failed to init index, name is empty.");
     return RC::INVALID_ARGUMENT;
   }
 
-  name_  = name;
-  field_ = field.name();
+  if (fields.empty() || fields.size() > MAX_FIELD_NUM) {
+    LOG_ERROR("Failed to init index, invalid field number. name=%s, field num=%d", name, static_cast<int>(fields.size()));
+    return RC::INVALID_ARGUMENT;
+  }
+
+  if (include_fields.size() > MAX_FIELD_NUM) {
+    LOG_ERROR("Failed to init index, invalid include field number. name=%s, field num=%d",
+        name, static_cast<int>(include_fields.size()));
+    return RC::INVALID_ARGUMENT;
+  }
+
+  name_ = name;
+  fields_.clear();
+  for (const FieldMeta *field : fields) {
+    fields_.emplace_back(field->name());
+  }
+  include_fields_.clear();
+  for (const FieldMeta *field : include_fields) {
+    include_fields_.emplace_back(field->name());
+  }
   return RC::SUCCESS;
 }
 
 void IndexMeta::to_json(Json::Value &json_value) const
 {
   json_value[FIELD_NAME]       = name_;
-  json_value[FIELD_FIELD_NAME] = field_;
+  json_value[FIELD_FIELD_NAME] = fields_[0];
+
+  // 单字段的索引仍然只使用 field_name，与旧版本的元数据保持兼容
+  if (fields_.size() > 1) {
+    Json::Value fields_value;
+    for (const string &field : fields_) {
+      fields_value.append(field);
+    }
+    json_value[FIELD_FIELD_NAMES] = std::move(fields_value);
+  }
+
+  if (!include_fields_.empty()) {
+    Json::Value fields_value;
+    for (const string &field : include_fields_) {
+      fields_value.append(field);
+    }
+    json_value[FIELD_INCLUDE_FIELD_NAMES] = std::move(fields_value);
+  }
 }
 
 RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, IndexMeta &index)
@@ -55,17 +130,61 @@ RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, I
     return RC::INTERNAL;
   }
 
-  const FieldMeta *field = table.field(field_value.asCString());
-  if (nullptr == field) {
-    LOG_ERROR("Deserialize index [%s]: no such field: %s", name_value.asCString(), field_value.asCString());
-    return RC::SCHEMA_FIELD_MISSING;
+  RC                 rc = RC::SUCCESS;
+  vector<string>     field_names;
+  const Json::Value &fields_value = json_value[FIELD_FIELD_NAMES];
+  if (fields_value.isArray()) {
+    rc = field_names_from_json(name_value, fields_value, field_names);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  } else {
+    field_names.emplace_back(field_value.asString());
+  }
+
+  vector<string>     include_field_names;
+  const Json::Value &include_fields_value = json_value[FIELD_INCLUDE_FIELD_NAMES];
+  if (include_fields_value.isArray()) {
+    rc = field_names_from_json(name_value, include_fields_value, include_field_names);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
   }
 
-  return index.init(name_value.asCString(), *field);
+  vector<const FieldMeta *> fields;
+  vector<const FieldMeta *> include_fields;
+  rc = fields_of_table(table, name_value, field_names, fields);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  rc = fields_of_table(table, name_value, include_field_names, include_fields);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  return index.init(name_value.asCString(), fields, include_fields);
 }
 
 const char *IndexMeta::name() const { return name_.c_str(); }
 
-const char *IndexMeta::field() const { return field_.c_str(); }
+const char *IndexMeta::field() const { return fields_[0].c_str(); }
 
-void IndexMeta::desc(ostream &os) const { os << "index name=" << name_ << ", field=" << field_; }
\ No newline at end of file
+bool IndexMeta::covers(const char *field_name) const
+{
+  return std::find(fields_.begin(), fields_.end(), field_name) != fields_.end() ||
+         std::find(include_fields_.begin(), include_fields_.end(), field_name) != include_fields_.end();
+}
+
+void IndexMeta::desc(ostream &os) const
+{
+  os << "index name=" << name_ << ", field=" << fields_[0];
+  for (size_t i = 1; i < fields_.size(); i++) {
+    os << "," << fields_[i];
+  }
+  if (!include_fields_.empty()) {
+    os << ", include=" << include_fields_[0];
+    for (size_t i = 1; i < include_fields_.size(); i++) {
+      os << "," << include_fields_[i];
+    }
+  }
+}
\ No newline at end of file
@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/rc.h"
 #include "common/lang/string.h"
+#include "common/lang/vector.h"
 
 class TableMeta;
 class FieldMeta;
@@ -32,15 +33,31 @@ class Value;
  */
 class IndexMeta
 {
+public:
+  static constexpr size_t MAX_FIELD_NUM = 8;  ///< 一个索引最多包含的字段数
+
 public:
   IndexMeta() = default;
 
   RC init(const char *name, const FieldMeta &field);
+  RC init(const char *name, const vector<const FieldMeta *> &fields,
+      const vector<const FieldMeta *> &include_fields = {});
 
 public:
   const char *name() const;
+
+  /// 索引的第一个字段
   const char *field() const;
 
+  /// 索引包含的所有字段，按照键值中的顺序排列
+  const vector<string> &fields() const { return fields_; }
+
+  /// 索引的包含列(INCLUDE)，不参与排序，只是把值存放在叶子节点中
+  const vector<string> &include_fields() const { return include_fields_; }
+
+  /// 索引的键值或包含列中是否有这个字段，不需要回表就可以拿到字段的值
+  bool covers(const char *field_name) const;
+
   void desc(ostream &os) const;
 
 public:
@@ -48,6 +65,7 @@ public:
   static RC from_json(const TableMeta &table, const Json::Value &json_value, IndexMeta &index);
 
 protected:
-  string name_;   // index's name
-  string field_;  // field's name
+  string         name_;            // index's name
+  vector<string> fields_;          // fields' name
+  vector<string> include_fields_;  // included fields' name
 };
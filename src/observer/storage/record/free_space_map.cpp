@@ -0,0 +1,281 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "storage/record/free_space_map.h"
+#include "common/io/io.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/vector.h"
+#include "common/log/log.h"
+#include "common/math/crc.h"
+
+FreeSpaceMap::~FreeSpaceMap() { close(); }
+
+int FreeSpaceMap::level_of(int free_slots, int capacity)
+{
+  if (free_slots <= 0 || capacity <= 0) {
+    return 0;
+  }
+  return min(MAX_LEVEL, (free_slots * MAX_LEVEL + capacity - 1) / capacity);
+}
+
+RC FreeSpaceMap::open(const char *filename, int page_count, bool &loaded)
+{
+  loaded = false;
+  if (fd_ >= 0) {
+    LOG_WARN("free space map has been opened. filename=%s", filename);
+    return RC::RECORD_OPENNED;
+  }
+
+  int fd = ::open(filename, O_CREAT | O_RDWR, 0644);
+  if (fd < 0) {
+    LOG_ERROR("failed to open free space map file. filename=%s, error=%s", filename, strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+  fd_ = fd;
+
+  const int capacity = max(page_count, ENTRIES_PER_PAGE);
+  capacity_.store(capacity);
+  entries_ = make_unique<atomic<uint8_t>[]>(capacity);
+  for (int i = 0; i < capacity; i++) {
+    entries_[i].store(0, memory_order_relaxed);
+  }
+  size_.store(page_count);
+  available_pages_.store(0);
+  search_start_.store(0);
+
+  // 读取上次正常关闭时写入的数据。数据页面个数不一致说明文件不是这个数据文件的，不能使用
+  FileHeader header;
+  memset(&header, 0, sizeof(header));
+  const int  fsm_page_num = (page_count + ENTRIES_PER_PAGE - 1) / ENTRIES_PER_PAGE;
+  vector<char> data(static_cast<size_t>(fsm_page_num) * BP_PAGE_SIZE);
+  if (common::readn(fd_, &header, sizeof(header)) == 0 && header.magic == FileHeader::MAGIC && header.clean == 1 &&
+      header.page_count == page_count && lseek(fd_, BP_PAGE_SIZE, SEEK_SET) != -1 &&
+      (data.empty() || common::readn(fd_, data.data(), static_cast<int>(data.size())) == 0) &&
+      crc32(data.data(), static_cast<unsigned int>(data.size())) == header.checksum) {
+    int available = 0;
+    for (int i = 0; i < page_count; i++) {
+      const int level = (static_cast<uint8_t>(data[i / 4]) >> ((i % 4) * LEVEL_BITS)) & LEVEL_MASK;
+      entries_[i].store(static_cast<uint8_t>(level), memory_order_relaxed);
+      available += level != 0 ? 1 : 0;
+    }
+    available_pages_.store(available);
+    loaded = true;
+  }
+
+  // 内存中的数据会不断变化，在正常关闭之前文件中的数据都是无效的
+  RC rc = write_header(false /*clean*/, 0);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to invalidate free space map file. filename=%s, rc=%s", filename, strrc(rc));
+    ::close(fd_);
+    fd_ = -1;
+    return rc;
+  }
+
+  LOG_INFO("open free space map. filename=%s, page count=%d, loaded=%d, available pages=%d",
+      filename, page_count, loaded, available_pages_.load());
+  return RC::SUCCESS;
+}
+
+RC FreeSpaceMap::close()
+{
+  if (fd_ < 0) {
+    return RC::SUCCESS;
+  }
+
+  const int    page_count   = size_.load();
+  const int    fsm_page_num = (page_count + ENTRIES_PER_PAGE - 1) / ENTRIES_PER_PAGE;
+  vector<char> data(static_cast<size_t>(fsm_page_num) * BP_PAGE_SIZE, 0);
+  for (int i = 0; i < page_count; i++) {
+    const uint8_t level = entries_[i].load(memory_order_relaxed) & LEVEL_MASK;
+    data[i / 4] |= static_cast<char>(level << ((i % 4) * LEVEL_BITS));
+  }
+
+  RC rc = RC::SUCCESS;
+  if (lseek(fd_, BP_PAGE_SIZE, SEEK_SET) == -1 ||
+      (!data.empty() && common::writen(fd_, data.data(), static_cast<int>(data.size())) != 0) || fdatasync(fd_) != 0) {
+    LOG_WARN("failed to write free space map. error=%s", strerror(errno));
+    rc = RC::IOERR_WRITE;
+  } else {
+    rc = write_header(true /*clean*/, crc32(data.data(), static_cast<unsigned int>(data.size())));
+  }
+
+  ::close(fd_);
+  fd_ = -1;
+  entries_.reset();
+  capacity_.store(0);
+  size_.store(0);
+  available_pages_.store(0);
+  return rc;
+}
+
+RC FreeSpaceMap::write_header(bool clean, uint32_t checksum)
+{
+  char page[BP_PAGE_SIZE];
+  memset(page, 0, sizeof(page));
+
+  FileHeader *header = reinterpret_cast<FileHeader *>(page);
+  header->magic      = FileHeader::MAGIC;
+  header->page_count = size_.load();
+  header->clean      = clean ? 1 : 0;
+  header->checksum   = checksum;
+
+  if (lseek(fd_, 0, SEEK_SET) == -1 || common::writen(fd_, page, sizeof(page)) != 0 || fdatasync(fd_) != 0) {
+    LOG_WARN("failed to write free space map header. error=%s", strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+  return RC::SUCCESS;
+}
+
+template <typename F>
+bool FreeSpaceMap::update_entry(PageNum page_num, F &&func)
+{
+  atomic<uint8_t> &entry     = entries_[page_num];
+  uint8_t          old_value = entry.load();
+  uint8_t          new_value = 0;
+  do {
+    if (!func(old_value, new_value)) {
+      return false;
+    }
+    if (new_value == old_value) {
+      return true;
+    }
+  } while (!entry.compare_exchange_weak(old_value, new_value));
+
+  const int delta = (available(new_value) ? 1 : 0) - (available(old_value) ? 1 : 0);
+  if (delta != 0) {
+    available_pages_.fetch_add(delta);
+  }
+  return true;
+}
+
+void FreeSpaceMap::ensure_capacity(PageNum page_num)
+{
+  if (page_num < capacity_.load()) {
+    return;
+  }
+
+  lock_.lock();
+  if (page_num >= capacity_.load()) {
+    const int old_capacity = capacity_.load();
+    const int new_capacity = max(old_capacity * 2, page_num + 1);
+    auto      new_entries  = make_unique<atomic<uint8_t>[]>(new_capacity);
+    for (int i = 0; i < new_capacity; i++) {
+      new_entries[i].store(i < old_capacity ? entries_[i].load() : 0, memory_order_relaxed);
+    }
+    entries_ = std::move(new_entries);
+    capacity_.store(new_capacity);
+  }
+  lock_.unlock();
+}
+
+void FreeSpaceMap::set_level(PageNum page_num, int level)
+{
+  if (page_num < 0 || fd_ < 0) {
+    return;
+  }
+
+  ensure_capacity(page_num);
+
+  lock_.lock_shared();
+  int size = size_.load();
+  while (size <= page_num && !size_.compare_exchange_weak(size, page_num + 1)) {}
+
+  update_entry(page_num, [level](uint8_t old_value, uint8_t &new_value) {
+    new_value = static_cast<uint8_t>((old_value & CLAIMED) | (level & LEVEL_MASK));
+    return true;
+  });
+  lock_.unlock_shared();
+}
+
+int FreeSpaceMap::level(PageNum page_num) const
+{
+  if (page_num < 0 || page_num >= size_.load()) {
+    return 0;
+  }
+
+  lock_.lock_shared();
+  const int level = entries_[page_num].load() & LEVEL_MASK;
+  lock_.unlock_shared();
+  return level;
+}
+
+PageNum FreeSpaceMap::claim_free_page()
+{
+  if (available_pages_.load() <= 0) {
+    return BP_INVALID_PAGE_NUM;
+  }
+
+  lock_.lock_shared();
+  const int size  = size_.load();
+  int       start = search_start_.load();
+  if (start <= 0 || start >= size) {
+    start = 1;  // 第0个页面是数据文件的文件头
+  }
+
+  PageNum result = BP_INVALID_PAGE_NUM;
+  for (int i = 0; i < size - 1 && available_pages_.load() > 0; i++) {
+    const PageNum page_num = (start - 1 + i) % (size - 1) + 1;
+    const bool    claimed  = update_entry(page_num, [](uint8_t old_value, uint8_t &new_value) {
+      if (!available(old_value)) {
+        return false;
+      }
+      new_value = old_value | CLAIMED;
+      return true;
+    });
+    if (claimed) {
+      result = page_num;
+      search_start_.store(page_num);
+      break;
+    }
+  }
+  lock_.unlock_shared();
+  return result;
+}
+
+void FreeSpaceMap::add_claimed_page(PageNum page_num, int level)
+{
+  if (page_num < 0 || fd_ < 0) {
+    return;
+  }
+
+  ensure_capacity(page_num);
+
+  lock_.lock_shared();
+  int size = size_.load();
+  while (size <= page_num && !size_.compare_exchange_weak(size, page_num + 1)) {}
+
+  update_entry(page_num, [level](uint8_t, uint8_t &new_value) {
+    new_value = static_cast<uint8_t>(CLAIMED | (level & LEVEL_MASK));
+    return true;
+  });
+  lock_.unlock_shared();
+}
+
+void FreeSpaceMap::release(PageNum page_num)
+{
+  if (page_num < 0 || page_num >= size_.load()) {
+    return;
+  }
+
+  lock_.lock_shared();
+  update_entry(page_num, [](uint8_t old_value, uint8_t &new_value) {
+    new_value = old_value & ~CLAIMED;
+    return true;
+  });
+  lock_.unlock_shared();
+}
@@ -0,0 +1,118 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+
+#include "common/lang/atomic.h"
+#include "common/lang/memory.h"
+#include "common/lang/mutex.h"
+#include "common/lang/string.h"
+#include "common/rc.h"
+#include "storage/buffer/page.h"
+
+/**
+ * @brief 记录文件的空闲空间映射(free space map)
+ * @ingroup RecordManager
+ * @details 每个页面用2个比特记录还有多少空闲位置(level)，0表示没有空闲位置，3表示空闲位置超过2/3。
+ * 插入记录时从这里找有空闲位置的页面，不需要遍历页面。
+ * 找到的页面会被标记为已占用(claim)，直到占用者释放之前，其它插入线程不会再选中这个页面，
+ * 这样并发插入的线程会写不同的页面。
+ *
+ * FSM 保存在单独的文件中(数据文件名加上 FILE_SUFFIX)，文件由 FSM 页面组成：第一个页面是文件头，
+ * 后面每个页面记录 ENTRIES_PER_PAGE 个数据页面的 level。FSM 不记录日志，只是一个提示：
+ * 打开时读取文件后就把它标记为无效，正常关闭时再写回。异常退出之后文件是无效的，需要扫描所有页面重建。
+ * level 比实际的大时，插入时会发现页面满了并修正；比实际的小只会浪费一些空间。
+ */
+class FreeSpaceMap
+{
+public:
+  static constexpr const char *FILE_SUFFIX      = ".fsm";
+  static constexpr int         LEVEL_BITS       = 2;
+  static constexpr int         MAX_LEVEL        = (1 << LEVEL_BITS) - 1;
+  static constexpr int         ENTRIES_PER_PAGE = BP_PAGE_SIZE * 8 / LEVEL_BITS;
+
+  FreeSpaceMap() = default;
+  ~FreeSpaceMap();
+
+  static string file_name(const char *data_file) { return string(data_file) + FILE_SUFFIX; }
+
+  /// 按照空闲位置占容量的比例计算 level
+  static int level_of(int free_slots, int capacity);
+
+  /**
+   * @brief 打开 FSM 文件
+   * @param filename 文件名，不存在时会创建
+   * @param page_count 数据文件当前的页面数
+   * @param[out] loaded 是否从文件中加载了有效的数据。没有加载时所有页面的 level 都是0，需要调用者重建
+   */
+  RC open(const char *filename, int page_count, bool &loaded);
+
+  /// 把 FSM 写回文件并标记为有效
+  RC close();
+
+  /// 设置页面的 level，不影响页面的占用状态
+  void set_level(PageNum page_num, int level);
+  int  level(PageNum page_num) const;
+
+  /**
+   * @brief 找一个有空闲位置并且没有被占用的页面，并占用它
+   * @return 找不到时返回 BP_INVALID_PAGE_NUM
+   */
+  PageNum claim_free_page();
+
+  /// 新分配的页面，设置 level 的同时占用它
+  void add_claimed_page(PageNum page_num, int level);
+
+  /// 释放 claim_free_page/add_claimed_page 占用的页面
+  void release(PageNum page_num);
+
+  /// 有空闲位置并且没有被占用的页面个数
+  int available_pages() const { return available_pages_.load(); }
+
+private:
+  static constexpr uint8_t LEVEL_MASK = MAX_LEVEL;
+  static constexpr uint8_t CLAIMED    = 0x80;
+
+  struct FileHeader
+  {
+    static constexpr int32_t MAGIC = 0x4653'4d31;  // "FSM1"
+
+    int32_t  magic;
+    int32_t  page_count;  ///< 记录了多少个数据页面
+    int32_t  clean;       ///< 正常关闭时写入的数据才有效
+    uint32_t checksum;    ///< 后面所有 FSM 页面的 crc32
+  };
+
+  static bool available(uint8_t entry) { return (entry & LEVEL_MASK) != 0 && (entry & CLAIMED) == 0; }
+
+  /// 用 CAS 修改页面对应的字节，同时维护 available_pages_。调用者需要持有 lock_ 的读锁
+  template <typename F>
+  bool update_entry(PageNum page_num, F &&func);
+
+  /// 保证可以容纳 page_num，需要时扩容
+  void ensure_capacity(PageNum page_num);
+
+  RC write_header(bool clean, uint32_t checksum);
+
+private:
+  int fd_ = -1;
+
+  /// 扩容时加写锁，其它操作只加读锁，页面的状态用原子操作修改
+  mutable common::SharedMutex lock_;
+  unique_ptr<atomic<uint8_t>[]> entries_;
+  atomic<int>                   capacity_{0};
+  atomic<int>                   size_{0};             ///< 记录了多少个数据页面
+  atomic<int>                   available_pages_{0};  ///< 有空闲位置并且没有被占用的页面个数
+  atomic<int>                   search_start_{0};     ///< 下次从这个位置开始查找空闲页面
+};
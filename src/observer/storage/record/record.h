@@ -172,7 +172,10 @@ public:
 
   void set_data(char *data, int len = 0)
   {
-    this->data_ = data;
+    // 之前可能复制过数据(比如事务读取了旧版本)，需要先释放
+    this->~Record();
+    this->owner_ = false;
+    this->data_  = data;
     this->len_  = len;
   }
   void set_data_owner(char *data, int len)
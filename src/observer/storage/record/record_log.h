@@ -41,7 +41,8 @@ public:
     INIT_PAGE,  /// 初始化空页面
     INSERT,     /// 插入一条记录
     DELETE,     /// 删除一条记录
-    UPDATE      /// 更新一条记录
+    UPDATE,     /// 更新一条记录
+    BATCH_INSERT  /// 在一个页面上插入多条记录
   };
 
 public:
@@ -69,6 +70,7 @@ struct RecordLogHeader
   {
     SlotNum slot_num;
     int32_t record_size;
+    int32_t record_num;  ///< BATCH_INSERT 时插入的记录个数
   };
 
   char data[0];
@@ -109,6 +111,15 @@ public:
    */
   RC insert_record(Frame *frame, const RID &rid, const char *record);
 
+  /**
+   * @brief 在同一个页面上插入多条记录
+   * @details 只记录一条日志，日志内容是所有记录的槽位，后面跟着所有记录的数据
+   * @param frame 页帧
+   * @param slots 记录的槽位
+   * @param records 记录的内容，与槽位一一对应
+   */
+  RC insert_records(Frame *frame, span<const SlotNum> slots, span<const char *const> records);
+
   /**
    * @brief 删除一条记录
    * @param frame 页帧
@@ -147,6 +158,7 @@ public:
 private:
   RC replay_init_page(DiskBufferPool &buffer_pool, const RecordLogHeader &log_header);
   RC replay_insert(DiskBufferPool &buffer_pool, const RecordLogHeader &log_header);
+  RC replay_batch_insert(DiskBufferPool &buffer_pool, const RecordLogHeader &log_header);
   RC replay_delete(DiskBufferPool &buffer_pool, const RecordLogHeader &log_header);
   RC replay_update(DiskBufferPool &buffer_pool, const RecordLogHeader &log_header);
 
@@ -12,6 +12,7 @@ See the Mulan PSL v2 for more details. */
 // Created by Meiyi & Longda on 2021/4/13.
 //
 #include "storage/record/record_manager.h"
+#include "common/lang/algorithm.h"
 #include "common/log/log.h"
 #include "storage/common/condition_filter.h"
 #include "storage/trx/trx.h"
@@ -266,6 +267,51 @@ RC RecordPageHandler::cleanup()
   return RC::SUCCESS;
 }
 
+RC RecordPageHandler::insert_records(span<Record> records, int &inserted_num)
+{
+  ASSERT(rw_mode_ != ReadWriteMode::READ_ONLY, 
+         "cannot insert record into page while the page is readonly");
+
+  inserted_num = 0;
+
+  Bitmap               bitmap(bitmap_, page_header_->record_capacity);
+  vector<SlotNum>      slots;
+  vector<const char *> datas;
+  int                  index = -1;
+  for (Record &record : records) {
+    if (page_header_->record_num == page_header_->record_capacity) {
+      break;
+    }
+
+    // 空闲位置总是在上一条插入位置的后面
+    index = bitmap.next_unsetted_bit(index + 1);
+    bitmap.set_bit(index);
+    page_header_->record_num++;
+
+    write_record(index, record.data());
+    record.set_rid(RID(get_page_num(), index));
+    slots.push_back(index);
+    datas.push_back(record.data());
+  }
+
+  inserted_num = static_cast<int>(slots.size());
+  if (inserted_num == 0) {
+    LOG_WARN("Page is full, page_num %d:%d.", disk_buffer_pool_->file_desc(), frame_->page_num());
+    return RC::RECORD_NOMEM;
+  }
+
+  frame_->mark_dirty();
+
+  // 页面的写锁一直持有，页面在记录日志之前不会刷到磁盘上
+  RC rc = log_handler_.insert_records(frame_, slots, datas);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to insert records. page_num %d:%d. rc=%s", 
+              disk_buffer_pool_->file_desc(), frame_->page_num(), strrc(rc));
+    // return rc; // ignore errors
+  }
+  return RC::SUCCESS;
+}
+
 RC RowRecordPageHandler::insert_record(const char *data, RID *rid)
 {
   ASSERT(rw_mode_ != ReadWriteMode::READ_ONLY, 
@@ -289,8 +335,7 @@ RC RowRecordPageHandler::insert_record(const char *data, RID *rid)
   }
 
   // assert index < page_header_->record_capacity
-  char *record_data = get_record_data(index);
-  memcpy(record_data, data, page_header_->record_real_size);
+  write_record(index, data);
 
   frame_->mark_dirty();
 
@@ -303,6 +348,11 @@ RC RowRecordPageHandler::insert_record(const char *data, RID *rid)
   return RC::SUCCESS;
 }
 
+void RowRecordPageHandler::write_record(SlotNum slot_num, const char *data)
+{
+  memcpy(get_record_data(slot_num), data, page_header_->record_real_size);
+}
+
 RC RowRecordPageHandler::recover_insert_record(const char *data, const RID &rid)
 {
   if (rid.slot_num >= page_header_->record_capacity) {
@@ -438,6 +488,21 @@ RC PaxRecordPageHandler::insert_record(const char *data, RID *rid)
   }
 
   // insert data here, assert index < page_header_->record_capacity
+  write_record(index, data);
+
+  frame_->mark_dirty();
+
+  if (rid) {
+    rid->page_num = get_page_num();
+    rid->slot_num = index;
+  }
+
+  LOG_TRACE("Insert record. rid page_num=%d, slot num=%d", get_page_num(), index);
+  return RC::SUCCESS;
+}
+
+void PaxRecordPageHandler::write_record(SlotNum slot_num, const char *data)
+{
   // partition the record to several cols
   // then, insert the record's each col into page
   int idx = 0;
@@ -451,21 +516,11 @@ RC PaxRecordPageHandler::insert_record(const char *data, RID *rid)
     } else {
       col_len = (column_index[i] - column_index[i - 1]) / page_header_->record_capacity;
     }
-    char *record_col_data = frame_->data() + page_header_->data_offset + col_len * index + prev_cols_len;
+    char *record_col_data = frame_->data() + page_header_->data_offset + col_len * slot_num + prev_cols_len;
     memcpy(record_col_data, data + idx, col_len);
     idx += col_len;
     prev_cols_len += page_header_->record_capacity * col_len;
   }
-
-  frame_->mark_dirty();
-
-  if (rid) {
-    rid->page_num = get_page_num();
-    rid->slot_num = index;
-  }
-
-  LOG_TRACE("Insert record. rid page_num=%d, slot num=%d", get_page_num(), index);
-  return RC::SUCCESS;
 }
 
 RC PaxRecordPageHandler::delete_record(const RID *rid)
@@ -492,6 +547,35 @@ RC PaxRecordPageHandler::delete_record(const RID *rid)
   }
 }
 
+RC PaxRecordPageHandler::update_record(const RID &rid, const char *data)
+{
+  ASSERT(rw_mode_ != ReadWriteMode::READ_ONLY, "cannot update record in page while the page is readonly");
+
+  if (rid.slot_num >= page_header_->record_capacity) {
+    LOG_ERROR("Invalid slot_num %d, exceed page's record capacity, frame=%s, page_header=%s",
+              rid.slot_num, frame_->to_string().c_str(), page_header_->to_string().c_str());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  if (bitmap.get_bit(rid.slot_num)) {
+    frame_->mark_dirty();
+    write_record(rid.slot_num, data);
+
+    RC rc = log_handler_.update_record(frame_, rid, data);
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("Failed to update record. page_num %d:%d. rc=%s", 
+                disk_buffer_pool_->file_desc(), frame_->page_num(), strrc(rc));
+      // return rc; // ignore errors
+    }
+
+    return RC::SUCCESS;
+  } else {
+    LOG_DEBUG("Invalid slot_num %d, slot is empty, page_num %d.", rid.slot_num, frame_->page_num());
+    return RC::RECORD_NOT_EXIST;
+  }
+}
+
 RC PaxRecordPageHandler::get_record(const RID &rid, Record &record)
 {
   // your code here
@@ -524,13 +608,60 @@ RC PaxRecordPageHandler::get_record(const RID &rid, Record &record)
 
 // TODO: specify the column_ids that chunk needed, currenly we get all columns.
 RC PaxRecordPageHandler::get_chunk(Chunk &chunk) {
-  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  const int record_capacity = page_header_->record_capacity;
+  const int record_num      = page_header_->record_num;
+  Bitmap    bitmap(bitmap_, record_capacity);
+
+  // 页面上大部分位置都有记录时，直接引用页面中的列数据，空闲的位置用选择向量过滤掉
+  if (record_num > 0 && record_num * Chunk::COMPACT_RATIO >= record_capacity) {
+    for (int i = 0; i < chunk.column_num(); i++) {
+      chunk.column(i).reference(get_field_data(0, chunk.column_ids(i)), record_capacity);
+    }
+
+    vector<int> selection;
+    selection.reserve(record_num);
+    for (int j = bitmap.next_setted_bit(0); j != -1; j = bitmap.next_setted_bit(j + 1)) {
+      selection.push_back(j);
+    }
+    chunk.set_selection(std::move(selection));
+    return RC::SUCCESS;
+  }
+
   for(int i = 0;i < chunk.column_num();i ++) {
     int idx = chunk.column_ids(i);
     auto col = chunk.column_ptr(i);
-    for(int j = 0;j < page_header_->record_capacity;j ++) {
-      if(bitmap.get_bit(j)) {
-        col->append_one(get_field_data(j, idx));
+    // 上一个页面引用了页面中的数据
+    if (!col->own()) {
+      col->init(col->attr_type(), col->attr_len(), record_capacity);
+    }
+    for (int j = bitmap.next_setted_bit(0); j != -1; j = bitmap.next_setted_bit(j + 1)) {
+      RC rc = col->append_one(get_field_data(j, idx));
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC PaxRecordPageHandler::get_chunk(span<const RID> rids, Chunk &chunk)
+{
+  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  for (const RID &rid : rids) {
+    if (rid.page_num != frame_->page_num() || rid.slot_num >= page_header_->record_capacity ||
+        !bitmap.get_bit(rid.slot_num)) {
+      LOG_WARN("record not exist in page. rid=%s, page_num=%d", rid.to_string().c_str(), frame_->page_num());
+      return RC::RECORD_NOT_EXIST;
+    }
+  }
+
+  for (int i = 0; i < chunk.column_num(); i++) {
+    const int idx = chunk.column_ids(i);
+    Column   *col = chunk.column_ptr(i);
+    for (const RID &rid : rids) {
+      RC rc = col->append_one(get_field_data(rid.slot_num, idx));
+      if (OB_FAIL(rc)) {
+        return rc;
       }
     }
   }
@@ -572,7 +703,18 @@ RC RecordFileHandler::init(DiskBufferPool &buffer_pool, LogHandler &log_handler,
   log_handler_      = &log_handler;
   table_meta_       = table_meta;
 
-  RC rc = init_free_pages();
+  bool loaded = false;
+  RC   rc     = free_space_map_.open(
+      FreeSpaceMap::file_name(buffer_pool.filename()).c_str(), buffer_pool.page_count(), loaded);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open free space map. file=%s, rc=%s", buffer_pool.filename(), strrc(rc));
+    disk_buffer_pool_ = nullptr;
+    return rc;
+  }
+
+  if (!loaded) {
+    rc = rebuild_free_space_map();
+  }
 
   LOG_INFO("open record file handle done. rc=%s", strrc(rc));
   return RC::SUCCESS;
@@ -581,25 +723,34 @@ RC RecordFileHandler::init(DiskBufferPool &buffer_pool, LogHandler &log_handler,
 void RecordFileHandler::close()
 {
   if (disk_buffer_pool_ != nullptr) {
-    free_pages_.clear();
+    free_space_map_.close();
+    for (InsertTarget &target : insert_targets_) {
+      target.page_num.store(BP_INVALID_PAGE_NUM);
+    }
+    all_visible_pages_.clear();
     disk_buffer_pool_ = nullptr;
     log_handler_      = nullptr;
     table_meta_       = nullptr;
   }
 }
 
-RC RecordFileHandler::init_free_pages()
+int RecordFileHandler::insert_target_index()
 {
-  // 遍历当前文件上所有页面，找到没有满的页面
-  // 这个效率很低，会降低启动速度
-  // NOTE: 由于是初始化时的动作，所以不需要加锁控制并发
+  static atomic<int> next_index{0};
+  thread_local int   index = next_index.fetch_add(1) % INSERT_TARGET_NUM;
+  return index;
+}
 
+RC RecordFileHandler::rebuild_free_space_map()
+{
+  // NOTE: 由于是初始化时的动作，所以不需要加锁控制并发
   RC rc = RC::SUCCESS;
 
   BufferPoolIterator bp_iterator;
   bp_iterator.init(*disk_buffer_pool_, 1);
   unique_ptr<RecordPageHandler> record_page_handler(RecordPageHandler::create(storage_format_));
   PageNum                       current_page_num = 0;
+  int                           free_page_num    = 0;
 
   while (bp_iterator.has_next()) {
     current_page_num = bp_iterator.next();
@@ -610,79 +761,164 @@ RC RecordFileHandler::init_free_pages()
       return rc;
     }
 
-    if (!record_page_handler->is_full()) {
-      free_pages_.insert(current_page_num);
-    }
+    update_free_space(*record_page_handler);
+    free_page_num += record_page_handler->is_full() ? 0 : 1;
     record_page_handler->cleanup();
   }
-  LOG_INFO("record file handler init free pages done. free page num=%d, rc=%s", free_pages_.size(), strrc(rc));
+  LOG_INFO("record file handler rebuild free space map done. free page num=%d, rc=%s", free_page_num, strrc(rc));
   return rc;
 }
 
-RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
+void RecordFileHandler::update_free_space(const RecordPageHandler &record_page_handler)
 {
-  RC ret = RC::SUCCESS;
+  const int capacity = record_page_handler.record_capacity();
+  free_space_map_.set_level(record_page_handler.get_page_num(),
+      FreeSpaceMap::level_of(capacity - record_page_handler.record_num(), capacity));
+}
 
+RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
+{
   unique_ptr<RecordPageHandler> record_page_handler(RecordPageHandler::create(storage_format_));
-  bool                          page_found       = false;
-  PageNum                       current_page_num = 0;
+  InsertTarget                 &target = insert_targets_[insert_target_index()];
 
-  // 当前要访问free_pages对象，所以需要加锁。在非并发编译模式下，不需要考虑这个锁
-  lock_.lock();
+  RC rc = get_insert_page(target, record_size, *record_page_handler);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
 
-  // 找到没有填满的页面
-  while (!free_pages_.empty()) {
-    current_page_num = *free_pages_.begin();
+  // 找到空闲位置
+  const PageNum page_num = record_page_handler->get_page_num();
+  clear_all_visible(page_num);
+  rc = record_page_handler->insert_record(data, rid);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
 
-    ret = record_page_handler->init(*disk_buffer_pool_, *log_handler_, current_page_num, ReadWriteMode::READ_WRITE);
-    if (OB_FAIL(ret)) {
-      lock_.unlock();
-      LOG_WARN("failed to init record page handler. page num=%d, rc=%d:%s", current_page_num, ret, strrc(ret));
-      return ret;
-    }
+  update_free_space(*record_page_handler);
+  if (record_page_handler->is_full()) {
+    retire_insert_page(target, page_num);
+  }
+  return rc;
+}
+
+RC RecordFileHandler::insert_records(span<Record> records, int record_size)
+{
+  unique_ptr<RecordPageHandler> record_page_handler(RecordPageHandler::create(storage_format_));
+  InsertTarget                 &target = insert_targets_[insert_target_index()];
 
-    if (!record_page_handler->is_full()) {
-      page_found = true;
+  RC     rc           = RC::SUCCESS;
+  size_t inserted_num = 0;
+  while (inserted_num < records.size()) {
+    rc = get_insert_page(target, record_size, *record_page_handler);
+    if (OB_FAIL(rc)) {
       break;
     }
+
+    const PageNum page_num = record_page_handler->get_page_num();
+    clear_all_visible(page_num);
+
+    int page_inserted_num = 0;
+    rc = record_page_handler->insert_records(records.subspan(inserted_num), page_inserted_num);
+    inserted_num += page_inserted_num;
+    if (OB_SUCC(rc)) {
+      update_free_space(*record_page_handler);
+      if (record_page_handler->is_full()) {
+        retire_insert_page(target, page_num);
+      }
+    }
     record_page_handler->cleanup();
-    free_pages_.erase(free_pages_.begin());
+    if (OB_FAIL(rc)) {
+      break;
+    }
   }
-  lock_.unlock();  // 如果找到了一个有效的页面，那么此时已经拿到了页面的写锁
 
-  // 找不到就分配一个新的页面
-  if (!page_found) {
-    Frame *frame = nullptr;
-    if ((ret = disk_buffer_pool_->allocate_page(&frame)) != RC::SUCCESS) {
-      LOG_ERROR("Failed to allocate page while inserting record. ret:%d", ret);
-      return ret;
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to insert records. inserted num=%d, total num=%d, rc=%s",
+             static_cast<int>(inserted_num), static_cast<int>(records.size()), strrc(rc));
+    for (size_t i = 0; i < inserted_num; i++) {
+      RC rc2 = delete_record(&records[i].rid());
+      if (OB_FAIL(rc2)) {
+        LOG_ERROR("failed to rollback inserted record. rid=%s, rc=%s", records[i].rid().to_string().c_str(), strrc(rc2));
+      }
     }
+  }
+  return rc;
+}
 
-    current_page_num = frame->page_num();
+RC RecordFileHandler::get_insert_page(InsertTarget &target, int record_size, RecordPageHandler &record_page_handler)
+{
+  while (true) {
+    PageNum page_num = target.page_num.load();
+    if (page_num == BP_INVALID_PAGE_NUM) {
+      page_num = free_space_map_.claim_free_page();
+      if (page_num == BP_INVALID_PAGE_NUM) {
+        return allocate_insert_page(target, record_size, record_page_handler);
+      }
 
-    ret = record_page_handler->init_empty_page(
-        *disk_buffer_pool_, *log_handler_, current_page_num, record_size, table_meta_);
-    if (OB_FAIL(ret)) {
-      frame->unpin();
-      LOG_ERROR("Failed to init empty page. ret:%d", ret);
-      // this is for allocate_page
-      return ret;
+      // 其它使用同一个 target 的线程可能已经设置了新的页面，就使用那个页面
+      PageNum expected = BP_INVALID_PAGE_NUM;
+      if (!target.page_num.compare_exchange_strong(expected, page_num)) {
+        free_space_map_.release(page_num);
+        continue;
+      }
     }
 
-    // frame 在allocate_page的时候，是有一个pin的，在init_empty_page时又会增加一个，所以这里手动释放一个
+    RC rc = record_page_handler.init(*disk_buffer_pool_, *log_handler_, page_num, ReadWriteMode::READ_WRITE);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init record page handler. page num=%d, rc=%d:%s", page_num, rc, strrc(rc));
+      return rc;
+    }
+
+    if (!record_page_handler.is_full()) {
+      return RC::SUCCESS;
+    }
+
+    // FSM 中的信息可能是过时的，或者使用同一个 target 的其它线程把页面写满了
+    update_free_space(record_page_handler);
+    record_page_handler.cleanup();
+    retire_insert_page(target, page_num);
+  }
+}
+
+RC RecordFileHandler::allocate_insert_page(
+    InsertTarget &target, int record_size, RecordPageHandler &record_page_handler)
+{
+  Frame *frame = nullptr;
+  RC     rc    = disk_buffer_pool_->allocate_page(&frame);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to allocate page while inserting record. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  const PageNum page_num = frame->page_num();
+
+  rc = record_page_handler.init_empty_page(*disk_buffer_pool_, *log_handler_, page_num, record_size, table_meta_);
+  if (OB_FAIL(rc)) {
     frame->unpin();
+    LOG_ERROR("Failed to init empty page. rc=%s", strrc(rc));
+    // this is for allocate_page
+    return rc;
+  }
 
-    // 这里的加锁顺序看起来与上面是相反的，但是不会出现死锁
-    // 上面的逻辑是先加lock锁，然后加页面写锁，这里是先加上
-    // 了页面写锁，然后加lock的锁，但是不会引起死锁。
-    // 为什么？
-    lock_.lock();
-    free_pages_.insert(current_page_num);
-    lock_.unlock();
+  // frame 在allocate_page的时候，是有一个pin的，在init_empty_page时又会增加一个，所以这里手动释放一个
+  frame->unpin();
+
+  free_space_map_.add_claimed_page(page_num, FreeSpaceMap::MAX_LEVEL);
+  PageNum expected = BP_INVALID_PAGE_NUM;
+  if (!target.page_num.compare_exchange_strong(expected, page_num)) {
+    // 其它使用同一个 target 的线程已经设置了页面，这个页面插入一条记录后留给其它线程使用
+    free_space_map_.release(page_num);
   }
+  return RC::SUCCESS;
+}
 
-  // 找到空闲位置
-  return record_page_handler->insert_record(data, rid);
+void RecordFileHandler::retire_insert_page(InsertTarget &target, PageNum page_num)
+{
+  // 只有把页面从 target 中移除的线程才能释放占用，防止重复释放
+  PageNum expected = page_num;
+  if (target.page_num.compare_exchange_strong(expected, BP_INVALID_PAGE_NUM)) {
+    free_space_map_.release(page_num);
+  }
 }
 
 RC RecordFileHandler::recover_insert_record(const char *data, int record_size, const RID &rid)
@@ -697,7 +933,12 @@ RC RecordFileHandler::recover_insert_record(const char *data, int record_size, c
     return ret;
   }
 
-  return record_page_handler->recover_insert_record(data, rid);
+  clear_all_visible(rid.page_num);
+  ret = record_page_handler->recover_insert_record(data, rid);
+  if (OB_SUCC(ret)) {
+    update_free_space(*record_page_handler);
+  }
+  return ret;
 }
 
 RC RecordFileHandler::delete_record(const RID *rid)
@@ -712,19 +953,14 @@ RC RecordFileHandler::delete_record(const RID *rid)
     return rc;
   }
 
+  clear_all_visible(rid->page_num);
   rc = record_page_handler->delete_record(rid);
-  // 📢 这里注意要清理掉资源，否则会与insert_record中的加锁顺序冲突而可能出现死锁
-  // delete record的加锁逻辑是拿到页面锁，删除指定记录，然后加上和释放record manager锁
-  // insert record是加上 record manager锁，然后拿到指定页面锁再释放record manager锁
-  record_page_handler->cleanup();
   if (OB_SUCC(rc)) {
-    // 因为这里已经释放了页面锁，并发时，其它线程可能又把该页面填满了，那就不应该再放入 free_pages_
-    // 中。但是这里可以不关心，因为在查找空闲页面时，会自动过滤掉已经满的页面
-    lock_.lock();
-    free_pages_.insert(rid->page_num);
-    LOG_TRACE("add free page %d to free page list", rid->page_num);
-    lock_.unlock();
+    // 页面有了空闲位置，插入线程可以通过 free_space_map_ 找到它
+    update_free_space(*record_page_handler);
+    LOG_TRACE("delete record from page %d. free space level=%d", rid->page_num, free_space_map_.level(rid->page_num));
   }
+  record_page_handler->cleanup();
   return rc;
 }
 
@@ -775,11 +1011,90 @@ RC RecordFileHandler::visit_record(const RID &rid, function<bool(Record &)> upda
 
   bool updated = updater(record);
   if (updated) {
+    clear_all_visible(rid.page_num);
     rc = page_handler->update_record(rid, record.data());
   }
   return rc;
 }
 
+RC RecordFileHandler::get_chunk(span<const RID> rids, Chunk &chunk)
+{
+  unique_ptr<RecordPageHandler> page_handler(RecordPageHandler::create(storage_format_));
+
+  RC     rc    = RC::SUCCESS;
+  size_t begin = 0;
+  while (begin < rids.size()) {
+    // 同一个页面上的记录是连续的，只需要固定一次页面
+    const PageNum page_num = rids[begin].page_num;
+    size_t        end      = begin + 1;
+    while (end < rids.size() && rids[end].page_num == page_num) {
+      end++;
+    }
+
+    rc = page_handler->init(*disk_buffer_pool_, *log_handler_, page_num, ReadWriteMode::READ_ONLY);
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("Failed to init record page handler.page number=%d", page_num);
+      return rc;
+    }
+
+    rc = page_handler->get_chunk(rids.subspan(begin, end - begin), chunk);
+    (void)page_handler->cleanup();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get records from record page handle. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    begin = end;
+  }
+  return rc;
+}
+
+bool RecordFileHandler::is_all_visible(PageNum page_num)
+{
+  lock_guard<common::Mutex> guard(all_visible_lock_);
+  return all_visible_pages_.count(page_num) > 0;
+}
+
+void RecordFileHandler::clear_all_visible(PageNum page_num)
+{
+  lock_guard<common::Mutex> guard(all_visible_lock_);
+  all_visible_pages_.erase(page_num);
+}
+
+RC RecordFileHandler::try_mark_all_visible(
+    PageNum page_num, function<bool(const Record &)> visible_to_all, bool &marked)
+{
+  marked = false;
+
+  unique_ptr<RecordPageHandler> page_handler(RecordPageHandler::create(storage_format_));
+
+  // 持有页面的读锁，检查期间页面不会被修改，修改页面的操作会在拿到写锁之后清除标记
+  RC rc = page_handler->init(*disk_buffer_pool_, *log_handler_, page_num, ReadWriteMode::READ_ONLY);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init record page handler. page num=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+
+  RecordPageIterator iterator;
+  iterator.init(page_handler.get());
+  Record record;
+  while (iterator.has_next()) {
+    rc = iterator.next(record);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get record from page. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+    if (!visible_to_all(record)) {
+      return RC::SUCCESS;
+    }
+  }
+
+  lock_guard<common::Mutex> guard(all_visible_lock_);
+  all_visible_pages_.insert(page_num);
+  marked = true;
+  return RC::SUCCESS;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 RecordFileScanner::~RecordFileScanner() { close_scan(); }
@@ -795,7 +1110,7 @@ RC RecordFileScanner::open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *
   log_handler_      = &log_handler;
   rw_mode_          = mode;
 
-  RC rc = bp_iterator_.init(buffer_pool, 1);
+  RC rc = bp_iterator_.init(buffer_pool, 1, BufferPoolIterator::DEFAULT_READ_AHEAD_PAGES);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to init bp iterator. rc=%d:%s", rc, strrc(rc));
     return rc;
@@ -870,22 +1185,24 @@ RC RecordFileScanner::fetch_next_record_in_page()
       return rc;
     }
 
-    // 如果有过滤条件，就用过滤条件过滤一下
-    if (condition_filter_ != nullptr && !condition_filter_->filter(next_record_)) {
-      continue;
-    }
-
     // 如果是某个事务上遍历数据，还要看看事务访问是否有冲突
-    if (trx_ == nullptr) {
-      return rc;
+    if (trx_ != nullptr) {
+      // 让当前事务探测一下是否访问冲突，或者需要加锁、等锁等操作，由事务自己决定
+      // 事务也可能把记录换成它能看到的旧版本，所以要在过滤之前
+      // TODO 把判断事务有效性的逻辑从Scanner中移除
+      rc = trx_->visit_record(table_, next_record_, rw_mode_);
+      if (rc == RC::RECORD_INVISIBLE) {
+        // 可以参考MvccTrx，表示当前记录不可见
+        // 这种模式仅在 readonly 事务下是有效的
+        continue;
+      }
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
     }
 
-    // 让当前事务探测一下是否访问冲突，或者需要加锁、等锁等操作，由事务自己决定
-    // TODO 把判断事务有效性的逻辑从Scanner中移除
-    rc = trx_->visit_record(table_, next_record_, rw_mode_);
-    if (rc == RC::RECORD_INVISIBLE) {
-      // 可以参考MvccTrx，表示当前记录不可见
-      // 这种模式仅在 readonly 事务下是有效的
+    // 如果有过滤条件，就用过滤条件过滤一下
+    if (condition_filter_ != nullptr && !condition_filter_->filter(next_record_)) {
       continue;
     }
     return rc;
@@ -951,16 +1268,17 @@ RC ChunkFileScanner::close_scan()
 }
 
 RC ChunkFileScanner::open_scan_chunk(
-    Table *table, DiskBufferPool &buffer_pool, LogHandler &log_handler, ReadWriteMode mode)
+    Table *table, DiskBufferPool &buffer_pool, Trx *trx, LogHandler &log_handler, ReadWriteMode mode)
 {
   close_scan();
 
   table_            = table;
   disk_buffer_pool_ = &buffer_pool;
+  trx_              = trx;
   log_handler_      = &log_handler;
   rw_mode_          = mode;
 
-  RC rc = bp_iterator_.init(buffer_pool, 1);
+  RC rc = bp_iterator_.init(buffer_pool, 1, BufferPoolIterator::DEFAULT_READ_AHEAD_PAGES);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to init bp iterator. rc=%d:%s", rc, strrc(rc));
     return rc;
@@ -986,7 +1304,11 @@ RC ChunkFileScanner::next_chunk(Chunk &chunk)
       LOG_WARN("failed to init record page handler. page_num=%d, rc=%s", page_num, strrc(rc));
       return rc;
     }
-    rc = record_page_handler_->get_chunk(chunk);
+    if (nullptr == table_ || table_->table_meta().storage_format() == StorageFormat::ROW_FORMAT) {
+      rc = get_row_chunk(chunk);
+    } else {
+      rc = record_page_handler_->get_chunk(chunk);
+    }
     if (rc == RC::SUCCESS) {
       return rc;
     } else if (rc == RC::RECORD_EOF) {
@@ -1000,3 +1322,54 @@ RC ChunkFileScanner::next_chunk(Chunk &chunk)
   record_page_handler_->cleanup();
   return RC::RECORD_EOF;
 }
+
+RC ChunkFileScanner::get_row_chunk(Chunk &chunk)
+{
+  if (nullptr == table_) {
+    return RC::UNIMPLENMENT;
+  }
+
+  // chunk 中记录的是字段ID，事务字段的ID是负数，不能直接当作字段的下标
+  const vector<FieldMeta>  &all_fields = *table_->table_meta().field_metas();
+  vector<const FieldMeta *> field_metas;
+  for (int i = 0; i < chunk.column_num(); i++) {
+    auto iter = find_if(all_fields.begin(), all_fields.end(),
+        [&chunk, i](const FieldMeta &field) { return field.field_id() == chunk.column_ids(i); });
+    const FieldMeta *field_meta = iter == all_fields.end() ? nullptr : &*iter;
+    if (nullptr == field_meta) {
+      LOG_WARN("no such field in table. table=%s, field id=%d", table_->name(), chunk.column_ids(i));
+      return RC::SCHEMA_FIELD_NOT_EXIST;
+    }
+    field_metas.push_back(field_meta);
+  }
+
+  RecordPageIterator iterator;
+  iterator.init(record_page_handler_);
+  Record record;
+  while (iterator.has_next()) {
+    RC rc = iterator.next(record);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    // 与 RecordFileScanner 一样，事务可能跳过这条记录，或者把它替换成自己能看到的旧版本
+    if (trx_ != nullptr) {
+      rc = trx_->visit_record(table_, record, rw_mode_);
+      if (rc == RC::RECORD_INVISIBLE) {
+        continue;
+      }
+      if (OB_FAIL(rc)) {
+        LOG_TRACE("failed to visit record. rid=%s, rc=%s", record.rid().to_string().c_str(), strrc(rc));
+        return rc;
+      }
+    }
+
+    for (int i = 0; i < chunk.column_num(); i++) {
+      rc = chunk.column(i).append_one(record.data() + field_metas[i]->offset());
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+  }
+  return RC::SUCCESS;
+}
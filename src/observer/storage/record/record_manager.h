@@ -15,9 +15,11 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "common/lang/bitmap.h"
+#include "common/lang/span.h"
 #include "common/lang/sstream.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/common/chunk.h"
+#include "storage/record/free_space_map.h"
 #include "storage/record/record.h"
 #include "storage/record/record_log.h"
 #include "common/types.h"
@@ -181,6 +183,14 @@ public:
    */
   virtual RC insert_record(const char *data, RID *rid) { return RC::UNIMPLENMENT; }
 
+  /**
+   * @brief 在当前页面上插入多条记录，直到页面写满
+   * @details 在一次加锁中写入所有记录，并且只记录一条日志
+   * @param records 要插入的记录，插入成功会设置RID
+   * @param[out] inserted_num 插入了多少条记录，插入的是 records 中的前 inserted_num 条
+   */
+  RC insert_records(span<Record> records, int &inserted_num);
+
   /**
    * @brief 数据库恢复时，在指定位置插入数据
    *
@@ -218,6 +228,15 @@ public:
    */
   virtual RC get_chunk(Chunk &chunk) { return RC::UNIMPLENMENT; }
 
+  /**
+   * @brief 获取当前页面中指定的若干条记录，追加到 chunk 中
+   *
+   * @param rids 记录的位置，必须都在当前页面中
+   * @param chunk 由 chunk.column(i).col_id() 指定列。
+   * 只需由 PaxRecordPageHandler 实现。
+   */
+  virtual RC get_chunk(span<const RID> rids, Chunk &chunk) { return RC::UNIMPLENMENT; }
+
   /**
    * @brief 返回该记录页的页号
    */
@@ -228,7 +247,18 @@ public:
    */
   bool is_full() const;
 
+  /// 页面上记录的个数与最多可以存放的记录个数
+  int record_num() const { return page_header_->record_num; }
+  int record_capacity() const { return page_header_->record_capacity; }
+  int record_real_size() const { return page_header_->record_real_size; }
+
 protected:
+  /**
+   * @brief 把记录的数据写到指定的槽位上
+   * @details 不修改 bitmap，也不记录日志，由调用者处理
+   */
+  virtual void write_record(SlotNum slot_num, const char *data) = 0;
+
   /**
    * @details
    * 前面在计算record_capacity时并没有考虑对齐，但第一个record需要8字节对齐
@@ -297,6 +327,9 @@ public:
    * @param record 返回指定的数据。这里不会将数据复制出来，而是使用指针，所以调用者必须保证数据使用期间受到保护
    */
   virtual RC get_record(const RID &rid, Record &record) override;
+
+protected:
+  void write_record(SlotNum slot_num, const char *data) override;
 };
 
 /**
@@ -326,6 +359,11 @@ public:
 
   virtual RC delete_record(const RID *rid) override;
 
+  /**
+   * @brief 原地更新一条记录，记录会按列拆分后写到原来的位置
+   */
+  virtual RC update_record(const RID &rid, const char *data) override;
+
   /**
    * @brief 获取指定位置的记录数据
    *
@@ -339,9 +377,24 @@ public:
    * @brief 以 Chunk 格式获取整个页面中指定列的所有记录。
    *
    * @param chunk 由 chunk.column(i).col_id() 指定列。
+   * @details 页面中的记录足够多时，chunk 中的列直接引用页面中的列数据(不复制)，页面的 bitmap 转换成
+   * chunk 的选择向量。这时 chunk 只在 cleanup 之前有效，因为 cleanup 之后 frame 就不再是 pin 住的了。
+   * 记录很少时仍然把记录复制到 chunk 中。
    */
   virtual RC get_chunk(Chunk &chunk) override;
 
+  /**
+   * @brief 以 Chunk 格式获取当前页面中指定的若干条记录
+   *
+   * @param rids 记录的位置，必须都在当前页面中
+   * @param chunk 由 chunk.column(i).col_id() 指定列。
+   */
+  virtual RC get_chunk(span<const RID> rids, Chunk &chunk) override;
+
+protected:
+  /// 将 record 按列拆分，写到各个列中
+  void write_record(SlotNum slot_num, const char *data) override;
+
 private:
   // get the field data by `slot_num` and `column id`
   char *get_field_data(SlotNum slot_num, int col_id);
@@ -388,6 +441,14 @@ public:
    */
   RC insert_record(const char *data, int record_size, RID *rid);
 
+  /**
+   * @brief 插入多条记录
+   * @details 每个页面只加一次锁，并且只记录一条日志。失败时已经插入的记录会被删除
+   * @param records     要插入的记录，插入成功会设置每条记录的RID
+   * @param record_size 记录大小
+   */
+  RC insert_records(span<Record> records, int record_size);
+
   /**
    * @brief 数据库恢复时，在指定文件指定位置插入数据
    *
@@ -401,17 +462,74 @@ public:
 
   RC visit_record(const RID &rid, function<bool(Record &)> updater);
 
+  /**
+   * @brief 获取一批记录，以 Chunk 格式追加到 chunk 中
+   * @details rids 需要按照页面编号排好序，同一个页面上的记录只需要访问一次页面
+   * @param rids 记录的位置
+   * @param chunk 由 chunk.column(i).col_id() 指定列。当前只支持 PAX 格式
+   */
+  RC get_chunk(span<const RID> rids, Chunk &chunk);
+
+  /**
+   * @brief 页面上的记录是否对所有事务(包括以后开启的事务)都可见
+   * @details 这是一个只在内存中维护的提示，索引覆盖扫描时用来跳过回表检查可见性。
+   * 修改页面上的记录时会先清除这个标记，重启之后所有页面都没有这个标记。
+   */
+  bool is_all_visible(PageNum page_num);
+
+  /**
+   * @brief 检查页面上的所有记录，如果都对所有事务可见，就给页面加上 all-visible 标记
+   * @param visible_to_all 判断一条记录是否对所有事务可见
+   * @param[out] marked 是否加上了标记
+   */
+  RC try_mark_all_visible(PageNum page_num, function<bool(const Record &)> visible_to_all, bool &marked);
+
 private:
   /**
-   * @brief 初始化当前没有填满记录的页面，初始化free_pages_成员
+   * @brief 插入线程当前使用的页面
+   * @details 每个线程按照编号固定使用其中一个，并发插入的线程写不同的页面，不需要争抢同一个页面的锁。
+   * 页面从 free_space_map_ 中占用(claim)，写满之后释放
+   */
+  struct InsertTarget
+  {
+    alignas(64) atomic<PageNum> page_num{BP_INVALID_PAGE_NUM};
+  };
+  static constexpr int INSERT_TARGET_NUM = 64;
+
+  /// 当前线程使用的 InsertTarget 的下标
+  static int insert_target_index();
+
+  /**
+   * @brief 遍历所有页面，重建 free_space_map_
+   * @details FSM 文件无效时(比如没有正常关闭)使用，效率很低，会降低启动速度
    */
-  RC init_free_pages();
+  RC rebuild_free_space_map();
+
+  /**
+   * @brief 找一个可以插入记录的页面，record_page_handler 返回时持有这个页面的写锁
+   * @details 优先使用 target 中的页面，它满了就从 free_space_map_ 中找，都没有时分配新的页面
+   */
+  RC get_insert_page(InsertTarget &target, int record_size, RecordPageHandler &record_page_handler);
+
+  /// 分配一个新的页面用来插入记录
+  RC allocate_insert_page(InsertTarget &target, int record_size, RecordPageHandler &record_page_handler);
+
+  /// 页面写满之后不再作为 target 的插入页面，并释放对它的占用
+  void retire_insert_page(InsertTarget &target, PageNum page_num);
+
+  /// 修改页面之后更新 free_space_map_ 中的 level，需要持有页面的写锁
+  void update_free_space(const RecordPageHandler &record_page_handler);
+
+  /// 修改页面上的记录之前调用，需要持有页面的写锁
+  void clear_all_visible(PageNum page_num);
 
 private:
   DiskBufferPool        *disk_buffer_pool_ = nullptr;
   LogHandler            *log_handler_      = nullptr;  ///< 记录日志的处理器
-  unordered_set<PageNum> free_pages_;                  ///< 没有填充满的页面集合
-  common::Mutex          lock_;  ///< 当编译时增加-DCONCURRENCY=ON 选项时，才会真正的支持并发
+  FreeSpaceMap           free_space_map_;              ///< 记录每个页面的空闲空间
+  InsertTarget           insert_targets_[INSERT_TARGET_NUM];
+  unordered_set<PageNum> all_visible_pages_;  ///< 所有记录都对所有事务可见的页面
+  common::Mutex          all_visible_lock_;   ///< 保护 all_visible_pages_，不会在持有它时再加其它的锁
   StorageFormat          storage_format_;
   TableMeta             *table_meta_;
 };
@@ -491,8 +609,13 @@ public:
   ChunkFileScanner() = default;
   ~ChunkFileScanner();
 
-  // TODO: not support filter and transaction
-  RC open_scan_chunk(Table *table, DiskBufferPool &buffer_pool, LogHandler &log_handler, ReadWriteMode mode);
+  /**
+   * @brief 打开一个文件扫描
+   * @details 不支持过滤条件。行存格式的表会使用事务判断每条记录是否可见，
+   * PAX 格式的 chunk 直接引用页面中的列数据，不检查可见性
+   * @param trx 当前是哪个事务在遍历，为空时返回所有的记录
+   */
+  RC open_scan_chunk(Table *table, DiskBufferPool &buffer_pool, Trx *trx, LogHandler &log_handler, ReadWriteMode mode);
 
   /**
    * @brief 关闭一个文件扫描，释放相应的资源
@@ -501,14 +624,24 @@ public:
 
   /**
    * @brief 每次调用获取一个页面中的所有记录。
+   * @details PAX 格式的 chunk 可能直接引用页面中的数据(参考 PaxRecordPageHandler::get_chunk)，
+   * 页面在下一次调用 next_chunk 或者 close_scan 之前一直是 pin 住的，chunk 也只在这之前有效。
+   * chunk 中的列会被修改为引用或者重新分配内存，不能与其它 chunk 共享。
    */
   RC next_chunk(Chunk &chunk);
 
+private:
+  /**
+   * @brief 行存格式的页面没有按列存放数据，按照字段的偏移把每条可见记录的字段复制到 chunk 中
+   */
+  RC get_row_chunk(Chunk &chunk);
+
 private:
   Table *table_ = nullptr;  ///< 当前遍历的是哪张表。
 
   DiskBufferPool *disk_buffer_pool_ = nullptr;  ///< 当前访问的文件
   LogHandler     *log_handler_      = nullptr;
+  Trx            *trx_              = nullptr;  ///< 当前是哪个事务在遍历
   ReadWriteMode   rw_mode_ = ReadWriteMode::READ_WRITE;  ///< 遍历出来的数据，是否可能对它做修改
 
   BufferPoolIterator bp_iterator_;                    ///< 遍历buffer pool的所有页面
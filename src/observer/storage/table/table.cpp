@@ -70,6 +70,14 @@ RC Table::destroy(const char* dir) {
         return RC::FILE_NOT_EXIST;
     }
 
+    // 关闭时会写回空闲空间映射文件，所以要先关闭再删除
+    record_handler_->close();
+    std::string fsm_file = FreeSpaceMap::file_name(data_file.c_str());
+    if(unlink(fsm_file.c_str()) != 0 && errno != ENOENT) {
+        LOG_ERROR("Failed to remove free space map file=%s, errno=%d", fsm_file.c_str(), errno);
+        return RC::FILE_NOT_EXIST;
+    }
+
     // 删除表实现text字段的数据文件（后续实现了text case时需要考虑，最开始可以不考虑这个逻辑）
     // std::string text_data_file = std::string(dir) + "/" + name() + TABLE_TEXT_DATA_SUFFIX;
     // if(unlink(text_data_file.c_str()) != 0) { 
@@ -197,19 +205,33 @@ RC Table::open(Db *db, const char *meta_file, const char *base_dir)
   const int index_num = table_meta_.index_num();
   for (int i = 0; i < index_num; i++) {
     const IndexMeta *index_meta = table_meta_.index(i);
-    const FieldMeta *field_meta = table_meta_.field(index_meta->field());
-    if (field_meta == nullptr) {
-      LOG_ERROR("Found invalid index meta info which has a non-exists field. table=%s, index=%s, field=%s",
-                name(), index_meta->name(), index_meta->field());
-      // skip cleanup
-      //  do all cleanup action in destructive Table function
-      return RC::INTERNAL;
+    vector<const FieldMeta *> field_metas;
+    vector<const FieldMeta *> include_field_metas;
+    for (const string &field_name : index_meta->fields()) {
+      const FieldMeta *field_meta = table_meta_.field(field_name.c_str());
+      if (field_meta == nullptr) {
+        LOG_ERROR("Found invalid index meta info which has a non-exists field. table=%s, index=%s, field=%s",
+                  name(), index_meta->name(), field_name.c_str());
+        // skip cleanup
+        //  do all cleanup action in destructive Table function
+        return RC::INTERNAL;
+      }
+      field_metas.push_back(field_meta);
+    }
+    for (const string &field_name : index_meta->include_fields()) {
+      const FieldMeta *field_meta = table_meta_.field(field_name.c_str());
+      if (field_meta == nullptr) {
+        LOG_ERROR("Found invalid index meta info which has a non-exists include field. table=%s, index=%s, field=%s",
+                  name(), index_meta->name(), field_name.c_str());
+        return RC::INTERNAL;
+      }
+      include_field_metas.push_back(field_meta);
     }
 
     BplusTreeIndex *index      = new BplusTreeIndex();
     string          index_file = table_index_file(base_dir, name(), index_meta->name());
 
-    rc = index->open(this, index_file.c_str(), *index_meta, *field_meta);
+    rc = index->open(this, index_file.c_str(), *index_meta, field_metas, include_field_metas);
     if (rc != RC::SUCCESS) {
       delete index;
       LOG_ERROR("Failed to open index. table=%s, index=%s, file=%s, rc=%s",
@@ -249,17 +271,117 @@ RC Table::insert_record(Record &record)
   return rc;
 }
 
-// update record here
-RC Table::update_record(Record &record, Record& new_record) {
-  RC rc = RC::SUCCESS;
-  // delete from file first, also delete from index
-  rc = delete_record(record);
-  if(OB_FAIL(rc)) return rc;
-  // insert the new record, also insert into index
-  rc = insert_record(new_record);
+RC Table::insert_records(span<Record> records)
+{
+  RC rc = record_handler_->insert_records(records, table_meta_.record_size());
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Insert records failed. table name=%s, record num=%d, rc=%s",
+              table_meta_.name(), static_cast<int>(records.size()), strrc(rc));
+    return rc;
+  }
+
+  for (Index *index : indexes_) {
+    rc = index->insert_entries(records);
+    if (OB_FAIL(rc)) {  // 可能出现了键值重复
+      break;
+    }
+  }
+
+  if (OB_FAIL(rc)) {
+    // 出错的索引中可能只插入了一部分键值，这里不关心哪些不存在
+    for (const Record &record : records) {
+      for (Index *index : indexes_) {
+        RC rc2 = index->delete_entry(record.data(), &record.rid());
+        if (rc2 != RC::SUCCESS && rc2 != RC::RECORD_NOT_EXIST) {
+          LOG_ERROR("Failed to rollback index data when insert index entries failed. table name=%s, rc=%d:%s",
+                    name(), rc2, strrc(rc2));
+        }
+      }
+
+      RC rc2 = record_handler_->delete_record(&record.rid());
+      if (rc2 != RC::SUCCESS) {
+        LOG_PANIC("Failed to rollback record data when insert index entries failed. table name=%s, rc=%d:%s",
+                  name(), rc2, strrc(rc2));
+      }
+    }
+  }
   return rc;
 }
 
+RC Table::update_record(Record &record, Record &new_record)
+{
+  const RID &rid = record.rid();
+  new_record.set_rid(rid);
+
+  vector<Index *> changed_indexes;
+  for (Index *index : indexes_) {
+    if (index->entry_changed(record.data(), new_record.data())) {
+      changed_indexes.push_back(index);
+    }
+  }
+
+  // 先修改索引，键值重复时还没有修改记录
+  RC     rc        = RC::SUCCESS;
+  size_t index_num = 0;
+  for (; index_num < changed_indexes.size(); index_num++) {
+    Index *index = changed_indexes[index_num];
+    rc           = index->delete_entry(record.data(), &rid);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to delete index entry while updating record. table=%s, index=%s, rid=%s, rc=%s",
+               name(), index->index_meta().name(), rid.to_string().c_str(), strrc(rc));
+      break;
+    }
+
+    rc = index->insert_entry(new_record.data(), &rid);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to insert index entry while updating record. table=%s, index=%s, rid=%s, rc=%s",
+               name(), index->index_meta().name(), rid.to_string().c_str(), strrc(rc));
+      RC rc2 = index->insert_entry(record.data(), &rid);
+      if (OB_FAIL(rc2)) {
+        LOG_PANIC("failed to rollback index entry. table=%s, index=%s, rc=%s",
+                  name(), index->index_meta().name(), strrc(rc2));
+      }
+      break;
+    }
+  }
+
+  if (OB_SUCC(rc)) {
+    rc = record_handler_->visit_record(rid, [&new_record](Record &inplace_record) -> bool {
+      memcpy(inplace_record.data(), new_record.data(), inplace_record.len());
+      return true;
+    });
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to update record in place. table=%s, rid=%s, rc=%s",
+               name(), rid.to_string().c_str(), strrc(rc));
+    }
+  }
+
+  if (OB_FAIL(rc)) {
+    for (size_t i = 0; i < index_num; i++) {
+      Index *index = changed_indexes[i];
+      RC     rc2   = index->delete_entry(new_record.data(), &rid);
+      if (OB_SUCC(rc2)) {
+        rc2 = index->insert_entry(record.data(), &rid);
+      }
+      if (OB_FAIL(rc2)) {
+        LOG_PANIC("failed to rollback index entry. table=%s, index=%s, rc=%s",
+                  name(), index->index_meta().name(), strrc(rc2));
+      }
+    }
+  }
+  return rc;
+}
+
+bool Table::indexes_changed(const char *old_record, const char *new_record) const
+{
+  for (const Index *index : indexes_) {
+    if (index->entry_changed(old_record, new_record)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 RC Table::visit_record(const RID &rid, function<bool(Record &)> visitor)
 {
   return record_handler_->visit_record(rid, visitor);
@@ -305,6 +427,8 @@ const char *Table::name() const { return table_meta_.name(); }
 
 const TableMeta &Table::table_meta() const { return table_meta_; }
 
+int32_t Table::data_page_count() const { return data_buffer_pool_->allocated_pages(); }
+
 RC Table::make_record(int value_num, const Value *values, Record &record)
 {
   // 检查字段类型是否一致
@@ -382,26 +506,29 @@ RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, ReadWriteMode
 
 RC Table::get_chunk_scanner(ChunkFileScanner &scanner, Trx *trx, ReadWriteMode mode)
 {
-  RC rc = scanner.open_scan_chunk(this, *data_buffer_pool_, db_->log_handler(), mode);
+  RC rc = scanner.open_scan_chunk(this, *data_buffer_pool_, trx, db_->log_handler(), mode);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("failed to open scanner. rc=%s", strrc(rc));
   }
   return rc;
 }
 
-RC Table::create_index(Trx *trx, const FieldMeta *field_meta, const char *index_name)
+RC Table::create_index(Trx *trx, const vector<const FieldMeta *> &field_metas, const char *index_name,
+    const vector<const FieldMeta *> &include_field_metas)
 {
-  if (common::is_blank(index_name) || nullptr == field_meta) {
+  if (common::is_blank(index_name) || field_metas.empty() ||
+      std::find(field_metas.begin(), field_metas.end(), nullptr) != field_metas.end() ||
+      std::find(include_field_metas.begin(), include_field_metas.end(), nullptr) != include_field_metas.end()) {
     LOG_INFO("Invalid input arguments, table name is %s, index_name is blank or attribute_name is blank", name());
     return RC::INVALID_ARGUMENT;
   }
 
   IndexMeta new_index_meta;
 
-  RC rc = new_index_meta.init(index_name, *field_meta);
+  RC rc = new_index_meta.init(index_name, field_metas, include_field_metas);
   if (rc != RC::SUCCESS) {
     LOG_INFO("Failed to init IndexMeta in table:%s, index_name:%s, field_name:%s", 
-             name(), index_name, field_meta->name());
+             name(), index_name, field_metas[0]->name());
     return rc;
   }
 
@@ -409,39 +536,41 @@ RC Table::create_index(Trx *trx, const FieldMeta *field_meta, const char *index_
   BplusTreeIndex *index      = new BplusTreeIndex();
   string          index_file = table_index_file(base_dir_.c_str(), name(), index_name);
 
-  rc = index->create(this, index_file.c_str(), new_index_meta, *field_meta);
+  rc = index->create(this, index_file.c_str(), new_index_meta, field_metas, include_field_metas);
   if (rc != RC::SUCCESS) {
     delete index;
     LOG_ERROR("Failed to create bplus tree index. file name=%s, rc=%d:%s", index_file.c_str(), rc, strrc(rc));
     return rc;
   }
 
-  // 遍历当前的所有数据，插入这个索引
+  // 构建索引失败时，关闭索引文件(同时关闭它的buffer pool)并删除，否则无法再创建同名的索引
+  auto destroy_index = [&]() {
+    index->close();
+    delete index;
+    if (unlink(index_file.c_str()) != 0) {
+      LOG_WARN("failed to remove index file=%s, errno=%d:%s", index_file.c_str(), errno, strerror(errno));
+    }
+  };
+
+  // 遍历当前的所有数据，批量构建这个索引
+  // 与插入记录时一样，索引要包含页面上所有的记录，可见性在访问记录时再判断，所以这里不按事务过滤
   RecordFileScanner scanner;
-  rc = get_record_scanner(scanner, trx, ReadWriteMode::READ_ONLY);
+  rc = get_record_scanner(scanner, nullptr /*trx*/, ReadWriteMode::READ_ONLY);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to create scanner while creating index. table=%s, index=%s, rc=%s", 
              name(), index_name, strrc(rc));
+    destroy_index();
     return rc;
   }
 
-  Record record;
-  while (OB_SUCC(rc = scanner.next(record))) {
-    rc = index->insert_entry(record.data(), &record.rid());
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to insert record into index while creating index. table=%s, index=%s, rc=%s",
-               name(), index_name, strrc(rc));
-      return rc;
-    }
-  }
-  if (RC::RECORD_EOF == rc) {
-    rc = RC::SUCCESS;
-  } else {
-    LOG_WARN("failed to insert record into index while creating index. table=%s, index=%s, rc=%s",
+  rc = index->bulk_load(scanner);
+  scanner.close_scan();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to insert records into index while creating index. table=%s, index=%s, rc=%s",
              name(), index_name, strrc(rc));
+    destroy_index();
     return rc;
   }
-  scanner.close_scan();
   LOG_INFO("inserted all records into new index. table=%s, index=%s", name(), index_name);
 
   indexes_.push_back(index);
@@ -76,9 +76,29 @@ public:
    * @param record[in/out] 传入的数据包含具体的数据，插入成功会通过此字段返回RID
    */
   RC insert_record(Record &record);
+
+  /**
+   * @brief 在当前的表中插入多条记录
+   * @details 同一个页面上的记录在一次加锁中写入，并且只记录一条日志；每个索引的键值先排序再插入。
+   * 任何一条记录插入失败时，已经插入的记录和索引数据都会删除。
+   * @param records[in/out] 插入成功会设置每条记录的RID
+   */
+  RC insert_records(span<Record> records);
+
   RC delete_record(const Record &record);
   RC delete_record(const RID &rid);
-  RC update_record(Record &record, Record& new_record);
+
+  /**
+   * @brief 原地更新一条记录，不关心事务相关操作
+   * @details 记录的长度是固定的，新数据直接覆盖原来的位置，RID不变。
+   * 只有索引字段或包含列发生变化的索引才会删除旧的索引项并插入新的索引项，失败时会恢复这些索引
+   * @param record 修改之前的记录，需要有RID
+   * @param new_record 修改之后的记录，成功后RID与 record 相同
+   */
+  RC update_record(Record &record, Record &new_record);
+
+  /// 记录从 old_record 修改成 new_record 时，是否有索引需要修改
+  bool indexes_changed(const char *old_record, const char *new_record) const;
   RC get_record(const RID &rid, Record &record);
 
   RC destroy(const char* dir);
@@ -86,7 +106,11 @@ public:
   RC recover_insert_record(Record &record);
 
   // TODO refactor
-  RC create_index(Trx *trx, const FieldMeta *field_meta, const char *index_name);
+  /**
+   * @brief 创建索引，包含多个字段时创建联合索引，键值按照字段的顺序比较
+   */
+  RC create_index(Trx *trx, const vector<const FieldMeta *> &field_metas, const char *index_name,
+      const vector<const FieldMeta *> &include_field_metas = {});
 
   RC get_record_scanner(RecordFileScanner &scanner, Trx *trx, ReadWriteMode mode);
 
@@ -111,6 +135,12 @@ public:
 
   const TableMeta &table_meta() const;
 
+  /**
+   * @brief 数据文件中已经分配的页面数
+   * @details 优化器用它粗略地估计表的大小
+   */
+  int32_t data_page_count() const;
+
   RC sync();
 
 private:
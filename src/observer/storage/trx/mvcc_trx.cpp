@@ -44,6 +44,13 @@ const vector<FieldMeta> *MvccTrxKit::trx_fields() const { return &fields_; }
 
 int32_t MvccTrxKit::next_trx_id() { return ++current_trx_id_; }
 
+void MvccTrxKit::update_trx_id(int32_t trx_id)
+{
+  int32_t current = current_trx_id_.load();
+  while (current < trx_id && !current_trx_id_.compare_exchange_weak(current, trx_id)) {
+  }
+}
+
 int32_t MvccTrxKit::max_trx_id() const { return numeric_limits<int32_t>::max(); }
 
 Trx *MvccTrxKit::create_trx(LogHandler &log_handler)
@@ -99,6 +106,75 @@ Trx *MvccTrxKit::find_trx(int32_t trx_id)
   return nullptr;
 }
 
+void MvccTrxKit::min_active_lsn(LSN &lsn)
+{
+  lock_.lock();
+  for (Trx *trx : trxes_) {
+    LSN start_lsn = static_cast<MvccTrx *>(trx)->start_lsn();
+    if (start_lsn > 0 && start_lsn < lsn) {
+      lsn = start_lsn;
+    }
+  }
+  lock_.unlock();
+}
+
+int32_t MvccTrxKit::open_read_view(ReadView &read_view)
+{
+  lock_.lock();
+  const int32_t trx_id = next_trx_id();
+
+  vector<int32_t> committing_xids;
+  for (Trx *trx : trxes_) {
+    const int32_t committing_xid = static_cast<MvccTrx *>(trx)->committing_xid();
+    if (committing_xid > 0) {
+      committing_xids.push_back(committing_xid);
+    }
+  }
+  read_view.open(trx_id, std::move(committing_xids));
+  lock_.unlock();
+  return trx_id;
+}
+
+void MvccTrxKit::close_read_view(ReadView &read_view)
+{
+  lock_.lock();
+  read_view.close();
+  lock_.unlock();
+}
+
+int32_t MvccTrxKit::begin_commit(int32_t &committing_xid)
+{
+  lock_.lock();
+  committing_xid = next_trx_id();
+  lock_.unlock();
+  return committing_xid;
+}
+
+void MvccTrxKit::end_commit(int32_t &committing_xid)
+{
+  lock_.lock();
+  committing_xid = 0;
+  lock_.unlock();
+}
+
+int32_t MvccTrxKit::visible_xid_limit()
+{
+  lock_.lock();
+  // 以后分配的提交事务号都比当前的事务号大，以后创建的读视图可以看到当前已经完成的提交
+  int32_t limit = current_trx_id_.load() + 1;
+  for (Trx *trx : trxes_) {
+    auto *mvcc_trx = static_cast<MvccTrx *>(trx);
+    if (mvcc_trx->committing_xid() > 0) {
+      limit = min(limit, mvcc_trx->committing_xid());
+    }
+    if (mvcc_trx->read_view().is_open()) {
+      limit = min(limit, mvcc_trx->read_view().up_limit());
+    }
+  }
+  lock_.unlock();
+  return limit;
+}
+
 void MvccTrxKit::all_trxes(vector<Trx *> &trxes)
 {
   lock_.lock();
@@ -148,13 +224,98 @@ RC MvccTrx::insert_record(Table *table, Record &record)
   return rc;
 }
 
-RC MvccTrx::update_record(Table *table, Record &record, Record& new_record){
-  RC rc = RC::SUCCESS;
-  rc = delete_record(table, record);
-  rc = insert_record(table, new_record);
+RC MvccTrx::insert_records(Table *table, vector<Record> &records)
+{
+  Field begin_field;
+  Field end_field;
+  trx_fields(table, begin_field, end_field);
+
+  for (Record &record : records) {
+    begin_field.set_int(record, -trx_id_);
+    end_field.set_int(record, trx_kit_.max_trx_id());
+  }
+
+  RC rc = table->insert_records(records);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to insert records into table. record num=%d, rc=%s", static_cast<int>(records.size()), strrc(rc));
+    return rc;
+  }
+
+  for (Record &record : records) {
+    rc = log_handler_.insert_record(trx_id_, table, record.rid());
+    ASSERT(rc == RC::SUCCESS, "failed to append insert record log. trx id=%d, table id=%d, rid=%s, record len=%d, rc=%s",
+           trx_id_, table->table_id(), record.rid().to_string().c_str(), record.len(), strrc(rc));
+
+    operations_.push_back(Operation(Operation::Type::INSERT, table, record.rid()));
+  }
   return rc;
 }
 
+RC MvccTrx::update_record(Table *table, Record &record, Record &new_record)
+{
+  if (!table->indexes_changed(record.data(), new_record.data())) {
+    return update_record_inplace(table, record, new_record);
+  }
+
+  // 索引项中没有版本信息，修改了索引字段时使用一条新的记录，旧的索引项仍然指向旧版本
+  RC rc = delete_record(table, record);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  return insert_record(table, new_record);
+}
+
+RC MvccTrx::update_record_inplace(Table *table, Record &record, Record &new_record)
+{
+  Field begin_field;
+  Field end_field;
+  trx_fields(table, begin_field, end_field);
+
+  RC update_result = RC::SUCCESS;
+
+  auto updater = [this, table, &new_record, &begin_field, &end_field, &update_result](Record &inplace_record) -> bool {
+    update_result = this->check_writable(table, inplace_record);
+    if (OB_FAIL(update_result)) {
+      return false;
+    }
+
+    // 当前事务插入的或者已经修改过的记录，回滚时不需要再多保存一个版本
+    if (begin_field.get_int(inplace_record) != -trx_id_) {
+      const RID       &rid = inplace_record.rid();
+      span<const char> old_data(inplace_record.data(), inplace_record.len());
+
+      update_result = log_handler_.update_record(trx_id_, table, rid, old_data);
+      if (OB_FAIL(update_result)) {
+        LOG_WARN("failed to append update record log. trx id=%d, table id=%d, rid=%s, rc=%s",
+                 trx_id_, table->table_id(), rid.to_string().c_str(), strrc(update_result));
+        return false;
+      }
+
+      trx_kit_.undo_log().push(table->table_id(), rid, trx_id_, old_data);
+      operations_.push_back(Operation(Operation::Type::UPDATE, table, rid));
+    }
+
+    memcpy(inplace_record.data(), new_record.data(), inplace_record.len());
+    begin_field.set_int(inplace_record, -trx_id_);
+    end_field.set_int(inplace_record, trx_kit_.max_trx_id());
+    return true;
+  };
+
+  RC rc = table->visit_record(record.rid(), updater);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to visit record. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  if (OB_FAIL(update_result)) {
+    LOG_TRACE("failed to update record. rid=%s, rc=%s", record.rid().to_string().c_str(), strrc(update_result));
+    return update_result;
+  }
+
+  new_record.set_rid(record.rid());
+  return RC::SUCCESS;
+}
+
 RC MvccTrx::delete_record(Table *table, Record &record)
 {
   Field begin_field;
@@ -164,7 +325,7 @@ RC MvccTrx::delete_record(Table *table, Record &record)
   RC delete_result = RC::SUCCESS;
 
   RC rc = table->visit_record(record.rid(), [this, table, &delete_result, &end_field](Record &inplace_record) -> bool {
-    RC rc = this->visit_record(table, inplace_record, ReadWriteMode::READ_WRITE);
+    RC rc = this->check_writable(table, inplace_record);
     if (OB_FAIL(rc)) {
       delete_result = rc;
       return false;
@@ -193,31 +354,127 @@ RC MvccTrx::delete_record(Table *table, Record &record)
   return RC::SUCCESS;
 }
 
+bool MvccTrx::visible_to_all(Table *table, const Record &record)
+{
+  Field begin_field;
+  Field end_field;
+  trx_fields(table, begin_field, end_field);
+
+  const int32_t begin_xid = begin_field.get_int(record);
+  const int32_t end_xid   = end_field.get_int(record);
+  if (begin_xid <= 0 || end_xid != trx_kit_.max_trx_id()) {
+    return false;
+  }
+  return begin_xid < trx_kit_.visible_xid_limit();
+}
+
 RC MvccTrx::visit_record(Table *table, Record &record, ReadWriteMode mode)
 {
   Field begin_field;
   Field end_field;
   trx_fields(table, begin_field, end_field);
 
-  int32_t begin_xid = begin_field.get_int(record);
-  int32_t end_xid   = end_field.get_int(record);
+  RC rc = check_visible(begin_field.get_int(record), end_field.get_int(record), mode);
+  if (rc != RC::RECORD_INVISIBLE || trx_kit_.undo_log().version_num() == 0) {
+    return rc;
+  }
+
+  // 读写访问时也返回旧版本，由调用者判断是否需要修改。真正修改时会检查冲突，参考 check_writable
+  vector<char> visible_data;
+  if (!find_undo_version(table, record.rid(), visible_data)) {
+    return RC::RECORD_INVISIBLE;
+  }
+
+  const RID rid = record.rid();
+  record.copy_data(visible_data.data(), static_cast<int>(visible_data.size()));
+  record.set_rid(rid);
+  return RC::SUCCESS;
+}
+
+RC MvccTrx::check_writable(Table *table, const Record &inplace_record)
+{
+  Field begin_field;
+  Field end_field;
+  trx_fields(table, begin_field, end_field);
+
+  const int32_t end_xid = end_field.get_int(inplace_record);
 
-  RC rc = RC::SUCCESS;
-  if (begin_xid > 0 && end_xid > 0) {
-    if (trx_id_ >= begin_xid && trx_id_ <= end_xid) {
-      rc = RC::SUCCESS;
-    } else {
-      LOG_TRACE("record invisible. trx id=%d, begin xid=%d, end xid=%d", trx_id_, begin_xid, end_xid);
-      rc = RC::RECORD_INVISIBLE;
+  RC rc = check_visible(begin_field.get_int(inplace_record), end_xid, ReadWriteMode::READ_WRITE);
+  if (OB_SUCC(rc) && end_xid > 0 && end_xid != trx_kit_.max_trx_id()) {
+    // 能看到的数据被读视图之后提交的事务删除了，不能再修改
+    LOG_TRACE("concurrency conflit. someone has deleted this record. trx id=%d, rid=%s",
+              trx_id_, inplace_record.rid().to_string().c_str());
+    return RC::LOCKED_CONCURRENCY_CONFLICT;
+  }
+  if (rc != RC::RECORD_INVISIBLE || trx_kit_.undo_log().version_num() == 0) {
+    return rc;
+  }
+
+  // 能看到旧版本，说明其它事务修改了这条记录
+  vector<char> visible_data;
+  if (find_undo_version(table, inplace_record.rid(), visible_data)) {
+    LOG_TRACE("concurrency conflit. someone has updated this record. trx id=%d, rid=%s",
+              trx_id_, inplace_record.rid().to_string().c_str());
+    return RC::LOCKED_CONCURRENCY_CONFLICT;
+  }
+  return rc;
+}
+
+bool MvccTrx::find_undo_version(Table *table, const RID &rid, vector<char> &data)
+{
+  Field begin_field;
+  Field end_field;
+  trx_fields(table, begin_field, end_field);
+
+  const int begin_offset = begin_field.meta()->offset();
+  const int end_offset   = end_field.meta()->offset();
+
+  // 旧版本上的结束事务号是修改它的事务提交时的事务号，没有提交时对其它事务来说还没有结束
+  auto finder = [this, begin_offset, end_offset, &data](const UndoLog::Version &version) -> bool {
+    if (version.trx_id == trx_id_) {
+      return false;  // 当前事务自己修改的，应该看到记录上的版本
     }
-  } else if (begin_xid < 0) {
+
+    int32_t begin_xid = 0;
+    int32_t end_xid   = version.commit_xid != 0 ? version.commit_xid : trx_kit_.max_trx_id();
+    memcpy(&begin_xid, version.data.data() + begin_offset, sizeof(begin_xid));
+    if (OB_FAIL(check_visible(begin_xid, end_xid, ReadWriteMode::READ_ONLY))) {
+      return false;
+    }
+
+    data = version.data;
+    memcpy(data.data() + end_offset, &end_xid, sizeof(end_xid));
+    return true;
+  };
+
+  return trx_kit_.undo_log().find_version(table->table_id(), rid, finder);
+}
+
+RC MvccTrx::check_visible(int32_t begin_xid, int32_t end_xid, ReadWriteMode mode) const
+{
+  RC rc = RC::SUCCESS;
+  if (begin_xid < 0) {
     // begin xid 小于0说明是刚插入而且没有提交的数据
-    if (-begin_xid == trx_id_) {
-      rc = RC::SUCCESS;
-    } else {
+    if (-begin_xid != trx_id_) {
       LOG_TRACE("record invisible. someone is updating this record right now. trx id=%d, begin xid=%d, end xid=%d",
                 trx_id_, begin_xid, end_xid);
       rc = RC::RECORD_INVISIBLE;
+    } else if (end_xid == begin_xid) {
+      LOG_TRACE("record invisible. self has deleted this record. trx id=%d, begin xid=%d, end xid=%d",
+                trx_id_, begin_xid, end_xid);
+      rc = RC::RECORD_INVISIBLE;
+    }
+  } else if (!read_view_.committed_visible(begin_xid)) {
+    // 读视图创建之后才提交的数据
+    LOG_TRACE("record invisible. trx id=%d, begin xid=%d, end xid=%d, read view=%s",
+              trx_id_, begin_xid, end_xid, read_view_.to_string().c_str());
+    rc = RC::RECORD_INVISIBLE;
+  } else if (end_xid > 0) {
+    // 删除已经提交的数据，读视图能看到删除时就看不到这条数据
+    if (read_view_.committed_visible(end_xid)) {
+      LOG_TRACE("record invisible. trx id=%d, begin xid=%d, end xid=%d, read view=%s",
+                trx_id_, begin_xid, end_xid, read_view_.to_string().c_str());
+      rc = RC::RECORD_INVISIBLE;
     }
   } else if (end_xid < 0) {
     // end xid 小于0 说明是正在删除但是还没有提交的数据
@@ -271,22 +528,24 @@ RC MvccTrx::start_if_need()
 {
   if (!started_) {
     ASSERT(operations_.empty(), "try to start a new trx while operations is not empty");
-    trx_id_ = trx_kit_.next_trx_id();
-    LOG_DEBUG("current thread change to new trx with %d", trx_id_);
+    trx_id_ = trx_kit_.open_read_view(read_view_);
+    LOG_DEBUG("current thread change to new trx with %d. read view=%s", trx_id_, read_view_.to_string().c_str());
     started_ = true;
+    start_lsn_.store(log_handler_.current_lsn() + 1);
   }
   return RC::SUCCESS;
 }
 
 RC MvccTrx::commit()
 {
-  int32_t commit_id = trx_kit_.next_trx_id();
+  int32_t commit_id = trx_kit_.begin_commit(committing_xid_);
   return commit_with_trx_id(commit_id);
 }
 
 RC MvccTrx::commit_with_trx_id(int32_t commit_xid)
 {
-  // TODO 原子性提交BUG：这里存在一个很大的问题，不能让其他事务一次性看到当前事务更新到的数据或同时看不到
+  // 记录上的事务号是一条一条修改的。提交完成之前创建的读视图都把 commit_xid 当作正在提交，
+  // 看不到当前事务的任何修改；之后创建的读视图可以看到全部修改
   RC rc    = RC::SUCCESS;
   started_ = false;
 
@@ -336,6 +595,31 @@ RC MvccTrx::commit_with_trx_id(int32_t commit_xid)
                rid.to_string().c_str(), strrc(rc));
       } break;
 
+      case Operation::Type::UPDATE: {
+        Table *table = operation.table();
+        RID    rid(operation.page_num(), operation.slot_num());
+
+        Field begin_xid_field, end_xid_field;
+        trx_fields(table, begin_xid_field, end_xid_field);
+
+        auto record_updater = [this, &begin_xid_field, commit_xid](Record &record) -> bool {
+          (void)this;
+          ASSERT(begin_xid_field.get_int(record) == -trx_id_, 
+                 "got an invalid record while committing. begin xid=%d, this trx id=%d", 
+                 begin_xid_field.get_int(record), trx_id_);
+
+          begin_xid_field.set_int(record, commit_xid);
+          return true;
+        };
+
+        rc = table->visit_record(rid, record_updater);
+        ASSERT(rc == RC::SUCCESS, "failed to get record while committing. rid=%s, rc=%s",
+               rid.to_string().c_str(), strrc(rc));
+
+        // 旧版本在其它活跃事务都能看到新版本之后才能清理
+        trx_kit_.undo_log().commit(table->table_id(), rid, trx_id_, commit_xid);
+      } break;
+
       default: {
         ASSERT(false, "unsupported operation. type=%d", static_cast<int>(operation.type()));
       }
@@ -347,6 +631,10 @@ RC MvccTrx::commit_with_trx_id(int32_t commit_xid)
   }
 
   operations_.clear();
+  trx_kit_.end_commit(committing_xid_);
+  trx_kit_.close_read_view(read_view_);
+  start_lsn_.store(0);
+  purge_undo_log();
 
   LOG_TRACE("append trx commit log. trx id=%d, commit_xid=%d, rc=%s", trx_id_, commit_xid, strrc(rc));
   return rc;
@@ -415,6 +703,41 @@ RC MvccTrx::rollback()
                rid.to_string().c_str(), strrc(rc));
       } break;
 
+      case Operation::Type::UPDATE: {
+        Table *table = operation.table();
+        RID    rid(operation.page_num(), operation.slot_num());
+
+        vector<char> old_data;
+        if (!trx_kit_.undo_log().get(table->table_id(), rid, trx_id_, old_data)) {
+          ASSERT(false, "cannot find the old version while rollback. table=%s, rid=%s, trx id=%d",
+                 table->name(), rid.to_string().c_str(), trx_id_);
+          return RC::INTERNAL;
+        }
+
+        Field begin_xid_field, end_xid_field;
+        trx_fields(table, begin_xid_field, end_xid_field);
+
+        auto record_updater = [this, &begin_xid_field, &old_data](Record &record) -> bool {
+          // 恢复时可能已经回滚过了
+          if (recovering_ && begin_xid_field.get_int(record) != -trx_id_) {
+            return false;
+          }
+
+          ASSERT(begin_xid_field.get_int(record) == -trx_id_, 
+                "got an invalid record while rollback. begin xid=%d, this trx id=%d", 
+                begin_xid_field.get_int(record), trx_id_);
+
+          memcpy(record.data(), old_data.data(), record.len());
+          return true;
+        };
+
+        rc = table->visit_record(rid, record_updater);
+        ASSERT(rc == RC::SUCCESS, "failed to get record while rollback. rid=%s, rc=%s",
+               rid.to_string().c_str(), strrc(rc));
+
+        trx_kit_.undo_log().remove(table->table_id(), rid, trx_id_);
+      } break;
+
       default: {
         ASSERT(false, "unsupported operation. type=%d", static_cast<int>(operation.type()));
       }
@@ -426,6 +749,9 @@ RC MvccTrx::rollback()
   if (!recovering_) {
     rc = log_handler_.rollback(trx_id_);
   }
+  trx_kit_.close_read_view(read_view_);
+  start_lsn_.store(0);
+  purge_undo_log();
   LOG_TRACE("append trx rollback log. trx id=%d, rc=%s", trx_id_, strrc(rc));
   return rc;
 }
@@ -435,7 +761,8 @@ RC find_table(Db *db, const LogEntry &log_entry, Table *&table)
   auto *trx_log_header = reinterpret_cast<const MvccTrxLogHeader *>(log_entry.data());
   switch (MvccTrxLogOperation(trx_log_header->operation_type).type()) {
     case MvccTrxLogOperation::Type::INSERT_RECORD:
-    case MvccTrxLogOperation::Type::DELETE_RECORD: {
+    case MvccTrxLogOperation::Type::DELETE_RECORD:
+    case MvccTrxLogOperation::Type::UPDATE_RECORD: {
       auto *trx_log_record = reinterpret_cast<const MvccTrxRecordLogEntry *>(log_entry.data());
       table                = db->find_table(trx_log_record->table_id);
       if (nullptr == table) {
@@ -470,15 +797,26 @@ RC MvccTrx::redo(Db *db, const LogEntry &log_entry)
       operations_.push_back(Operation(Operation::Type::DELETE, table, trx_log_record->rid));
     } break;
 
+    case MvccTrxLogOperation::Type::UPDATE_RECORD: {
+      // 记录的修改已经通过record日志恢复，这里恢复旧版本，没有提交时用来回滚
+      auto *trx_log_record = reinterpret_cast<const MvccTrxRecordLogEntry *>(log_entry.data());
+      span<const char> old_data(log_entry.data() + MvccTrxRecordLogEntry::SIZE,
+                                log_entry.payload_size() - MvccTrxRecordLogEntry::SIZE);
+      trx_kit_.undo_log().push(table->table_id(), trx_log_record->rid, trx_id_, old_data);
+      operations_.push_back(Operation(Operation::Type::UPDATE, table, trx_log_record->rid));
+    } break;
+
     case MvccTrxLogOperation::Type::COMMIT: {
-      // auto *trx_log_record = reinterpret_cast<const MvccTrxCommitLogEntry *>(log_entry.data());
-      // commit_with_trx_id(trx_log_record->commit_trx_id);
       // 遇到了提交日志，说明前面的记录都已经提交成功了
+      // 记录上的提交事务号已经通过record日志恢复，这里只需要保证新事务的事务号比它大
+      auto *trx_log_record = reinterpret_cast<const MvccTrxCommitLogEntry *>(log_entry.data());
+      trx_kit_.update_trx_id(trx_log_record->commit_trx_id);
+      release_undo_versions();
     } break;
 
     case MvccTrxLogOperation::Type::ROLLBACK: {
-      // do nothing
       // 遇到了回滚日志，前面的回滚操作也都执行完成了
+      release_undo_versions();
     } break;
 
     default: {
@@ -489,3 +827,23 @@ RC MvccTrx::redo(Db *db, const LogEntry &log_entry)
 
   return RC::SUCCESS;
 }
+
+void MvccTrx::release_undo_versions()
+{
+  // 恢复之前的事务都已经结束了，旧版本不会再被访问到
+  for (const Operation &operation : operations_) {
+    if (operation.type() == Operation::Type::UPDATE) {
+      RID rid(operation.page_num(), operation.slot_num());
+      trx_kit_.undo_log().remove(operation.table()->table_id(), rid, trx_id_);
+    }
+  }
+  operations_.clear();
+}
+
+void MvccTrx::purge_undo_log()
+{
+  UndoLog &undo_log = trx_kit_.undo_log();
+  if (undo_log.version_num() > 0) {
+    undo_log.purge(trx_kit_.visible_xid_limit());
+  }
+}
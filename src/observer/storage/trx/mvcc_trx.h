@@ -14,9 +14,12 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/lang/atomic.h"
 #include "common/lang/vector.h"
 #include "storage/trx/trx.h"
 #include "storage/trx/mvcc_trx_log.h"
+#include "storage/trx/read_view.h"
+#include "storage/trx/undo_log.h"
 
 class CLogManager;
 class LogHandler;
@@ -42,11 +45,46 @@ public:
   Trx *find_trx(int32_t trx_id) override;
   void all_trxes(vector<Trx *> &trxes) override;
 
+  void min_active_lsn(LSN &lsn) override;
+
+  /**
+   * @brief 分配事务号并创建读视图
+   * @details 与分配提交事务号互斥，已经分配了提交事务号但是还没有提交完成的事务，都会记录在读视图中
+   * @return 分配的事务号
+   */
+  int32_t open_read_view(ReadView &read_view);
+  void    close_read_view(ReadView &read_view);
+
+  /**
+   * @brief 开始提交，分配提交事务号
+   * @details 调用 end_commit 之前，新创建的读视图都看不到这个提交事务号的修改
+   * @param committing_xid 事务保存提交事务号的地方，创建读视图时会读取
+   */
+  int32_t begin_commit(int32_t &committing_xid);
+  void    end_commit(int32_t &committing_xid);
+
+  /**
+   * @brief 小于这个值的提交对所有打开的读视图都可见
+   * @details 以后创建的读视图也都可以看到，可以根据这个值清理旧版本
+   */
+  int32_t visible_xid_limit();
+
+  /// 原地更新的记录的旧版本
+  UndoLog &undo_log() { return undo_log_; }
+
   LogReplayer *create_log_replayer(Db &db, LogHandler &log_handler) override;
 
 public:
   int32_t next_trx_id();
 
+  /**
+   * @brief 保证后续分配的事务号比 trx_id 大
+   * @details 恢复时使用。提交时分配的事务号只记录在提交日志和检查点中，恢复后新的事务需要能看到这些提交的数据
+   */
+  void update_trx_id(int32_t trx_id) override;
+
+  int32_t current_trx_id() const override { return current_trx_id_.load(); }
+
 public:
   int32_t max_trx_id() const;
 
@@ -57,6 +95,8 @@ private:
 
   common::Mutex lock_;
   vector<Trx *> trxes_;
+
+  UndoLog undo_log_;
 };
 
 /**
@@ -77,12 +117,14 @@ public:
   virtual ~MvccTrx();
 
   RC insert_record(Table *table, Record &record) override;
+  RC insert_records(Table *table, vector<Record> &records) override;
   RC delete_record(Table *table, Record &record) override;
   RC update_record(Table *table, Record &record, Record &new_record) override;
 
 
   /**
    * @brief 当访问到某条数据时，使用此函数来判断是否可见，或者是否有访问冲突
+   * @details 记录上的版本不可见时，会在原地更新留下的旧版本中查找可见的版本，并替换 record 的数据
    *
    * @param table    要访问的数据属于哪张表
    * @param record   要访问哪条数据
@@ -93,6 +135,12 @@ public:
    */
   RC visit_record(Table *table, Record &record, ReadWriteMode mode) override;
 
+  /**
+   * @brief 数据已经提交并且没有被删除，对所有打开的读视图都可见
+   * @details 以后创建的读视图也都可以看到这条数据，参考 MvccTrxKit::visible_xid_limit
+   */
+  bool visible_to_all(Table *table, const Record &record) override;
+
   RC start_if_need() override;
   RC commit() override;
   RC rollback() override;
@@ -101,10 +149,42 @@ public:
 
   int32_t id() const override { return trx_id_; }
 
+  /// @brief 事务开始时的下一个LSN，事务的日志都不会比它小。没有开始或者已经结束时是0
+  LSN start_lsn() const { return start_lsn_.load(); }
+
+  /// 事务开始时创建的读视图，没有开始或者已经结束时是关闭的。其它线程需要持有 MvccTrxKit 的锁访问
+  const ReadView &read_view() const { return read_view_; }
+
+  /// 正在提交时的提交事务号，否则是0。其它线程需要持有 MvccTrxKit 的锁访问
+  int32_t committing_xid() const { return committing_xid_; }
+
 private:
   RC   commit_with_trx_id(int32_t commit_id);
   void trx_fields(Table *table, Field &begin_xid_field, Field &end_xid_field) const;
 
+  /// 根据记录上的事务号和读视图判断是否可见，参考 visit_record
+  RC check_visible(int32_t begin_xid, int32_t end_xid, ReadWriteMode mode) const;
+
+  /**
+   * @brief 修改记录之前检查是否有冲突
+   * @details 与 visit_record 的读写访问类似。另外，记录上的版本不可见但是能看到旧版本时，
+   * 说明其它事务修改了这条记录，返回 LOCKED_CONCURRENCY_CONFLICT。记录被读视图看不到的事务删除了，也是冲突
+   * @param inplace_record 页面上的记录
+   */
+  RC check_writable(Table *table, const Record &inplace_record);
+
+  /// 在原地更新留下的旧版本中找到当前事务可以看到的版本，返回的数据中结束事务号是修改它的事务提交时的事务号
+  bool find_undo_version(Table *table, const RID &rid, vector<char> &data);
+
+  /// 原地更新记录，修改之前的数据保存到 UndoLog 中
+  RC update_record_inplace(Table *table, Record &record, Record &new_record);
+
+  /// 事务已经结束后，清理不再需要的旧版本
+  void purge_undo_log();
+
+  /// 恢复时遇到了提交或回滚日志，删除事务保存的旧版本
+  void release_undo_versions();
+
 private:
   static const int32_t MAX_TRX_ID = numeric_limits<int32_t>::max();
 
@@ -117,5 +197,8 @@ private:
   int32_t           trx_id_     = -1;
   bool              started_    = false;
   bool              recovering_ = false;
+  atomic<LSN>       start_lsn_{0};
+  ReadView          read_view_;
+  int32_t           committing_xid_ = 0;
   OperationSet      operations_;
 };
@@ -31,6 +31,7 @@ string MvccTrxLogOperation::to_string() const
     case Type::DELETE_RECORD: return ret + "DELETE_RECORD";
     case Type::COMMIT: return ret + "COMMIT";
     case Type::ROLLBACK: return ret + "ROLLBACK";
+    case Type::UPDATE_RECORD: return ret + "UPDATE_RECORD";
     default: return ret + "UNKNOWN";
   }
 }
@@ -98,6 +99,23 @@ RC MvccTrxLogHandler::delete_record(int32_t trx_id, Table *table, const RID &rid
       lsn, LogModule::Id::TRANSACTION, span<const char>(reinterpret_cast<const char *>(&log_entry), sizeof(log_entry)));
 }
 
+RC MvccTrxLogHandler::update_record(int32_t trx_id, Table *table, const RID &rid, span<const char> old_data)
+{
+  ASSERT(trx_id > 0, "invalid trx_id:%d", trx_id);
+
+  vector<char> buffer(sizeof(MvccTrxRecordLogEntry) + old_data.size());
+
+  auto *log_entry                  = reinterpret_cast<MvccTrxRecordLogEntry *>(buffer.data());
+  log_entry->header.operation_type = MvccTrxLogOperation(MvccTrxLogOperation::Type::UPDATE_RECORD).index();
+  log_entry->header.trx_id         = trx_id;
+  log_entry->table_id              = table->table_id();
+  log_entry->rid                   = rid;
+  memcpy(buffer.data() + sizeof(MvccTrxRecordLogEntry), old_data.data(), old_data.size());
+
+  LSN lsn = 0;
+  return log_handler_.append(lsn, LogModule::Id::TRANSACTION, std::move(buffer));
+}
+
 RC MvccTrxLogHandler::commit(int32_t trx_id, int32_t commit_trx_id)
 {
   ASSERT(trx_id > 0 && commit_trx_id > trx_id, "invalid trx_id:%d, commit_trx_id:%d", trx_id, commit_trx_id);
@@ -132,6 +150,8 @@ RC MvccTrxLogHandler::rollback(int32_t trx_id)
       lsn, LogModule::Id::TRANSACTION, span<const char>(reinterpret_cast<const char *>(&log_entry), sizeof(log_entry)));
 }
 
+LSN MvccTrxLogHandler::current_lsn() const { return log_handler_.current_lsn(); }
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 MvccTrxLogReplayer::MvccTrxLogReplayer(Db &db, MvccTrxKit &trx_kit, LogHandler &log_handler)
   : db_(db), trx_kit_(trx_kit), log_handler_(log_handler)
@@ -155,7 +175,7 @@ RC MvccTrxLogReplayer::replay(const LogEntry &entry)
   auto trx_iter = trx_map_.find(header->trx_id);
   if (trx_iter == trx_map_.end()) {
     trx = static_cast<MvccTrx *>(trx_kit_.create_trx(log_handler_, header->trx_id));
-    // trx = new MvccTrx(trx_kit_, log_handler_, header->trx_id);
+    trx_map_.emplace(header->trx_id, trx);
   } else {
     trx = trx_iter->second;
   }
@@ -166,7 +186,6 @@ RC MvccTrxLogReplayer::replay(const LogEntry &entry)
   /// 如果事务结束了，需要从内存中把它删除
   if (MvccTrxLogOperation(header->operation_type).type() == MvccTrxLogOperation::Type::ROLLBACK ||
       MvccTrxLogOperation(header->operation_type).type() == MvccTrxLogOperation::Type::COMMIT) {
-    Trx *trx = trx_map_[header->trx_id];
     trx_kit_.destroy_trx(trx);
     trx_map_.erase(header->trx_id);
   }
@@ -180,7 +199,7 @@ RC MvccTrxLogReplayer::on_done()
   for (auto &pair : trx_map_) {
     MvccTrx *trx = pair.second;
     trx->rollback(); // 恢复时的rollback，可能遇到之前已经回滚一半的事务又再次调用回滚的情况
-    delete pair.second;
+    trx_kit_.destroy_trx(trx);
   }
   trx_map_.clear();
 
@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/rc.h"
 #include "common/types.h"
+#include "common/lang/span.h"
 #include "common/lang/string.h"
 #include "common/lang/unordered_map.h"
 #include "storage/record/record.h"
@@ -40,7 +41,8 @@ public:
     INSERT_RECORD,  ///< 插入一条记录
     DELETE_RECORD,  ///< 删除一条记录
     COMMIT,         ///< 提交事务
-    ROLLBACK        ///< 回滚事务
+    ROLLBACK,       ///< 回滚事务
+    UPDATE_RECORD   ///< 原地更新一条记录，日志后面跟着修改之前的数据
   };
 
 public:
@@ -122,6 +124,13 @@ public:
    */
   RC delete_record(int32_t trx_id, Table *table, const RID &rid);
 
+  /**
+   * @brief 记录原地更新一条记录的日志
+   * @details 与插入和删除不同，需要记录修改之前的数据，恢复时用来回滚没有提交的事务
+   * @param old_data 修改之前的记录数据
+   */
+  RC update_record(int32_t trx_id, Table *table, const RID &rid, span<const char> old_data);
+
   /**
    * @brief 记录提交事务的日志
    * @details 会等待日志落地
@@ -134,6 +143,9 @@ public:
    */
   RC rollback(int32_t trx_id);
 
+  /// @brief 当前最大的LSN
+  LSN current_lsn() const;
+
 private:
   LogHandler &log_handler_;
 };
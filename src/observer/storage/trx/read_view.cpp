@@ -0,0 +1,59 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include <algorithm>
+
+#include "storage/trx/read_view.h"
+#include "common/lang/sstream.h"
+
+void ReadView::open(int32_t low_limit, vector<int32_t> committing_xids)
+{
+  std::sort(committing_xids.begin(), committing_xids.end());
+
+  low_limit_       = low_limit;
+  up_limit_        = committing_xids.empty() ? low_limit : std::min(low_limit, committing_xids.front());
+  committing_xids_ = std::move(committing_xids);
+}
+
+void ReadView::close()
+{
+  low_limit_ = 0;
+  up_limit_  = 0;
+  committing_xids_.clear();
+}
+
+bool ReadView::committed_visible(int32_t commit_xid) const
+{
+  if (commit_xid < up_limit_) {
+    return true;
+  }
+  if (commit_xid >= low_limit_) {
+    return false;
+  }
+  return !std::binary_search(committing_xids_.begin(), committing_xids_.end(), commit_xid);
+}
+
+string ReadView::to_string() const
+{
+  stringstream ss;
+  ss << "low_limit:" << low_limit_ << ", up_limit:" << up_limit_ << ", committing:[";
+  for (size_t i = 0; i < committing_xids_.size(); i++) {
+    if (i > 0) {
+      ss << ",";
+    }
+    ss << committing_xids_[i];
+  }
+  ss << "]";
+  return ss.str();
+}
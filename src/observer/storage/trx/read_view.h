@@ -0,0 +1,55 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+
+/**
+ * @brief MVCC 事务的读视图
+ * @ingroup Transaction
+ * @details 事务开始时创建，记录当时哪些提交已经完成。事务号和提交事务号从同一个计数器分配，
+ * 提交事务号不小于 low_limit 的提交发生在读视图创建之后，对读视图不可见；
+ * 创建读视图时正在提交的事务也不可见，这样一个事务的修改要么全部可见，要么全部不可见。
+ */
+class ReadView
+{
+public:
+  ReadView()  = default;
+  ~ReadView() = default;
+
+  /**
+   * @brief 打开读视图
+   * @param low_limit       创建读视图的事务的事务号，以后分配的事务号都比它大
+   * @param committing_xids 正在提交的事务的提交事务号
+   */
+  void open(int32_t low_limit, vector<int32_t> committing_xids);
+  void close();
+
+  bool is_open() const { return low_limit_ > 0; }
+
+  /// 提交事务号为 commit_xid 的提交对读视图是否可见
+  bool committed_visible(int32_t commit_xid) const;
+
+  /// 小于这个值的提交对读视图都可见
+  int32_t up_limit() const { return up_limit_; }
+
+  string to_string() const;
+
+private:
+  int32_t         low_limit_ = 0;
+  int32_t         up_limit_  = 0;
+  vector<int32_t> committing_xids_;  ///< 创建读视图时正在提交的事务，从小到大排列
+};
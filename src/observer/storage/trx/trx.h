@@ -127,6 +127,22 @@ public:
 
   virtual void destroy_trx(Trx *trx) = 0;
 
+  /**
+   * @brief 计算活跃事务写的第一条日志的LSN中最小的那个
+   * @details 做检查点时使用。恢复时需要活跃事务的所有日志才能把它们回滚掉，所以检查点不能超过这个LSN。
+   * @param[in,out] lsn 如果有活跃事务的日志比它更早，就修改为这个事务的第一条日志的LSN
+   */
+  virtual void min_active_lsn(LSN &lsn) = 0;
+
+  /**
+   * @brief 当前已经分配出去的最大事务号
+   * @details 做检查点时记录到数据库元数据中。检查点之前的日志删除之后，重启时不能再从提交日志中恢复事务号
+   */
+  virtual int32_t current_trx_id() const = 0;
+
+  /// @brief 保证后续分配的事务号比 trx_id 大，重启时使用
+  virtual void update_trx_id(int32_t trx_id) = 0;
+
   virtual LogReplayer *create_log_replayer(Db &db, LogHandler &log_handler) = 0;
 
 public:
@@ -144,10 +160,22 @@ public:
   virtual ~Trx() = default;
 
   virtual RC insert_record(Table *table, Record &record)                    = 0;
+  /**
+   * @brief 插入多条记录
+   * @details 使用 Table::insert_records 批量写入页面和索引，比逐条插入的开销小。
+   * 全部插入成功或者全部失败
+   */
+  virtual RC insert_records(Table *table, vector<Record> &records)          = 0;
   virtual RC delete_record(Table *table, Record &record)                    = 0;
   virtual RC update_record(Table *table, Record &record, Record &new_record) = 0;
   virtual RC visit_record(Table *table, Record &record, ReadWriteMode mode) = 0;
 
+  /**
+   * @brief 这条数据是否对当前所有活跃的事务以及以后开启的事务都可见
+   * @details 用于给页面加上 all-visible 标记，参考 RecordFileHandler::try_mark_all_visible
+   */
+  virtual bool visible_to_all(Table *table, const Record &record) = 0;
+
   virtual RC start_if_need() = 0;
   virtual RC commit()        = 0;
   virtual RC rollback()      = 0;
@@ -0,0 +1,123 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include "storage/trx/undo_log.h"
+
+void UndoLog::push(int32_t table_id, const RID &rid, int32_t trx_id, span<const char> data)
+{
+  Version version;
+  version.trx_id = trx_id;
+  version.data.assign(data.begin(), data.end());
+
+  lock_guard<common::Mutex> guard(lock_);
+  versions_[Key{table_id, rid}].push_back(std::move(version));
+  version_num_++;
+}
+
+bool UndoLog::get(int32_t table_id, const RID &rid, int32_t trx_id, vector<char> &data) const
+{
+  lock_guard<common::Mutex> guard(lock_);
+  auto iter = versions_.find(Key{table_id, rid});
+  if (iter == versions_.end()) {
+    return false;
+  }
+
+  for (auto version = iter->second.rbegin(); version != iter->second.rend(); ++version) {
+    if (version->trx_id == trx_id) {
+      data = version->data;
+      return true;
+    }
+  }
+  return false;
+}
+
+void UndoLog::remove(int32_t table_id, const RID &rid, int32_t trx_id)
+{
+  lock_guard<common::Mutex> guard(lock_);
+  auto iter = versions_.find(Key{table_id, rid});
+  if (iter == versions_.end()) {
+    return;
+  }
+
+  VersionChain &chain = iter->second;
+  for (auto version = chain.begin(); version != chain.end(); ++version) {
+    if (version->trx_id == trx_id) {
+      chain.erase(version);
+      version_num_--;
+      break;
+    }
+  }
+  if (chain.empty()) {
+    versions_.erase(iter);
+  }
+}
+
+void UndoLog::commit(int32_t table_id, const RID &rid, int32_t trx_id, int32_t commit_xid)
+{
+  Key key{table_id, rid};
+
+  lock_guard<common::Mutex> guard(lock_);
+  auto iter = versions_.find(key);
+  if (iter == versions_.end()) {
+    return;
+  }
+
+  for (Version &version : iter->second) {
+    if (version.trx_id == trx_id) {
+      version.commit_xid = commit_xid;
+      committed_.push_back(CommittedVersion{key, commit_xid});
+      break;
+    }
+  }
+}
+
+bool UndoLog::find_version(int32_t table_id, const RID &rid, const function<bool(const Version &)> &visitor) const
+{
+  lock_guard<common::Mutex> guard(lock_);
+  auto iter = versions_.find(Key{table_id, rid});
+  if (iter == versions_.end()) {
+    return false;
+  }
+
+  for (auto version = iter->second.rbegin(); version != iter->second.rend(); ++version) {
+    if (visitor(*version)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void UndoLog::purge(int32_t visible_xid_limit)
+{
+  lock_guard<common::Mutex> guard(lock_);
+  while (!committed_.empty() && committed_.front().commit_xid < visible_xid_limit) {
+    const CommittedVersion &committed = committed_.front();
+
+    auto iter = versions_.find(committed.key);
+    if (iter != versions_.end()) {
+      // 同一条记录上更早提交的版本也都可以清理掉
+      VersionChain &chain = iter->second;
+      size_t        num   = 0;
+      while (num < chain.size() && chain[num].commit_xid != 0 && chain[num].commit_xid <= committed.commit_xid) {
+        num++;
+      }
+      chain.erase(chain.begin(), chain.begin() + num);
+      version_num_ -= num;
+      if (chain.empty()) {
+        versions_.erase(iter);
+      }
+    }
+    committed_.pop_front();
+  }
+}
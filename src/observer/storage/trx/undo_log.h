@@ -0,0 +1,105 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+
+#include "common/lang/atomic.h"
+#include "common/lang/deque.h"
+#include "common/lang/functional.h"
+#include "common/lang/mutex.h"
+#include "common/lang/span.h"
+#include "common/lang/unordered_map.h"
+#include "common/lang/vector.h"
+#include "storage/record/record.h"
+
+/**
+ * @brief 记录被原地更新之前的版本
+ * @ingroup Transaction
+ * @details MVCC 事务原地更新一条记录时，把修改之前的数据保存在这里。同一条记录的多个旧版本组成一个版本链，
+ * 其它事务看不到记录上的当前版本时，沿着版本链从新到旧找到自己可以看到的版本。
+ * 修改的事务提交之后，所有打开的读视图都能看到新版本时，旧版本就会被清理掉。
+ * 旧版本只保存在内存中，重启时由事务日志恢复还没有提交的事务保存的旧版本。
+ */
+class UndoLog
+{
+public:
+  struct Version
+  {
+    int32_t      trx_id     = 0;  ///< 修改记录的事务
+    int32_t      commit_xid = 0;  ///< 修改记录的事务提交时的事务号，还没有提交时是0
+    vector<char> data;            ///< 修改之前的记录数据，包含事务字段
+  };
+
+public:
+  UndoLog()  = default;
+  ~UndoLog() = default;
+
+  /// 保存事务 trx_id 修改记录之前的数据，每个事务对同一条记录只需要保存一次
+  void push(int32_t table_id, const RID &rid, int32_t trx_id, span<const char> data);
+
+  /// 获取事务 trx_id 修改记录之前的数据
+  bool get(int32_t table_id, const RID &rid, int32_t trx_id, vector<char> &data) const;
+
+  /// 删除事务 trx_id 保存的版本，事务回滚时使用
+  void remove(int32_t table_id, const RID &rid, int32_t trx_id);
+
+  /// 事务 trx_id 提交了，记录下提交时的事务号，以后可以清理
+  void commit(int32_t table_id, const RID &rid, int32_t trx_id, int32_t commit_xid);
+
+  /**
+   * @brief 从新到旧遍历一条记录的旧版本
+   * @details 遍历期间持有锁，visitor 中不能再访问 UndoLog
+   * @param visitor 返回 true 时停止遍历
+   * @return 是否有 visitor 返回了 true
+   */
+  bool find_version(int32_t table_id, const RID &rid, const function<bool(const Version &)> &visitor) const;
+
+  /**
+   * @brief 清理提交事务号小于 visible_xid_limit 的版本
+   * @details 这些提交对所有的读视图都可见，不会再有事务读取旧版本，参考 MvccTrxKit::visible_xid_limit
+   */
+  void purge(int32_t visible_xid_limit);
+
+  /// 保存的版本数，包括还没有提交的
+  int64_t version_num() const { return version_num_.load(); }
+
+private:
+  struct Key
+  {
+    int32_t table_id;
+    RID     rid;
+
+    bool operator==(const Key &other) const { return table_id == other.table_id && rid == other.rid; }
+  };
+
+  struct KeyHash
+  {
+    size_t operator()(const Key &key) const noexcept { return RIDHash()(key.rid) ^ hash<int32_t>()(key.table_id); }
+  };
+
+  /// 一条记录的旧版本，最新的版本在最后面
+  using VersionChain = vector<Version>;
+
+  struct CommittedVersion
+  {
+    Key     key;
+    int32_t commit_xid;
+  };
+
+private:
+  mutable common::Mutex                     lock_;
+  unordered_map<Key, VersionChain, KeyHash> versions_;
+  deque<CommittedVersion>                   committed_;  ///< 按照提交顺序排列，用来清理
+  atomic<int64_t>                           version_num_{0};
+};
@@ -28,12 +28,16 @@ Trx *VacuousTrxKit::find_trx(int32_t /* trx_id */) { return nullptr; }
 
 void VacuousTrxKit::all_trxes(vector<Trx *> &trxes) { return; }
 
+void VacuousTrxKit::min_active_lsn(LSN &/* lsn */) {}
+
 LogReplayer *VacuousTrxKit::create_log_replayer(Db &, LogHandler &) { return new VacuousTrxLogReplayer; }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 RC VacuousTrx::insert_record(Table *table, Record &record) { return table->insert_record(record); }
 
+RC VacuousTrx::insert_records(Table *table, vector<Record> &records) { return table->insert_records(records); }
+
 RC VacuousTrx::delete_record(Table *table, Record &record) { return table->delete_record(record); }
 
 RC VacuousTrx::update_record(Table *table, Record &record, Record& new_record) { return table->update_record(record, new_record); }
@@ -35,6 +35,11 @@ public:
 
   void destroy_trx(Trx *trx) override;
 
+  void min_active_lsn(LSN &lsn) override;
+
+  int32_t current_trx_id() const override { return 0; }
+  void    update_trx_id(int32_t /* trx_id */) override {}
+
   LogReplayer *create_log_replayer(Db &db, LogHandler &log_handler) override;
 };
 
@@ -45,9 +50,11 @@ public:
   virtual ~VacuousTrx() = default;
 
   RC insert_record(Table *table, Record &record) override;
+  RC insert_records(Table *table, vector<Record> &records) override;
   RC delete_record(Table *table, Record &record) override;
   RC update_record(Table *table, Record &record, Record &new_record) override;
   RC visit_record(Table *table, Record &record, ReadWriteMode mode) override;
+  bool visible_to_all(Table *table, const Record &record) override { return true; }
   RC start_if_need() override;
   RC commit() override;
   RC rollback() override;
@@ -0,0 +1,85 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2024/07/20.
+//
+
+#include "common/lang/segmented_lru_cache.h"
+#include "common/lang/vector.h"
+#include "gtest/gtest.h"
+
+using namespace common;
+
+static vector<int> eviction_order(SegmentedLruCache<int, int> &cache)
+{
+  vector<int> keys;
+  cache.foreach_reverse([&keys](const int &key, const int &) {
+    keys.push_back(key);
+    return true;
+  });
+  return keys;
+}
+
+TEST(segmented_lru_cache, get_put_remove)
+{
+  SegmentedLruCache<int, int> cache;
+  for (int i = 0; i < 10; i++) {
+    cache.put(i, i * 10);
+  }
+  ASSERT_EQ(cache.count(), 10);
+
+  int value = 0;
+  ASSERT_TRUE(cache.get(3, value));
+  ASSERT_EQ(value, 30);
+  ASSERT_FALSE(cache.get(100, value));
+
+  cache.remove(3);
+  ASSERT_FALSE(cache.get(3, value));
+  ASSERT_EQ(cache.count(), 9);
+
+  cache.put(4, 400);
+  ASSERT_TRUE(cache.get(4, value));
+  ASSERT_EQ(value, 400);
+
+  cache.destroy();
+  ASSERT_EQ(cache.count(), 0);
+}
+
+TEST(segmented_lru_cache, scan_resistant)
+{
+  SegmentedLruCache<int, int> cache;
+
+  // 0~3 被反复访问，是热点数据
+  for (int i = 0; i < 4; i++) {
+    cache.put(i, i);
+  }
+  int value = 0;
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(cache.get(i, value));
+  }
+  ASSERT_EQ(cache.protected_count(), 3);  // 4 * 80%
+
+  // 模拟一次扫描，每个元素只访问一次
+  for (int i = 100; i < 110; i++) {
+    cache.put(i, i);
+  }
+
+  // 扫描的数据应该先于热点数据被淘汰
+  vector<int> order = eviction_order(cache);
+  ASSERT_EQ(order.size(), 14);
+  ASSERT_EQ(order[0], 0);  // 被降级到试用段的热点数据
+  for (int i = 1; i <= 10; i++) {
+    ASSERT_EQ(order[i], 100 + i - 1);
+  }
+  ASSERT_EQ(order[11], 1);
+  ASSERT_EQ(order[12], 2);
+  ASSERT_EQ(order[13], 3);
+}
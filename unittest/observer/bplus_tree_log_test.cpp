@@ -19,6 +19,7 @@ See the Mulan PSL v2 for more details. */
 #include "gtest/gtest.h"
 #include "storage/index/bplus_tree_log.h"
 #include "storage/index/bplus_tree.h"
+#include "storage/index/bplus_tree_bulk_loader.h"
 #include "storage/clog/disk_log_handler.h"
 #include "storage/clog/integrated_log_replayer.h"
 #include "common/math/integer_generator.h"
@@ -156,6 +157,173 @@ TEST(BplusTreeLog, base)
   log_handler2.reset();
 }
 
+TEST(BplusTreeLog, prefix_leaf)
+{
+  filesystem::path test_directory = "bplus_tree_log_test_dir";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  const filesystem::path bp_filename   = test_directory / "bplus_tree.bp";
+  const filesystem::path log_directory = test_directory / "clog";
+
+  auto bpm = make_unique<BufferPoolManager>();
+  ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+  DiskBufferPool *buffer_pool = nullptr;
+  auto            log_handler = make_unique<DiskLogHandler>();
+  ASSERT_EQ(RC::SUCCESS, bpm->create_file(bp_filename.c_str()));
+  ASSERT_EQ(RC::SUCCESS, bpm->open_file(*log_handler, bp_filename.c_str(), buffer_pool));
+  ASSERT_EQ(RC::SUCCESS, log_handler->init(log_directory.c_str()));
+
+  IntegratedLogReplayer log_replayer(*bpm);
+  ASSERT_EQ(RC::SUCCESS, log_handler->replay(log_replayer, 0));
+  ASSERT_EQ(RC::SUCCESS, log_handler->start());
+
+  // 字符串键值，叶子节点使用前缀压缩的格式
+  const int attr_length = 32;
+  auto      bplus_tree  = make_unique<BplusTreeHandler>();
+  ASSERT_EQ(RC::SUCCESS, bplus_tree->create(*log_handler, *buffer_pool, AttrType::CHARS, attr_length));
+  ASSERT_EQ(IndexFileHeader::LEAF_FORMAT_PREFIX, bplus_tree->file_header().leaf_format);
+
+  auto make_user_key = [](int i) {
+    string key(attr_length, '\0');
+    snprintf(key.data(), key.size(), "/data/user/%08d", i);
+    return key;
+  };
+
+  const int   insert_num = 10000;
+  vector<int> keys(insert_num);
+  for (int i = 0; i < insert_num; i++) {
+    keys[i] = i;
+  }
+  mt19937 generator(0);
+  shuffle(keys.begin(), keys.end(), generator);
+
+  for (int i : keys) {
+    RID rid(i, i);
+    ASSERT_EQ(RC::SUCCESS, bplus_tree->insert_entry(make_user_key(i).data(), &rid));
+  }
+  // 删除一部分，让节点合并或者重新分配
+  for (int i : keys) {
+    if (i % 3 != 0) {
+      RID rid(i, i);
+      ASSERT_EQ(RC::SUCCESS, bplus_tree->delete_entry(make_user_key(i).data(), &rid));
+    }
+  }
+
+  ASSERT_EQ(log_handler->stop(), RC::SUCCESS);
+  ASSERT_EQ(log_handler->await_termination(), RC::SUCCESS);
+
+  bplus_tree.reset();
+  bpm.reset();
+  log_handler.reset();
+
+  // 使用原始的文件，重新回放日志
+  const filesystem::path bp_filename2 = test_directory / "bplus_tree2.bp";
+  ASSERT_TRUE(filesystem::copy_file(bp_filename, bp_filename2));
+
+  auto bpm2 = make_unique<BufferPoolManager>();
+  ASSERT_EQ(RC::SUCCESS, bpm2->init(make_unique<VacuousDoubleWriteBuffer>()));
+  auto            log_handler2 = make_unique<DiskLogHandler>();
+  DiskBufferPool *buffer_pool2 = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm2->open_file(*log_handler2, bp_filename2.c_str(), buffer_pool2));
+  ASSERT_EQ(RC::SUCCESS, log_handler2->init(log_directory.c_str()));
+
+  IntegratedLogReplayer log_replayer2(*bpm2);
+  ASSERT_EQ(RC::SUCCESS, log_handler2->replay(log_replayer2, 0));
+
+  auto tree_handler2 = make_unique<BplusTreeHandler>();
+  ASSERT_EQ(RC::SUCCESS, tree_handler2->open(*log_handler2, *buffer_pool2));
+  ASSERT_TRUE(tree_handler2->validate_tree());
+
+  vector<RID> rids;
+  ASSERT_EQ(RC::SUCCESS, list_all_values(*tree_handler2, rids));
+  ASSERT_EQ((insert_num + 2) / 3, static_cast<int>(rids.size()));
+  for (size_t i = 0; i < rids.size(); i++) {
+    ASSERT_EQ(static_cast<int>(i) * 3, rids[i].page_num);
+  }
+
+  tree_handler2.reset();
+  bpm2.reset();
+  log_handler2.reset();
+}
+
+TEST(BplusTreeLog, bulk_load)
+{
+  filesystem::path test_directory = "bplus_tree_log_test_dir";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  const filesystem::path bp_filename   = test_directory / "bplus_tree.bp";
+  const filesystem::path log_directory = test_directory / "clog";
+
+  auto bpm = make_unique<BufferPoolManager>();
+  ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+  DiskBufferPool *buffer_pool = nullptr;
+  auto            log_handler = make_unique<DiskLogHandler>();
+  ASSERT_EQ(RC::SUCCESS, bpm->create_file(bp_filename.c_str()));
+  ASSERT_EQ(RC::SUCCESS, bpm->open_file(*log_handler, bp_filename.c_str(), buffer_pool));
+  ASSERT_EQ(RC::SUCCESS, log_handler->init(log_directory.c_str()));
+
+  IntegratedLogReplayer log_replayer(*bpm);
+  ASSERT_EQ(RC::SUCCESS, log_handler->replay(log_replayer, 0));
+  ASSERT_EQ(RC::SUCCESS, log_handler->start());
+
+  auto bplus_tree = make_unique<BplusTreeHandler>();
+  ASSERT_EQ(RC::SUCCESS, bplus_tree->create(*log_handler, *buffer_pool, AttrType::INTS, sizeof(int)));
+
+  const int   insert_num = 20000;
+  vector<int> keys(insert_num);
+  for (int i = 0; i < insert_num; i++) {
+    keys[i] = i;
+  }
+  mt19937 generator(0);
+  shuffle(keys.begin(), keys.end(), generator);
+
+  // 批量构建时每个节点的数据一次性写入，日志也是以页面为单位记录的
+  BplusTreeBulkLoader loader(*bplus_tree, 64 * 1024);
+  for (int i : keys) {
+    ASSERT_EQ(RC::SUCCESS, loader.add(reinterpret_cast<const char *>(&i), RID(i, i)));
+  }
+  ASSERT_EQ(RC::SUCCESS, loader.finish());
+  ASSERT_TRUE(bplus_tree->validate_tree());
+
+  ASSERT_EQ(log_handler->stop(), RC::SUCCESS);
+  ASSERT_EQ(log_handler->await_termination(), RC::SUCCESS);
+
+  bplus_tree.reset();
+  bpm.reset();
+  log_handler.reset();
+
+  // 使用原始的文件，重新回放日志
+  const filesystem::path bp_filename2 = test_directory / "bplus_tree2.bp";
+  ASSERT_TRUE(filesystem::copy_file(bp_filename, bp_filename2));
+
+  auto bpm2 = make_unique<BufferPoolManager>();
+  ASSERT_EQ(RC::SUCCESS, bpm2->init(make_unique<VacuousDoubleWriteBuffer>()));
+  auto            log_handler2 = make_unique<DiskLogHandler>();
+  DiskBufferPool *buffer_pool2 = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm2->open_file(*log_handler2, bp_filename2.c_str(), buffer_pool2));
+  ASSERT_EQ(RC::SUCCESS, log_handler2->init(log_directory.c_str()));
+
+  IntegratedLogReplayer log_replayer2(*bpm2);
+  ASSERT_EQ(RC::SUCCESS, log_handler2->replay(log_replayer2, 0));
+
+  auto tree_handler2 = make_unique<BplusTreeHandler>();
+  ASSERT_EQ(RC::SUCCESS, tree_handler2->open(*log_handler2, *buffer_pool2));
+  ASSERT_TRUE(tree_handler2->validate_tree());
+
+  vector<RID> rids;
+  ASSERT_EQ(RC::SUCCESS, list_all_values(*tree_handler2, rids));
+  ASSERT_EQ(insert_num, static_cast<int>(rids.size()));
+  for (size_t i = 0; i < rids.size(); i++) {
+    ASSERT_EQ(static_cast<int>(i), rids[i].page_num);
+  }
+
+  tree_handler2.reset();
+  bpm2.reset();
+  log_handler2.reset();
+}
+
 TEST(BplusTreeLog, concurrency)
 {
   filesystem::path test_directory      = "bplus_tree_log_test_dir";
@@ -267,8 +435,10 @@ TEST(BplusTreeLog, concurrency)
   }
 
   ASSERT_EQ(RC::SUCCESS, log_handler2->init(log_directory.c_str()));
-  IntegratedLogReplayer log_replayer2(*bpm2);
+  // 多个索引文件的日志由多个线程并行回放
+  IntegratedLogReplayer log_replayer2(*bpm2, 4 /*worker_num*/);
   ASSERT_EQ(RC::SUCCESS, log_handler2->replay(log_replayer2, 0));
+  ASSERT_EQ(RC::SUCCESS, log_replayer2.on_done());
 
   vector<unique_ptr<BplusTreeHandler>> bplus_trees2;
   for (DiskBufferPool *buffer_pool : buffer_pools2) {
@@ -15,13 +15,16 @@ See the Mulan PSL v2 for more details. */
 #include <iostream>
 #include <list>
 #include <filesystem>
+#include <random>
 
 #include "common/log/log.h"
 #include "common/lang/memory.h"
 #include "common/lang/filesystem.h"
+#include "common/lang/limits.h"
 #include "sql/parser/parse_defs.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/index/bplus_tree.h"
+#include "storage/index/bplus_tree_bulk_loader.h"
 #include "storage/clog/vacuous_log_handler.h"
 #include "storage/buffer/double_write_buffer.h"
 #include "gtest/gtest.h"
@@ -793,6 +796,703 @@ TEST(test_bplus_tree, test_scanner)
   handler.close();
 }
 
+TEST(test_bplus_tree, test_scanner_batch)
+{
+  LoggerFactory::init_default("test.log");
+
+  filesystem::path test_directory("bplus_tree");
+  filesystem::path buffer_pool_file = test_directory / "scanner_batch.btree";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(buffer_pool_file.c_str()));
+
+  DiskBufferPool *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, buffer_pool_file.c_str(), buffer_pool));
+  ASSERT_NE(nullptr, buffer_pool);
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(log_handler, *buffer_pool, AttrType::INTS, sizeof(int), ORDER, ORDER));
+
+  // 插入数据[1 - 199] 所有奇数，数据分布在多个叶子节点上
+  RID rid;
+  for (int i = 0; i < 100; i++) {
+    int key      = i * 2 + 1;
+    rid.page_num = 0;
+    rid.slot_num = key;
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&key, &rid));
+  }
+
+  // 批量返回的数据与逐条返回的数据应该完全相同
+  const vector<pair<int, int>> ranges = {{-100, -20}, {-100, 1}, {1, 3}, {11, 91}, {191, 201}, {200, 301}, {0, 300}};
+  for (const auto &[begin, end] : ranges) {
+    vector<int> expected;
+    {
+      BplusTreeScanner scanner(handler);
+      ASSERT_EQ(RC::SUCCESS, scanner.open((const char *)&begin, 4, true, (const char *)&end, 4, true));
+      RC rc = RC::SUCCESS;
+      while ((rc = scanner.next_entry(rid)) == RC::SUCCESS) {
+        expected.push_back(rid.slot_num);
+      }
+      ASSERT_EQ(RC::RECORD_EOF, rc);
+    }
+
+    for (int batch_size : {1, 3, 1000}) {
+      BplusTreeScanner scanner(handler);
+      ASSERT_EQ(RC::SUCCESS, scanner.open((const char *)&begin, 4, true, (const char *)&end, 4, true));
+
+      vector<int> actual;
+      vector<RID> rids;
+      RC          rc = RC::SUCCESS;
+      while ((rc = scanner.next_entries(rids, batch_size)) == RC::SUCCESS) {
+        ASSERT_FALSE(rids.empty());
+        ASSERT_LE(static_cast<int>(rids.size()), batch_size);
+        for (const RID &item : rids) {
+          actual.push_back(item.slot_num);
+        }
+      }
+      ASSERT_EQ(RC::RECORD_EOF, rc);
+      ASSERT_TRUE(rids.empty());
+      ASSERT_EQ(expected, actual) << "begin=" << begin << ", end=" << end << ", batch size=" << batch_size;
+
+      // 遍历结束之后继续调用也是 RECORD_EOF
+      ASSERT_EQ(RC::RECORD_EOF, scanner.next_entries(rids, batch_size));
+    }
+  }
+
+  // 先逐条获取，再批量获取
+  {
+    BplusTreeScanner scanner(handler);
+    ASSERT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, true, nullptr, 0, true));
+    ASSERT_EQ(RC::SUCCESS, scanner.next_entry(rid));
+    ASSERT_EQ(1, rid.slot_num);
+
+    // 每次最多返回一个叶子节点中的数据
+    vector<RID> rids;
+    ASSERT_EQ(RC::SUCCESS, scanner.next_entries(rids, 2));
+    ASSERT_FALSE(rids.empty());
+    ASSERT_LE(static_cast<int>(rids.size()), 2);
+    for (size_t i = 0; i < rids.size(); i++) {
+      ASSERT_EQ(3 + static_cast<int>(i) * 2, rids[i].slot_num);
+    }
+
+    ASSERT_EQ(RC::SUCCESS, scanner.next_entry(rid));
+    ASSERT_EQ(rids.back().slot_num + 2, rid.slot_num);
+  }
+
+  handler.close();
+}
+
+TEST(test_bplus_tree, test_composite_key)
+{
+  LoggerFactory::init_default("test.log");
+
+  filesystem::path test_directory("bplus_tree");
+  filesystem::path buffer_pool_file = test_directory / "composite.btree";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+  // 键值是 (chars(4), int)
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS,
+      handler.create(log_handler,
+          bpm,
+          buffer_pool_file.c_str(),
+          vector<AttrType>{AttrType::CHARS, AttrType::INTS},
+          vector<int>{4, sizeof(int)},
+          ORDER,
+          ORDER));
+
+  auto make_user_key = [](const char *s, int v) {
+    string key(4 + sizeof(int), '\0');
+    memcpy(key.data(), s, strlen(s));
+    memcpy(key.data() + 4, &v, sizeof(v));
+    return key;
+  };
+
+  // 插入 ("a".."j") x [0, 100)，第二个字段的顺序与第一个字段的顺序无关
+  const char *prefixes[] = {"a", "b", "c", "d", "e", "f", "g", "h", "i", "j"};
+  RID         rid;
+  for (int v = 99; v >= 0; v--) {
+    for (int p = 0; p < 10; p++) {
+      rid.page_num = p;
+      rid.slot_num = v;
+      ASSERT_EQ(RC::SUCCESS, handler.insert_entry(make_user_key(prefixes[p], v).data(), &rid));
+    }
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  // 扫描 ("c", 10) < key <= ("c", 20)，结果按照第二个字段有序
+  BplusTreeScanner scanner(handler);
+  string           left  = make_user_key("c", 10);
+  string           right = make_user_key("c", 20);
+  ASSERT_EQ(RC::SUCCESS, scanner.open(left.data(), left.size(), false, right.data(), right.size(), true));
+  int  count = 0;
+  RC   rc    = RC::SUCCESS;
+  while ((rc = scanner.next_entry(rid)) == RC::SUCCESS) {
+    ASSERT_EQ(2, rid.page_num);
+    ASSERT_EQ(11 + count, rid.slot_num);
+    count++;
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  ASSERT_EQ(10, count);
+  scanner.close();
+
+  // 只固定第一个字段 "e"，第二个字段取最小值和最大值
+  left  = make_user_key("e", numeric_limits<int>::min());
+  right = make_user_key("e", numeric_limits<int>::max());
+  ASSERT_EQ(RC::SUCCESS, scanner.open(left.data(), left.size(), true, right.data(), right.size(), true));
+  count = 0;
+  while ((rc = scanner.next_entry(rid)) == RC::SUCCESS) {
+    ASSERT_EQ(4, rid.page_num);
+    count++;
+  }
+  ASSERT_EQ(100, count);
+  scanner.close();
+
+  // 删除之后再扫描
+  for (int v = 0; v < 50; v++) {
+    rid.page_num = 4;
+    rid.slot_num = v;
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry(make_user_key("e", v).data(), &rid));
+  }
+  ASSERT_EQ(RC::SUCCESS, scanner.open(left.data(), left.size(), true, right.data(), right.size(), true));
+  count = 0;
+  while ((rc = scanner.next_entry(rid)) == RC::SUCCESS) {
+    ASSERT_EQ(50 + count, rid.slot_num);
+    count++;
+  }
+  ASSERT_EQ(50, count);
+  scanner.close();
+
+  handler.close();
+}
+
+TEST(test_bplus_tree, test_include_data)
+{
+  LoggerFactory::init_default("test.log");
+
+  filesystem::path test_directory("bplus_tree");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+  // 包含列是两个int
+  const int include_length = 2 * sizeof(int);
+  auto      make_include   = [](int v) {
+    string include(2 * sizeof(int), '\0');
+    const int values[2] = {v * 10, v * 100};
+    memcpy(include.data(), values, sizeof(values));
+    return include;
+  };
+  auto check_include = [](const char *include, int v) {
+    int values[2];
+    memcpy(values, include, sizeof(values));
+    ASSERT_EQ(v * 10, values[0]);
+    ASSERT_EQ(v * 100, values[1]);
+  };
+
+  // 包含列太长时不能创建
+  {
+    BplusTreeHandler handler;
+    filesystem::path file = test_directory / "include_too_long.btree";
+    ASSERT_EQ(RC::INVALID_ARGUMENT,
+        handler.create(log_handler, bpm, file.c_str(), vector<AttrType>{AttrType::INTS}, vector<int>{sizeof(int)},
+            -1, -1, BP_PAGE_DATA_SIZE / 4));
+  }
+
+  // 逐条插入，节点会不断地分裂，重新打开之后包含列的长度不变
+  filesystem::path ints_file = test_directory / "include_ints.btree";
+  {
+    BplusTreeHandler handler;
+    ASSERT_EQ(RC::SUCCESS,
+        handler.create(log_handler, bpm, ints_file.c_str(), vector<AttrType>{AttrType::INTS},
+            vector<int>{sizeof(int)}, ORDER, ORDER, include_length));
+
+    for (int v = 999; v >= 0; v--) {
+      RID rid(v, v % 7);
+      ASSERT_EQ(RC::SUCCESS,
+          handler.insert_entry(reinterpret_cast<const char *>(&v), &rid, make_include(v).data()));
+    }
+    ASSERT_TRUE(handler.validate_tree());
+
+    for (int v = 0; v < 1000; v += 2) {
+      RID rid(v, v % 7);
+      ASSERT_EQ(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&v), &rid));
+    }
+    ASSERT_TRUE(handler.validate_tree());
+    handler.close();
+  }
+  {
+    BplusTreeHandler handler;
+    ASSERT_EQ(RC::SUCCESS, handler.open(log_handler, bpm, ints_file.c_str()));
+
+    BplusTreeScanner scanner(handler);
+    ASSERT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, true, nullptr, 0, true));
+    RID  rid;
+    int  key   = 0;
+    char include[include_length];
+    int  count = 0;
+    RC   rc    = RC::SUCCESS;
+    while ((rc = scanner.next_entry(rid, reinterpret_cast<char *>(&key), include)) == RC::SUCCESS) {
+      const int v = 2 * count + 1;
+      ASSERT_EQ(v, key);
+      ASSERT_EQ(RID(v, v % 7), rid);
+      check_include(include, v);
+      count++;
+    }
+    ASSERT_EQ(RC::RECORD_EOF, rc);
+    ASSERT_EQ(500, count);
+    scanner.close();
+    handler.close();
+  }
+
+  // 前缀压缩格式的叶子节点，包含列跟在 RID 后面
+  {
+    BplusTreeHandler handler;
+    filesystem::path file = test_directory / "include_chars.btree";
+    ASSERT_EQ(RC::SUCCESS,
+        handler.create(log_handler, bpm, file.c_str(), vector<AttrType>{AttrType::CHARS}, vector<int>{16},
+            -1, -1, include_length));
+
+    auto make_user_key = [](int v) {
+      string key(16, '\0');
+      snprintf(key.data(), key.size(), "user_%06d", v);
+      return key;
+    };
+    for (int v = 0; v < 3000; v++) {
+      RID rid(v, 0);
+      ASSERT_EQ(RC::SUCCESS, handler.insert_entry(make_user_key(v).data(), &rid, make_include(v).data()));
+    }
+    ASSERT_TRUE(handler.validate_tree());
+
+    BplusTreeScanner scanner(handler);
+    string           left = make_user_key(1000);
+    ASSERT_EQ(RC::SUCCESS, scanner.open(left.data(), left.size(), true, nullptr, 0, true));
+    RID  rid;
+    char key[16];
+    char include[include_length];
+    int  count = 0;
+    RC   rc    = RC::SUCCESS;
+    while ((rc = scanner.next_entry(rid, key, include)) == RC::SUCCESS) {
+      const int v = 1000 + count;
+      ASSERT_EQ(0, memcmp(make_user_key(v).data(), key, sizeof(key)));
+      ASSERT_EQ(v, rid.page_num);
+      check_include(include, v);
+      count++;
+    }
+    ASSERT_EQ(RC::RECORD_EOF, rc);
+    ASSERT_EQ(2000, count);
+    scanner.close();
+    handler.close();
+  }
+
+  // 批量构建
+  {
+    BplusTreeHandler handler;
+    filesystem::path file = test_directory / "include_bulk_load.btree";
+    ASSERT_EQ(RC::SUCCESS,
+        handler.create(log_handler, bpm, file.c_str(), vector<AttrType>{AttrType::INTS}, vector<int>{sizeof(int)},
+            -1, -1, include_length));
+
+    BplusTreeBulkLoader loader(handler, 64 * 1024);
+    for (int v = 4999; v >= 0; v--) {
+      ASSERT_EQ(RC::SUCCESS, loader.add(reinterpret_cast<const char *>(&v), RID(v, 0), make_include(v).data()));
+    }
+    ASSERT_EQ(RC::SUCCESS, loader.finish());
+    ASSERT_TRUE(handler.validate_tree());
+
+    BplusTreeScanner scanner(handler);
+    ASSERT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, true, nullptr, 0, true));
+    RID  rid;
+    char include[include_length];
+    int  count = 0;
+    RC   rc    = RC::SUCCESS;
+    while ((rc = scanner.next_entry(rid, nullptr, include)) == RC::SUCCESS) {
+      ASSERT_EQ(count, rid.page_num);
+      check_include(include, count);
+      count++;
+    }
+    ASSERT_EQ(RC::RECORD_EOF, rc);
+    ASSERT_EQ(5000, count);
+    scanner.close();
+    handler.close();
+  }
+}
+
+TEST(test_bplus_tree, test_prefix_leaf)
+{
+  LoggerFactory::init_default("test.log");
+
+  filesystem::path test_directory("bplus_tree");
+  filesystem::path buffer_pool_file = test_directory / "prefix_leaf.btree";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(buffer_pool_file.c_str()));
+
+  DiskBufferPool *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, buffer_pool_file.c_str(), buffer_pool));
+  ASSERT_NE(nullptr, buffer_pool);
+
+  // 字符串键值有很长的公共前缀，叶子节点使用前缀压缩的格式
+  const int        attr_length = 64;
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(log_handler, *buffer_pool, AttrType::CHARS, attr_length));
+  ASSERT_EQ(IndexFileHeader::LEAF_FORMAT_PREFIX, handler.file_header().leaf_format);
+
+  auto make_user_key = [](int i) {
+    string key(attr_length, '\0');
+    snprintf(key.data(), key.size(), "https://www.example.com/users/%06d/profile", i);
+    return key;
+  };
+
+  const int   insert_num = 20000;
+  vector<int> values(insert_num);
+  for (int i = 0; i < insert_num; i++) {
+    values[i] = i;
+  }
+  std::mt19937 generator(0);
+  shuffle(values.begin(), values.end(), generator);
+
+  for (int i : values) {
+    RID rid(i / 1000, i % 1000);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(make_user_key(i).data(), &rid));
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  // 定长格式的叶子节点全部装满也至少需要这么多页面
+  const int plain_leaf_capacity = (BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE) / (attr_length + 2 * sizeof(RID));
+  ASSERT_LT(buffer_pool->allocated_pages(), insert_num / plain_leaf_capacity);
+
+  list<RID> rids;
+  for (int i = 0; i < insert_num; i += 7) {
+    rids.clear();
+    ASSERT_EQ(RC::SUCCESS, handler.get_entry(make_user_key(i).data(), attr_length, rids));
+    ASSERT_EQ(1, rids.size());
+    ASSERT_EQ(RID(i / 1000, i % 1000), rids.front());
+  }
+
+  // 重复的键值和没有公共前缀的键值
+  RID    rid(1000, 0);
+  string other_key(attr_length, '\0');
+  memcpy(other_key.data(), "ftp://", 6);
+  ASSERT_EQ(RC::SUCCESS, handler.insert_entry(make_user_key(100).data(), &rid));
+  ASSERT_EQ(RC::SUCCESS, handler.insert_entry(other_key.data(), &rid));
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler.insert_entry(other_key.data(), &rid));
+  ASSERT_TRUE(handler.validate_tree());
+
+  {
+    // 扫描器销毁时才会释放页面上的锁
+    BplusTreeScanner scanner(handler);
+    string           left  = make_user_key(1000);
+    string           right = make_user_key(1999);
+    ASSERT_EQ(RC::SUCCESS, scanner.open(left.data(), attr_length, true, right.data(), attr_length, false));
+    int count = 0;
+    RC  rc    = RC::SUCCESS;
+    while ((rc = scanner.next_entry(rid)) == RC::SUCCESS) {
+      ASSERT_EQ(RID(1, count), rid);
+      count++;
+    }
+    ASSERT_EQ(RC::RECORD_EOF, rc);
+    ASSERT_EQ(999, count);
+    scanner.close();
+  }
+
+  // 删除一半之后节点需要合并或者重新分配
+  for (int i : values) {
+    if (i % 2 == 0) {
+      RID rid(i / 1000, i % 1000);
+      ASSERT_EQ(RC::SUCCESS, handler.delete_entry(make_user_key(i).data(), &rid));
+    }
+  }
+  ASSERT_TRUE(handler.validate_tree());
+  for (int i = 0; i < insert_num; i += 3) {
+    rids.clear();
+    ASSERT_EQ(RC::SUCCESS, handler.get_entry(make_user_key(i).data(), attr_length, rids));
+    ASSERT_EQ(i % 2 == 0 ? 0 : 1, static_cast<int>(rids.size()));
+  }
+
+  for (int i : values) {
+    if (i % 2 == 1) {
+      RID rid(i / 1000, i % 1000);
+      ASSERT_EQ(RC::SUCCESS, handler.delete_entry(make_user_key(i).data(), &rid));
+    }
+  }
+  rid = RID(1000, 0);
+  ASSERT_EQ(RC::SUCCESS, handler.delete_entry(make_user_key(100).data(), &rid));
+  ASSERT_EQ(RC::SUCCESS, handler.delete_entry(other_key.data(), &rid));
+  ASSERT_TRUE(handler.is_empty());
+
+  handler.close();
+}
+
+TEST(test_bplus_tree, test_bulk_load)
+{
+  LoggerFactory::init_default("test.log");
+
+  filesystem::path test_directory("bplus_tree");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+  auto open_file = [&](const char *name, DiskBufferPool *&buffer_pool) {
+    filesystem::path file = test_directory / name;
+    ASSERT_EQ(RC::SUCCESS, bpm.create_file(file.c_str()));
+    ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, file.c_str(), buffer_pool));
+    ASSERT_NE(nullptr, buffer_pool);
+  };
+
+  // 每个键值重复多次，RID 不同。内存限制很小，排序时会写很多临时文件
+  {
+    DiskBufferPool *buffer_pool = nullptr;
+    open_file("bulk_load_ints.btree", buffer_pool);
+
+    BplusTreeHandler handler;
+    ASSERT_EQ(RC::SUCCESS, handler.create(log_handler, *buffer_pool, AttrType::INTS, sizeof(int)));
+
+    const int   insert_num = 30000;
+    vector<int> values(insert_num);
+    for (int i = 0; i < insert_num; i++) {
+      values[i] = i;
+    }
+    std::mt19937 generator(0);
+    shuffle(values.begin(), values.end(), generator);
+
+    BplusTreeBulkLoader loader(handler, 64 * 1024);
+    for (int i : values) {
+      const int key = i / 3;
+      ASSERT_EQ(RC::SUCCESS, loader.add(reinterpret_cast<const char *>(&key), RID(i, i % 7)));
+    }
+    ASSERT_GT(loader.run_count(), 1);
+    ASSERT_EQ(RC::SUCCESS, loader.finish());
+    ASSERT_TRUE(handler.validate_tree());
+    // 临时文件都已经删除了
+    for (const auto &entry : filesystem::directory_iterator(test_directory)) {
+      ASSERT_EQ(string::npos, entry.path().string().find(".sort.")) << entry.path();
+    }
+
+    // 叶子节点都是装满的
+    const int leaf_max_size = handler.file_header().leaf_max_size;
+    ASSERT_LE(buffer_pool->allocated_pages(), insert_num / leaf_max_size + insert_num / leaf_max_size / 10 + 4);
+
+    list<RID> rids;
+    for (int key = 0; key < insert_num / 3; key += 11) {
+      rids.clear();
+      ASSERT_EQ(RC::SUCCESS, handler.get_entry(reinterpret_cast<const char *>(&key), sizeof(key), rids));
+      list<RID> expected;
+      for (int i = key * 3; i < key * 3 + 3; i++) {
+        expected.emplace_back(i, i % 7);
+      }
+      ASSERT_EQ(expected, rids);
+    }
+
+    {
+      BplusTreeScanner scanner(handler);
+      ASSERT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, true, nullptr, 0, true));
+      RID rid;
+      int count = 0;
+      while (scanner.next_entry(rid) == RC::SUCCESS) {
+        ASSERT_EQ(count, rid.page_num);
+        count++;
+      }
+      ASSERT_EQ(insert_num, count);
+    }
+
+    // 批量构建之后还可以正常地插入和删除
+    for (int i = insert_num; i < insert_num + 3000; i++) {
+      const int key = i % 1000;
+      RID       rid(i, 0);
+      ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&key), &rid));
+    }
+    ASSERT_TRUE(handler.validate_tree());
+    for (int i = 0; i < insert_num; i++) {
+      const int key = i / 3;
+      RID       rid(i, i % 7);
+      ASSERT_EQ(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&key), &rid));
+    }
+    ASSERT_TRUE(handler.validate_tree());
+    handler.close();
+  }
+
+  // 前缀压缩格式的叶子节点，按照实际使用的空间装满
+  {
+    DiskBufferPool *buffer_pool = nullptr;
+    open_file("bulk_load_chars.btree", buffer_pool);
+
+    const int        attr_length = 64;
+    BplusTreeHandler handler;
+    ASSERT_EQ(RC::SUCCESS, handler.create(log_handler, *buffer_pool, AttrType::CHARS, attr_length));
+    ASSERT_EQ(IndexFileHeader::LEAF_FORMAT_PREFIX, handler.file_header().leaf_format);
+
+    auto make_user_key = [](int i) {
+      string key(attr_length, '\0');
+      snprintf(key.data(), key.size(), "/data/%c/user/%06d", 'a' + i % 26, i);
+      return key;
+    };
+
+    const int           insert_num = 20000;
+    BplusTreeBulkLoader loader(handler);
+    for (int i = 0; i < insert_num; i++) {
+      ASSERT_EQ(RC::SUCCESS, loader.add(make_user_key(i).data(), RID(i, 0)));
+    }
+    ASSERT_EQ(RC::SUCCESS, loader.finish());
+    ASSERT_EQ(0, loader.run_count());
+    ASSERT_TRUE(handler.validate_tree());
+
+    list<RID> rids;
+    for (int i = 0; i < insert_num; i += 13) {
+      rids.clear();
+      ASSERT_EQ(RC::SUCCESS, handler.get_entry(make_user_key(i).data(), attr_length, rids));
+      ASSERT_EQ(list<RID>{RID(i, 0)}, rids);
+    }
+
+    for (int i = 0; i < insert_num; i += 2) {
+      RID rid(i, 1);
+      ASSERT_EQ(RC::SUCCESS, handler.insert_entry(make_user_key(i).data(), &rid));
+    }
+    ASSERT_TRUE(handler.validate_tree());
+    handler.close();
+  }
+
+  // 重复的数据和非空的B+树
+  {
+    DiskBufferPool *buffer_pool = nullptr;
+    open_file("bulk_load_duplicate.btree", buffer_pool);
+
+    BplusTreeHandler handler;
+    ASSERT_EQ(RC::SUCCESS, handler.create(log_handler, *buffer_pool, AttrType::INTS, sizeof(int)));
+
+    const int key = 1;
+    {
+      BplusTreeBulkLoader loader(handler);
+      ASSERT_EQ(RC::SUCCESS, loader.add(reinterpret_cast<const char *>(&key), RID(1, 1)));
+      ASSERT_EQ(RC::SUCCESS, loader.add(reinterpret_cast<const char *>(&key), RID(1, 1)));
+      ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, loader.finish());
+      ASSERT_TRUE(handler.is_empty());
+    }
+
+    RID rid(1, 1);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&key), &rid));
+    BplusTreeBulkLoader loader(handler);
+    ASSERT_EQ(RC::SUCCESS, loader.add(reinterpret_cast<const char *>(&key), RID(2, 2)));
+    ASSERT_NE(RC::SUCCESS, loader.finish());
+    handler.close();
+  }
+}
+
+TEST(test_bplus_tree, test_upgrade_format)
+{
+  LoggerFactory::init_default("test.log");
+
+  filesystem::path test_directory("bplus_tree");
+  filesystem::path buffer_pool_file = test_directory / "upgrade.btree";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+  const int         key_num = 500;
+  RID               rid;
+
+  {
+    BufferPoolManager bpm;
+    ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+    BplusTreeHandler handler;
+    ASSERT_EQ(RC::SUCCESS,
+        handler.create(log_handler, bpm, buffer_pool_file.c_str(), AttrType::INTS, sizeof(int), ORDER, ORDER));
+    for (int i = 0; i < key_num; i++) {
+      rid.page_num = i;
+      rid.slot_num = i;
+      ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&i, &rid));
+    }
+    ASSERT_TRUE(handler.validate_tree());
+    ASSERT_EQ(RC::SUCCESS, handler.sync());
+    handler.close();
+  }
+
+  // 把所有的节点页面改回旧版本的格式：头部在 key_num 后面还有父节点页面编号
+  {
+    BufferPoolManager bpm;
+    ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+    DiskBufferPool *buffer_pool = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, buffer_pool_file.c_str(), buffer_pool));
+
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->get_this_page(1, &frame));
+    IndexFileHeader *file_header = reinterpret_cast<IndexFileHeader *>(frame->data());
+    ASSERT_EQ(IndexFileHeader::CURRENT_FORMAT_VERSION, file_header->format_version);
+    file_header->format_version = IndexFileHeader::FORMAT_VERSION_WITH_PARENT;
+    frame->mark_dirty();
+    buffer_pool->unpin_page(frame);
+
+    const int          added_size = IndexNode::HEADER_SIZE_WITH_PARENT - IndexNode::HEADER_SIZE;
+    BufferPoolIterator iterator;
+    iterator.init(*buffer_pool, 2);
+    while (iterator.has_next()) {
+      ASSERT_EQ(RC::SUCCESS, buffer_pool->get_this_page(iterator.next(), &frame));
+      char *data = frame->data();
+      memmove(data + IndexNode::HEADER_SIZE_WITH_PARENT,
+          data + IndexNode::HEADER_SIZE,
+          BP_PAGE_DATA_SIZE - IndexNode::HEADER_SIZE_WITH_PARENT);
+      memset(data + IndexNode::HEADER_SIZE, 0xFF, added_size);
+      reinterpret_cast<IndexNode *>(data)->format = 0;
+      frame->mark_dirty();
+      buffer_pool->unpin_page(frame);
+    }
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->flush_all_pages());
+    ASSERT_EQ(RC::SUCCESS, bpm.close_file(buffer_pool_file.c_str()));
+  }
+
+  // 打开时升级，升级之后可以正常地查询和修改
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.open(log_handler, bpm, buffer_pool_file.c_str()));
+  ASSERT_EQ(IndexFileHeader::CURRENT_FORMAT_VERSION, handler.file_header().format_version);
+  ASSERT_TRUE(handler.validate_tree());
+
+  for (int i = 0; i < key_num; i++) {
+    list<RID> rids;
+    ASSERT_EQ(RC::SUCCESS, handler.get_entry((const char *)&i, sizeof(i), rids));
+    ASSERT_EQ(1, rids.size());
+    ASSERT_EQ(i, rids.front().slot_num);
+  }
+
+  for (int i = key_num; i < key_num * 2; i++) {
+    rid.page_num = i;
+    rid.slot_num = i;
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&i, &rid));
+  }
+  for (int i = 0; i < key_num * 2; i += 2) {
+    rid.page_num = i;
+    rid.slot_num = i;
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry((const char *)&i, &rid));
+  }
+  ASSERT_TRUE(handler.validate_tree());
+  handler.close();
+}
+
 TEST(test_bplus_tree, test_bplus_tree_insert)
 {
   LoggerFactory::init_default("test.log");
@@ -60,6 +60,69 @@ TEST(ChunkTest, chunk_test)
   }
 }
 
+TEST(ChunkTest, selection_test)
+{
+  int   row_num = 16;
+  Chunk chunk;
+  chunk.add_column(std::make_unique<Column>(AttrType::INTS, sizeof(int), row_num), 0);
+  auto constant = std::make_unique<Column>();
+  constant->init(Value(7));
+  chunk.add_column(std::move(constant), 1);
+  for (int i = 0; i < row_num; i++) {
+    chunk.column(0).append_one((char *)&i);
+  }
+
+  // 全部选中时没有选择向量
+  vector<uint8_t> select(row_num, 1);
+  chunk.select(select);
+  ASSERT_FALSE(chunk.has_selection());
+  ASSERT_EQ(chunk.selected_rows(), row_num);
+
+  // 选中偶数行
+  for (int i = 0; i < row_num; i++) {
+    select[i] = (i % 2 == 0) ? 1 : 0;
+  }
+  chunk.select(select);
+  ASSERT_TRUE(chunk.has_selection());
+  ASSERT_FALSE(chunk.sparse());
+  ASSERT_EQ(chunk.selected_rows(), row_num / 2);
+  for (int i = 0; i < chunk.selected_rows(); i++) {
+    ASSERT_EQ(chunk.row_index(i), i * 2);
+  }
+
+  Chunk chunk2;
+  chunk2.reference(chunk);
+  ASSERT_TRUE(chunk2.has_selection());
+  ASSERT_EQ(chunk2.selected_rows(), row_num / 2);
+
+  Column gathered(AttrType::INTS, sizeof(int), row_num);
+  ASSERT_EQ(chunk.gather(chunk.column(0), gathered), RC::SUCCESS);
+  ASSERT_EQ(gathered.count(), row_num / 2);
+  for (int i = 0; i < gathered.count(); i++) {
+    ASSERT_EQ(gathered.get_value(i).get_int(), i * 2);
+  }
+
+  // 只选中第 3 行和第 9 行
+  select.assign(row_num, 0);
+  select[3] = 1;
+  select[9] = 1;
+  chunk.select(select);
+  ASSERT_TRUE(chunk.sparse());
+
+  Chunk compacted;
+  ASSERT_EQ(chunk.compact(compacted), RC::SUCCESS);
+  ASSERT_FALSE(compacted.has_selection());
+  ASSERT_EQ(compacted.column_num(), 2);
+  ASSERT_EQ(compacted.rows(), 2);
+  ASSERT_EQ(compacted.get_value(0, 0).get_int(), 3);
+  ASSERT_EQ(compacted.get_value(0, 1).get_int(), 9);
+  ASSERT_EQ(compacted.column(1).column_type(), Column::Type::CONSTANT_COLUMN);
+  ASSERT_EQ(compacted.get_value(1, 0).get_int(), 7);
+
+  chunk.reset_data();
+  ASSERT_FALSE(chunk.has_selection());
+}
+
 int main(int argc, char **argv)
 {
 
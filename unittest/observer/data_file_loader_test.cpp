@@ -0,0 +1,197 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include <string.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "common/log/log.h"
+#include "sql/executor/data_file_loader.h"
+#include "storage/db/db.h"
+#include "storage/index/index.h"
+#include "storage/record/record.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+using namespace common;
+
+class DataFileLoaderTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    filesystem::remove_all(directory_);
+    filesystem::create_directories(directory_ / "db");
+
+    db_ = make_unique<Db>();
+    ASSERT_EQ(RC::SUCCESS, db_->init("test_db", (directory_ / "db").c_str(), "vacuous", "vacuous"));
+
+    vector<AttrInfoSqlNode> attr_infos = {
+        {AttrType::INTS, "id", 4},
+        {AttrType::FLOATS, "score", 4},
+        {AttrType::CHARS, "name", 8},
+    };
+    ASSERT_EQ(RC::SUCCESS, db_->create_table("t", attr_infos));
+    table_ = db_->find_table("t");
+    ASSERT_NE(nullptr, table_);
+  }
+
+  void TearDown() override
+  {
+    db_.reset();
+    filesystem::remove_all(directory_);
+  }
+
+  string write_file(const string &content)
+  {
+    string   file_name = (directory_ / "data.txt").string();
+    ofstream ofs(file_name, ios::out | ios::trunc);
+    ofs << content;
+    return file_name;
+  }
+
+  /// 使用表扫描统计记录数，并检查 id 之和
+  void check_records(int64_t expect_num, int64_t expect_id_sum)
+  {
+    RecordFileScanner scanner;
+    ASSERT_EQ(RC::SUCCESS, table_->get_record_scanner(scanner, nullptr, ReadWriteMode::READ_ONLY));
+    const FieldMeta *id_field = table_->table_meta().field("id");
+
+    int64_t num = 0, id_sum = 0;
+    Record  record;
+    while (OB_SUCC(scanner.next(record))) {
+      num++;
+      id_sum += *reinterpret_cast<const int *>(record.data() + id_field->offset());
+    }
+    scanner.close_scan();
+    ASSERT_EQ(expect_num, num);
+    ASSERT_EQ(expect_id_sum, id_sum);
+  }
+
+  int64_t count_index_entries(Index *index)
+  {
+    IndexScanner *scanner = index->create_scanner(nullptr, 0, true, nullptr, 0, true);
+    int64_t       num     = 0;
+    RID           rid;
+    while (OB_SUCC(scanner->next_entry(&rid))) {
+      num++;
+    }
+    scanner->destroy();
+    return num;
+  }
+
+protected:
+  filesystem::path directory_ = "data_file_loader_test";
+  unique_ptr<Db>   db_;
+  Table           *table_ = nullptr;
+};
+
+TEST_F(DataFileLoaderTest, parse_fields)
+{
+  string file_name = write_file("1|1.5|alice\n 2 | +2.5 |bob\n\n3|-3|a_long_name|ignored\n4|4|");
+
+  DataFileLoader loader(table_);
+  ASSERT_EQ(RC::SUCCESS, loader.load(file_name.c_str()));
+  ASSERT_EQ(5, loader.line_num());
+  ASSERT_EQ(4, loader.record_num());
+  check_records(4, 10);
+
+  RecordFileScanner scanner;
+  ASSERT_EQ(RC::SUCCESS, table_->get_record_scanner(scanner, nullptr, ReadWriteMode::READ_ONLY));
+  const FieldMeta *score_field = table_->table_meta().field("score");
+  const FieldMeta *name_field  = table_->table_meta().field("name");
+
+  vector<float>  scores;
+  vector<string> names;
+  Record         record;
+  while (OB_SUCC(scanner.next(record))) {
+    scores.push_back(*reinterpret_cast<const float *>(record.data() + score_field->offset()));
+    names.push_back(string(record.data() + name_field->offset(), strnlen(record.data() + name_field->offset(), 8)));
+  }
+  scanner.close_scan();
+  ASSERT_EQ((vector<float>{1.5, 2.5, -3, 4}), scores);
+  ASSERT_EQ((vector<string>{"alice", "bob", "a_long_n", ""}), names);
+}
+
+TEST_F(DataFileLoaderTest, errors)
+{
+  // 出错的行之前的记录会保留下来
+  DataFileLoader loader(table_);
+  ASSERT_EQ(RC::SCHEMA_FIELD_TYPE_MISMATCH, loader.load(write_file("1|1|a\n2|x|b\n3|3|c\n").c_str()));
+  ASSERT_EQ(2, loader.error_line());
+  ASSERT_EQ("Line:2 insert record failed:need a float number but got 'x'(field index:1). "
+            "error:SCHEMA_FIELD_TYPE_MISMATCH",
+            loader.error_message());
+  check_records(1, 1);
+
+  DataFileLoader loader2(table_);
+  ASSERT_EQ(RC::SCHEMA_FIELD_MISSING, loader2.load(write_file("10|1\n").c_str()));
+  ASSERT_EQ(1, loader2.error_line());
+
+  DataFileLoader loader3(table_);
+  ASSERT_EQ(RC::SCHEMA_FIELD_TYPE_MISMATCH, loader3.load(write_file("1.5|1|a\n").c_str()));
+
+  DataFileLoader loader4(table_);
+  ASSERT_EQ(RC::FILE_NOT_EXIST, loader4.load((directory_ / "not_exist").c_str()));
+  ASSERT_EQ(0, loader4.error_line());
+  check_records(1, 1);
+}
+
+TEST_F(DataFileLoaderTest, parallel_blocks)
+{
+  ASSERT_EQ(RC::SUCCESS, table_->create_index(nullptr, {table_->table_meta().field("id")}, "t_id"));
+  Index *index = table_->find_index("t_id");
+  ASSERT_NE(nullptr, index);
+
+  const int row_num = 10000;
+  string    content;
+  int64_t   id_sum = 0;
+  for (int i = 0; i < row_num; i++) {
+    content += to_string(i) + "|" + to_string(i % 100) + "|n" + to_string(i) + "\n";
+    id_sum += i;
+  }
+
+  // 数据块很小，索引是空的，导入之后再构建索引
+  DataFileLoader loader(table_, 4 /*thread_num*/, '|', 1024 /*block_size*/);
+  ASSERT_EQ(RC::SUCCESS, loader.load(write_file(content).c_str()));
+  ASSERT_EQ(row_num, loader.record_num());
+  check_records(row_num, id_sum);
+  ASSERT_EQ(row_num, count_index_entries(index));
+
+  // 索引不是空的，插入时维护索引。错误出现在后面的数据块中，之前的数据块都已经插入
+  content.clear();
+  for (int i = 0; i < row_num; i++) {
+    content += (i == row_num / 2 ? string("bad") : to_string(i)) + "|1|x\n";
+  }
+  DataFileLoader loader2(table_, 4 /*thread_num*/, '|', 1024 /*block_size*/);
+  ASSERT_EQ(RC::SCHEMA_FIELD_TYPE_MISMATCH, loader2.load(write_file(content).c_str()));
+  ASSERT_EQ(row_num / 2 + 1, loader2.error_line());
+  ASSERT_EQ(row_num / 2, loader2.record_num());
+  check_records(row_num + row_num / 2, id_sum + static_cast<int64_t>(row_num / 2 - 1) * (row_num / 2) / 2);
+  ASSERT_EQ(row_num + row_num / 2, count_index_entries(index));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  filesystem::path log_filename = filesystem::path(argv[0]).filename();
+  LoggerFactory::init_default(log_filename.string() + ".log", LOG_LEVEL_INFO);
+  return RUN_ALL_TESTS();
+}
@@ -132,6 +132,152 @@ TEST(BufferPool, create)
   ASSERT_EQ(buffer_pool->id(), buffer_pool2->id());
 }
 
+TEST(BufferPoolManager, page_cleaner)
+{
+  filesystem::path test_directory("buffer_pool");
+  filesystem::path bp_file = test_directory / "page_cleaner.bp";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  // 只有一个内存池，128个页帧
+  BufferPoolManager bpm(1);
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(bp_file.c_str()));
+
+  VacuousLogHandler log_handler;
+  DiskBufferPool   *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, bp_file.c_str(), buffer_pool));
+  ASSERT_NE(buffer_pool, nullptr);
+
+  BPFrameManager &frame_manager = bpm.get_frame_manager();
+  const size_t    total_frames  = frame_manager.total_frame_num();
+
+  auto write_pages = [buffer_pool](int count, vector<PageNum> &page_nums) {
+    for (int i = 0; i < count; i++) {
+      Frame *frame = nullptr;
+      ASSERT_EQ(RC::SUCCESS, buffer_pool->allocate_page(&frame));
+      const PageNum page_num = frame->page_num();
+      frame->write_latch();
+      memcpy(frame->data(), &page_num, sizeof(page_num));
+      frame->mark_dirty();
+      frame->write_unlatch();
+      page_nums.push_back(page_num);
+      ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+    }
+  };
+
+  auto check_pages = [buffer_pool](const vector<PageNum> &page_nums) {
+    for (PageNum page_num : page_nums) {
+      Frame *frame = nullptr;
+      ASSERT_EQ(RC::SUCCESS, buffer_pool->get_this_page(page_num, &frame));
+      ASSERT_EQ(0, memcmp(frame->data(), &page_num, sizeof(page_num)));
+      ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+    }
+  };
+
+  // 直接清理一批页面，脏页会先刷到磁盘上
+  vector<PageNum> page_nums;
+  write_pages(100, page_nums);
+  const size_t free_frames = frame_manager.free_frame_num();
+  int          cleaned     = 0;
+  ASSERT_EQ(RC::SUCCESS, bpm.clean_frames(50, cleaned));
+  ASSERT_EQ(cleaned, 50);
+  ASSERT_EQ(frame_manager.free_frame_num(), free_frames + 50);
+  check_pages(page_nums);
+
+  // 后台线程保持一定数量的空闲页帧
+  const int free_frame_target = 64;
+  ASSERT_EQ(RC::SUCCESS, bpm.start_page_cleaner(free_frame_target));
+  write_pages(static_cast<int>(total_frames), page_nums);
+  for (int i = 0; i < 100 && frame_manager.free_frame_num() < static_cast<size_t>(free_frame_target); i++) {
+    this_thread::sleep_for(chrono::milliseconds(50));
+  }
+  ASSERT_GE(frame_manager.free_frame_num(), static_cast<size_t>(free_frame_target));
+  bpm.stop_page_cleaner();
+
+  check_pages(page_nums);
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(bp_file.c_str()));
+}
+
+TEST(BufferPoolManager, read_ahead)
+{
+  filesystem::path test_directory("buffer_pool");
+  filesystem::path bp_file = test_directory / "read_ahead.bp";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+  const int         page_count = 100;
+
+  // 先写一批页面，关闭文件后页面都不在内存中了
+  {
+    BufferPoolManager bpm(1);
+    ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+    ASSERT_EQ(RC::SUCCESS, bpm.create_file(bp_file.c_str()));
+
+    DiskBufferPool *buffer_pool = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, bp_file.c_str(), buffer_pool));
+    for (int i = 0; i < page_count; i++) {
+      Frame *frame = nullptr;
+      ASSERT_EQ(RC::SUCCESS, buffer_pool->allocate_page(&frame));
+      const PageNum page_num = frame->page_num();
+      memcpy(frame->data(), &page_num, sizeof(page_num));
+      frame->mark_dirty();
+      ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+    }
+    ASSERT_EQ(RC::SUCCESS, bpm.close_file(bp_file.c_str()));
+  }
+
+  BufferPoolManager bpm(1);
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  DiskBufferPool *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, bp_file.c_str(), buffer_pool));
+  ASSERT_EQ(RC::SUCCESS, bpm.start_read_ahead(1));
+
+  BPFrameManager &frame_manager = bpm.get_frame_manager();
+  auto            in_memory     = [&frame_manager, buffer_pool](PageNum page_num) {
+    Frame *frame = frame_manager.get(buffer_pool->id(), page_num);
+    if (frame == nullptr) {
+      return false;
+    }
+    frame->unpin();
+    return true;
+  };
+
+  // 访问第一个页面时，会预读后面的页面
+  const int          read_ahead_pages = 16;
+  BufferPoolIterator bp_iterator;
+  ASSERT_EQ(RC::SUCCESS, bp_iterator.init(*buffer_pool, 1, read_ahead_pages));
+  ASSERT_TRUE(bp_iterator.has_next());
+  ASSERT_EQ(1, bp_iterator.next());
+
+  const PageNum last_read_ahead_page = 1 + read_ahead_pages;
+  for (int i = 0; i < 100 && !in_memory(last_read_ahead_page); i++) {
+    this_thread::sleep_for(chrono::milliseconds(50));
+  }
+  for (PageNum page_num = 2; page_num <= last_read_ahead_page; page_num++) {
+    ASSERT_TRUE(in_memory(page_num)) << "page " << page_num << " should be read ahead";
+  }
+  ASSERT_FALSE(in_memory(last_read_ahead_page + read_ahead_pages));
+
+  // 预读的页面和直接读到的页面一样
+  int visited = 1;
+  while (bp_iterator.has_next()) {
+    const PageNum page_num = bp_iterator.next();
+    Frame        *frame    = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->get_this_page(page_num, &frame));
+    frame->read_latch();
+    ASSERT_EQ(0, memcmp(frame->data(), &page_num, sizeof(page_num)));
+    frame->read_unlatch();
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+    visited++;
+  }
+  ASSERT_EQ(page_count, visited);
+
+  bpm.stop_read_ahead();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(bp_file.c_str()));
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -13,6 +13,7 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include <filesystem>
+#include <fstream>
 
 #include "gtest/gtest.h"
 
@@ -201,6 +202,76 @@ TEST(DoubleWriteBuffer, single_file_exception)
   bpm  = nullptr;
 }
 
+TEST(DoubleWriteBuffer, batch_flush)
+{
+  /*
+  页面先攒在内存中，攒够一批之后才一起写入double write buffer文件和数据文件
+  */
+  filesystem::path directory("double_write_buffer_test_batch_flush_dir");
+  filesystem::remove_all(directory);
+  filesystem::create_directories(directory);
+
+  filesystem::path buffer_pool_filename         = directory / "buffer_pool.bp";
+  filesystem::path double_write_buffer_filename = directory / "double_write_buffer.dwb";
+
+  const int         batch_pages = 8;
+  auto              bpm         = make_unique<BufferPoolManager>();
+  VacuousLogHandler log_handler;
+  auto              double_write_buffer = make_unique<DiskDoubleWriteBuffer>(*bpm, batch_pages);
+  ASSERT_EQ(RC::SUCCESS, double_write_buffer->open_file(double_write_buffer_filename.c_str()));
+  ASSERT_EQ(bpm->init(std::move(double_write_buffer)), RC::SUCCESS);
+
+  DiskBufferPool *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm->create_file(buffer_pool_filename.c_str()));
+  ASSERT_EQ(RC::SUCCESS, bpm->open_file(log_handler, buffer_pool_filename.c_str(), buffer_pool));
+  ASSERT_NE(buffer_pool, nullptr);
+
+  vector<Frame *> frames;
+  for (int i = 0; i < batch_pages; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->allocate_page(&frame));
+    frames.push_back(frame);
+  }
+
+  // 分配页面时写入的空页面也会进入double write buffer，先把它们都刷出去
+  ASSERT_EQ(RC::SUCCESS, bpm->get_dblwr_buffer()->flush_all());
+
+  auto read_data_file = [&buffer_pool_filename](PageNum page_num, Page &page) {
+    ifstream data_file(buffer_pool_filename, ios::binary);
+    data_file.seekg(static_cast<int64_t>(page_num) * BP_PAGE_SIZE);
+    return static_cast<bool>(data_file.read(reinterpret_cast<char *>(&page), BP_PAGE_SIZE));
+  };
+
+  for (int i = 0; i < batch_pages; i++) {
+    Frame *frame = frames[i];
+    snprintf(frame->data(), BP_PAGE_DATA_SIZE, "page %d", frame->page_num());
+    frame->mark_dirty();
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->flush_page(*frame));
+
+    if (i + 1 < batch_pages) {
+      // 还没有攒够一批，页面只在内存中，可以从double write buffer中读到，数据文件中还是空页面
+      Page page;
+      ASSERT_EQ(RC::SUCCESS, bpm->get_dblwr_buffer()->read_page(buffer_pool, frame->page_num(), page));
+      ASSERT_EQ(0, memcmp(page.data, frame->data(), BP_PAGE_DATA_SIZE));
+
+      ASSERT_TRUE(read_data_file(frame->page_num(), page));
+      ASSERT_NE(0, memcmp(page.data, frame->data(), BP_PAGE_DATA_SIZE));
+    }
+  }
+
+  // 整批页面已经写入数据文件，double write buffer也清空了
+  for (Frame *frame : frames) {
+    Page page;
+    ASSERT_EQ(RC::BUFFERPOOL_INVALID_PAGE_NUM, bpm->get_dblwr_buffer()->read_page(buffer_pool, frame->page_num(), page));
+    ASSERT_TRUE(read_data_file(frame->page_num(), page));
+    ASSERT_EQ(0, memcmp(page.data, frame->data(), BP_PAGE_DATA_SIZE));
+
+    frame->unpin();
+  }
+
+  bpm = nullptr;
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -307,6 +307,63 @@ TEST(ComparisonExpr, comparison_expr_test)
   }
 }
 
+TEST(ConjunctionExpr, conjunction_expr_eval_test)
+{
+  const int               int_len = sizeof(int);
+  FieldMeta               field_meta("col1", AttrType::INTS, 0, int_len, true, 0);
+  Field                   field(nullptr, &field_meta);
+  int                     count  = 100;
+  std::unique_ptr<Column> column = std::make_unique<Column>(AttrType::INTS, int_len, count);
+  for (int i = 0; i < count; ++i) {
+    column->append_one((char *)&i);
+  }
+  Chunk chunk;
+  chunk.add_column(std::move(column), 0);
+
+  auto make_comparison = [&field](CompOp op, int left, int right) -> unique_ptr<Expression> {
+    // left 或 right 为 -1 时表示用字段
+    unique_ptr<Expression> left_expr;
+    unique_ptr<Expression> right_expr;
+    if (left == -1) {
+      left_expr = std::make_unique<FieldExpr>(field);
+    } else {
+      left_expr = std::make_unique<ValueExpr>(Value(left));
+    }
+    if (right == -1) {
+      right_expr = std::make_unique<FieldExpr>(field);
+    } else {
+      right_expr = std::make_unique<ValueExpr>(Value(right));
+    }
+    return std::make_unique<ComparisonExpr>(op, std::move(left_expr), std::move(right_expr));
+  };
+
+  {
+    // 10 < col1 and col1 < 20
+    vector<unique_ptr<Expression>> children;
+    children.emplace_back(make_comparison(CompOp::LESS_THAN, 10, -1));
+    children.emplace_back(make_comparison(CompOp::LESS_THAN, -1, 20));
+    ConjunctionExpr      expr(ConjunctionExpr::Type::AND, children);
+    std::vector<uint8_t> select(count, 1);
+    ASSERT_EQ(expr.eval(chunk, select), RC::SUCCESS);
+    for (int i = 0; i < count; ++i) {
+      ASSERT_EQ(select[i], (i > 10 && i < 20) ? 1 : 0);
+    }
+  }
+  {
+    // col1 < 5 or 95 < col1，结果还要与 select 中原有的值做与运算
+    vector<unique_ptr<Expression>> children;
+    children.emplace_back(make_comparison(CompOp::LESS_THAN, -1, 5));
+    children.emplace_back(make_comparison(CompOp::LESS_THAN, 95, -1));
+    ConjunctionExpr      expr(ConjunctionExpr::Type::OR, children);
+    std::vector<uint8_t> select(count, 1);
+    select[0] = 0;
+    ASSERT_EQ(expr.eval(chunk, select), RC::SUCCESS);
+    for (int i = 0; i < count; ++i) {
+      ASSERT_EQ(select[i], (i > 0 && (i < 5 || i > 95)) ? 1 : 0);
+    }
+  }
+}
+
 TEST(AggregateExpr, aggregate_expr_test)
 {
   Value                  int_value(1);
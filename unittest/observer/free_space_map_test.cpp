@@ -0,0 +1,247 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include <filesystem>
+#include <thread>
+
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/record/free_space_map.h"
+#include "storage/record/record_manager.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace common;
+
+TEST(FreeSpaceMap, level_of)
+{
+  ASSERT_EQ(0, FreeSpaceMap::level_of(0, 100));
+  ASSERT_EQ(0, FreeSpaceMap::level_of(10, 0));
+  ASSERT_EQ(1, FreeSpaceMap::level_of(1, 100));
+  ASSERT_EQ(1, FreeSpaceMap::level_of(33, 100));
+  ASSERT_EQ(2, FreeSpaceMap::level_of(34, 100));
+  ASSERT_EQ(3, FreeSpaceMap::level_of(67, 100));
+  ASSERT_EQ(3, FreeSpaceMap::level_of(100, 100));
+}
+
+TEST(FreeSpaceMap, claim_release)
+{
+  const char *filename = "free_space_map_claim.fsm";
+  filesystem::remove(filename);
+
+  FreeSpaceMap fsm;
+  bool         loaded = true;
+  ASSERT_EQ(RC::SUCCESS, fsm.open(filename, 4, loaded));
+  ASSERT_FALSE(loaded);
+  ASSERT_EQ(0, fsm.available_pages());
+  ASSERT_EQ(BP_INVALID_PAGE_NUM, fsm.claim_free_page());
+
+  fsm.set_level(1, 0);
+  fsm.set_level(2, 2);
+  fsm.set_level(3, 3);
+  ASSERT_EQ(2, fsm.available_pages());
+
+  // 被占用的页面不会再被其它线程找到
+  PageNum first  = fsm.claim_free_page();
+  PageNum second = fsm.claim_free_page();
+  ASSERT_EQ(2, first);
+  ASSERT_EQ(3, second);
+  ASSERT_EQ(0, fsm.available_pages());
+  ASSERT_EQ(BP_INVALID_PAGE_NUM, fsm.claim_free_page());
+
+  // 修改 level 不影响占用状态
+  fsm.set_level(first, 1);
+  ASSERT_EQ(1, fsm.level(first));
+  ASSERT_EQ(0, fsm.available_pages());
+
+  fsm.release(first);
+  ASSERT_EQ(1, fsm.available_pages());
+  ASSERT_EQ(first, fsm.claim_free_page());
+
+  // 新页面超过当前容量时会自动扩容
+  const PageNum new_page = FreeSpaceMap::ENTRIES_PER_PAGE + 10;
+  fsm.add_claimed_page(new_page, FreeSpaceMap::MAX_LEVEL);
+  ASSERT_EQ(FreeSpaceMap::MAX_LEVEL, fsm.level(new_page));
+  ASSERT_EQ(0, fsm.available_pages());
+  fsm.release(new_page);
+  ASSERT_EQ(1, fsm.available_pages());
+  ASSERT_EQ(FreeSpaceMap::MAX_LEVEL, fsm.level(second));
+
+  ASSERT_EQ(RC::SUCCESS, fsm.close());
+  filesystem::remove(filename);
+}
+
+TEST(FreeSpaceMap, persistence)
+{
+  const char *filename   = "free_space_map_persistence.fsm";
+  const int   page_count = FreeSpaceMap::ENTRIES_PER_PAGE + 100;
+  filesystem::remove(filename);
+
+  {
+    FreeSpaceMap fsm;
+    bool         loaded = true;
+    ASSERT_EQ(RC::SUCCESS, fsm.open(filename, page_count, loaded));
+    ASSERT_FALSE(loaded);
+    for (int i = 1; i < page_count; i++) {
+      fsm.set_level(i, i % (FreeSpaceMap::MAX_LEVEL + 1));
+    }
+    fsm.claim_free_page();  // 占用状态不会保存
+    ASSERT_EQ(RC::SUCCESS, fsm.close());
+  }
+
+  {
+    FreeSpaceMap fsm;
+    bool         loaded = false;
+    ASSERT_EQ(RC::SUCCESS, fsm.open(filename, page_count, loaded));
+    ASSERT_TRUE(loaded);
+    int available = 0;
+    for (int i = 1; i < page_count; i++) {
+      ASSERT_EQ(i % (FreeSpaceMap::MAX_LEVEL + 1), fsm.level(i));
+      available += fsm.level(i) != 0 ? 1 : 0;
+    }
+    ASSERT_EQ(available, fsm.available_pages());
+    ASSERT_EQ(RC::SUCCESS, fsm.close());
+  }
+
+  {
+    // 数据文件的页面个数变了，FSM 不能使用
+    FreeSpaceMap fsm;
+    bool         loaded = true;
+    ASSERT_EQ(RC::SUCCESS, fsm.open(filename, page_count + 1, loaded));
+    ASSERT_FALSE(loaded);
+    ASSERT_EQ(0, fsm.available_pages());
+    ASSERT_EQ(RC::SUCCESS, fsm.close());
+  }
+
+  filesystem::remove(filename);
+}
+
+TEST(FreeSpaceMap, invalid_without_close)
+{
+  const char *filename = "free_space_map_crash.fsm";
+  filesystem::remove(filename);
+
+  {
+    FreeSpaceMap fsm;
+    bool         loaded = true;
+    ASSERT_EQ(RC::SUCCESS, fsm.open(filename, 10, loaded));
+    fsm.set_level(5, 3);
+    ASSERT_EQ(RC::SUCCESS, fsm.close());
+  }
+
+  // 打开之后文件就是无效的，这里模拟没有正常关闭：复制出打开状态下的文件
+  const char *crash_filename = "free_space_map_crash_copy.fsm";
+  filesystem::remove(crash_filename);
+  {
+    FreeSpaceMap fsm;
+    bool         loaded = false;
+    ASSERT_EQ(RC::SUCCESS, fsm.open(filename, 10, loaded));
+    ASSERT_TRUE(loaded);
+    filesystem::copy_file(filename, crash_filename);
+    ASSERT_EQ(RC::SUCCESS, fsm.close());
+  }
+
+  FreeSpaceMap fsm;
+  bool         loaded = true;
+  ASSERT_EQ(RC::SUCCESS, fsm.open(crash_filename, 10, loaded));
+  ASSERT_FALSE(loaded);
+  ASSERT_EQ(0, fsm.level(5));
+  ASSERT_EQ(RC::SUCCESS, fsm.close());
+
+  filesystem::remove(filename);
+  filesystem::remove(crash_filename);
+}
+
+TEST(FreeSpaceMap, record_file_handler)
+{
+  VacuousLogHandler log_handler;
+
+  const char *record_file = "free_space_map_record.bp";
+  filesystem::remove(record_file);
+  filesystem::remove(FreeSpaceMap::file_name(record_file));
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(record_file));
+
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, record_file, bp));
+
+  const int  thread_num            = 4;
+  const int  record_num_per_thread = 2000;
+  const int  record_size           = 100;
+  vector<vector<RID>> thread_rids(thread_num);
+  {
+    RecordFileHandler file_handler(StorageFormat::ROW_FORMAT);
+    ASSERT_EQ(RC::SUCCESS, file_handler.init(*bp, log_handler, nullptr));
+
+    // 每个线程有自己的插入页面，不同线程的记录不会写到同一个页面
+    vector<thread> threads;
+    for (int t = 0; t < thread_num; t++) {
+      threads.emplace_back([&file_handler, &thread_rids, t]() {
+        char data[record_size] = {0};
+        for (int i = 0; i < record_num_per_thread; i++) {
+          RID rid;
+          ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(data, record_size, &rid));
+          thread_rids[t].push_back(rid);
+        }
+      });
+    }
+    for (thread &th : threads) {
+      th.join();
+    }
+
+    unordered_map<PageNum, int> page_owner;
+    for (int t = 0; t < thread_num; t++) {
+      for (const RID &rid : thread_rids[t]) {
+        auto iter = page_owner.emplace(rid.page_num, t).first;
+        ASSERT_EQ(t, iter->second);
+      }
+    }
+
+    // 删除记录之后，页面的空闲空间可以被找到
+    for (int i = 0; i < record_num_per_thread; i++) {
+      ASSERT_EQ(RC::SUCCESS, file_handler.delete_record(&thread_rids[0][i]));
+    }
+    file_handler.close();
+  }
+
+  {
+    // 正常关闭之后，重新打开时不需要扫描页面，删除留下的空间可以继续使用
+    RecordFileHandler file_handler(StorageFormat::ROW_FORMAT);
+    ASSERT_EQ(RC::SUCCESS, file_handler.init(*bp, log_handler, nullptr));
+
+    const int32_t page_count = bp->page_count();
+    char          data[record_size] = {0};
+    for (int i = 0; i < record_num_per_thread; i++) {
+      RID rid;
+      ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(data, record_size, &rid));
+    }
+    ASSERT_EQ(page_count, bp->page_count());
+    file_handler.close();
+  }
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(record_file));
+  filesystem::remove(record_file);
+  filesystem::remove(FreeSpaceMap::file_name(record_file));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  filesystem::path log_filename = filesystem::path(argv[0]).filename();
+  LoggerFactory::init_default(log_filename.string() + ".log", LOG_LEVEL_TRACE);
+  return RUN_ALL_TESTS();
+}
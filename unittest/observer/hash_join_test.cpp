@@ -0,0 +1,206 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include "gtest/gtest.h"
+#include "sql/expr/join_hash_table.h"
+#include "sql/operator/hash_join_vec_physical_operator.h"
+
+using namespace std;
+
+TEST(JoinHashTable, probe)
+{
+  JoinHashTable hash_table;
+  // 每个键重复 3 次
+  for (int i = 0; i < 300; i++) {
+    int key = i % 100;
+    hash_table.add(JoinHashTable::hash(Value(key)));
+  }
+  hash_table.build();
+  ASSERT_EQ(300, hash_table.size());
+
+  for (int key = 0; key < 100; key++) {
+    const uint64_t hash = JoinHashTable::hash(Value(key));
+    size_t         pos  = hash_table.begin(hash);
+    vector<int>    rows;
+    for (int row = hash_table.next(hash, pos); row != -1; row = hash_table.next(hash, pos)) {
+      rows.push_back(row);
+    }
+    sort(rows.begin(), rows.end());
+    ASSERT_EQ((vector<int>{key, key + 100, key + 200}), rows);
+  }
+
+  const uint64_t hash = JoinHashTable::hash(Value(1000));
+  size_t         pos  = hash_table.begin(hash);
+  ASSERT_EQ(-1, hash_table.next(hash, pos));
+
+  JoinHashTable empty_table;
+  pos = empty_table.begin(hash);
+  ASSERT_EQ(-1, empty_table.next(hash, pos));
+}
+
+TEST(JoinHashTable, hash_and_equal)
+{
+  // 字符串字段的长度不同，结尾的'\0'不影响比较
+  const char left[8]  = "abc";
+  const char right[4] = {'a', 'b', 'c', '\0'};
+  ASSERT_EQ(JoinHashTable::hash(AttrType::CHARS, left, 8), JoinHashTable::hash(AttrType::CHARS, right, 4));
+  ASSERT_TRUE(JoinHashTable::equal(AttrType::CHARS, left, 8, right, 4));
+  ASSERT_TRUE(JoinHashTable::equal(Value("abc"), Value(AttrType::CHARS, const_cast<char *>(left), 8)));
+  ASSERT_FALSE(JoinHashTable::equal(Value("abc"), Value("abcd")));
+
+  ASSERT_EQ(JoinHashTable::hash(Value(0.0f)), JoinHashTable::hash(Value(-0.0f)));
+  ASSERT_TRUE(JoinHashTable::equal(Value(0.0f), Value(-0.0f)));
+  ASSERT_FALSE(JoinHashTable::equal(Value(1.5f), Value(2.5f)));
+
+  ASSERT_NE(JoinHashTable::combine(JoinHashTable::hash(Value(1)), JoinHashTable::hash(Value(2))),
+      JoinHashTable::combine(JoinHashTable::hash(Value(2)), JoinHashTable::hash(Value(1))));
+}
+
+/**
+ * @brief 按照 chunk 输出两列整数(key, value)的算子
+ */
+class IntChunkSource : public PhysicalOperator
+{
+public:
+  IntChunkSource(vector<int> keys, vector<int> values, int chunk_rows)
+      : keys_(std::move(keys)), values_(std::move(values)), chunk_rows_(chunk_rows)
+  {
+    chunk_.add_column(make_unique<Column>(AttrType::INTS, sizeof(int)), 0);
+    chunk_.add_column(make_unique<Column>(AttrType::INTS, sizeof(int)), 1);
+  }
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::TABLE_SCAN_VEC; }
+
+  RC open(Trx *) override
+  {
+    offset_ = 0;
+    return RC::SUCCESS;
+  }
+
+  RC next(Chunk &chunk) override
+  {
+    if (offset_ >= static_cast<int>(keys_.size())) {
+      return RC::RECORD_EOF;
+    }
+
+    const int rows = min(chunk_rows_, static_cast<int>(keys_.size()) - offset_);
+    chunk_.reset_data();
+    chunk_.column(0).append(reinterpret_cast<char *>(&keys_[offset_]), rows);
+    chunk_.column(1).append(reinterpret_cast<char *>(&values_[offset_]), rows);
+    offset_ += rows;
+    return chunk.reference(chunk_);
+  }
+
+  RC close() override { return RC::SUCCESS; }
+
+private:
+  vector<int> keys_;
+  vector<int> values_;
+  int         chunk_rows_ = 0;
+  int         offset_     = 0;
+  Chunk       chunk_;
+};
+
+/**
+ * @brief 连接 left(key, value) 和 right(key, value)，返回每个输出行 (left.value, right.value)
+ */
+void hash_join(const vector<int> &left_keys, const vector<int> &right_keys, bool build_left,
+    vector<pair<int, int>> &result, int &chunk_count)
+{
+  vector<int> left_values(left_keys.size());
+  vector<int> right_values(right_keys.size());
+  for (size_t i = 0; i < left_values.size(); i++) {
+    left_values[i] = static_cast<int>(i);
+  }
+  for (size_t i = 0; i < right_values.size(); i++) {
+    right_values[i] = static_cast<int>(i) + 1000000;
+  }
+
+  FieldMeta field_meta("key", AttrType::INTS, 0, sizeof(int), true, 0);
+
+  vector<unique_ptr<Expression>> build_keys;
+  vector<unique_ptr<Expression>> probe_keys;
+  build_keys.emplace_back(new FieldExpr(nullptr, &field_meta));
+  probe_keys.emplace_back(new FieldExpr(nullptr, &field_meta));
+
+  HashJoinVecPhysicalOperator join_oper(std::move(build_keys), std::move(probe_keys), build_left);
+  join_oper.add_child(make_unique<IntChunkSource>(left_keys, left_values, 1000));
+  join_oper.add_child(make_unique<IntChunkSource>(right_keys, right_values, 700));
+
+  result.clear();
+  chunk_count = 0;
+  ASSERT_EQ(RC::SUCCESS, join_oper.open(nullptr));
+  Chunk chunk;
+  RC    rc = RC::SUCCESS;
+  while (OB_SUCC(rc = join_oper.next(chunk))) {
+    ASSERT_EQ(4, chunk.column_num());
+    ASSERT_GT(chunk.rows(), 0);
+    for (int i = 0; i < chunk.rows(); i++) {
+      ASSERT_EQ(chunk.get_value(0, i).get_int(), chunk.get_value(2, i).get_int());
+      result.emplace_back(chunk.get_value(1, i).get_int(), chunk.get_value(3, i).get_int());
+    }
+    chunk_count++;
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  ASSERT_EQ(RC::SUCCESS, join_oper.close());
+  sort(result.begin(), result.end());
+}
+
+TEST(HashJoinVecPhysicalOperator, join)
+{
+  // 左边每个键出现 100 次，右边每个键出现 1 次，结果超过一个 chunk 的容量
+  vector<int> left_keys;
+  vector<int> right_keys;
+  for (int i = 0; i < 10000; i++) {
+    left_keys.push_back(i % 100);
+  }
+  for (int i = 0; i < 200; i++) {
+    right_keys.push_back(i);
+  }
+
+  vector<pair<int, int>> expected;
+  for (size_t l = 0; l < left_keys.size(); l++) {
+    for (size_t r = 0; r < right_keys.size(); r++) {
+      if (left_keys[l] == right_keys[r]) {
+        expected.emplace_back(static_cast<int>(l), static_cast<int>(r) + 1000000);
+      }
+    }
+  }
+  sort(expected.begin(), expected.end());
+  ASSERT_EQ(10000, static_cast<int>(expected.size()));
+
+  for (bool build_left : {true, false}) {
+    vector<pair<int, int>> result;
+    int                    chunk_count = 0;
+    hash_join(left_keys, right_keys, build_left, result, chunk_count);
+    ASSERT_EQ(expected, result);
+    ASSERT_GE(chunk_count, 2);
+  }
+
+  // 有一边是空的
+  for (bool build_left : {true, false}) {
+    vector<pair<int, int>> result;
+    int                    chunk_count = 0;
+    hash_join(left_keys, vector<int>(), build_left, result, chunk_count);
+    ASSERT_TRUE(result.empty());
+    hash_join(vector<int>(), right_keys, build_left, result, chunk_count);
+    ASSERT_TRUE(result.empty());
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
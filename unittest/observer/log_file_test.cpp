@@ -390,6 +390,48 @@ TEST(LogFileManager, next_file)
   filesystem::remove_all(directory);
 }
 
+TEST(LogFileManager, remove_files_before)
+{
+  const char *directory                 = "remove_files_before";
+  int         max_entry_number_per_file = 1000;
+
+  filesystem::remove_all(directory);
+  ASSERT_TRUE(filesystem::create_directory(directory));
+
+  LSN lsns[] = {0, 1000, 2000, 3000};
+  for (LSN lsn : lsns) {
+    string filename = string(LogFileManager::file_prefix_) + to_string(lsn) + LogFileManager::file_suffix_;
+    ofstream ofs(filesystem::path(directory) / filename);
+    ofs.close();
+  }
+
+  LogFileManager manager;
+  ASSERT_EQ(RC::SUCCESS, manager.init(directory, max_entry_number_per_file));
+
+  // 2000 这个文件中还有需要的日志，不能删除
+  ASSERT_EQ(RC::SUCCESS, manager.remove_files_before(2500));
+  vector<string> files;
+  ASSERT_EQ(RC::SUCCESS, manager.list_files(files, 0));
+  ASSERT_EQ(2, files.size());
+  ASSERT_FALSE(filesystem::exists(filesystem::path(directory) / "clog_0.log"));
+  ASSERT_FALSE(filesystem::exists(filesystem::path(directory) / "clog_1000.log"));
+
+  // 最后一个文件永远不会删除
+  ASSERT_EQ(RC::SUCCESS, manager.remove_files_before(10000));
+  ASSERT_EQ(RC::SUCCESS, manager.list_files(files, 0));
+  ASSERT_EQ(1, files.size());
+  ASSERT_EQ("clog_3000.log", filesystem::path(files[0]).filename());
+
+  LogFileWriter writer;
+  ASSERT_EQ(RC::SUCCESS, manager.next_file(writer));
+  LSN lsn = 0;
+  ASSERT_EQ(RC::SUCCESS, LogFileManager::get_lsn_from_filename(filesystem::path(writer.filename()).filename(), lsn));
+  ASSERT_EQ(4000, lsn);
+
+  writer.close();
+  filesystem::remove_all(directory);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -22,6 +22,8 @@ See the Mulan PSL v2 for more details. */
 #include "storage/db/db.h"
 #include "storage/table/table.h"
 #include "storage/record/record.h"
+#include "storage/common/meta_util.h"
+#include "storage/index/bplus_tree_index.h"
 #include "storage/trx/mvcc_trx.h"
 #include "common/thread/thread_pool_executor.h"
 
@@ -713,6 +715,387 @@ TEST(MvccTrxLog, wal_rollback_abnormal)
   db.reset();
 }
 
+TEST(MvccTrxLog, checkpoint)
+{
+  /*
+  插入数据的同时做检查点，检查点不能越过还没有提交的事务，检查点之前的日志文件会被删除。
+  然后将文件都复制到另一个目录，使用新的目录初始化一个新的数据库，检查数据是否一致。
+  */
+  filesystem::path test_directory("mvcc_trx_log_test");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  const char      *dbname           = "test_db";
+  const char      *dbname2          = "test_db2";
+  filesystem::path db_path          = test_directory / dbname;
+  filesystem::path db_path2         = test_directory / dbname2;
+  const char      *trx_kit_name     = "mvcc";
+  const char      *log_handler_name = "disk";
+
+  filesystem::create_directories(db_path);
+  filesystem::create_directories(db_path2);
+
+  auto db = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db->init(dbname, db_path.c_str(), trx_kit_name, log_handler_name));
+
+  const char             *table_name = "table_0";
+  const int               field_num = 10;
+  vector<AttrInfoSqlNode> attr_infos;
+  for (int i = 0; i < field_num; i++) {
+    AttrInfoSqlNode attr_info;
+    attr_info.name   = string("field_") + to_string(i);
+    attr_info.type   = AttrType::INTS;
+    attr_info.length = 4;
+    attr_infos.push_back(attr_info);
+  }
+  ASSERT_EQ(RC::SUCCESS, db->create_table(table_name, attr_infos));
+  ASSERT_EQ(RC::SUCCESS, db->sync());
+
+  Table  *table   = db->find_table(table_name);
+  TrxKit &trx_kit = db->trx_kit();
+  ASSERT_NE(table, nullptr);
+
+  auto insert_record = [table, field_num](Trx *trx, int value) {
+    Record        record;
+    vector<Value> values(field_num);
+    for (Value &v : values) {
+      v.set_int(value);
+    }
+    ASSERT_EQ(RC::SUCCESS, table->make_record(values.size(), values.data(), record));
+    ASSERT_EQ(RC::SUCCESS, trx->insert_record(table, record));
+  };
+
+  auto insert_committed = [&trx_kit, &db, &insert_record](int num) {
+    for (int i = 0; i < num; i++) {
+      Trx *trx = trx_kit.create_trx(db->log_handler());
+      trx->start_if_need();
+      insert_record(trx, i);
+      ASSERT_EQ(RC::SUCCESS, trx->commit());
+      trx_kit.destroy_trx(trx);
+    }
+  };
+
+  filesystem::path first_log_file = db_path / "clog" / "clog_0.log";
+
+  // 一个很早开始的事务，没有提交时检查点不能越过它
+  Trx *long_trx = trx_kit.create_trx(db->log_handler());
+  long_trx->start_if_need();
+  insert_record(long_trx, -1);
+
+  const int insert_num = 1000;
+  insert_committed(insert_num);
+  ASSERT_EQ(RC::SUCCESS, db->checkpoint());
+  ASSERT_TRUE(filesystem::exists(first_log_file));
+
+  ASSERT_EQ(RC::SUCCESS, long_trx->commit());
+  trx_kit.destroy_trx(long_trx);
+  ASSERT_EQ(RC::SUCCESS, db->checkpoint());
+  ASSERT_FALSE(filesystem::exists(first_log_file));
+
+  // 检查点之后再写一些数据，其中有一个事务没有提交，恢复时需要回滚
+  insert_committed(insert_num);
+  Trx *uncommitted_trx = trx_kit.create_trx(db->log_handler());
+  uncommitted_trx->start_if_need();
+  insert_record(uncommitted_trx, -2);
+
+  DiskLogHandler &log_handler = static_cast<DiskLogHandler &>(db->log_handler());
+  ASSERT_EQ(RC::SUCCESS, log_handler.wait_lsn(log_handler.current_lsn()));
+
+  filesystem::copy(db_path, db_path2, filesystem::copy_options::recursive);
+
+  auto db2 = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db2->init(dbname2, db_path2.c_str(), trx_kit_name, log_handler_name));
+
+  Table *table2 = db2->find_table(table_name);
+  ASSERT_NE(table2, nullptr);
+
+  Trx *trx = db2->trx_kit().create_trx(db2->log_handler());
+  trx->start_if_need();
+
+  RecordFileScanner scanner;
+  ASSERT_EQ(RC::SUCCESS, table2->get_record_scanner(scanner, nullptr, ReadWriteMode::READ_ONLY));
+  int    visible_count = 0;
+  Record record;
+  RC     rc = RC::SUCCESS;
+  while (OB_SUCC(rc = scanner.next(record))) {
+    if (OB_SUCC(trx->visit_record(table2, record, ReadWriteMode::READ_ONLY))) {
+      visible_count++;
+    }
+  }
+  ASSERT_EQ(insert_num * 2 + 1, visible_count);
+  db2->trx_kit().destroy_trx(trx);
+
+  trx_kit.destroy_trx(uncommitted_trx);
+  db2.reset();
+  db.reset();
+}
+
+TEST(MvccTrxLog, wal_update)
+{
+  /*
+  原地更新一些记录，其中一部分事务没有提交，恢复时需要使用日志中的旧版本回滚。
+  */
+  filesystem::path test_directory("mvcc_trx_log_test");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  const char      *dbname           = "test_db";
+  const char      *dbname2          = "test_db2";
+  filesystem::path db_path          = test_directory / dbname;
+  filesystem::path db_path2         = test_directory / dbname2;
+  const char      *trx_kit_name     = "mvcc";
+  const char      *log_handler_name = "disk";
+
+  filesystem::create_directories(db_path);
+  filesystem::create_directories(db_path2);
+
+  auto db = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db->init(dbname, db_path.c_str(), trx_kit_name, log_handler_name));
+
+  const char             *table_name = "table_0";
+  vector<AttrInfoSqlNode> attr_infos = {{AttrType::INTS, "id", 4}, {AttrType::INTS, "value", 4}};
+  ASSERT_EQ(RC::SUCCESS, db->create_table(table_name, attr_infos));
+  ASSERT_EQ(RC::SUCCESS, db->sync());
+
+  Table  *table   = db->find_table(table_name);
+  TrxKit &trx_kit = db->trx_kit();
+  ASSERT_NE(table, nullptr);
+  const int value_offset = table->table_meta().field("value")->offset();
+
+  const int insert_num = 1000;
+  Trx      *trx        = trx_kit.create_trx(db->log_handler());
+  trx->start_if_need();
+  for (int i = 0; i < insert_num; i++) {
+    Record        record;
+    vector<Value> values = {Value(i), Value(i)};
+    ASSERT_EQ(RC::SUCCESS, table->make_record(values.size(), values.data(), record));
+    ASSERT_EQ(RC::SUCCESS, trx->insert_record(table, record));
+  }
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  trx_kit.destroy_trx(trx);
+
+  vector<Record> records;
+  {
+    RecordFileScanner scanner;
+    ASSERT_EQ(RC::SUCCESS, table->get_record_scanner(scanner, nullptr, ReadWriteMode::READ_ONLY));
+    Record record;
+    while (OB_SUCC(scanner.next(record))) {
+      records.emplace_back();
+      records.back().copy_data(record.data(), record.len());
+      records.back().set_rid(record.rid());
+    }
+  }
+  ASSERT_EQ(insert_num, static_cast<int>(records.size()));
+
+  // 前一半记录的修改提交了，后一半没有提交
+  Trx *committed_trx   = trx_kit.create_trx(db->log_handler());
+  Trx *uncommitted_trx = trx_kit.create_trx(db->log_handler());
+  committed_trx->start_if_need();
+  uncommitted_trx->start_if_need();
+  for (int i = 0; i < insert_num; i++) {
+    Record new_record(records[i]);
+    *reinterpret_cast<int *>(new_record.data() + value_offset) = -1;
+    Trx   *update_trx = i < insert_num / 2 ? committed_trx : uncommitted_trx;
+    ASSERT_EQ(RC::SUCCESS, update_trx->update_record(table, records[i], new_record));
+  }
+  ASSERT_EQ(RC::SUCCESS, committed_trx->commit());
+  trx_kit.destroy_trx(committed_trx);
+
+  DiskLogHandler &log_handler = static_cast<DiskLogHandler &>(db->log_handler());
+  ASSERT_EQ(RC::SUCCESS, log_handler.wait_lsn(log_handler.current_lsn()));
+
+  filesystem::copy(db_path, db_path2, filesystem::copy_options::recursive);
+
+  auto db2 = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db2->init(dbname2, db_path2.c_str(), trx_kit_name, log_handler_name));
+  ASSERT_EQ(0, static_cast<MvccTrxKit &>(db2->trx_kit()).undo_log().version_num());
+
+  Table *table2 = db2->find_table(table_name);
+  ASSERT_NE(table2, nullptr);
+
+  trx = db2->trx_kit().create_trx(db2->log_handler());
+  trx->start_if_need();
+
+  RecordFileScanner scanner;
+  ASSERT_EQ(RC::SUCCESS, table2->get_record_scanner(scanner, trx, ReadWriteMode::READ_ONLY));
+  int    visible_count = 0;
+  Record record;
+  while (OB_SUCC(scanner.next(record))) {
+    const int id    = *reinterpret_cast<const int *>(record.data() + table2->table_meta().field("id")->offset());
+    const int value = *reinterpret_cast<const int *>(record.data() + value_offset);
+    ASSERT_EQ(id < insert_num / 2 ? -1 : id, value);
+    visible_count++;
+  }
+  ASSERT_EQ(insert_num, visible_count);
+  scanner.close_scan();
+  db2->trx_kit().destroy_trx(trx);
+
+  trx_kit.destroy_trx(uncommitted_trx);
+  db2.reset();
+  db.reset();
+}
+
+TEST(MvccTrxLog, checkpoint_trx_id)
+{
+  /*
+  提交一些事务之后做检查点，提交日志都会被删除。
+  复制到另一个目录重新打开数据库，新的事务号要比记录上的提交事务号大，才能看到之前提交的数据。
+  */
+  filesystem::path test_directory("mvcc_trx_log_test");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  const char      *dbname           = "test_db";
+  const char      *dbname2          = "test_db2";
+  filesystem::path db_path          = test_directory / dbname;
+  filesystem::path db_path2         = test_directory / dbname2;
+  const char      *trx_kit_name     = "mvcc";
+  const char      *log_handler_name = "disk";
+
+  filesystem::create_directories(db_path);
+  filesystem::create_directories(db_path2);
+
+  auto db = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db->init(dbname, db_path.c_str(), trx_kit_name, log_handler_name));
+
+  const char             *table_name = "table_0";
+  vector<AttrInfoSqlNode> attr_infos = {{AttrType::INTS, "id", 4}};
+  ASSERT_EQ(RC::SUCCESS, db->create_table(table_name, attr_infos));
+  ASSERT_EQ(RC::SUCCESS, db->sync());
+
+  Table  *table   = db->find_table(table_name);
+  TrxKit &trx_kit = db->trx_kit();
+  ASSERT_NE(table, nullptr);
+
+  const int insert_num = 100;
+  for (int i = 0; i < insert_num; i++) {
+    Trx *trx = trx_kit.create_trx(db->log_handler());
+    trx->start_if_need();
+    Record        record;
+    vector<Value> values = {Value(i)};
+    ASSERT_EQ(RC::SUCCESS, table->make_record(values.size(), values.data(), record));
+    ASSERT_EQ(RC::SUCCESS, trx->insert_record(table, record));
+    ASSERT_EQ(RC::SUCCESS, trx->commit());
+    trx_kit.destroy_trx(trx);
+  }
+
+  const int32_t max_trx_id = trx_kit.current_trx_id();
+  ASSERT_EQ(RC::SUCCESS, db->checkpoint());
+  filesystem::copy(db_path, db_path2, filesystem::copy_options::recursive);
+
+  auto db2 = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db2->init(dbname2, db_path2.c_str(), trx_kit_name, log_handler_name));
+  ASSERT_GE(db2->trx_kit().current_trx_id(), max_trx_id);
+
+  Table *table2 = db2->find_table(table_name);
+  ASSERT_NE(table2, nullptr);
+
+  Trx *trx = db2->trx_kit().create_trx(db2->log_handler());
+  trx->start_if_need();
+
+  RecordFileScanner scanner;
+  ASSERT_EQ(RC::SUCCESS, table2->get_record_scanner(scanner, trx, ReadWriteMode::READ_ONLY));
+  int    visible_count = 0;
+  Record record;
+  while (OB_SUCC(scanner.next(record))) {
+    visible_count++;
+  }
+  scanner.close_scan();
+  ASSERT_EQ(insert_num, visible_count);
+  db2->trx_kit().destroy_trx(trx);
+
+  db2.reset();
+  db.reset();
+}
+
+TEST(MvccTrxLog, checkpoint_failed_bulk_load)
+{
+  /*
+  创建索引时批量构建失败，会关闭并删除索引文件，同时检查点线程在不停地刷脏页。
+  关闭文件时会删除 buffer pool，检查点不能访问已经删除的 buffer pool。最后还可以创建同名的索引。
+  */
+  filesystem::path test_directory("mvcc_trx_log_test");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  const char      *dbname           = "test_db";
+  filesystem::path db_path          = test_directory / dbname;
+  const char      *trx_kit_name     = "mvcc";
+  const char      *log_handler_name = "disk";
+
+  filesystem::create_directories(db_path);
+
+  auto db = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db->init(dbname, db_path.c_str(), trx_kit_name, log_handler_name));
+
+  const char             *table_name = "table_0";
+  vector<AttrInfoSqlNode> attr_infos = {{AttrType::INTS, "id", 4}};
+  ASSERT_EQ(RC::SUCCESS, db->create_table(table_name, attr_infos));
+  ASSERT_EQ(RC::SUCCESS, db->sync());
+
+  Table  *table   = db->find_table(table_name);
+  TrxKit &trx_kit = db->trx_kit();
+  ASSERT_NE(table, nullptr);
+
+  Trx *trx = trx_kit.create_trx(db->log_handler());
+  trx->start_if_need();
+  for (int i = 0; i < 2000; i++) {
+    Record        record;
+    vector<Value> values = {Value(i)};
+    ASSERT_EQ(RC::SUCCESS, table->make_record(values.size(), values.data(), record));
+    ASSERT_EQ(RC::SUCCESS, trx->insert_record(table, record));
+  }
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  trx_kit.destroy_trx(trx);
+
+  atomic<bool> stopped{false};
+  thread       checkpoint_thread([&db, &stopped]() {
+    while (!stopped.load()) {
+      // 有页面正在修改时不能确定检查点，与检查点线程一样忽略 LOCKED_NEED_WAIT
+      RC rc = db->checkpoint();
+      EXPECT_TRUE(rc == RC::SUCCESS || rc == RC::LOCKED_NEED_WAIT) << strrc(rc);
+    }
+  });
+
+  const char                     *index_name  = "index_id";
+  const string                    index_file  = table_index_file(db_path.c_str(), table_name, index_name);
+  const vector<const FieldMeta *> field_metas = {table->table_meta().field("id")};
+  for (int i = 0; i < 50; i++) {
+    IndexMeta index_meta;
+    ASSERT_EQ(RC::SUCCESS, index_meta.init(index_name, field_metas, {}));
+
+    auto index = make_unique<BplusTreeIndex>();
+    ASSERT_EQ(RC::SUCCESS, index->create(table, index_file.c_str(), index_meta, field_metas, {}));
+
+    // 先插入一些数据，产生一些脏页。索引不是空的，批量构建会在读完所有数据之后失败
+    RecordFileScanner scanner;
+    Record            record;
+    ASSERT_EQ(RC::SUCCESS, table->get_record_scanner(scanner, nullptr, ReadWriteMode::READ_ONLY));
+    for (int j = 0; j < 500 && OB_SUCC(scanner.next(record)); j++) {
+      ASSERT_EQ(RC::SUCCESS, index->insert_entry(record.data(), &record.rid()));
+    }
+    scanner.close_scan();
+
+    RecordFileScanner bulk_load_scanner;
+    ASSERT_EQ(RC::SUCCESS, table->get_record_scanner(bulk_load_scanner, nullptr, ReadWriteMode::READ_ONLY));
+    ASSERT_NE(RC::SUCCESS, index->bulk_load(bulk_load_scanner));
+    bulk_load_scanner.close_scan();
+
+    // 与 Table::create_index 失败时一样清理
+    ASSERT_EQ(RC::SUCCESS, index->close());
+    index.reset();
+    ASSERT_TRUE(filesystem::remove(index_file));
+  }
+
+  stopped.store(true);
+  checkpoint_thread.join();
+
+  ASSERT_EQ(RC::SUCCESS, table->create_index(nullptr, field_metas, index_name, {}));
+  ASSERT_NE(nullptr, table->find_index(index_name));
+
+  db.reset();
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,425 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "common/log/log.h"
+#include "storage/db/db.h"
+#include "storage/index/index.h"
+#include "storage/common/chunk.h"
+#include "storage/common/column.h"
+#include "storage/record/record.h"
+#include "storage/record/record_manager.h"
+#include "storage/table/table.h"
+#include "storage/trx/mvcc_trx.h"
+#include "storage/trx/read_view.h"
+
+using namespace std;
+using namespace common;
+
+class MvccTrxTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    filesystem::remove_all(directory_);
+    filesystem::create_directories(directory_);
+
+    db_ = make_unique<Db>();
+    ASSERT_EQ(RC::SUCCESS, db_->init("test_db", directory_.c_str(), "mvcc", "disk"));
+
+    vector<AttrInfoSqlNode> attr_infos = {{AttrType::INTS, "id", 4}, {AttrType::INTS, "v", 4}};
+    ASSERT_EQ(RC::SUCCESS, db_->create_table("t", attr_infos));
+    table_ = db_->find_table("t");
+    ASSERT_NE(nullptr, table_);
+    ASSERT_EQ(RC::SUCCESS, table_->create_index(nullptr, {table_->table_meta().field("id")}, "t_id"));
+
+    Trx *trx = begin();
+    for (int i = 0; i < row_num_; i++) {
+      Record        record;
+      vector<Value> values = {Value(i), Value(i * 10)};
+      ASSERT_EQ(RC::SUCCESS, table_->make_record(values.size(), values.data(), record));
+      ASSERT_EQ(RC::SUCCESS, trx->insert_record(table_, record));
+    }
+    finish(trx, true);
+  }
+
+  void TearDown() override
+  {
+    db_.reset();
+    filesystem::remove_all(directory_);
+  }
+
+  Trx *begin()
+  {
+    Trx *trx = db_->trx_kit().create_trx(db_->log_handler());
+    trx->start_if_need();
+    return trx;
+  }
+
+  void finish(Trx *trx, bool commit)
+  {
+    ASSERT_EQ(RC::SUCCESS, commit ? trx->commit() : trx->rollback());
+    db_->trx_kit().destroy_trx(trx);
+  }
+
+  UndoLog &undo_log() { return static_cast<MvccTrxKit &>(db_->trx_kit()).undo_log(); }
+
+  int field_value(const Record &record, const char *field_name)
+  {
+    int value = 0;
+    memcpy(&value, record.data() + table_->table_meta().field(field_name)->offset(), sizeof(value));
+    return value;
+  }
+
+  /// 事务看到的所有记录，id -> v
+  map<int, int> read(Trx *trx)
+  {
+    map<int, int>     rows;
+    RecordFileScanner scanner;
+    EXPECT_EQ(RC::SUCCESS, table_->get_record_scanner(scanner, trx, ReadWriteMode::READ_ONLY));
+    Record record;
+    while (OB_SUCC(scanner.next(record))) {
+      rows[field_value(record, "id")] = field_value(record, "v");
+    }
+    scanner.close_scan();
+    return rows;
+  }
+
+  /// 使用 chunk 扫描时事务看到的所有记录，id -> v
+  map<int, int> read_chunks(Trx *trx)
+  {
+    const TableMeta &table_meta = table_->table_meta();
+    Chunk            chunk;
+    chunk.add_column(make_unique<Column>(*table_meta.field("id")), table_meta.field("id")->field_id());
+    chunk.add_column(make_unique<Column>(*table_meta.field("v")), table_meta.field("v")->field_id());
+
+    map<int, int>    rows;
+    ChunkFileScanner scanner;
+    EXPECT_EQ(RC::SUCCESS, table_->get_chunk_scanner(scanner, trx, ReadWriteMode::READ_ONLY));
+    while (OB_SUCC(scanner.next_chunk(chunk))) {
+      for (int i = 0; i < chunk.selected_rows(); i++) {
+        const int row = chunk.row_index(i);
+        rows[chunk.get_value(0, row).get_int()] = chunk.get_value(1, row).get_int();
+      }
+      chunk.reset_data();
+    }
+    scanner.close_scan();
+    return rows;
+  }
+
+  /// 把 id 对应的记录的 field_name 字段修改成 value
+  RC update(Trx *trx, int id, const char *field_name, int value, RID *rid = nullptr)
+  {
+    RecordFileScanner scanner;
+    RC                rc = table_->get_record_scanner(scanner, trx, ReadWriteMode::READ_WRITE);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    Record record;
+    while (OB_SUCC(rc = scanner.next(record)) && field_value(record, "id") != id) {
+    }
+    scanner.close_scan();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    // 扫描出来的记录可能直接指向页面，复制出来再修改
+    Record old_record;
+    old_record.copy_data(record.data(), record.len());
+    old_record.set_rid(record.rid());
+
+    Record new_record(old_record);
+    memcpy(new_record.data() + table_->table_meta().field(field_name)->offset(), &value, sizeof(value));
+    rc = trx->update_record(table_, old_record, new_record);
+    if (OB_SUCC(rc) && rid != nullptr) {
+      *rid = new_record.rid();
+    }
+    return rc;
+  }
+
+  /// 删除 id 对应的记录
+  RC remove(Trx *trx, int id)
+  {
+    RecordFileScanner scanner;
+    RC                rc = table_->get_record_scanner(scanner, trx, ReadWriteMode::READ_WRITE);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    Record record;
+    while (OB_SUCC(rc = scanner.next(record)) && field_value(record, "id") != id) {
+    }
+    scanner.close_scan();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    return trx->delete_record(table_, record);
+  }
+
+  RC insert(Trx *trx, int id, int v)
+  {
+    Record        record;
+    vector<Value> values = {Value(id), Value(v)};
+    RC            rc     = table_->make_record(values.size(), values.data(), record);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    return trx->insert_record(table_, record);
+  }
+
+  int count_index_entries(int id)
+  {
+    Index        *index   = table_->find_index("t_id");
+    IndexScanner *scanner = index->create_scanner(
+        reinterpret_cast<const char *>(&id), sizeof(id), true, reinterpret_cast<const char *>(&id), sizeof(id), true);
+    int num = 0;
+    RID rid;
+    while (OB_SUCC(scanner->next_entry(&rid))) {
+      num++;
+    }
+    scanner->destroy();
+    return num;
+  }
+
+protected:
+  filesystem::path directory_ = "mvcc_trx_test";
+  unique_ptr<Db>   db_;
+  Table           *table_  = nullptr;
+  const int        row_num_ = 10;
+};
+
+TEST_F(MvccTrxTest, update_in_place)
+{
+  Trx *reader = begin();
+  Trx *writer = begin();
+
+  RID rid;
+  ASSERT_EQ(RC::SUCCESS, update(writer, 1, "v", 100, &rid));
+  ASSERT_EQ(RC::SUCCESS, update(writer, 1, "v", 101));
+  ASSERT_EQ(1, undo_log().version_num());  // 同一个事务多次修改只保存一个旧版本
+  ASSERT_EQ(1, count_index_entries(1));   // 没有修改索引字段，索引项不变
+
+  // 修改之后记录的位置不变，其它事务读到的是修改之前的版本
+  Record record;
+  ASSERT_EQ(RC::SUCCESS, table_->get_record(rid, record));
+  ASSERT_EQ(101, field_value(record, "v"));
+  ASSERT_EQ(101, read(writer)[1]);
+  ASSERT_EQ(10, read(reader)[1]);
+  ASSERT_EQ(static_cast<size_t>(row_num_), read(reader).size());
+
+  Trx *before_commit = begin();
+  ASSERT_EQ(10, read(before_commit)[1]);
+
+  finish(writer, true);
+
+  // 提交之前开始的事务仍然看到旧版本，之后开始的事务看到新版本
+  ASSERT_EQ(10, read(reader)[1]);
+  ASSERT_EQ(10, read(before_commit)[1]);
+  Trx *after_commit = begin();
+  ASSERT_EQ(101, read(after_commit)[1]);
+
+  // 旧版本在所有活跃的事务都能看到新版本之后才清理
+  finish(reader, true);
+  ASSERT_EQ(1, undo_log().version_num());
+  finish(before_commit, true);
+  ASSERT_EQ(0, undo_log().version_num());
+  finish(after_commit, true);
+}
+
+TEST_F(MvccTrxTest, update_conflict)
+{
+  Trx *reader  = begin();
+  Trx *writer  = begin();
+  Trx *writer2 = begin();
+
+  ASSERT_EQ(RC::SUCCESS, update(writer, 2, "v", 200));
+  ASSERT_EQ(RC::LOCKED_CONCURRENCY_CONFLICT, update(writer2, 2, "v", 201));
+  finish(writer2, false);
+  finish(writer, true);
+
+  // 提交之前开始的事务不能再修改这条记录
+  ASSERT_EQ(RC::LOCKED_CONCURRENCY_CONFLICT, update(reader, 2, "v", 202));
+  ASSERT_EQ(RC::SUCCESS, update(reader, 3, "v", 300));
+  finish(reader, true);
+
+  Trx *trx = begin();
+  ASSERT_EQ(200, read(trx)[2]);
+  ASSERT_EQ(300, read(trx)[3]);
+  finish(trx, true);
+  ASSERT_EQ(0, undo_log().version_num());
+}
+
+TEST_F(MvccTrxTest, rollback)
+{
+  Trx *writer = begin();
+  ASSERT_EQ(RC::SUCCESS, update(writer, 4, "v", 400));
+  ASSERT_EQ(RC::SUCCESS, update(writer, 5, "id", 50));
+  ASSERT_EQ(400, read(writer)[4]);
+  finish(writer, false);
+  ASSERT_EQ(0, undo_log().version_num());
+
+  Trx *trx = begin();
+  map<int, int> rows = read(trx);
+  ASSERT_EQ(static_cast<size_t>(row_num_), rows.size());
+  ASSERT_EQ(40, rows[4]);
+  ASSERT_EQ(50, rows[5]);
+  ASSERT_EQ(0, rows.count(50));
+  finish(trx, true);
+}
+
+TEST_F(MvccTrxTest, update_index_field)
+{
+  Trx *reader = begin();
+  Trx *writer = begin();
+
+  // 修改索引字段时插入一条新的记录，旧的索引项仍然指向旧版本
+  RID old_rid;
+  RID new_rid;
+  ASSERT_EQ(RC::SUCCESS, update(writer, 6, "v", 600, &old_rid));
+  ASSERT_EQ(RC::SUCCESS, update(writer, 6, "id", 66, &new_rid));
+  ASSERT_NE(old_rid, new_rid);
+  ASSERT_EQ(1, count_index_entries(6));
+  ASSERT_EQ(1, count_index_entries(66));
+  finish(writer, true);
+
+  map<int, int> rows = read(reader);
+  ASSERT_EQ(60, rows[6]);
+  ASSERT_EQ(0, rows.count(66));
+  finish(reader, true);
+
+  Trx *trx = begin();
+  rows     = read(trx);
+  ASSERT_EQ(0, rows.count(6));
+  ASSERT_EQ(600, rows[66]);
+  ASSERT_EQ(static_cast<size_t>(row_num_), rows.size());
+  finish(trx, true);
+}
+
+TEST_F(MvccTrxTest, snapshot_read)
+{
+  Trx *reader = begin();
+
+  for (int v : {100, 101}) {
+    Trx *writer = begin();
+    ASSERT_EQ(RC::SUCCESS, update(writer, 1, "v", v));
+    finish(writer, true);
+  }
+  Trx *writer = begin();
+  ASSERT_EQ(RC::SUCCESS, remove(writer, 2));
+  ASSERT_EQ(RC::SUCCESS, insert(writer, 100, 1000));
+  finish(writer, true);
+
+  // 读视图创建之后提交的修改都看不到，沿着版本链读到最早的版本
+  map<int, int> rows = read(reader);
+  ASSERT_EQ(static_cast<size_t>(row_num_), rows.size());
+  ASSERT_EQ(10, rows[1]);
+  ASSERT_EQ(20, rows[2]);
+  ASSERT_EQ(0, rows.count(100));
+  ASSERT_EQ(2, undo_log().version_num());
+
+  // 能看到但是已经被其它事务删除的记录不能再修改
+  ASSERT_EQ(RC::LOCKED_CONCURRENCY_CONFLICT, update(reader, 2, "v", 200));
+  finish(reader, false);
+  ASSERT_EQ(0, undo_log().version_num());
+
+  Trx *trx = begin();
+  rows     = read(trx);
+  ASSERT_EQ(101, rows[1]);
+  ASSERT_EQ(0, rows.count(2));
+  ASSERT_EQ(1000, rows[100]);
+  finish(trx, true);
+}
+
+TEST_F(MvccTrxTest, delete_own_insert)
+{
+  Trx *trx = begin();
+  ASSERT_EQ(RC::SUCCESS, insert(trx, 100, 1000));
+  ASSERT_EQ(1000, read(trx)[100]);
+  ASSERT_EQ(RC::SUCCESS, remove(trx, 100));
+  ASSERT_EQ(0, read(trx).count(100));
+  finish(trx, true);
+
+  trx = begin();
+  ASSERT_EQ(0, read(trx).count(100));
+  finish(trx, true);
+}
+
+TEST_F(MvccTrxTest, chunk_scan)
+{
+  Trx *reader = begin();
+  Trx *writer = begin();
+  ASSERT_EQ(RC::SUCCESS, update(writer, 1, "v", 100));
+  ASSERT_EQ(RC::SUCCESS, insert(writer, 100, 1000));
+
+  // 其它事务没有提交的修改看不到
+  ASSERT_EQ(read(reader), read_chunks(reader));
+  ASSERT_EQ(10, read_chunks(reader)[1]);
+  ASSERT_EQ(0, read_chunks(reader).count(100));
+  ASSERT_EQ(read(writer), read_chunks(writer));
+  ASSERT_EQ(100, read_chunks(writer)[1]);
+  finish(writer, true);
+
+  writer = begin();
+  ASSERT_EQ(RC::SUCCESS, remove(writer, 2));
+  finish(writer, true);
+
+  // 读视图创建之后提交的修改也看不到
+  map<int, int> rows = read_chunks(reader);
+  ASSERT_EQ(static_cast<size_t>(row_num_), rows.size());
+  ASSERT_EQ(10, rows[1]);
+  ASSERT_EQ(20, rows[2]);
+  finish(reader, true);
+
+  Trx *trx = begin();
+  rows     = read_chunks(trx);
+  ASSERT_EQ(read(trx), rows);
+  ASSERT_EQ(0, rows.count(2));
+  ASSERT_EQ(1000, rows[100]);
+  finish(trx, true);
+}
+
+TEST(ReadView, committed_visible)
+{
+  ReadView read_view;
+  ASSERT_FALSE(read_view.is_open());
+
+  // 事务号10创建读视图时，提交事务号为7和9的事务正在提交
+  read_view.open(10, {9, 7});
+  ASSERT_TRUE(read_view.is_open());
+  ASSERT_EQ(7, read_view.up_limit());
+  ASSERT_TRUE(read_view.committed_visible(6));
+  ASSERT_FALSE(read_view.committed_visible(7));
+  ASSERT_TRUE(read_view.committed_visible(8));
+  ASSERT_FALSE(read_view.committed_visible(9));
+  ASSERT_FALSE(read_view.committed_visible(10));
+  ASSERT_FALSE(read_view.committed_visible(11));
+
+  read_view.close();
+  ASSERT_FALSE(read_view.is_open());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  filesystem::path log_filename = filesystem::path(argv[0]).filename();
+  LoggerFactory::init_default(log_filename.string() + ".log", LOG_LEVEL_INFO);
+  return RUN_ALL_TESTS();
+}
@@ -88,7 +88,7 @@ TEST_P(PaxRecordFileScannerWithParam, test_file_iterator)
   ASSERT_EQ(count, 0);
 
   // chunk iterator
-  rc = chunk_scanner.open_scan_chunk(&table, *bp, log_handler, ReadWriteMode::READ_ONLY);
+  rc = chunk_scanner.open_scan_chunk(&table, *bp, nullptr /*trx*/, log_handler, ReadWriteMode::READ_ONLY);
   ASSERT_EQ(rc, RC::SUCCESS);
   Chunk     chunk;
   FieldMeta fm;
@@ -97,7 +97,7 @@ TEST_P(PaxRecordFileScannerWithParam, test_file_iterator)
   chunk.add_column(std::move(col1), 0);
   count = 0;
   while (OB_SUCC(rc = chunk_scanner.next_chunk(chunk))) {
-    count += chunk.rows();
+    count += chunk.selected_rows();
     chunk.reset_data();
   }
   ASSERT_EQ(rc, RC::RECORD_EOF);
@@ -108,6 +108,8 @@ TEST_P(PaxRecordFileScannerWithParam, test_file_iterator)
   std::vector<RID> rids;
   for (int i = 0; i < record_insert_num; i++) {
     RID rid;
+    memcpy(record_data, &i, sizeof(i));
+    memcpy(record_data + sizeof(i), &i, sizeof(i));
     rc = file_handler.insert_record(record_data, sizeof(record_data), &rid);
     ASSERT_EQ(rc, RC::SUCCESS);
     rids.push_back(rid);
@@ -127,12 +129,12 @@ TEST_P(PaxRecordFileScannerWithParam, test_file_iterator)
   ASSERT_EQ(count, rids.size());
 
   // chunk iterator
-  rc = chunk_scanner.open_scan_chunk(&table, *bp, log_handler, ReadWriteMode::READ_ONLY);
+  rc = chunk_scanner.open_scan_chunk(&table, *bp, nullptr /*trx*/, log_handler, ReadWriteMode::READ_ONLY);
   ASSERT_EQ(rc, RC::SUCCESS);
   chunk.reset_data();
   count = 0;
   while (OB_SUCC(rc = chunk_scanner.next_chunk(chunk))) {
-    count += chunk.rows();
+    count += chunk.selected_rows();
     chunk.reset_data();
   }
   ASSERT_EQ(rc, RC::RECORD_EOF);
@@ -158,17 +160,41 @@ TEST_P(PaxRecordFileScannerWithParam, test_file_iterator)
   ASSERT_EQ(count, rids.size() / 2);
 
   // chunk iterator
-  rc = chunk_scanner.open_scan_chunk(&table, *bp, log_handler, ReadWriteMode::READ_ONLY);
+  rc = chunk_scanner.open_scan_chunk(&table, *bp, nullptr /*trx*/, log_handler, ReadWriteMode::READ_ONLY);
   ASSERT_EQ(rc, RC::SUCCESS);
   chunk.reset_data();
   count = 0;
   while (OB_SUCC(rc = chunk_scanner.next_chunk(chunk))) {
-    count += chunk.rows();
+    count += chunk.selected_rows();
     chunk.reset_data();
   }
   ASSERT_EQ(rc, RC::RECORD_EOF);
   ASSERT_EQ(count, rids.size() / 2);
 
+  // get records by rids
+  vector<RID> left_rids;
+  for (int i = 1; i < record_insert_num; i += 2) {
+    left_rids.push_back(rids[i]);
+  }
+  Chunk     rid_chunk;
+  FieldMeta fm2;
+  fm2.init("col2", AttrType::INTS, 4, 4, true, 1);
+  rid_chunk.add_column(make_unique<Column>(fm, max<size_t>(left_rids.size(), 1)), 0);
+  rid_chunk.add_column(make_unique<Column>(fm2, max<size_t>(left_rids.size(), 1)), 1);
+  rc = file_handler.get_chunk(left_rids, rid_chunk);
+  ASSERT_EQ(rc, RC::SUCCESS);
+  ASSERT_EQ(rid_chunk.rows(), static_cast<int>(left_rids.size()));
+  for (int i = 0; i < rid_chunk.rows(); i++) {
+    ASSERT_EQ(rid_chunk.get_value(0, i).get_int(), i * 2 + 1);
+    ASSERT_EQ(rid_chunk.get_value(1, i).get_int(), i * 2 + 1);
+  }
+
+  // deleted records cannot be fetched
+  if (record_insert_num > 0) {
+    rid_chunk.reset_data();
+    ASSERT_EQ(file_handler.get_chunk(span<const RID>(&rids[0], 1), rid_chunk), RC::RECORD_NOT_EXIST);
+  }
+
   bpm->close_file(record_manager_file);
   delete bpm;
 }
@@ -273,14 +299,20 @@ TEST_P(PaxPageHandlerTestWithParam, PaxPageHandler)
   chunk1.add_column(std::move(col_4), 3);
   rc = record_page_handle->get_chunk(chunk1);
   ASSERT_EQ(rc, RC::SUCCESS);
-  ASSERT_EQ(chunk1.rows(), record_num);
+  ASSERT_EQ(chunk1.selected_rows(), record_num);
+  // 记录足够多时直接引用页面中的数据
+  if (!chunk1.column(0).own()) {
+    ASSERT_GE(chunk1.column(0).data(), frame->data());
+    ASSERT_LT(chunk1.column(0).data(), frame->data() + BP_PAGE_SIZE);
+  }
   for (int i = 0; i < record_num; i++) {
     int   int_val   = i + int_base;
     float float_val = i + float_base;
-    ASSERT_EQ(chunk1.get_value(0, i).get_int(), int_val);
-    ASSERT_EQ(chunk1.get_value(1, i).get_float(), float_val);
-    ASSERT_STREQ(chunk1.get_value(2, i).get_string().c_str(), "1234");
-    ASSERT_STREQ(chunk1.get_value(3, i).get_string().c_str(), "5678910");
+    int   row       = chunk1.row_index(i);
+    ASSERT_EQ(chunk1.get_value(0, row).get_int(), int_val);
+    ASSERT_EQ(chunk1.get_value(1, row).get_float(), float_val);
+    ASSERT_STREQ(chunk1.get_value(2, row).get_string().c_str(), "1234");
+    ASSERT_STREQ(chunk1.get_value(3, row).get_string().c_str(), "5678910");
   }
 
   Chunk     chunk2;
@@ -290,10 +322,10 @@ TEST_P(PaxPageHandlerTestWithParam, PaxPageHandler)
   chunk2.add_column(std::move(col_2_1), 1);
   rc = record_page_handle->get_chunk(chunk2);
   ASSERT_EQ(rc, RC::SUCCESS);
-  ASSERT_EQ(chunk2.rows(), record_num);
+  ASSERT_EQ(chunk2.selected_rows(), record_num);
   for (int i = 0; i < record_num; i++) {
     float float_val = i + float_base;
-    ASSERT_FLOAT_EQ(chunk2.get_value(0, i).get_float(), float_val);
+    ASSERT_FLOAT_EQ(chunk2.get_value(0, chunk2.row_index(i)).get_float(), float_val);
   }
 
   // delete record
@@ -316,12 +348,12 @@ TEST_P(PaxPageHandlerTestWithParam, PaxPageHandler)
   // get chunk
   chunk1.reset_data();
   record_page_handle->get_chunk(chunk1);
-  ASSERT_EQ(chunk1.rows(), record_num - delete_num);
+  ASSERT_EQ(chunk1.selected_rows(), record_num - delete_num);
 
   int col1_expected = (int_base + 0 + int_base + record_num - 1) * record_num /2;
   int col1_actual   = 0;
-  for (int i = 0; i < chunk1.rows(); i++) {
-    col1_actual += chunk1.get_value(0, i).get_int();
+  for (int i = 0; i < chunk1.selected_rows(); i++) {
+    col1_actual += chunk1.get_value(0, chunk1.row_index(i)).get_int();
   }
   for (auto it = delete_slots.begin(); it != delete_slots.end(); ++it) {
     col1_actual += *it + int_base;
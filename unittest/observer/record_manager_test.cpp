@@ -337,9 +337,10 @@ TEST(RecordManager, durability)
   ASSERT_EQ(bpm2.open_file(log_handler2, record_manager_file.c_str(), buffer_pool2), RC::SUCCESS);
   ASSERT_NE(buffer_pool2, nullptr);
 
-  IntegratedLogReplayer log_replayer2(bpm2);
+  IntegratedLogReplayer log_replayer2(bpm2, 4 /*worker_num*/);
   ASSERT_EQ(log_handler2.init(directory.c_str()), RC::SUCCESS);
   ASSERT_EQ(log_handler2.replay(log_replayer2, 0), RC::SUCCESS);
+  ASSERT_EQ(log_replayer2.on_done(), RC::SUCCESS);
   ASSERT_EQ(log_handler2.start(), RC::SUCCESS);
 
   RecordFileHandler record_file_handler2(StorageFormat::ROW_FORMAT);
@@ -355,6 +356,181 @@ TEST(RecordManager, durability)
   bpm2.close_file(record_manager_file.c_str());
 }
 
+TEST(RecordManager, insert_records)
+{
+  /*
+   * 测试场景：
+   * 1. 批量插入记录，记录会写到多个页面上
+   * 2. 重启数据库，从日志中恢复，检查记录是否恢复
+   */
+  filesystem::path directory("record_manager_insert_records");
+  filesystem::remove_all(directory);
+  ASSERT_TRUE(filesystem::create_directories(directory));
+
+  filesystem::path record_manager_file = directory / "record_manager.bp";
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(bpm.init(make_unique<VacuousDoubleWriteBuffer>()), RC::SUCCESS);
+
+  DiskLogHandler        log_handler;
+  IntegratedLogReplayer log_replayer(bpm);
+  ASSERT_EQ(log_handler.init(directory.c_str()), RC::SUCCESS);
+  ASSERT_EQ(log_handler.replay(log_replayer, 0), RC::SUCCESS);
+  ASSERT_EQ(log_handler.start(), RC::SUCCESS);
+
+  DiskBufferPool *buffer_pool = nullptr;
+  ASSERT_EQ(bpm.create_file(record_manager_file.c_str()), RC::SUCCESS);
+  ASSERT_EQ(bpm.open_file(log_handler, record_manager_file.c_str(), buffer_pool), RC::SUCCESS);
+
+  RecordFileHandler record_file_handler(StorageFormat::ROW_FORMAT);
+  ASSERT_EQ(record_file_handler.init(*buffer_pool, log_handler, nullptr), RC::SUCCESS);
+
+  // 先删除一条记录，批量插入时要能使用页面中间的空闲位置
+  const int record_size = 100;
+  char      record_data[record_size];
+  RID       rids[3];
+  for (RID &rid : rids) {
+    memset(record_data, 0, sizeof(record_data));
+    ASSERT_EQ(record_file_handler.insert_record(record_data, record_size, &rid), RC::SUCCESS);
+  }
+  ASSERT_EQ(record_file_handler.delete_record(&rids[1]), RC::SUCCESS);
+
+  const int      record_num = 1000;
+  vector<Record> records(record_num);
+  for (int i = 0; i < record_num; i++) {
+    snprintf(record_data, sizeof(record_data), "record %d", i);
+    ASSERT_EQ(records[i].copy_data(record_data, record_size), RC::SUCCESS);
+  }
+  ASSERT_EQ(record_file_handler.insert_records(records, record_size), RC::SUCCESS);
+  ASSERT_EQ(records[0].rid(), rids[1]);
+
+  unordered_set<RID, RIDHash> rid_set;
+  unordered_set<PageNum>      pages;
+  for (const Record &record : records) {
+    ASSERT_TRUE(rid_set.insert(record.rid()).second);
+    pages.insert(record.rid().page_num);
+
+    Record stored;
+    ASSERT_EQ(record_file_handler.get_record(record.rid(), stored), RC::SUCCESS);
+    ASSERT_EQ(memcmp(stored.data(), record.data(), record_size), 0);
+  }
+  ASSERT_GT(pages.size(), 1);
+
+  // 复制出没有刷盘的文件，再从日志中恢复
+  filesystem::path record_manager_file_copy = directory / "record_manager_copy.bp";
+  filesystem::copy_file(record_manager_file, record_manager_file_copy);
+  record_file_handler.close();
+  bpm.close_file(record_manager_file.c_str());
+  filesystem::remove(record_manager_file);
+  ASSERT_EQ(log_handler.stop(), RC::SUCCESS);
+  ASSERT_EQ(log_handler.await_termination(), RC::SUCCESS);
+
+  DiskLogHandler    log_handler2;
+  BufferPoolManager bpm2;
+  ASSERT_EQ(RC::SUCCESS, bpm2.init(make_unique<VacuousDoubleWriteBuffer>()));
+  DiskBufferPool *buffer_pool2 = nullptr;
+  filesystem::copy(record_manager_file_copy, record_manager_file);
+  ASSERT_EQ(bpm2.open_file(log_handler2, record_manager_file.c_str(), buffer_pool2), RC::SUCCESS);
+
+  IntegratedLogReplayer log_replayer2(bpm2);
+  ASSERT_EQ(log_handler2.init(directory.c_str()), RC::SUCCESS);
+  ASSERT_EQ(log_handler2.replay(log_replayer2, 0), RC::SUCCESS);
+  ASSERT_EQ(log_replayer2.on_done(), RC::SUCCESS);
+  ASSERT_EQ(log_handler2.start(), RC::SUCCESS);
+
+  RecordFileHandler record_file_handler2(StorageFormat::ROW_FORMAT);
+  ASSERT_EQ(record_file_handler2.init(*buffer_pool2, log_handler2, nullptr), RC::SUCCESS);
+  for (const Record &record : records) {
+    Record stored;
+    ASSERT_EQ(record_file_handler2.get_record(record.rid(), stored), RC::SUCCESS);
+    ASSERT_EQ(memcmp(stored.data(), record.data(), record_size), 0);
+  }
+
+  record_file_handler2.close();
+  ASSERT_EQ(log_handler2.stop(), RC::SUCCESS);
+  ASSERT_EQ(log_handler2.await_termination(), RC::SUCCESS);
+  bpm2.close_file(record_manager_file.c_str());
+}
+
+TEST(RecordManager, replay_allocated_pages)
+{
+  /*
+   * 测试场景：
+   * 1. 创建文件之后马上复制出来，模拟新分配的页面都还没有落盘时崩溃
+   * 2. 插入记录，记录会写到多个新分配的页面上
+   * 3. 使用多个线程从日志中恢复，页面上的日志要在分配页面之后回放
+   */
+  filesystem::path directory("record_manager_replay_allocated_pages");
+  filesystem::remove_all(directory);
+  ASSERT_TRUE(filesystem::create_directories(directory));
+
+  filesystem::path record_manager_file      = directory / "record_manager.bp";
+  filesystem::path record_manager_file_copy = directory / "record_manager_copy.bp";
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(bpm.init(make_unique<VacuousDoubleWriteBuffer>()), RC::SUCCESS);
+
+  DiskLogHandler        log_handler;
+  IntegratedLogReplayer log_replayer(bpm);
+  ASSERT_EQ(log_handler.init(directory.c_str()), RC::SUCCESS);
+  ASSERT_EQ(log_handler.replay(log_replayer, 0), RC::SUCCESS);
+  ASSERT_EQ(log_handler.start(), RC::SUCCESS);
+
+  DiskBufferPool *buffer_pool = nullptr;
+  ASSERT_EQ(bpm.create_file(record_manager_file.c_str()), RC::SUCCESS);
+  filesystem::copy_file(record_manager_file, record_manager_file_copy);
+  ASSERT_EQ(bpm.open_file(log_handler, record_manager_file.c_str(), buffer_pool), RC::SUCCESS);
+
+  RecordFileHandler record_file_handler(StorageFormat::ROW_FORMAT);
+  ASSERT_EQ(record_file_handler.init(*buffer_pool, log_handler, nullptr), RC::SUCCESS);
+
+  const int                           record_size = 100;
+  char                                record_data[record_size];
+  unordered_map<RID, string, RIDHash> record_map;
+  unordered_set<PageNum>              pages;
+  for (int i = 0; i < 2000; i++) {
+    memset(record_data, 0, sizeof(record_data));
+    snprintf(record_data, sizeof(record_data), "record %d", i);
+    RID rid;
+    ASSERT_EQ(record_file_handler.insert_record(record_data, record_size, &rid), RC::SUCCESS);
+    record_map.emplace(rid, string(record_data, record_size));
+    pages.insert(rid.page_num);
+  }
+  ASSERT_GT(pages.size(), 4);
+
+  record_file_handler.close();
+  bpm.close_file(record_manager_file.c_str());
+  filesystem::remove(record_manager_file);
+  ASSERT_EQ(log_handler.stop(), RC::SUCCESS);
+  ASSERT_EQ(log_handler.await_termination(), RC::SUCCESS);
+
+  DiskLogHandler    log_handler2;
+  BufferPoolManager bpm2;
+  ASSERT_EQ(RC::SUCCESS, bpm2.init(make_unique<VacuousDoubleWriteBuffer>()));
+  DiskBufferPool *buffer_pool2 = nullptr;
+  filesystem::copy(record_manager_file_copy, record_manager_file);
+  ASSERT_EQ(bpm2.open_file(log_handler2, record_manager_file.c_str(), buffer_pool2), RC::SUCCESS);
+
+  IntegratedLogReplayer log_replayer2(bpm2, 4 /*worker_num*/);
+  ASSERT_EQ(log_handler2.init(directory.c_str()), RC::SUCCESS);
+  ASSERT_EQ(log_handler2.replay(log_replayer2, 0), RC::SUCCESS);
+  ASSERT_EQ(log_replayer2.on_done(), RC::SUCCESS);
+  ASSERT_EQ(log_handler2.start(), RC::SUCCESS);
+
+  RecordFileHandler record_file_handler2(StorageFormat::ROW_FORMAT);
+  ASSERT_EQ(record_file_handler2.init(*buffer_pool2, log_handler2, nullptr), RC::SUCCESS);
+  for (const auto &[rid, record] : record_map) {
+    Record stored;
+    ASSERT_EQ(record_file_handler2.get_record(rid, stored), RC::SUCCESS);
+    ASSERT_EQ(memcmp(stored.data(), record.c_str(), record_size), 0);
+  }
+
+  record_file_handler2.close();
+  ASSERT_EQ(log_handler2.stop(), RC::SUCCESS);
+  ASSERT_EQ(log_handler2.await_termination(), RC::SUCCESS);
+  bpm2.close_file(record_manager_file.c_str());
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,321 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created on 2026/10/18.
+//
+
+#include <math.h>
+#include <string.h>
+#include <random>
+#include <vector>
+
+#include "common/lang/comparator.h"
+#include "sql/expr/simd_kernel.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+static const CompOp comp_ops[]     = {EQUAL_TO, NOT_EQUAL, LESS_THAN, LESS_EQUAL, GREAT_THAN, GREAT_EQUAL};
+static const int    sizes[]        = {1, 7, 16, 33, 100, 1001};
+static const SimdLevel all_levels[] = {SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512};
+
+static bool compare_by_result(CompOp op, int cmp)
+{
+  switch (op) {
+    case EQUAL_TO: return cmp == 0;
+    case NOT_EQUAL: return cmp != 0;
+    case LESS_THAN: return cmp < 0;
+    case LESS_EQUAL: return cmp <= 0;
+    case GREAT_THAN: return cmp > 0;
+    case GREAT_EQUAL: return cmp >= 0;
+    default: return false;
+  }
+}
+
+template <typename T>
+static int compare_number(T left, T right)
+{
+  return left < right ? -1 : (left > right ? 1 : 0);
+}
+
+/// 设置每一种 CPU 支持的指令集，执行 func。测试结束后恢复默认的指令集
+template <typename F>
+static void for_each_level(F &&func)
+{
+  for (SimdLevel level : all_levels) {
+    if (static_cast<int>(level) > static_cast<int>(cpu_simd_level())) {
+      continue;
+    }
+    set_simd_level(level);
+    SCOPED_TRACE(simd_level_name(level));
+    func();
+  }
+  set_simd_level(cpu_simd_level());
+}
+
+/// 初始的 result 是随机的0/1，检查比较结果与原来的值做了与运算
+static vector<uint8_t> random_mask(mt19937 &rng, int n)
+{
+  vector<uint8_t> mask(n);
+  for (uint8_t &v : mask) {
+    v = rng() % 4 != 0;
+  }
+  return mask;
+}
+
+TEST(SimdKernelTest, simd_level)
+{
+  set_simd_level(SimdLevel::AVX512);
+  ASSERT_LE(static_cast<int>(simd_level()), static_cast<int>(cpu_simd_level()));
+  set_simd_level(SimdLevel::SCALAR);
+  ASSERT_EQ(SimdLevel::SCALAR, simd_level());
+  set_simd_level(cpu_simd_level());
+  ASSERT_EQ(cpu_simd_level(), simd_level());
+}
+
+TEST(SimdKernelTest, compare_int32)
+{
+  mt19937 rng(1);
+  for (int n : sizes) {
+    vector<int32_t> left(n), right(n);
+    for (int i = 0; i < n; i++) {
+      left[i]  = static_cast<int32_t>(rng() % 8) - 4;
+      right[i] = static_cast<int32_t>(rng() % 8) - 4;
+    }
+    left[0] = INT32_MIN;
+
+    vector<uint8_t> init = random_mask(rng, n);
+    for_each_level([&]() {
+      for (CompOp op : comp_ops) {
+        for (int consts = 0; consts < 4; consts++) {
+          const bool      left_const  = consts & 1;
+          const bool      right_const = consts & 2;
+          vector<uint8_t> result      = init;
+          SimdKernel::compare_int32(op, left.data(), left_const, right.data(), right_const, n, result.data());
+          for (int i = 0; i < n; i++) {
+            const bool expect = init[i] && compare_by_result(op,
+                                               compare_number(left[left_const ? 0 : i], right[right_const ? 0 : i]));
+            ASSERT_EQ(expect ? 1 : 0, result[i]) << "op=" << op << ", i=" << i << ", consts=" << consts;
+          }
+        }
+      }
+    });
+  }
+}
+
+TEST(SimdKernelTest, compare_float)
+{
+  mt19937 rng(2);
+  for (int n : sizes) {
+    vector<float> left(n), right(n);
+    for (int i = 0; i < n; i++) {
+      left[i]  = static_cast<float>(rng() % 8) / 2;
+      right[i] = static_cast<float>(rng() % 8) / 2;
+    }
+    if (n > 3) {
+      left[3] = NAN;
+    }
+
+    vector<uint8_t> init = random_mask(rng, n);
+    for_each_level([&]() {
+      for (CompOp op : comp_ops) {
+        for (int consts = 0; consts < 4; consts++) {
+          const bool      left_const  = consts & 1;
+          const bool      right_const = consts & 2;
+          vector<uint8_t> result      = init;
+          SimdKernel::compare_float(op, left.data(), left_const, right.data(), right_const, n, result.data());
+          for (int i = 0; i < n; i++) {
+            const float l      = left[left_const ? 0 : i];
+            const float r      = right[right_const ? 0 : i];
+            bool        expect = false;
+            switch (op) {
+              case EQUAL_TO: expect = l == r; break;
+              case NOT_EQUAL: expect = l != r; break;
+              case LESS_THAN: expect = l < r; break;
+              case LESS_EQUAL: expect = l <= r; break;
+              case GREAT_THAN: expect = l > r; break;
+              default: expect = l >= r; break;
+            }
+            ASSERT_EQ(init[i] && expect ? 1 : 0, result[i]) << "op=" << op << ", i=" << i << ", consts=" << consts;
+          }
+        }
+      }
+    });
+  }
+}
+
+TEST(SimdKernelTest, compare_bool)
+{
+  mt19937 rng(3);
+  for (int n : sizes) {
+    vector<uint8_t> left(n), right(n);
+    for (int i = 0; i < n; i++) {
+      left[i]  = rng() % 2;
+      right[i] = rng() % 3 == 0 ? 2 : rng() % 2;  // 非0都是 true
+    }
+
+    vector<uint8_t> init = random_mask(rng, n);
+    for_each_level([&]() {
+      for (CompOp op : comp_ops) {
+        for (int consts = 0; consts < 4; consts++) {
+          const bool      left_const  = consts & 1;
+          const bool      right_const = consts & 2;
+          vector<uint8_t> result      = init;
+          SimdKernel::compare_bool(op, left.data(), left_const, right.data(), right_const, n, result.data());
+          for (int i = 0; i < n; i++) {
+            const int  l      = left[left_const ? 0 : i] != 0;
+            const int  r      = right[right_const ? 0 : i] != 0;
+            const bool expect = init[i] && compare_by_result(op, compare_number(l, r));
+            ASSERT_EQ(expect ? 1 : 0, result[i]) << "op=" << op << ", i=" << i << ", consts=" << consts;
+          }
+        }
+      }
+    });
+  }
+}
+
+TEST(SimdKernelTest, compare_chars)
+{
+  mt19937 rng(4);
+
+  // 字符串长度随机，后面可能是'\0'和无用的数据，也可能占满整个字段
+  auto fill = [&rng](vector<char> &data, int len, int n) {
+    static const char alphabet[] = {'a', 'b', 'c', static_cast<char>(0xe4)};
+    data.assign(static_cast<size_t>(len) * n, 0);
+    for (int i = 0; i < n; i++) {
+      char *value   = data.data() + static_cast<size_t>(i) * len;
+      int   str_len = len == 0 ? 0 : rng() % (len + 1);
+      for (int j = 0; j < len; j++) {
+        value[j] = j < str_len ? alphabet[rng() % 4] : (j == str_len ? 0 : alphabet[rng() % 4]);
+      }
+      // 公共前缀长一些，才能测到字符串后部的比较
+      if (i > 0 && rng() % 2 == 0) {
+        memcpy(value, data.data(), min(len, static_cast<int>(rng() % (len + 1))));
+      }
+    }
+  };
+
+  const int lengths[][2] = {{4, 4}, {8, 3}, {20, 20}, {31, 32}, {32, 32}, {40, 5}, {64, 64}, {65, 10}, {100, 100}};
+  for (auto &length : lengths) {
+    const int left_len  = length[0];
+    const int right_len = length[1];
+    for (int n : sizes) {
+      vector<char> left, right;
+      fill(left, left_len, n);
+      fill(right, right_len, n);
+      // 与第一行相同的行，保证有相等的情况
+      if (n > 1) {
+        memcpy(right.data() + right_len, left.data(), min(left_len, right_len));
+      }
+
+      vector<uint8_t> init = random_mask(rng, n);
+      for_each_level([&]() {
+        for (CompOp op : comp_ops) {
+          for (int consts = 0; consts < 4; consts++) {
+            const bool      left_const  = consts & 1;
+            const bool      right_const = consts & 2;
+            vector<uint8_t> result      = init;
+            SimdKernel::compare_chars(
+                op, left.data(), left_len, left_const, right.data(), right_len, right_const, n, result.data());
+            for (int i = 0; i < n; i++) {
+              const char *l   = left.data() + (left_const ? 0 : static_cast<size_t>(i) * left_len);
+              const char *r   = right.data() + (right_const ? 0 : static_cast<size_t>(i) * right_len);
+              const int   cmp = common::compare_string(
+                  (void *)l, strnlen(l, left_len), (void *)r, strnlen(r, right_len));
+              const bool expect = init[i] && compare_by_result(op, cmp);
+              ASSERT_EQ(expect ? 1 : 0, result[i])
+                  << "op=" << op << ", i=" << i << ", consts=" << consts << ", len=" << left_len << "/" << right_len;
+            }
+          }
+        }
+      });
+    }
+  }
+}
+
+TEST(SimdKernelTest, mask)
+{
+  mt19937 rng(5);
+  for (int n : sizes) {
+    vector<uint8_t> dst = random_mask(rng, n);
+    vector<uint8_t> src = random_mask(rng, n);
+    for_each_level([&]() {
+      vector<uint8_t> and_result = dst;
+      vector<uint8_t> or_result  = dst;
+      SimdKernel::mask_and(and_result.data(), src.data(), n);
+      SimdKernel::mask_or(or_result.data(), src.data(), n);
+      for (int i = 0; i < n; i++) {
+        ASSERT_EQ(dst[i] & src[i], and_result[i]);
+        ASSERT_EQ(dst[i] | src[i], or_result[i]);
+      }
+    });
+  }
+}
+
+TEST(SimdKernelTest, arithmetic)
+{
+  using ArithType = SimdKernel::ArithType;
+  mt19937 rng(6);
+  for (int n : sizes) {
+    vector<int32_t> int_left(n), int_right(n);
+    vector<float>   float_left(n), float_right(n);
+    for (int i = 0; i < n; i++) {
+      int_left[i]    = static_cast<int32_t>(rng() % 20001) - 10000;
+      int_right[i]   = static_cast<int32_t>(rng() % 20001) - 10000;
+      float_left[i]  = static_cast<float>(int_left[i]) / 7;
+      float_right[i] = static_cast<float>(int_right[i]) / 3;
+    }
+
+    for_each_level([&]() {
+      for (int consts = 0; consts < 4; consts++) {
+        const bool left_const  = consts & 1;
+        const bool right_const = consts & 2;
+        for (ArithType type : {ArithType::ADD, ArithType::SUB, ArithType::MUL}) {
+          vector<int32_t> result(n);
+          SimdKernel::arith_int32(type, int_left.data(), left_const, int_right.data(), right_const, n, result.data());
+          for (int i = 0; i < n; i++) {
+            const int32_t l = int_left[left_const ? 0 : i];
+            const int32_t r = int_right[right_const ? 0 : i];
+            const int32_t expect = type == ArithType::ADD ? l + r : (type == ArithType::SUB ? l - r : l * r);
+            ASSERT_EQ(expect, result[i]);
+          }
+        }
+        for (ArithType type : {ArithType::ADD, ArithType::SUB, ArithType::MUL, ArithType::DIV}) {
+          vector<float> result(n);
+          SimdKernel::arith_float(
+              type, float_left.data(), left_const, float_right.data(), right_const, n, result.data());
+          for (int i = 0; i < n; i++) {
+            const float l      = float_left[left_const ? 0 : i];
+            const float r      = float_right[right_const ? 0 : i];
+            float       expect = 0;
+            switch (type) {
+              case ArithType::ADD: expect = l + r; break;
+              case ArithType::SUB: expect = l - r; break;
+              case ArithType::MUL: expect = l * r; break;
+              case ArithType::DIV: expect = l / r; break;
+            }
+            if (std::isnan(expect)) {
+              ASSERT_TRUE(std::isnan(result[i]));
+            } else {
+              ASSERT_EQ(expect, result[i]);
+            }
+          }
+        }
+      }
+    });
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}